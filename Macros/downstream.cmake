@@ -31,6 +31,7 @@ endif()
 message(STATUS "PETSC_ROOT set to ${PETSC_ROOT}")
 
 find_package(MPI)
+find_package(OpenMP)
 
 #-------------------- Macros
 include(GNUInstallDirs)
@@ -56,3 +57,6 @@ link_directories("${PDES_DIR}/lib")
 
 set(PDELibs ${MPI_CXX_LIBRARIES} petsc)
 set(PDELibs ${PDELibs} PDELib)
+if (OpenMP_CXX_FOUND)
+    set(PDELibs ${PDELibs} OpenMP::OpenMP_CXX)
+endif()
@@ -16,7 +16,7 @@ KEigenvalueSolver::execute()
     assemble_matrix(ASSEMBLE_SCATTER);
   else
     assemble_matrix(NO_ASSEMBLER_FLAGS);
-  linear_solver->set_matrix(A);
+  attach_operator();
 
   power_method();
 
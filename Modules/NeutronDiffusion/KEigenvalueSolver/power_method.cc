@@ -51,7 +51,7 @@ KEigenvalueSolver::power_method()
     k_eff *= production/production_ell;
 
     k_eff_change = std::fabs(k_eff - k_eff_ell)/k_eff;
-    phi_change = l1_norm(phi - phi_tmp) / l1_norm(phi);
+    phi_change = l1_norm_diff(phi, phi_tmp) / l1_norm(phi);
 
     production_ell = production;
     k_eff_ell = k_eff;
@@ -8,11 +8,31 @@ using namespace NeutronDiffusion;
 void
 SteadyStateSolver::
 assemble_matrix(AssemblerFlags assembler_flags)
+{
+  if (operator_type == OperatorType::BLOCK_SPARSE)
+    assemble_matrix(A_block, assembler_flags);
+  else if (operator_type == OperatorType::MATRIX_FREE)
+    assemble_matrix(A_matrix_free, assembler_flags);
+  else
+  {
+    assemble_matrix(A, assembler_flags);
+
+    // Entries outside of the preallocated sparsity pattern decompress the
+    // matrix, so repack it. Otherwise, this does nothing.
+    A.compress();
+  }
+}
+
+
+template<class MatrixType>
+void
+SteadyStateSolver::
+assemble_matrix(MatrixType& matrix, AssemblerFlags assembler_flags)
 {
   const bool assemble_scatter = (assembler_flags & ASSEMBLE_SCATTER);
   const bool assemble_fission = (assembler_flags & ASSEMBLE_FISSION);
 
-  A = 0.0;
+  matrix = 0.0;
 
   // Loop over cells
   for (const auto& cell: mesh->cells)
@@ -32,7 +52,7 @@ assemble_matrix(AssemblerFlags assembler_flags)
       // Total interaction term + buckling
       //========================================
 
-      A.add(i + g, i + g, (sig_t[g] + D[g] * B[g]) * volume);
+      matrix.add(i + g, i + g, (sig_t[g] + D[g] * B[g]) * volume);
 
       //========================================
       // Scattering term
@@ -42,7 +62,7 @@ assemble_matrix(AssemblerFlags assembler_flags)
       {
         const auto* sig_s = xs->transfer_matrices[0][g].data();
         for (unsigned int gp = 0; gp < n_groups; ++gp)
-          A.add(i + g, i + gp, -sig_s[gp] * volume);
+          matrix.add(i + g, i + gp, -sig_s[gp] * volume);
       }
 
       //========================================
@@ -58,7 +78,7 @@ assemble_matrix(AssemblerFlags assembler_flags)
           const auto* nu_sigf = xs->nu_sigma_f.data();
 
           for (unsigned int gp = 0; gp < n_groups; ++gp)
-            A.add(i + g, i + gp, -chi * nu_sigf[gp] * volume);
+            matrix.add(i + g, i + gp, -chi * nu_sigf[gp] * volume);
         }
 
         // Prompt + delayed fission
@@ -75,7 +95,7 @@ assemble_matrix(AssemblerFlags assembler_flags)
             double f = chi_p * nup_sigf[gp];
             for (unsigned int j = 0; j < xs->n_precursors; ++j)
               f += chi_d[j] * gamma[j] * nud_sigf[gp];
-            A.add(i + g, i + gp, -f * volume);
+            matrix.add(i + g, i + gp, -f * volume);
           }
         }
       }//if fissile
@@ -108,8 +128,8 @@ assemble_matrix(AssemblerFlags assembler_flags)
           const double D_eff = 1.0 / (w / D[g] + (1.0 - w) / D_nbr[g]);
           const double value = D_eff / d_pn * face.area;
 
-          A.add(i + g, i + g, value);
-          A.add(i + g, j + g, -value);
+          matrix.add(i + g, i + g, value);
+          matrix.add(i + g, j + g, -value);
         }
       }//if interior face
 
@@ -131,7 +151,7 @@ assemble_matrix(AssemblerFlags assembler_flags)
         {
           const auto d_pf = cell.centroid.distance(face.centroid);
           for (unsigned int g = 0; g < n_groups; ++g)
-            A.add(i + g, i + g, D[g] / d_pf * face.area);
+            matrix.add(i + g, i + g, D[g] / d_pf * face.area);
         }
 
           //========================================
@@ -149,10 +169,21 @@ assemble_matrix(AssemblerFlags assembler_flags)
             const auto bc = std::static_pointer_cast<RobinBoundary>(bndry);
 
             const auto value = bc->a * D[g] / (bc->b * D[g] + bc->a * d_pf);
-            A.add(i + g, i + g, value * face.area);
+            matrix.add(i + g, i + g, value * face.area);
           }
         }
       }//if boundary face
     }//for face
   }//for cell
 }
+
+
+template void
+SteadyStateSolver::assemble_matrix<SparseMatrix>(SparseMatrix&,
+                                                 AssemblerFlags);
+template void
+SteadyStateSolver::assemble_matrix<BlockSparseMatrix>(BlockSparseMatrix&,
+                                                      AssemblerFlags);
+template void
+SteadyStateSolver::assemble_matrix<DiffusionOperator>(DiffusionOperator&,
+                                                      AssemblerFlags);
@@ -16,7 +16,7 @@ NeutronDiffusion::SteadyStateSolver::execute()
   if (algorithm == Algorithm::DIRECT)
   {
     assemble_matrix(ASSEMBLE_SCATTER | ASSEMBLE_FISSION);
-    linear_solver->set_matrix(A);
+    attach_operator();
 
     set_source(APPLY_MATERIAL_SOURCE | APPLY_BOUNDARY_SOURCE);
     linear_solver->solve(phi, b);
@@ -24,7 +24,7 @@ NeutronDiffusion::SteadyStateSolver::execute()
   else
   {
     assemble_matrix();
-    linear_solver->set_matrix(A);
+    attach_operator();
 
     iterative_solve(APPLY_MATERIAL_SOURCE | APPLY_BOUNDARY_SOURCE |
                     APPLY_SCATTER_SOURCE | APPLY_FISSION_SOURCE);
@@ -37,6 +37,31 @@ NeutronDiffusion::SteadyStateSolver::execute()
 
 //######################################################################
 
+void
+NeutronDiffusion::SteadyStateSolver::attach_operator()
+{
+  if (operator_type == OperatorType::SPARSE)
+  {
+    linear_solver->set_matrix(A);
+    return;
+  }
+
+  using namespace LinearSolvers;
+  auto iterative_solver =
+      std::dynamic_pointer_cast<IterativeSolverBase>(linear_solver);
+  if (!iterative_solver)
+    throw std::runtime_error(
+        "Block sparse and matrix-free operators require an iterative "
+        "linear solver.");
+
+  if (operator_type == OperatorType::BLOCK_SPARSE)
+    iterative_solver->set_operator(A_block);
+  else
+    iterative_solver->set_operator(A_matrix_free);
+}
+
+//######################################################################
+
 std::pair<unsigned int, double>
 NeutronDiffusion::SteadyStateSolver::
 iterative_solve(SourceFlags source_flags)
@@ -55,7 +80,7 @@ iterative_solve(SourceFlags source_flags)
     linear_solver->solve(phi, b);
 
     // Convergence check, finalize iteration
-    change = l1_norm(phi - phi_ell);
+    change = l1_norm_diff(phi, phi_ell);
     bool converged = change < inner_tolerance;
     phi_ell = phi;
 
@@ -1,6 +1,7 @@
 #include "steadystate_solver.h"
 
 #include "Discretization/FiniteVolume/fv.h"
+#include "sparsity_pattern.h"
 #include "Math/LinearSolvers/Direct/cholesky.h"
 
 #include <algorithm>
@@ -61,7 +62,24 @@ initialize()
   phi.resize(n_phi_dofs, 0.0);
   precursors.resize(n_precursor_dofs, 0.0);
 
-  A.reinit(n_phi_dofs, n_phi_dofs);
+  // Preallocate the multi-group matrix. Cross-group scattering and fission
+  // are only assembled into the matrix with the direct algorithm.
+  SparsityPattern pattern;
+  if (operator_type == OperatorType::BLOCK_SPARSE)
+  {
+    // Each cell defines a dense group-wise block while face coupling only
+    // occurs within a group, so the off-diagonal blocks are diagonal.
+    discretization->make_sparsity_pattern(pattern);
+    A_block.reinit(pattern, n_groups, true);
+  }
+  else if (operator_type == OperatorType::MATRIX_FREE)
+    A_matrix_free.reinit(*mesh, n_groups, algorithm == Algorithm::DIRECT);
+  else
+  {
+    discretization->make_sparsity_pattern(pattern, n_groups,
+                                          algorithm == Algorithm::DIRECT);
+    A.reinit(pattern);
+  }
   b.resize(n_phi_dofs, 0.0);
 
   std::cout
@@ -2,12 +2,14 @@
 #define STEADYSTATE_SOLVER_H
 
 #include "../boundaries.h"
+#include "../diffusion_operator.h"
 
 #include "mesh.h"
 #include "Discretization/discretization.h"
 
 #include "vector.h"
 #include "Math/sparse_matrix.h"
+#include "block_sparse_matrix.h"
 #include "LinearSolvers/linear_solver.h"
 
 #include "material.h"
@@ -35,6 +37,17 @@ namespace NeutronDiffusion
   };
 
 
+  /**
+   * Storage formats available for the multi-group operator.
+   */
+  enum class OperatorType
+  {
+    SPARSE = 0,       ///< Entry-wise compressed sparse row storage.
+    BLOCK_SPARSE = 1, ///< Group-wise block sparse row storage.
+    MATRIX_FREE = 2   ///< Cell and face coefficients applied on the fly.
+  };
+
+
   /**
    * Bitwise source flags for right-hand side vector construction.
    */
@@ -97,6 +110,16 @@ namespace NeutronDiffusion
     Algorithm algorithm = Algorithm::DIRECT;
     SDMethod discretization_method = SDMethod::FINITE_VOLUME;
 
+    /**
+     * The storage format of the multi-group operator. The block sparse format
+     * stores a dense <tt>n_groups x n_groups</tt> block per cell and diagonal
+     * blocks for face coupling. The matrix-free format only stores cell and
+     * face coefficients and applies them using the mesh connectivity. These
+     * formats require an iterative linear solver which only relies upon
+     * matrix-vector products.
+     */
+    OperatorType operator_type = OperatorType::SPARSE;
+
     /**
      * A flag for whether or not delayed neutron precursors should be used
      * or not. If delayed neutron data is present and this flag is false, the
@@ -211,6 +234,8 @@ namespace NeutronDiffusion
     Vector precursors;
 
     SparseMatrix A;  ///< The multi-group matrix.
+    BlockSparseMatrix A_block; ///< The block multi-group matrix.
+    DiffusionOperator A_matrix_free; ///< The matrix-free multi-group operator.
     Vector b; ///< The right-hand side vector.
 
   public:
@@ -276,6 +301,19 @@ namespace NeutronDiffusion
      */
     void assemble_matrix(AssemblerFlags assembler_flags = NO_ASSEMBLER_FLAGS);
 
+    /**
+     * Assemble the multi-group matrix into the specified \p matrix, which is
+     * stored entry-wise, group-wise in blocks, or matrix-free.
+     */
+    template<class MatrixType>
+    void assemble_matrix(MatrixType& matrix, AssemblerFlags assembler_flags);
+
+    /**
+     * Attach the multi-group matrix in the format specified by
+     * \p operator_type to the linear solver.
+     */
+    void attach_operator();
+
     /**
      * Accumulate sources into the right-hand side according to the specified
      * \p source_flags.
@@ -1,18 +1,150 @@
 #include "transient_solver.h"
 
+#include "vector_pool.h"
+
 #include <iomanip>
+#include <algorithm>
 
 using namespace NeutronDiffusion;
 
 
+namespace
+{
+  /**
+   * Return the coefficient of the precursor substitution term for group
+   * \p g when precursors are treated implicitly. This is the sum over
+   * precursor species of the delayed spectrum weighted by the fraction of
+   * precursors produced over a time step that also decay within it.
+   */
+  double
+  delayed_fission_coefficient(const CrossSections& xs,
+                              const unsigned int g,
+                              const double eff_dt)
+  {
+    const auto* chi_d = xs.chi_delayed[g].data();
+    const auto* lambda = xs.precursor_lambda.data();
+    const auto* gamma = xs.precursor_yield.data();
+
+    double coeff = 0.0;
+    for (unsigned int j = 0; j < xs.n_precursors; ++j)
+      coeff += chi_d[j] * lambda[j] * gamma[j] * eff_dt /
+               (1.0 + eff_dt*lambda[j]);
+    return coeff;
+  }
+}
+
+
 void
 TransientSolver::
 assemble_transient_matrix(AssemblerFlags assembler_flags)
+{
+  if (operator_type == OperatorType::BLOCK_SPARSE)
+    assemble_transient_matrix(A_block, assembler_flags);
+  else if (operator_type == OperatorType::MATRIX_FREE)
+    assemble_transient_matrix(A_matrix_free, assembler_flags);
+  else
+  {
+    // Only the time step dependent terms change with the time step size, so
+    // the remaining terms are assembled once per cross-section update.
+    if (!has_split_operator)
+      assemble_split_operator(assembler_flags);
+    form_transient_matrix();
+  }
+}
+
+
+void
+TransientSolver::
+assemble_split_operator(AssemblerFlags assembler_flags)
+{
+  // Time step independent terms. The copy provides the sparsity pattern.
+  A_loss = A;
+  assemble_transient_matrix(A_loss, assembler_flags, false);
+
+  // Entries outside of the preallocated sparsity pattern decompress the
+  // matrix, so repack it and share the pattern. Otherwise, this does nothing.
+  if (!A_loss.is_compressed())
+  {
+    A_loss.compress();
+    A = A_loss;
+  }
+
+  // Time-derivative mass diagonal
+  mass_diagonal.resize(A.n_rows());
+  for (const auto& cell : mesh->cells)
+  {
+    const auto& xs = material_xs[matid_to_xs_map[cell.material_id]];
+    for (unsigned int g = 0; g < n_groups; ++g)
+      mass_diagonal[n_groups * cell.id + g] =
+          xs->inv_velocity[g] * cell.volume;
+  }
+
+  // Unscaled delayed fission terms. Each row is scaled by the delayed
+  // fission coefficient of its group when the matrix is formed.
+  has_delayed_block = (assembler_flags & ASSEMBLE_FISSION) &&
+                      use_precursors && not lag_precursors;
+  if (has_delayed_block)
+  {
+    A_delayed = A_loss;
+    A_delayed = 0.0;
+    for (const auto& cell : mesh->cells)
+    {
+      const auto& xs = material_xs[matid_to_xs_map[cell.material_id]];
+      if (not xs->is_fissile)
+        continue;
+
+      const auto i = n_groups * cell.id;
+      const auto* nud_sigf = xs->nu_delayed_sigma_f.data();
+      for (unsigned int g = 0; g < n_groups; ++g)
+        for (unsigned int gp = 0; gp < n_groups; ++gp)
+          A_delayed.set(i + g, i + gp, -nud_sigf[gp] * cell.volume);
+    }
+  }
+
+  has_split_operator = true;
+}
+
+
+void
+TransientSolver::
+form_transient_matrix()
+{
+  const auto eff_dt = effective_time_step();
+
+  A.sadd(0.0, 1.0, A_loss);
+  for (size_t i = 0; i < A.n_rows(); ++i)
+    A.diag(i) += mass_diagonal[i] / eff_dt;
+
+  if (has_delayed_block)
+  {
+    ScratchVector row_factors_work(A.n_rows(), 0.0);
+    Vector& row_factors = *row_factors_work;
+    for (const auto& cell : mesh->cells)
+    {
+      const auto& xs = material_xs[matid_to_xs_map[cell.material_id]];
+      if (not xs->is_fissile)
+        continue;
+
+      for (unsigned int g = 0; g < n_groups; ++g)
+        row_factors[n_groups * cell.id + g] =
+            delayed_fission_coefficient(*xs, g, eff_dt);
+    }
+    A.add(row_factors, A_delayed);
+  }
+}
+
+
+template<class MatrixType>
+void
+TransientSolver::
+assemble_transient_matrix(MatrixType& matrix,
+                          AssemblerFlags assembler_flags,
+                          const bool time_step_terms)
 {
   const bool assemble_scatter = (assembler_flags & ASSEMBLE_SCATTER);
   const bool assemble_fission = (assembler_flags & ASSEMBLE_FISSION);
 
-  A = 0.0;
+  matrix = 0.0;
 
   // Get effective time step size
   const auto eff_dt = effective_time_step();
@@ -39,8 +171,9 @@ assemble_transient_matrix(AssemblerFlags assembler_flags)
       double entry = 0.0;
       entry += sig_t[g]; // total interaction
       entry += D[g] * B[g]; // buckling
-      entry += inv_vel[g]/eff_dt; // time-derivative
-      A.add(i + g, i + g, entry * volume);
+      if (time_step_terms)
+        entry += inv_vel[g]/eff_dt; // time-derivative
+      matrix.add(i + g, i + g, entry * volume);
 
       //========================================
       // Scattering term
@@ -50,7 +183,7 @@ assemble_transient_matrix(AssemblerFlags assembler_flags)
       {
         const auto* sig_s = xs->transfer_matrices[0][g].data();
         for (unsigned int gp = 0; gp < n_groups; ++gp)
-          A.add(i + g, i + gp, -sig_s[gp] * volume);
+          matrix.add(i + g, i + gp, -sig_s[gp] * volume);
       }//if scattering
 
       //========================================
@@ -66,7 +199,7 @@ assemble_transient_matrix(AssemblerFlags assembler_flags)
           const auto* nu_sigf = xs->nu_sigma_f.data();
 
           for (unsigned int gp = 0; gp < n_groups; ++gp)
-            A.add(i + g, i + gp, -chi * nu_sigf[gp] * volume);
+            matrix.add(i + g, i + gp, -chi * nu_sigf[gp] * volume);
         }//if no precursors
 
         //========== Prompt + delayed fission
@@ -76,35 +209,20 @@ assemble_transient_matrix(AssemblerFlags assembler_flags)
           const auto chi_p = xs->chi_prompt[g];
           const auto* nup_sigf = xs->nu_prompt_sigma_f.data();
           for (unsigned int gp = 0; gp < n_groups; ++gp)
-            A.add(i + g, i + gp, -chi_p * nup_sigf[gp] * volume);
+            matrix.add(i + g, i + gp, -chi_p * nup_sigf[gp] * volume);
 
           //===== Delayed
-          if (not lag_precursors)
+          if (not lag_precursors && time_step_terms)
           {
-            const auto* chi_d = xs->chi_delayed[g].data();
             const auto* nud_sigf = xs->nu_delayed_sigma_f.data();
-            const auto* lambda = xs->precursor_lambda.data();
-            const auto* gamma = xs->precursor_yield.data();
-
-            // This section of code computes the matrix coefficient
-            // corresponding to the precursor substitution term arising when
-            // precursors are treated implicitly. This term is similar to the
-            // normal fission term with the exception of having an inner sum
-            // over all precursor species. The first loop computes sum over
-            // precursor species. This provides a factor which is multiplied
-            // by nu_delayed_sigma_f when contributing to the matrix. The
-            // coefficient is computed ahead of time for the sake of efficiency.
-            // Using nested loops would require either this factor to be
-            // computed \p n_gsg times or for many more expensive sparse matrix
-            // add operations. */
-            double coeff= 0.0;
-            for (unsigned int j = 0; j < xs->n_precursors; ++j)
-              coeff += chi_d[j] * lambda[j] * gamma[j] * eff_dt /
-                       (1.0 + eff_dt*lambda[j]);
-
-            // Contribute the delayed fission term to the matrix.
+
+            // The precursor substitution term arising when precursors are
+            // treated implicitly is similar to the normal fission term with
+            // an inner sum over all precursor species, which is computed
+            // ahead of time to minimize the number of matrix additions.
+            const auto coeff = delayed_fission_coefficient(*xs, g, eff_dt);
             for (unsigned int gp = 0; gp < n_groups; ++gp)
-              A.add(i + g, i + gp, -coeff * nud_sigf[gp] * volume);
+              matrix.add(i + g, i + gp, -coeff * nud_sigf[gp] * volume);
           }//if not lag precursors
         }//if prompt + delayed fission
       }//if fissile
@@ -135,8 +253,8 @@ assemble_transient_matrix(AssemblerFlags assembler_flags)
         {
           const auto D_eff = 1.0/(w/D[g] + (1.0 - w)/D_nbr[g]);
 
-          A.add(i + g, i + g, D_eff / d_pn * face.area);
-          A.add(i + g, j + g, -D_eff / d_pn * face.area);
+          matrix.add(i + g, i + g, D_eff / d_pn * face.area);
+          matrix.add(i + g, j + g, -D_eff / d_pn * face.area);
         }
       }//if interior face
 
@@ -157,7 +275,7 @@ assemble_transient_matrix(AssemblerFlags assembler_flags)
         {
           const auto d_pf = cell.centroid.distance(face.centroid);
           for (unsigned int g = 0; g < n_groups; ++g)
-            A.add(i + g, i + g, D[g] / d_pf * face.area);
+            matrix.add(i + g, i + g, D[g] / d_pf * face.area);
         }//if Dirichlet
 
         //========================================
@@ -175,7 +293,7 @@ assemble_transient_matrix(AssemblerFlags assembler_flags)
             const auto bc = std::static_pointer_cast<RobinBoundary>(bndry);
 
             double val = bc->a*D[g]/(bc->b*D[g] + bc->a*d_pf);
-            A.add(i + g, i + g, val * face.area);
+            matrix.add(i + g, i + g, val * face.area);
           }//for g
         }//if Robin
       }//if boundary face
@@ -184,13 +302,81 @@ assemble_transient_matrix(AssemblerFlags assembler_flags)
 }
 
 
+template void
+TransientSolver::
+assemble_transient_matrix<SparseMatrix>(SparseMatrix&, AssemblerFlags,
+                                       const bool);
+template void
+TransientSolver::
+assemble_transient_matrix<BlockSparseMatrix>(BlockSparseMatrix&,
+                                             AssemblerFlags, const bool);
+template void
+TransientSolver::
+assemble_transient_matrix<DiffusionOperator>(DiffusionOperator&,
+                                             AssemblerFlags, const bool);
+
+
 void
 TransientSolver::
 rebuild_matrix()
 {
+  const double eff_dt = effective_time_step();
+  if (operator_type == OperatorType::SPARSE &&
+      operator_cache_size > 0 && has_operator)
+  {
+    // The attached operator is already up to date
+    if (operator_dt == eff_dt && operator_xs_version == xs_version)
+      return;
+
+    // Swap in a cached operator, caching the attached one in its place
+    const auto match = [&](const CachedOperator& entry)
+    { return entry.eff_dt == eff_dt && entry.xs_version == xs_version; };
+    auto it = std::find_if(operator_cache.begin(),
+                           operator_cache.end(), match);
+    if (it != operator_cache.end())
+    {
+      std::swap(A, it->matrix);
+      if (it->solver)
+        std::swap(linear_solver, it->solver);
+      else
+        linear_solver->set_matrix(A);
+
+      it->eff_dt = operator_dt;
+      it->xs_version = operator_xs_version;
+      operator_cache.splice(operator_cache.begin(), operator_cache, it);
+
+      operator_dt = eff_dt;
+      return;
+    }
+
+    // Cache the attached operator. If the solver can be cloned, the
+    // factorized solver is cached and a new one takes its place.
+    auto clone = linear_solver->clone();
+    operator_cache.push_front({operator_dt, operator_xs_version, A,
+                               clone ? linear_solver : nullptr});
+    if (operator_cache.size() > operator_cache_size)
+      operator_cache.pop_back();
+    if (clone)
+      linear_solver = clone;
+  }
+
   if (algorithm == Algorithm::DIRECT)
     assemble_transient_matrix(ASSEMBLE_SCATTER | ASSEMBLE_FISSION);
   else
     assemble_transient_matrix(NO_ASSEMBLER_FLAGS);
-  linear_solver->set_matrix(A);
+  attach_operator();
+
+  has_operator = true;
+  operator_dt = eff_dt;
+  operator_xs_version = xs_version;
+}
+
+
+void
+TransientSolver::
+clear_operator_cache()
+{
+  operator_cache.clear();
+  has_operator = false;
+  has_split_operator = false;
 }
@@ -24,6 +24,7 @@ TransientSolver::execute()
     write(output++);
 
   // Initialize matrices
+  clear_operator_cache();
   rebuild_matrix();
 
   const double dt_initial = dt;
@@ -14,11 +14,20 @@ TransientSolver::execute_time_step(bool reconstruct_matrices)
   // Update cross sections
   if (has_dynamic_xs)
   {
+    bool xs_changed = false;
     const auto eff_dt = effective_time_step();
     for (const auto& cell : mesh->cells)
-      cellwise_xs[cell.id].update({time + eff_dt,
-                                   temperature[cell.id]});
-    reconstruct_matrices = true;
+      if (cellwise_xs[cell.id].update({time + eff_dt,
+                                       temperature[cell.id]}))
+        xs_changed = true;
+
+    // Operators assembled with the old cross-sections are no longer valid
+    if (xs_changed)
+    {
+      ++xs_version;
+      clear_operator_cache();
+      reconstruct_matrices = true;
+    }
   }
 
   if (reconstruct_matrices)
@@ -69,7 +78,7 @@ TransientSolver::iterative_time_step_solve(SourceFlags source_flags)
     linear_solver->solve(phi, b);
 
     // Convergence check, finalize iteration
-    change = l1_norm(phi - phi_ell);
+    change = l1_norm_diff(phi, phi_ell);
     converged = change < inner_tolerance;
     phi_ell = phi;
 
@@ -4,6 +4,7 @@
 #include "../KEigenvalueSolver/keigenvalue_solver.h"
 
 #include <map>
+#include <list>
 #include <functional>
 
 
@@ -122,6 +123,19 @@ namespace NeutronDiffusion
     double coarsen_threshold = 0.01;
     double dt_min = 1.0e-6;
 
+    /**
+     * The number of previously assembled multi-group matrices, along with
+     * their factorized linear solvers, that are kept for reuse. When the
+     * effective time step returns to a recently used value and the
+     * cross-sections have not changed since, the cached matrix and solver
+     * are swapped back in rather than being reassembled and refactorized.
+     * This is most useful with adaptive time stepping, which tends to flip
+     * between a small set of time step sizes. Linear solvers which do not
+     * support LinearSolverBase::clone only reuse the matrix. A value of zero
+     * disables the cache. The cache is only used with sparse operators.
+     */
+    unsigned int operator_cache_size = 4;
+
   protected:
     /*-------------------- Problem Information --------------------*/
 
@@ -164,6 +178,56 @@ namespace NeutronDiffusion
     Vector temperature; ///< The cell-wise temperature.
     Vector temperature_old; ///< The temperature last time step.
 
+    /*-------------------- Split Operator --------------------*/
+
+    /**
+     * The sparse multi-group matrix is split as \f$ A(\Delta t) = K +
+     * \frac{1}{\Delta t} M + S(\Delta t) F_d \f$, where \f$ K \f$ contains
+     * all time step independent terms, \f$ M \f$ is the diagonal
+     * time-derivative mass matrix, \f$ F_d \f$ contains the delayed fission
+     * terms, and \f$ S \f$ is a diagonal matrix of delayed fission
+     * coefficients. When the time step size changes, only the scaled sum is
+     * recomputed. The parts share the sparsity pattern of \ref A.
+     */
+    SparseMatrix A_loss;
+    Vector mass_diagonal; ///< The time-derivative mass diagonal.
+    SparseMatrix A_delayed; ///< The unscaled delayed fission terms.
+
+    /** A flag for whether the implicit delayed fission terms are present. */
+    bool has_delayed_block = false;
+
+    /** A flag for whether the split parts match the cross-sections. */
+    bool has_split_operator = false;
+
+    /*-------------------- Operator Cache --------------------*/
+
+    /**
+     * A counter which is incremented whenever the dynamic cross-sections
+     * change. Cached operators are only valid for the version they were
+     * assembled with.
+     */
+    unsigned long xs_version = 0;
+
+    /** A previously assembled matrix and the solver it is attached to. */
+    struct CachedOperator
+    {
+      double eff_dt;
+      unsigned long xs_version;
+
+      SparseMatrix matrix;
+      std::shared_ptr<LinearSolver> solver;
+    };
+
+    /** The cached operators, from most to least recently used. */
+    std::list<CachedOperator> operator_cache;
+
+    /** A flag for whether the attached operator has a valid cache key. */
+    bool has_operator = false;
+
+    /** The effective time step and xs version of the attached operator. */
+    double operator_dt;
+    unsigned long operator_xs_version;
+
   public:
     /*-------------------- Public Routines --------------------*/
 
@@ -247,6 +311,31 @@ namespace NeutronDiffusion
     void assemble_transient_matrix(
         AssemblerFlags assembler_flags = NO_ASSEMBLER_FLAGS);
 
+    /**
+     * Assemble the transient multi-group matrix into the specified
+     * \p matrix, which is stored entry-wise, group-wise in blocks, or
+     * matrix-free. If \p time_step_terms is \p false, the time-derivative
+     * and implicit delayed fission terms, which depend on the time step size,
+     * are omitted.
+     */
+    template<class MatrixType>
+    void assemble_transient_matrix(MatrixType& matrix,
+                                   AssemblerFlags assembler_flags,
+                                   const bool time_step_terms = true);
+
+    /**
+     * Assemble the parts of the sparse multi-group matrix which do not
+     * depend on the time step size, i.e. \ref A_loss, \ref mass_diagonal,
+     * and \ref A_delayed.
+     */
+    void assemble_split_operator(AssemblerFlags assembler_flags);
+
+    /**
+     * Form the sparse multi-group matrix for the current effective time step
+     * from its split parts. This is a single pass over the non-zero entries.
+     */
+    void form_transient_matrix();
+
     /**
      * Accumulate sources into the right-hand side according to the specified
      * \p source_flags.
@@ -261,10 +350,18 @@ namespace NeutronDiffusion
      * Rebuild the multi-group matrix.
      *
      * This is shorthand for the conditional construction based on the
-     * \p algorithm option.
+     * \p algorithm option. Matrices are looked up in the operator cache by
+     * effective time step and cross-section version before being assembled.
+     * See \ref operator_cache_size.
      */
     void rebuild_matrix();
 
+    /**
+     * Discard all cached operators, including the attached one and the split
+     * parts of the sparse multi-group matrix.
+     */
+    void clear_operator_cache();
+
     /*-------------------- Auxiliary Quantities --------------------*/
 
     void update_fission_rate();
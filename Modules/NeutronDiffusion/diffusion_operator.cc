@@ -0,0 +1,182 @@
+#include "diffusion_operator.h"
+
+#include "vector.h"
+#include "multithreading.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+
+using namespace NeutronDiffusion;
+
+
+void
+DiffusionOperator::reinit(const Mesh& mesh,
+                          const unsigned int n_groups,
+                          const bool is_coupled)
+{
+  assert(mesh.cells.size() <= std::numeric_limits<unsigned int>::max());
+
+  this->n_groups = n_groups;
+  n_cells = mesh.cells.size();
+  coupled = is_coupled;
+
+  const size_t cell_block = coupled ? n_groups * n_groups : n_groups;
+  cell_values.assign(n_cells * cell_block, 0.0);
+
+  // Build the cell-wise neighbor lists. Each interior face is numbered from
+  // the lower numbered cell and the index is looked up from the other.
+  neighbor_offsets.assign(n_cells + 1, 0);
+  neighbor_ids.clear();
+  neighbor_faces.clear();
+
+  unsigned int n_faces = 0;
+  for (const auto& cell: mesh.cells)
+  {
+    for (const auto& face: cell.faces)
+    {
+      if (!face.has_neighbor)
+        continue;
+
+      const auto nbr = face.neighbor_id;
+      neighbor_ids.push_back(nbr);
+      if (cell.id < nbr)
+        neighbor_faces.push_back(n_faces++);
+      else
+      {
+        const auto first = neighbor_ids.begin() + neighbor_offsets[nbr];
+        const auto last = neighbor_ids.begin() + neighbor_offsets[nbr + 1];
+        const auto it = std::find(first, last, cell.id);
+        assert(it != last);
+        neighbor_faces.push_back(neighbor_faces[it - neighbor_ids.begin()]);
+      }
+    }
+    neighbor_offsets[cell.id + 1] = neighbor_ids.size();
+  }
+  face_values.assign(n_faces * n_groups, 0.0);
+}
+
+
+DiffusionOperator&
+DiffusionOperator::operator=(const double value)
+{
+  std::fill(cell_values.begin(), cell_values.end(), value);
+  std::fill(face_values.begin(), face_values.end(), value);
+  return *this;
+}
+
+
+size_t
+DiffusionOperator::n_rows() const
+{
+  return n_cells * n_groups;
+}
+
+
+size_t
+DiffusionOperator::n_cols() const
+{
+  return n_cells * n_groups;
+}
+
+
+size_t
+DiffusionOperator::n_stored_coefficients() const
+{
+  return cell_values.size() + face_values.size();
+}
+
+
+void
+DiffusionOperator::add(const size_t i, const size_t j, const double value)
+{
+  assert(i < n_rows());
+  assert(j < n_cols());
+
+  const size_t cell = i / n_groups, nbr = j / n_groups;
+  const unsigned int g = i % n_groups, gp = j % n_groups;
+
+  //========================================
+  // Within-cell terms
+  //========================================
+
+  if (cell == nbr)
+  {
+    assert(coupled || g == gp);
+    if (coupled)
+      cell_values[(cell * n_groups + g) * n_groups + gp] += value;
+    else
+      cell_values[cell * n_groups + g] += value;
+    return;
+  }
+
+  //========================================
+  // Diffusion coupling terms
+  //========================================
+
+  assert(g == gp);
+  const auto first = neighbor_ids.begin() + neighbor_offsets[cell];
+  const auto last = neighbor_ids.begin() + neighbor_offsets[cell + 1];
+  const auto it = std::find(first, last, nbr);
+  assert(it != last);
+
+  double& coeff = face_values[neighbor_faces[it - neighbor_ids.begin()] *
+                              n_groups + g];
+  if (cell < nbr)
+    coeff += value;
+  else
+    assert(std::fabs(coeff - value) <= 1.0e-8 * std::fabs(value));
+}
+
+
+void
+DiffusionOperator::vmult(Vector& y,
+                         const Vector& x,
+                         const bool adding) const
+{
+  assert(x.size() == n_cols());
+  assert(y.size() == n_rows());
+  assert(&x != &y);
+
+  const int n_threads = MultiThreading::n_threads(n_rows());
+  const auto bounds = MultiThreading::partition(neighbor_offsets.data(),
+                                                n_cells, n_threads);
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t)
+    for (size_t c = bounds[t]; c < bounds[t + 1]; ++c)
+    {
+      const double* x_c = x.data() + c * n_groups;
+      double* y_c = y.data() + c * n_groups;
+
+      // Within-cell contributions
+      if (coupled)
+      {
+        const double* a_c = cell_values.data() + c * n_groups * n_groups;
+        for (unsigned int g = 0; g < n_groups; ++g)
+        {
+          double val = adding ? y_c[g] : 0.0;
+          for (unsigned int gp = 0; gp < n_groups; ++gp)
+            val += a_c[g * n_groups + gp] * x_c[gp];
+          y_c[g] = val;
+        }
+      }
+      else
+      {
+        const double* a_c = cell_values.data() + c * n_groups;
+        for (unsigned int g = 0; g < n_groups; ++g)
+          y_c[g] = (adding ? y_c[g] : 0.0) + a_c[g] * x_c[g];
+      }
+
+      // Neighbor contributions
+      for (size_t k = neighbor_offsets[c]; k < neighbor_offsets[c + 1]; ++k)
+      {
+        const double* x_n = x.data() + neighbor_ids[k] * n_groups;
+        const double* a_f = face_values.data() + neighbor_faces[k] * n_groups;
+        for (unsigned int g = 0; g < n_groups; ++g)
+          y_c[g] += a_f[g] * x_n[g];
+      }
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef DIFFUSION_OPERATOR_H
+#define DIFFUSION_OPERATOR_H
+
+#include "mesh.h"
+#include "linear_operator.h"
+
+#include <cstddef>
+#include <vector>
+
+
+using namespace PDEs;
+using namespace Grid;
+using namespace Math;
+
+
+namespace NeutronDiffusion
+{
+  /**
+   * A matrix-free multi-group finite volume diffusion operator.
+   *
+   * Rather than storing the multi-group matrix, this operator stores the
+   * coefficients it is built from and applies them on the fly using the
+   * connectivity of the mesh. Each interior face stores one diffusion
+   * coupling coefficient per group, which is shared by the two cells on
+   * either side of it. Each cell stores its within-group diagonal entries
+   * or, when cross-group scattering or fission are included, its dense
+   * group-to-group block. No column indices or row offsets are stored.
+   *
+   * The coefficients are set with the same \ref add interface as a matrix,
+   * so the operator can be filled by the matrix assembly routines. The
+   * diffusion coupling coefficients are assumed to be symmetric, as is the
+   * case on orthogonal meshes, so only the coefficient from the lower
+   * numbered cell of each face is kept.
+   */
+  class DiffusionOperator : public LinearOperator
+  {
+  private:
+    unsigned int n_groups = 0;
+    size_t n_cells = 0;
+
+    /** A flag for whether cells store a dense group-to-group block. */
+    bool coupled = false;
+
+    /** The per-cell diagonal entries or dense blocks. */
+    std::vector<double> cell_values;
+
+    /**
+     * The offset of the first neighbor of each cell within
+     * \ref neighbor_ids and \ref neighbor_faces.
+     */
+    std::vector<size_t> neighbor_offsets;
+
+    /** The neighbor cell across each interior face of each cell. */
+    std::vector<unsigned int> neighbor_ids;
+
+    /** The unique interior face index of each interior face of each cell. */
+    std::vector<unsigned int> neighbor_faces;
+
+    /** The per-group diffusion coupling coefficients of each face. */
+    std::vector<double> face_values;
+
+  public:
+    /** Default constructor. */
+    DiffusionOperator() = default;
+
+    /**
+     * Reinitialize the operator for the specified \p mesh and number of
+     * groups. If \p is_coupled is set, storage for cross-group terms is
+     * allocated. All coefficients are set to zero.
+     */
+    void reinit(const Mesh& mesh,
+                const unsigned int n_groups,
+                const bool is_coupled = false);
+
+    /** Set all coefficients to a scalar \p value. */
+    DiffusionOperator& operator=(const double value);
+
+    /** Return the number of rows. */
+    size_t n_rows() const override;
+
+    /** Return the number of columns. */
+    size_t n_cols() const override;
+
+    /**
+     * Return the number of stored coefficients. This is the memory footprint
+     * of the operator, excluding the mesh connectivity.
+     */
+    size_t n_stored_coefficients() const;
+
+    /**
+     * Add \p value to the operator at row \p i and column \p j. The row and
+     * column are multi-group indices, i.e. <tt>n_groups * cell_id + g</tt>.
+     * Entries coupling two cells must be within-group. These are only stored
+     * when added from the lower numbered cell.
+     */
+    void add(const size_t i, const size_t j, const double value);
+
+    /**
+     * Apply the operator to a vector, i.e. \f$ y = A x \f$. The optional
+     * \p adding flag dictates whether to write or add to the destination
+     * vector \p y. Cells are split among threads.
+     */
+    void vmult(Vector& y,
+               const Vector& x,
+               const bool adding = false) const override;
+  };
+}
+
+#endif //DIFFUSION_OPERATOR_H
@@ -0,0 +1,102 @@
+#include "ortho_grids.h"
+
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace PDEs::Grid
+{
+
+  namespace
+  {
+    /**
+     * Return every other vertex of \p vertices, always including the last.
+     */
+    std::vector<double>
+    coarsen_vertices(const std::vector<double>& vertices)
+    {
+      std::vector<double> coarse_vertices;
+      coarse_vertices.reserve(vertices.size() / 2 + 2);
+      for (size_t i = 0; i < vertices.size(); i += 2)
+        coarse_vertices.push_back(vertices[i]);
+      if ((vertices.size() - 1) % 2 == 1)
+        coarse_vertices.push_back(vertices.back());
+      return coarse_vertices;
+    }
+  }
+
+
+  std::shared_ptr<Mesh>
+  coarsen_orthomesh(const Mesh& mesh,
+                    std::vector<size_t>& parent_ids,
+                    const bool verbose)
+  {
+    if (mesh.ijk_mapping.size() != mesh.cells.size())
+      throw std::runtime_error(
+          "Only orthogonal meshes with an ijk mapping can be coarsened.");
+
+    const size_t n_cells = mesh.cells.size();
+    parent_ids.resize(n_cells);
+
+    if (mesh.dimension == 1)
+    {
+      // the cells are ordered along the axis
+      std::vector<double> vertices(n_cells + 1);
+      for (const auto& cell: mesh.cells)
+      {
+        const size_t i = mesh.ijk_mapping[cell.id][0];
+        vertices[i] = mesh.vertices[cell.vertex_ids[0]].z();
+        vertices[i + 1] = mesh.vertices[cell.vertex_ids[1]].z();
+      }
+
+      for (const auto& cell: mesh.cells)
+        parent_ids[cell.id] = mesh.ijk_mapping[cell.id][0] / 2;
+
+      return create_1d_orthomesh(coarsen_vertices(vertices),
+                                 mesh.coordinate_system, verbose);
+    }
+
+    else if (mesh.dimension == 2)
+    {
+      // count the cells along each axis
+      size_t n_x = 0, n_y = 0;
+      for (const auto& ijk: mesh.ijk_mapping)
+      {
+        n_x = std::max(n_x, ijk[0] + 1);
+        n_y = std::max(n_y, ijk[1] + 1);
+      }
+      assert(n_x * n_y == n_cells);
+
+      // vertices are numbered from lower-left, counter-clockwise
+      std::vector<double> x_vertices(n_x + 1), y_vertices(n_y + 1);
+      for (const auto& cell: mesh.cells)
+      {
+        const auto& ijk = mesh.ijk_mapping[cell.id];
+        const auto& lower_left = mesh.vertices[cell.vertex_ids[0]];
+        const auto& upper_right = mesh.vertices[cell.vertex_ids[2]];
+
+        x_vertices[ijk[0]] = lower_left.x();
+        x_vertices[ijk[0] + 1] = upper_right.x();
+        y_vertices[ijk[1]] = lower_left.y();
+        y_vertices[ijk[1] + 1] = upper_right.y();
+      }
+
+      // coarse cells are numbered along rows, then columns
+      const size_t n_coarse_x = (n_x + 1) / 2;
+      for (const auto& cell: mesh.cells)
+      {
+        const auto& ijk = mesh.ijk_mapping[cell.id];
+        parent_ids[cell.id] = (ijk[1] / 2) * n_coarse_x + ijk[0] / 2;
+      }
+
+      return create_2d_orthomesh(coarsen_vertices(x_vertices),
+                                 coarsen_vertices(y_vertices), verbose);
+    }
+
+    else
+      throw std::runtime_error(
+          "Only 1D and 2D orthogonal meshes can be coarsened.");
+  }
+
+}
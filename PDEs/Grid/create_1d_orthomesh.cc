@@ -169,7 +169,7 @@ namespace PDEs::Grid
         right_face.normal = Normal(0.0, 0.0, 1.0);
         cell.faces.push_back(right_face);
 
-        mesh->ijk_mapping.push_back({c});
+        mesh->ijk_mapping.push_back({count});
         mesh->cells.emplace_back(cell);
         ++count;
       }//for cell
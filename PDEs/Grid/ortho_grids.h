@@ -62,6 +62,27 @@ namespace PDEs
     create_2d_orthomesh(const std::vector<double>& x_vertices,
                         const std::vector<double>& y_vertices,
                         const bool verbose = false);
+
+
+    /**
+     * Create the next coarser mesh of an orthogonal mesh created by \ref
+     * create_1d_orthomesh or \ref create_2d_orthomesh.
+     *
+     * The coarse mesh is obtained by agglomerating pairs of cells along each
+     * axis, i.e. 2 cells in 1D and 2x2 cells in 2D, using the \p ijk_mapping
+     * of \p mesh. When an axis has an odd number of cells, the last coarse
+     * cell along it contains a single cell. The coarse cells are defined by
+     * every other vertex of the fine mesh, so the geometry is preserved
+     * exactly. Material IDs are not set on the coarse mesh.
+     *
+     * \param mesh The orthogonal mesh to coarsen.
+     * \param parent_ids The coarse cell ID of each cell of \p mesh.
+     * \param verbose A flag for verbose screen output.
+     */
+    std::shared_ptr<Mesh>
+    coarsen_orthomesh(const Mesh& mesh,
+                      std::vector<size_t>& parent_ids,
+                      const bool verbose = false);
   }
 }
 #endif //GRID_STRUCTS_H
@@ -1,5 +1,7 @@
 #include "fv.h"
 
+#include "sparsity_pattern.h"
+
 
 using namespace PDEs;
 using namespace Math;
@@ -51,12 +53,13 @@ FiniteVolume::nodes(const Grid::Cell& cell) const
 
 void
 FiniteVolume::
-make_sparsity_pattern(std::vector<std::vector<size_t>> pattern,
+make_sparsity_pattern(SparsityPattern& pattern,
                       const unsigned int n_components,
                       const bool is_coupled) const
 {
-  // Resive based on the number of DoFs
-  pattern.resize(n_dofs(n_components));
+  // Size based on the number of DoFs
+  const size_t n = n_dofs(n_components);
+  pattern.reinit(n, n);
 
   // Loop over cells
   for (const auto& cell: mesh->cells)
@@ -67,9 +70,9 @@ make_sparsity_pattern(std::vector<std::vector<size_t>> pattern,
     {
       if (is_coupled)
         for (unsigned int cp = 0; cp < n_components; ++cp)
-          pattern[ir + c].emplace_back(ir + cp);
+          pattern.add(ir + c, ir + cp);
       else
-        pattern[ir + c].emplace_back(ir + c);
+        pattern.add(ir + c, ir + c);
 
     }
 
@@ -80,8 +83,9 @@ make_sparsity_pattern(std::vector<std::vector<size_t>> pattern,
       {
         const size_t jr = face.neighbor_id * n_components;
         for (unsigned int c = 0; c < n_components; ++c)
-          pattern[ir + c].emplace_back(jr + c);
+          pattern.add(ir + c, jr + c);
       }
     }//for face
   }//for cells
+  pattern.compress();
 }
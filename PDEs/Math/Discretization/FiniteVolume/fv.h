@@ -40,7 +40,7 @@ namespace PDEs
       nodes(const Grid::Cell& cell) const override;
 
       void
-      make_sparsity_pattern(std::vector<std::vector<size_t>> pattern,
+      make_sparsity_pattern(SparsityPattern& pattern,
                             const unsigned int n_components = 1,
                             const bool is_coupled = false) const override;
     };
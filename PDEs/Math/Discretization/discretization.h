@@ -10,6 +10,9 @@ namespace PDEs
 {
   namespace Math
   {
+    //forward declarations
+    class SparsityPattern;
+
 
     /**
      * Available spatial discretization methods.
@@ -76,10 +79,10 @@ namespace PDEs
        * components. If the \p is_coupled flag is set to \p true, it is assumed
        * that all components are coupled to one another, otherwise, it is
        * assumed that the system is uncoupled in all components. The resulting
-       * sparsity pattern is written into \p pattern.
+       * sparsity pattern is written into \p pattern in compressed form.
        */
       virtual void
-      make_sparsity_pattern(std::vector<std::vector<size_t>> pattern,
+      make_sparsity_pattern(SparsityPattern& pattern,
                             const unsigned int n_components = 1,
                             const bool is_coupled = false) const = 0;
 
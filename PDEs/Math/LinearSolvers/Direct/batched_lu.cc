@@ -0,0 +1,336 @@
+#include "batched_lu.h"
+
+#include "matrix.h"
+#include "vector_pool.h"
+#include "multithreading.h"
+#include "Math/sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+namespace
+{
+  constexpr size_t invalid = static_cast<size_t>(-1);
+
+  /**
+   * The number of blocks processed together. A chunk of the largest blocks
+   * fits in the L2 cache.
+   */
+  constexpr size_t chunk_size = 256;
+
+  /** The largest supported block size. */
+  constexpr size_t max_block_size = 64;
+}
+
+
+BatchedLU::BatchedLU(const bool pivot) :
+    pivot_flag(pivot)
+{}
+
+
+void
+BatchedLU::reinit(const size_t n_blocks, const size_t block_size)
+{
+  if (block_size > max_block_size)
+    throw std::runtime_error(
+        "BatchedLU: Blocks larger than " + std::to_string(max_block_size) +
+        " are not supported.");
+
+  batch_size = n_blocks;
+  this->block_size = block_size;
+  values.assign(n_blocks * block_size * block_size, 0.0);
+  pivots.assign(n_blocks * block_size, 0.0);
+  factorized = false;
+}
+
+
+size_t
+BatchedLU::n_blocks() const
+{
+  return batch_size;
+}
+
+
+size_t
+BatchedLU::get_block_size() const
+{
+  return block_size;
+}
+
+
+double&
+BatchedLU::operator()(const size_t b, const size_t i, const size_t j)
+{
+  assert(b < batch_size && i < block_size && j < block_size);
+  return values[(i * block_size + j) * batch_size + b];
+}
+
+
+double
+BatchedLU::operator()(const size_t b, const size_t i, const size_t j) const
+{
+  assert(b < batch_size && i < block_size && j < block_size);
+  return values[(i * block_size + j) * batch_size + b];
+}
+
+
+void
+BatchedLU::set_block(const size_t b, const Matrix& matrix)
+{
+  assert(matrix.n_rows() == block_size && matrix.n_cols() == block_size);
+  for (size_t i = 0; i < block_size; ++i)
+    for (size_t j = 0; j < block_size; ++j)
+      (*this)(b, i, j) = matrix(i, j);
+  factorized = false;
+}
+
+
+void
+BatchedLU::set_matrix(const SparseMatrix& matrix, const size_t block_size)
+{
+  assert(block_size > 0);
+  assert(matrix.n_rows() == matrix.n_cols());
+  assert(matrix.n_rows() % block_size == 0);
+
+  reinit(matrix.n_rows() / block_size, block_size);
+  for (size_t row = 0; row < matrix.n_rows(); ++row)
+  {
+    if (matrix.row_length(row) == 0)
+      continue;
+
+    const size_t b = row / block_size;
+    for (const auto el: matrix.row_iterator(row))
+      if (el.column / block_size == b)
+        (*this)(b, row % block_size, el.column % block_size) = el.value;
+  }
+  factorize();
+}
+
+
+void
+BatchedLU::factorize()
+{
+  const size_t G = block_size;
+  const size_t N = batch_size;
+  const long n_chunks = static_cast<long>((N + chunk_size - 1) / chunk_size);
+  const int n_threads = MultiThreading::n_threads(values.size());
+
+  size_t first_singular = invalid;
+  #pragma omp parallel for num_threads(n_threads) schedule(static) \
+          reduction(min: first_singular)
+  for (long c = 0; c < n_chunks; ++c)
+  {
+    const size_t b0 = c * chunk_size;
+    const size_t nb = std::min(chunk_size, N - b0);
+    const auto entry = [&](const size_t i, const size_t j)
+    { return values.data() + (i * G + j) * N + b0; };
+
+    double max[chunk_size];
+    for (size_t k = 0; k < G; ++k)
+    {
+      double* piv = pivots.data() + k * N + b0;
+      double* a_kk = entry(k, k);
+
+      // Find the pivot row of each block and interchange the rows
+      #pragma omp simd
+      for (size_t b = 0; b < nb; ++b)
+      {
+        piv[b] = static_cast<double>(k);
+        max[b] = std::fabs(a_kk[b]);
+      }
+
+      if (pivot_flag)
+      {
+        for (size_t r = k + 1; r < G; ++r)
+        {
+          const double* a_rk = entry(r, k);
+          const double row = static_cast<double>(r);
+
+          #pragma omp simd
+          for (size_t b = 0; b < nb; ++b)
+          {
+            const double v = std::fabs(a_rk[b]), m = max[b], p = piv[b];
+            const bool larger = v > m;
+            const double m_new = larger ? v : m, p_new = larger ? row : p;
+            max[b] = m_new;
+            piv[b] = p_new;
+          }
+        }
+
+        // Interchange the remaining parts of the rows. The computed columns
+        // of L are not interchanged, so the interchanges are applied during
+        // the forward solve.
+        bool used[max_block_size] = {};
+        for (size_t b = 0; b < nb; ++b)
+          used[static_cast<size_t>(piv[b])] = true;
+
+        for (size_t r = k + 1; r < G; ++r)
+        {
+          if (!used[r])
+            continue;
+
+          const double row = static_cast<double>(r);
+          for (size_t j = k; j < G; ++j)
+          {
+            double* a_kj = entry(k, j);
+            double* a_rj = entry(r, j);
+
+            #pragma omp simd
+            for (size_t b = 0; b < nb; ++b)
+            {
+              const bool swap = piv[b] == row;
+              const double u = a_kj[b], v = a_rj[b];
+              const double u_new = swap ? v : u, v_new = swap ? u : v;
+              a_kj[b] = u_new;
+              a_rj[b] = v_new;
+            }
+          }
+        }
+      }
+
+      for (size_t b = 0; b < nb; ++b)
+        if (a_kk[b] == 0.0)
+        {
+          first_singular = std::min(first_singular, b0 + b);
+          break;
+        }
+
+      // Compute the lower triangular components and update the remaining
+      // rows of each block
+      for (size_t i = k + 1; i < G; ++i)
+      {
+        double* a_ik = entry(i, k);
+
+        #pragma omp simd
+        for (size_t b = 0; b < nb; ++b)
+          a_ik[b] /= a_kk[b];
+
+        for (size_t j = k + 1; j < G; ++j)
+        {
+          double* a_ij = entry(i, j);
+          const double* a_kj = entry(k, j);
+
+          #pragma omp simd
+          for (size_t b = 0; b < nb; ++b)
+            a_ij[b] -= a_ik[b] * a_kj[b];
+        }
+      }
+    }
+  }
+
+  if (first_singular != invalid)
+    throw std::runtime_error(
+        "BatchedLU: Block " + std::to_string(first_singular) +
+        " is singular.");
+  factorized = true;
+}
+
+
+void
+BatchedLU::solve(Vector& x, const Vector& b) const
+{
+  const size_t G = block_size;
+  const size_t N = batch_size;
+  assert(factorized);
+  assert(b.size() == N * G);
+  assert(x.size() == N * G);
+
+  ScratchVector y_work(N * G);
+  double* y_ptr = y_work->data();
+  const double* b_ptr = b.data();
+  double* x_ptr = x.data();
+
+  const long n_chunks = static_cast<long>((N + chunk_size - 1) / chunk_size);
+  const int n_threads = MultiThreading::n_threads(values.size());
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static)
+  for (long c = 0; c < n_chunks; ++c)
+  {
+    const size_t b0 = c * chunk_size;
+    const size_t nb = std::min(chunk_size, N - b0);
+    const auto entry = [&](const size_t i, const size_t j)
+    { return values.data() + (i * G + j) * N + b0; };
+    const auto unknown = [&](const size_t i) { return y_ptr + i * N + b0; };
+
+    // Gather the right-hand side into the structure-of-arrays layout
+    for (size_t i = 0; i < G; ++i)
+    {
+      double* y_i = unknown(i);
+      for (size_t b = 0; b < nb; ++b)
+        y_i[b] = b_ptr[(b0 + b) * G + i];
+    }
+
+    // Forward solve, applying the row interchanges of each step
+    for (size_t k = 0; k < G; ++k)
+    {
+      double* y_k = unknown(k);
+      if (pivot_flag)
+      {
+        const double* piv = pivots.data() + k * N + b0;
+        for (size_t r = k + 1; r < G; ++r)
+        {
+          double* y_r = unknown(r);
+          const double row = static_cast<double>(r);
+
+          #pragma omp simd
+          for (size_t b = 0; b < nb; ++b)
+          {
+            const bool swap = piv[b] == row;
+            const double u = y_k[b], v = y_r[b];
+            const double u_new = swap ? v : u, v_new = swap ? u : v;
+            y_k[b] = u_new;
+            y_r[b] = v_new;
+          }
+        }
+      }
+
+      for (size_t i = k + 1; i < G; ++i)
+      {
+        const double* a_ik = entry(i, k);
+        double* y_i = unknown(i);
+
+        #pragma omp simd
+        for (size_t b = 0; b < nb; ++b)
+          y_i[b] -= a_ik[b] * y_k[b];
+      }
+    }
+
+    // Backward solve
+    for (size_t i = G - 1; i != -1; --i)
+    {
+      double* y_i = unknown(i);
+      for (size_t k = i + 1; k < G; ++k)
+      {
+        const double* a_ik = entry(i, k);
+        const double* y_k = unknown(k);
+
+        #pragma omp simd
+        for (size_t b = 0; b < nb; ++b)
+          y_i[b] -= a_ik[b] * y_k[b];
+      }
+
+      const double* a_ii = entry(i, i);
+
+      #pragma omp simd
+      for (size_t b = 0; b < nb; ++b)
+        y_i[b] /= a_ii[b];
+    }
+
+    // Scatter the solution back to the cell-wise ordering
+    for (size_t i = 0; i < G; ++i)
+    {
+      const double* y_i = unknown(i);
+      for (size_t b = 0; b < nb; ++b)
+        x_ptr[(b0 + b) * G + i] = y_i[b];
+    }
+  }
+}
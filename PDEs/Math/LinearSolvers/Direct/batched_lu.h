@@ -0,0 +1,114 @@
+#ifndef BATCHED_LU_H
+#define BATCHED_LU_H
+
+#include "vector.h"
+
+#include <vector>
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class Matrix;
+    class SparseMatrix;
+
+
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of a batched LU solver for many small dense blocks of
+       * the same size, such as the \f$ G \times G \f$ group blocks of each
+       * cell of a multigroup problem.
+       *
+       * The blocks are stored in a structure-of-arrays layout where entry
+       * \f$ (i, j) \f$ of every block is contiguous, i.e. entry \f$ (i, j) \f$
+       * of block \p b is located at <tt>(i * block_size + j) * n_blocks() +
+       * b</tt>. The factorization and the triangular solves then operate on
+       * whole rows of this layout at a time, vectorizing across the batch
+       * rather than within a block, which is too small to vectorize. The
+       * batch is additionally split into chunks which are processed in
+       * parallel.
+       *
+       * Partial pivoting is supported. Each block chooses its own pivots and
+       * the row interchanges are applied with per-block selects so that the
+       * batch remains in lockstep.
+       *
+       * Vectors passed to \ref solve use the cell-wise ordering of the
+       * multigroup unknowns, where unknown \p i of block \p b has index
+       * <tt>b * block_size + i</tt>.
+       */
+      class BatchedLU
+      {
+      private:
+        bool pivot_flag;
+
+        size_t batch_size = 0;
+        size_t block_size = 0;
+
+        /** The entries of all blocks in the structure-of-arrays layout. */
+        Vector::storage_type values;
+
+        /**
+         * The row interchanged with row \p k of each block at step \p k,
+         * stored at <tt>k * n_blocks() + b</tt>. The row indices are stored
+         * as floating point values so that the comparisons in the per-block
+         * selects have the same width as the entries and vectorize.
+         */
+        Vector::storage_type pivots;
+
+        bool factorized = false;
+
+      public:
+        /**
+         * Default constructor. Construct a batched LU solver, optionally with
+         * row pivoting.
+         */
+        BatchedLU(const bool pivot = true);
+
+        /**
+         * Allocate \p n_blocks blocks of size \p block_size and set their
+         * entries to zero.
+         */
+        void reinit(const size_t n_blocks, const size_t block_size);
+
+        /** Return the number of blocks. */
+        size_t n_blocks() const;
+
+        /** Return the size of each block. */
+        size_t get_block_size() const;
+
+        /** Read and write access to entry \f$ (i, j) \f$ of block \p b. */
+        double& operator()(const size_t b, const size_t i, const size_t j);
+
+        /** Read access to entry \f$ (i, j) \f$ of block \p b. */
+        double operator()(const size_t b, const size_t i, const size_t j) const;
+
+        /** Copy the dense \p matrix into block \p b. */
+        void set_block(const size_t b, const Matrix& matrix);
+
+        /**
+         * Extract the diagonal blocks of size \p block_size of \p matrix and
+         * factorize them. The number of rows of \p matrix must be a multiple
+         * of \p block_size.
+         */
+        void set_matrix(const SparseMatrix& matrix, const size_t block_size);
+
+        /**
+         * Factorize all blocks in place. An error is thrown if any block is
+         * singular.
+         */
+        void factorize();
+
+        /**
+         * Solve each block system with the corresponding entries of \p b.
+         * It is acceptable for \p x and \p b to be the same vector.
+         */
+        void solve(Vector& x, const Vector& b) const;
+      };
+    }
+  }
+}
+#endif //BATCHED_LU_H
@@ -0,0 +1,298 @@
+#include "block_tridiagonal.h"
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+namespace
+{
+  /**
+   * Compute the LU decomposition with partial pivoting of the row-major
+   * \p n by \p n matrix \p a in place. Return false if the matrix is
+   * singular.
+   */
+  bool
+  lu_factor(double* a, unsigned int* pivots, const size_t n)
+  {
+    for (size_t k = 0; k < n; ++k)
+    {
+      size_t p = k;
+      for (size_t i = k + 1; i < n; ++i)
+        if (std::fabs(a[i * n + k]) > std::fabs(a[p * n + k]))
+          p = i;
+      if (a[p * n + k] == 0.0)
+        return false;
+
+      pivots[k] = p;
+      if (p != k)
+        std::swap_ranges(a + k * n, a + (k + 1) * n, a + p * n);
+
+      const double* a_k = a + k * n;
+      for (size_t i = k + 1; i < n; ++i)
+      {
+        double* a_i = a + i * n;
+        const double factor = (a_i[k] /= a_k[k]);
+        for (size_t j = k + 1; j < n; ++j)
+          a_i[j] -= factor * a_k[j];
+      }
+    }
+    return true;
+  }
+
+
+  /**
+   * Overwrite the row-major \p n by \p m right-hand side \p x with the
+   * solution of the system whose LU decomposition is \p lu.
+   */
+  void
+  lu_solve(const double* lu,
+           const unsigned int* pivots,
+           double* x,
+           const size_t n,
+           const size_t m)
+  {
+    for (size_t k = 0; k < n; ++k)
+      if (pivots[k] != k)
+        std::swap_ranges(x + k * m, x + (k + 1) * m, x + pivots[k] * m);
+
+    for (size_t i = 1; i < n; ++i)
+    {
+      double* x_i = x + i * m;
+      for (size_t k = 0; k < i; ++k)
+      {
+        const double l_ik = lu[i * n + k];
+        const double* x_k = x + k * m;
+        for (size_t j = 0; j < m; ++j)
+          x_i[j] -= l_ik * x_k[j];
+      }
+    }
+
+    for (size_t i = n - 1; i != -1; --i)
+    {
+      double* x_i = x + i * m;
+      for (size_t k = i + 1; k < n; ++k)
+      {
+        const double u_ik = lu[i * n + k];
+        const double* x_k = x + k * m;
+        for (size_t j = 0; j < m; ++j)
+          x_i[j] -= u_ik * x_k[j];
+      }
+
+      const double u_ii = lu[i * n + i];
+      for (size_t j = 0; j < m; ++j)
+        x_i[j] /= u_ii;
+    }
+  }
+}
+
+
+BlockTridiagonalSolver::BlockTridiagonalSolver(const size_t block_size) :
+    DirectSolverBase<SparseMatrix>(), specified_block_size(block_size)
+{}
+
+
+std::shared_ptr<LinearSolverBase<SparseMatrix>>
+BlockTridiagonalSolver::clone() const
+{
+  return std::make_shared<BlockTridiagonalSolver>(specified_block_size);
+}
+
+
+void
+BlockTridiagonalSolver::set_matrix(const SparseMatrix& matrix)
+{
+  LinearSolverBase<SparseMatrix>::set_matrix(matrix);
+  factorized = false;
+
+  // Reuse the previous block size when it is still valid
+  const size_t n = matrix.n_rows();
+  if (specified_block_size > 0)
+    block_size = specified_block_size;
+  bool valid = block_size > 0 && is_block_tridiagonal(matrix, block_size);
+  if (!valid && specified_block_size == 0)
+  {
+    block_size = detect_block_size(matrix);
+    valid = true;
+  }
+
+  if (!valid)
+    throw std::runtime_error(
+        "BlockTridiagonalSolver: The matrix is not block tridiagonal "
+        "with block size " + std::to_string(block_size) + ".");
+
+  // Extract the blocks
+  const size_t bs = block_size;
+  n_blocks = n / bs;
+  blocks.assign(3 * n_blocks * bs * bs, 0.0);
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (matrix.row_length(i) == 0)
+      continue;
+
+    const size_t I = i / bs;
+    double* row_blocks = blocks.data() + 3 * I * bs * bs;
+    for (const auto el: matrix.row_iterator(i))
+    {
+      const size_t J = el.column / bs;
+      row_blocks[(J + 1 - I) * bs * bs +
+                 (i % bs) * bs + el.column % bs] = el.value;
+    }
+  }
+  factorize();
+}
+
+
+void
+BlockTridiagonalSolver::factorize()
+{
+  if (factorized) return;
+
+  const size_t bs = block_size;
+  const size_t bs2 = bs * bs;
+  pivots.resize(n_blocks * bs);
+  for (size_t I = 0; I < n_blocks; ++I)
+  {
+    const double* l = blocks.data() + 3 * I * bs2;
+    double* d = blocks.data() + 3 * I * bs2 + bs2;
+    unsigned int* p = pivots.data() + I * bs;
+
+    // Apply the Schur complement update D_I -= L_I W_{I-1}
+    if (I > 0)
+    {
+      const double* w = blocks.data() + 3 * (I - 1) * bs2 + 2 * bs2;
+      for (size_t i = 0; i < bs; ++i)
+        for (size_t k = 0; k < bs; ++k)
+        {
+          const double l_ik = l[i * bs + k];
+          for (size_t j = 0; j < bs; ++j)
+            d[i * bs + j] -= l_ik * w[k * bs + j];
+        }
+    }
+
+    if (!lu_factor(d, p, bs))
+      throw std::runtime_error(
+          "BlockTridiagonalSolver: Singular diagonal block encountered "
+          "in block row " + std::to_string(I) + ".");
+
+    // Compute W_I = D_I^{-1} U_I in place of U_I
+    if (I + 1 < n_blocks)
+      lu_solve(d, p, d + bs2, bs, bs);
+  }
+  factorized = true;
+}
+
+
+void
+BlockTridiagonalSolver::solve(Vector& x, const Vector& b) const
+{
+  const size_t bs = block_size;
+  const size_t bs2 = bs * bs;
+  assert(factorized);
+  assert(b.size() == n_blocks * bs);
+  assert(x.size() == n_blocks * bs);
+
+  // Forward sweep
+  for (size_t I = 0; I < n_blocks; ++I)
+  {
+    const double* l = blocks.data() + 3 * I * bs2;
+    double* x_I = x.data() + I * bs;
+    for (size_t i = 0; i < bs; ++i)
+      x_I[i] = b[I * bs + i];
+
+    if (I > 0)
+    {
+      const double* x_prev = x_I - bs;
+      for (size_t i = 0; i < bs; ++i)
+        for (size_t k = 0; k < bs; ++k)
+          x_I[i] -= l[i * bs + k] * x_prev[k];
+    }
+    lu_solve(l + bs2, pivots.data() + I * bs, x_I, bs, 1);
+  }
+
+  // Backward sweep
+  for (size_t I = n_blocks; I-- > 1;)
+  {
+    const double* w = blocks.data() + 3 * (I - 1) * bs2 + 2 * bs2;
+    double* x_prev = x.data() + (I - 1) * bs;
+    const double* x_I = x_prev + bs;
+    for (size_t i = 0; i < bs; ++i)
+      for (size_t k = 0; k < bs; ++k)
+        x_prev[i] -= w[i * bs + k] * x_I[k];
+  }
+}
+
+
+size_t
+BlockTridiagonalSolver::get_block_size() const
+{
+  return block_size;
+}
+
+
+size_t
+BlockTridiagonalSolver::detect_block_size(const SparseMatrix& matrix)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+
+  // An entry at distance k from the diagonal requires 2 bs - 1 >= k
+  const size_t n = matrix.n_rows();
+  size_t bandwidth = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (matrix.row_length(i) == 0)
+      continue;
+
+    for (const auto el: matrix.row_iterator(i))
+      bandwidth = std::max(bandwidth, i > el.column ? i - el.column
+                                                    : el.column - i);
+  }
+
+  // Any matrix is block tridiagonal with one or two blocks, which would
+  // silently turn this into a dense LU, so at least three blocks are
+  // required. Matrices with fewer than three rows are tridiagonal.
+  if (n < 3)
+    return 1;
+  for (size_t bs = std::max<size_t>(bandwidth / 2 + 1, 1); bs <= n / 3; ++bs)
+    if (n % bs == 0 && is_block_tridiagonal(matrix, bs))
+      return bs;
+
+  throw std::runtime_error(
+      "BlockTridiagonalSolver: The matrix is not block tridiagonal with "
+      "at least three blocks. Use a general sparse solver.");
+}
+
+
+bool
+BlockTridiagonalSolver::is_block_tridiagonal(const SparseMatrix& matrix,
+                                             const size_t block_size)
+{
+  if (block_size == 0 || matrix.n_rows() != matrix.n_cols() ||
+      matrix.n_rows() % block_size != 0)
+    return false;
+
+  for (size_t i = 0; i < matrix.n_rows(); ++i)
+  {
+    if (matrix.row_length(i) == 0)
+      continue;
+
+    const size_t I = i / block_size;
+    for (const auto el: matrix.row_iterator(i))
+    {
+      const size_t J = el.column / block_size;
+      if (J + 1 < I || J > I + 1)
+        return false;
+    }
+  }
+  return true;
+}
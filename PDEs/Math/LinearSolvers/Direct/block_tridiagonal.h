@@ -0,0 +1,117 @@
+#ifndef BLOCK_TRIDIAGONAL_H
+#define BLOCK_TRIDIAGONAL_H
+
+#include "Math/LinearSolvers/linear_solver.h"
+
+#include "Math/sparse_matrix.h"
+
+#include <vector>
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+
+      /**
+       * Implementation of a block tridiagonal (block Thomas) direct solver.
+       *
+       * Multigroup diffusion matrices on one-dimensional meshes, such as
+       * those created by \p create_1d_orthomesh, couple each cell only to
+       * itself and its two neighbors. With the unknowns numbered cell by
+       * cell, the matrix is block tridiagonal with \f$ G \times G \f$ blocks
+       * \f$ L_i \f$, \f$ D_i \f$, and \f$ U_i \f$. The factorization
+       * \f[
+       *    D_0' = D_0, \quad
+       *    W_i = D_i'^{-1} U_i, \quad
+       *    D_{i+1}' = D_{i+1} - L_{i+1} W_i,
+       * \f]
+       * stores the LU decomposition with partial pivoting of each \f$ D_i' \f$
+       * and requires \f$ \mathcal{O}(N G^3) \f$ operations. The system is then
+       * solved with the block forward and backward sweeps
+       * \f[
+       *    y_i = D_i'^{-1} (b_i - L_i y_{i-1}), \quad
+       *    x_i = y_i - W_i x_{i+1}.
+       * \f]
+       *
+       * The blocks of each block row are stored contiguously. Unlike the
+       * other direct solvers, the sparse matrix itself is not copied.
+       *
+       * The block size can be specified or is otherwise detected from the
+       * matrix as the smallest divisor of the number of rows for which the
+       * matrix is block tridiagonal. An error is thrown if the matrix is not
+       * block tridiagonal with the given block size, or, when detecting, with
+       * at least three blocks.
+       */
+      class BlockTridiagonalSolver : public DirectSolverBase<SparseMatrix>
+      {
+      private:
+        /**
+         * The specified block size, or zero if the block size is detected
+         * from the matrix.
+         */
+        size_t specified_block_size;
+
+        size_t block_size = 0;
+        size_t n_blocks = 0;
+
+        /**
+         * The blocks of each block row, stored contiguously in the order
+         * \f$ L_i \f$, \f$ D_i \f$, \f$ U_i \f$. Each block is row-major. After
+         * factorization, \f$ D_i \f$ and \f$ U_i \f$ are overwritten by the LU
+         * decomposition of \f$ D_i' \f$ and by \f$ W_i \f$.
+         */
+        std::vector<double> blocks;
+
+        /** The row pivots of the LU decomposition of each \f$ D_i' \f$. */
+        std::vector<unsigned int> pivots;
+
+      public:
+        /**
+         * Default constructor. Construct a block tridiagonal solver with the
+         * specified \p block_size, which is typically the number of groups.
+         * A value of zero detects the block size from the matrix.
+         */
+        BlockTridiagonalSolver(const size_t block_size = 0);
+
+        /** Return a new block tridiagonal solver with the same block size. */
+        std::shared_ptr<LinearSolverBase<SparseMatrix>> clone() const override;
+
+        /**
+         * Attach a matrix to the solver. The blocks are extracted directly
+         * from \p matrix and factorized.
+         */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /** Perform the block LU factorization of the extracted blocks. */
+        void factorize() override;
+
+        /** Solve the factored linear system with the block sweeps. */
+        void solve(Vector& x, const Vector& b) const override;
+
+        /** Return the block size used for the attached matrix. */
+        size_t get_block_size() const;
+
+        /**
+         * Return the smallest block size for which \p matrix is block
+         * tridiagonal with at least three blocks. An error is thrown if there
+         * is none, since fewer blocks amount to a dense factorization.
+         */
+        static size_t detect_block_size(const SparseMatrix& matrix);
+
+        /**
+         * Return whether \p matrix is block tridiagonal with the specified
+         * \p block_size.
+         */
+        static bool
+        is_block_tridiagonal(const SparseMatrix& matrix,
+                             const size_t block_size);
+      };
+
+    }
+  }
+}
+#endif //BLOCK_TRIDIAGONAL_H
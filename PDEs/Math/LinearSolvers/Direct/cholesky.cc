@@ -1,9 +1,13 @@
 #include "cholesky.h"
 
 #include "vector.h"
+#include "vector_pool.h"
 #include "matrix.h"
+#include "dense_kernels.h"
 
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 #include <cassert>
 
 
@@ -17,37 +21,94 @@ Cholesky::Cholesky() :
 {}
 
 
-SparseCholesky::SparseCholesky() :
-    DirectSolverBase<SparseMatrix>()
+SparseCholesky::SparseCholesky(const Ordering::Method ordering) :
+    DirectSolverBase<SparseMatrix>(), ordering(ordering)
 {}
 
 
+void
+SparseCholesky::set_permutation(const std::vector<size_t>& permutation)
+{
+  this->permutation = permutation;
+  fixed_permutation = !permutation.empty();
+  symbolic.reset();
+}
+
+
+void
+SparseCholesky::set_coordinates(const std::vector<Grid::Point>& points)
+{
+  this->points = points;
+  symbolic.reset();
+}
+
+
+std::shared_ptr<LinearSolverBase<Matrix>>
+Cholesky::clone() const
+{
+  return std::make_shared<Cholesky>();
+}
+
+
+std::shared_ptr<LinearSolverBase<SparseMatrix>>
+SparseCholesky::clone() const
+{
+  auto solver = std::make_shared<SparseCholesky>(ordering);
+  if (fixed_permutation)
+    solver->set_permutation(permutation);
+  solver->points = points;
+  solver->symbolic = symbolic;
+  return solver;
+}
+
+
 void
 Cholesky::factorize()
 {
   if (factorized) return;
 
-  // Compute the factorization column by column
-  size_t n = A.n_rows();
-  for (size_t j = 0; j < n; ++j)
-  {
-    double* a_j = A.data(j); // accessor for row j
+  const size_t n = A.n_rows();
+  const size_t lda = A.leading_dimension();
+  double* a = A.data();
 
-    // Compute the diagonal term
-    double sum = 0.0;
-    for (size_t k = 0; k < j; ++k)
-      sum += a_j[k] * a_j[k];
-    a_j[j] = std::sqrt(a_j[j] - sum);
+  // Apply the right-looking blocked algorithm. Each panel of columns is
+  // factored, then the lower triangle of the trailing matrix is updated
+  // block row by block row with matrix-matrix products.
+  for (size_t j0 = 0; j0 < n; j0 += DenseKernels::panel_width)
+  {
+    const size_t j1 = std::min(j0 + DenseKernels::panel_width, n);
 
-    // Compute the lower diagonal terms
-    for (size_t i = j + 1; i < n; ++i)
+    // Factor the panel column by column
+    for (size_t j = j0; j < j1; ++j)
     {
-      double* a_i = A.data(i); // accessor for row i
+      double* a_j = A.data(j); // accessor for row j
+
+      // Compute the diagonal term
+      double sum = 0.0;
+      for (size_t k = j0; k < j; ++k)
+        sum += a_j[k] * a_j[k];
+      a_j[j] = std::sqrt(a_j[j] - sum);
+
+      // Compute the lower diagonal terms
+      for (size_t i = j + 1; i < n; ++i)
+      {
+        double* a_i = A.data(i); // accessor for row i
+
+        sum = 0.0;
+        for (size_t k = j0; k < j; ++k)
+          sum += a_i[k] * a_j[k];
+        a_i[j] = (a_i[j] - sum) / a_j[j];
+      }
+    }
 
-      sum = 0.0;
-      for (size_t k = 0; k < j; ++k)
-        sum += a_i[k] * a_j[k];
-      a_i[j] = (a_i[j] - sum) / a_j[j];
+    // Update the trailing matrix with the panel times its transpose
+    for (size_t i0 = j1; i0 < n; i0 += DenseKernels::panel_width)
+    {
+      const size_t i1 = std::min(i0 + DenseKernels::panel_width, n);
+      DenseKernels::gemm(i1 - i0, i1 - j1, j1 - j0, -1.0,
+                         a + i0 * lda + j0, lda, 1,
+                         a + j1 * lda + j0, 1, lda,
+                         a + i0 * lda + j1, lda);
     }
   }
   factorized = true;
@@ -57,37 +118,63 @@ Cholesky::factorize()
 void
 SparseCholesky::factorize()
 {
-  size_t n = A.n_rows();
+  // The symbolic analysis is only redone when the pattern changes
+  if (!symbolic || !symbolic->matches(A))
+  {
+    if (!fixed_permutation)
+      permutation = Ordering::compute(ordering, A, points);
+    assert(permutation.size() == A.n_rows());
+
+    auto analysis = std::make_shared<SymbolicFactorization>();
+    analysis->analyze(A, permutation);
+    symbolic = analysis;
+  }
 
-  // Compute the factorization column by column
-  for (size_t j = 0; j < n; ++j)
+  const size_t n = symbolic->n_rows();
+  const size_t* row_offsets = symbolic->row_offsets_data();
+  const unsigned int* colnums = symbolic->colnums_data();
+  const size_t* diag = symbolic->diagonal_offsets_data();
+
+  symbolic->scatter(A, factor_values);
+  double* values = factor_values.data();
+
+  // Row-by-row (up-looking) algorithm. The lower part of row i is expanded
+  // into a dense work vector and each entry is computed from a sparse dot
+  // product with a finished row above it.
+  ScratchVector w_work(n, 0.0);
+  double* w = w_work->data();
+  for (size_t i = 0; i < n; ++i)
   {
-    // Accessor for the diagonal element
-    double& d = A.diag(j);
+    const size_t first = row_offsets[i];
+    for (size_t p = first; p < diag[i]; ++p)
+      w[colnums[p]] = values[p];
 
-    // Compute the new diagonal term
+    // Compute the lower-diagonal components, in increasing column order
     double sum = 0.0;
-    for (const auto el: A.row_iterator(j))
-      if (el.column < j)
-        sum += el.value * el.value;
-    d = std::sqrt(d - sum);
+    for (size_t p = first; p < diag[i]; ++p)
+    {
+      const unsigned int k = colnums[p];
+
+      double l_ik = w[k];
+      for (size_t q = row_offsets[k]; q < diag[k]; ++q)
+        l_ik -= values[q] * w[colnums[q]];
+      l_ik /= values[diag[k]];
 
-    // Set the lower-diagonal components
-    for (size_t i = j + 1; i < n; ++i)
+      w[k] = l_ik;
+      sum += l_ik * l_ik;
+    }
+
+    // Compute the diagonal term
+    const double d = values[diag[i]] - sum;
+    if (!(d > 0.0))
+      throw std::runtime_error(
+          "SparseCholesky: The matrix is not positive definite.");
+    values[diag[i]] = std::sqrt(d);
+
+    for (size_t p = first; p < diag[i]; ++p)
     {
-      // Go through row i and j, add to sum when columns are equal
-      sum = 0.0;
-      for (const auto a_ik: A.row_iterator(i))
-        if (a_ik.column < j)
-          for (const auto a_jk: A.row_iterator(j))
-            if (a_jk.column == a_ik.column)
-              sum += a_ik.value * a_jk.value;
-
-      // Set element i, j
-      double a_ij = A.el(i, j);
-      double value = (a_ij) ? (a_ij - sum) / d : -sum / d;
-      if (std::fabs(value) != 0.0)
-        A.set(i, j, value);
+      values[p] = w[colnums[p]];
+      w[colnums[p]] = 0.0;
     }
   }
   factorized = true;
@@ -132,28 +219,39 @@ Cholesky::solve(Vector& x, const Vector& b) const
 void
 SparseCholesky::solve(Vector& x, const Vector& b) const
 {
-  size_t n = A.n_rows();
+  const size_t n = symbolic->n_rows();
   assert(factorized);
   assert(b.size() == n);
   assert(x.size() == n);
 
+  const auto& permutation = symbolic->get_permutation();
+  const size_t* row_offsets = symbolic->row_offsets_data();
+  const unsigned int* colnums = symbolic->colnums_data();
+  const size_t* diag = symbolic->diagonal_offsets_data();
+  const double* values = factor_values.data();
+
+  // Work on the reordered system
+  ScratchVector y_work(n);
+  Vector& y = *y_work;
+
   // Forward solve
   for (size_t i = 0; i < n; ++i)
   {
-    double value = b[i];
-    for (const auto el: A.row_iterator(i))
-      if (el.column < i)
-        value -= el.value * x[el.column];
-    x[i] = value / A.diag(i);
+    double value = b[permutation[i]];
+    for (size_t p = row_offsets[i]; p < diag[i]; ++p)
+      value -= values[p] * y[colnums[p]];
+    y[i] = value / values[diag[i]];
   }
 
   // Backward solve
   for (size_t i = n - 1; i != -1; --i)
   {
-    x[i] /= A.diag(i);
-    for (const auto a_ij: A.row_iterator(i))
-      if (a_ij.column < i)
-        x[a_ij.column] -= a_ij.value * x[i];
+    const double y_i = (y[i] /= values[diag[i]]);
+    for (size_t p = row_offsets[i]; p < diag[i]; ++p)
+      y[colnums[p]] -= values[p] * y_i;
   }
-}
 
+  // Map back to the original ordering
+  for (size_t i = 0; i < n; ++i)
+    x[permutation[i]] = y[i];
+}
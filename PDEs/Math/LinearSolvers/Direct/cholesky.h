@@ -5,6 +5,8 @@
 
 #include "matrix.h"
 #include "Math/sparse_matrix.h"
+#include "Math/ordering.h"
+#include "symbolic_factorization.h"
 
 #include <vector>
 #include <cstddef>
@@ -38,6 +40,9 @@ namespace PDEs
         /**  Default constructor. */
         Cholesky();
 
+        /** Return a new Cholesky solver. */
+        std::shared_ptr<LinearSolverBase<Matrix>> clone() const override;
+
         /**
          * Perform a Cholesky factorization on the matrix \f$ A \f$.
          *
@@ -55,16 +60,68 @@ namespace PDEs
 
       /**
        * Implementation of a sparse Cholesky solver. For descriptions of the
-       * Cholesky decomposition solver see \erf Cholesky.
+       * Cholesky decomposition solver see \ref Cholesky.
+       *
+       * The matrix is symmetrically permuted with a fill-reducing ordering
+       * before factorization, and the symbolic analysis is reused for
+       * matrices with an unchanged pattern, as in \ref SparseLU. Only the
+       * lower triangular part of the symbolic pattern is used.
        */
       class SparseCholesky : public DirectSolverBase<SparseMatrix>
       {
+      private:
+        /** The method used to compute the fill-reducing ordering. */
+        Ordering::Method ordering;
+
+        /**
+         * The fill-reducing permutation. Entry \p k is the original index of
+         * row \p k of the factored matrix.
+         */
+        std::vector<size_t> permutation;
+
+        /**
+         * A flag for whether the permutation was provided by the user via
+         * \ref set_permutation rather than computed.
+         */
+        bool fixed_permutation = false;
+
+        /**
+         * The coordinates of the rows used by nested dissection. See
+         * \ref set_coordinates.
+         */
+        std::vector<Grid::Point> points;
+
+        /**
+         * The symbolic analysis of the attached matrix. This is shared with
+         * clones, which refactorize matrices with the same pattern.
+         */
+        std::shared_ptr<const SymbolicFactorization> symbolic;
+
+        /** The values of the factor, stored in the symbolic pattern. */
+        std::vector<double> factor_values;
+
       public:
-        SparseCholesky();
+        /**
+         * Default constructor. Construct a sparse Cholesky solver which
+         * reorders the matrix with the specified \p ordering.
+         */
+        SparseCholesky(const Ordering::Method ordering =
+                           Ordering::Method::MINIMUM_DEGREE);
+
+        /** See \ref SparseLU::set_permutation. */
+        void set_permutation(const std::vector<size_t>& permutation);
+
+        /** See \ref SparseLU::set_coordinates. */
+        void set_coordinates(const std::vector<Grid::Point>& points);
+
+        /** Return a new sparse Cholesky solver with the same ordering. */
+        std::shared_ptr<LinearSolverBase<SparseMatrix>> clone() const override;
 
         /**
-         * Perform a Cholesky factorization on the matrix \f$ A \f$.
-         * See \ref Cholesky::solve
+         * Perform a Cholesky factorization on the reordered matrix
+         * \f$ A \f$. The symbolic analysis is reused if the pattern of
+         * \f$ A \f$ is unchanged. An error is thrown if the matrix is not
+         * positive definite. See \ref Cholesky::factorize
          */
         void factorize() override;
 
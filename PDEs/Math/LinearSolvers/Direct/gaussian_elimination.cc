@@ -104,6 +104,9 @@ LinearSolvers::gaussian_elimination<SparseMatrix>(
   assert(b.size() == A.n_rows());
   size_t n = b.size();
 
+  // Fill entries are inserted, so work on the row-wise storage
+  A.decompress();
+
   //========================================
   // Row-echelon factorization
   //========================================
@@ -1,8 +1,11 @@
 #include "lu.h"
 
 #include "vector.h"
+#include "vector_pool.h"
 #include "matrix.h"
+#include "dense_kernels.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 
@@ -17,16 +20,33 @@ LU::LU(const bool pivot) :
 {}
 
 
-SparseLU::SparseLU(const bool pivot) :
-    pivot_flag(pivot)
+SparseLU::SparseLU(const bool pivot, const Ordering::Method ordering) :
+    pivot_flag(pivot), ordering(ordering)
 {}
 
 
+void
+SparseLU::set_permutation(const std::vector<size_t>& permutation)
+{
+  this->permutation = permutation;
+  fixed_permutation = !permutation.empty();
+  symbolic.reset();
+}
+
+
+void
+SparseLU::set_coordinates(const std::vector<Grid::Point>& points)
+{
+  this->points = points;
+  symbolic.reset();
+}
+
+
 void
 LU::set_matrix(const Matrix& matrix)
 {
-  DirectSolverBase<Matrix>::set_matrix(matrix);
   row_pivots.resize(matrix.n_rows());
+  DirectSolverBase<Matrix>::set_matrix(matrix);
 }
 
 
@@ -38,84 +58,220 @@ SparseLU::set_matrix(const SparseMatrix& matrix)
 }
 
 
+std::shared_ptr<LinearSolverBase<Matrix>>
+LU::clone() const
+{
+  return std::make_shared<LU>(pivot_flag);
+}
+
+
+std::shared_ptr<LinearSolverBase<SparseMatrix>>
+SparseLU::clone() const
+{
+  auto solver = std::make_shared<SparseLU>(pivot_flag, ordering);
+  if (fixed_permutation)
+    solver->set_permutation(permutation);
+  solver->points = points;
+  solver->symbolic = symbolic;
+  return solver;
+}
+
+
 void
 LU::factorize()
 {
-  size_t n = A.n_rows();
+  const size_t n = A.n_rows();
+  const size_t lda = A.leading_dimension();
+  double* a = A.data();
 
   // Initialize the pivot mappings such that each row maps to itself
   for (size_t i = 0; i < n; ++i)
     row_pivots[i] = i;
 
-  // Apply Doolittle algorithm
-  for (size_t j = 0; j < n; ++j)
+  // Apply the right-looking blocked Doolittle algorithm. Each panel of
+  // columns is factored, then the corresponding block row of U is computed
+  // and the trailing matrix is updated with a single matrix-matrix product.
+  for (size_t j0 = 0; j0 < n; j0 += DenseKernels::panel_width)
   {
-    // Find the row containing the largest magnitude entry for column j.
-    // This is only done for the sub-diagonal elements.
-    if (pivot_flag)
+    const size_t j1 = std::min(j0 + DenseKernels::panel_width, n);
+
+    // Factor the panel
+    for (size_t j = j0; j < j1; ++j)
     {
-      size_t argmax = j;
-      double max = std::fabs(A(j, j));
-      for (size_t k = j + 1; k < n; ++k)
+      // Find the row containing the largest magnitude entry for column j.
+      // This is only done for the sub-diagonal elements.
+      if (pivot_flag)
       {
-        const double a_kj = A(k, j);
-        if (std::fabs(a_kj) > max)
+        size_t argmax = j;
+        double max = std::fabs(A(j, j));
+        for (size_t k = j + 1; k < n; ++k)
         {
-          argmax = k;
-          max = std::fabs(a_kj);
+          const double a_kj = A(k, j);
+          if (std::fabs(a_kj) > max)
+          {
+            argmax = k;
+            max = std::fabs(a_kj);
+          }
         }
-      }
 
-      // If the sub-diagonal is uniformly zero, throw error
-      assert(max != 0.0);
+        // If the sub-diagonal is uniformly zero, throw error
+        assert(max != 0.0);
 
-      // Swap the current row and the row containing the largest magnitude
-      // entry corresponding for the current column. This is done to improve
-      // the numerical stability of the algorithm.
-      if (argmax != j)
+        // Swap the current row and the row containing the largest magnitude
+        // entry corresponding for the current column. This is done to improve
+        // the numerical stability of the algorithm.
+        if (argmax != j)
+        {
+          std::swap(row_pivots[j], row_pivots[argmax]);
+          A.swap_row(j, argmax);
+        }
+      }//if pivoting
+
+      const double* a_j = A.data(j); // accessor for row j
+      const double a_jj = a_j[j]; // diagonal element for row j
+
+      // Compute the lower triangular components and update the remaining
+      // columns of the panel.
+      for (size_t i = j + 1; i < n; ++i)
       {
-        std::swap(row_pivots[j], row_pivots[argmax]);
-        A.swap_row(j, argmax);
+        double* a_i = A.data(i); // accessor for row i
+        const double l_ij = (a_i[j] /= a_jj);
+        for (size_t k = j + 1; k < j1; ++k)
+          a_i[k] -= l_ij * a_j[k];
       }
-    }//if pivoting
-
-    const double* a_j = A.data(j); // accessor for row j
-    const double a_jj = a_j[j]; // diagonal element for row j
+    }
 
-    // Compute the elements of the LU decomposition.
-    for (size_t i = j + 1; i < n; ++i)
+    // Compute the block row of U to the right of the panel
+    for (size_t i = j0 + 1; i < j1; ++i)
     {
-      double* a_i = A.data(i); // accessor for row i
-      double& a_ij = a_i[j]; // accessor for element i, j
+      double* a_i = A.data(i);
+      for (size_t p = j0; p < i; ++p)
+      {
+        const double l_ip = a_i[p];
+        const double* a_p = A.data(p);
+        for (size_t k = j1; k < n; ++k)
+          a_i[k] -= l_ip * a_p[k];
+      }
+    }
 
-      // Lower triangular components. This represents the row operations
-      // performed to attain the upper-triangular, row-echelon matrix.
-      a_ij /= a_jj;
+    // Update the trailing matrix
+    DenseKernels::gemm(n - j1, n - j1, j1 - j0, -1.0,
+                       a + j1 * lda + j0, lda, 1,
+                       a + j0 * lda + j1, lda, 1,
+                       a + j1 * lda + j1, lda);
+  }
+  factorized = true;
+}
 
-      a_i += j + 1; // increment to the correct element
 
-      // Upper triangular components. This represents the row-echelon form of
-      // the original matrix.
-      for (size_t k = j + 1; k < n; ++k)
-        *a_i++ -= a_ij * a_j[k];
-    }
+void
+SparseLU::factorize()
+{
+  // The symbolic analysis is only redone when the pattern changes
+  if (!symbolic || !symbolic->matches(A))
+  {
+    if (!fixed_permutation)
+      permutation = Ordering::compute(ordering, A, points);
+    assert(permutation.size() == A.n_rows());
+
+    auto analysis = std::make_shared<SymbolicFactorization>();
+    analysis->analyze(A, permutation);
+    symbolic = analysis;
+  }
+
+  pivoted = !factorize_numeric();
+  if (pivoted)
+  {
+    factor_values = std::vector<double>();
+    factorize_pivoted();
   }
   factorized = true;
 }
 
 
+bool
+SparseLU::factorize_numeric()
+{
+  const size_t n = symbolic->n_rows();
+  const size_t* row_offsets = symbolic->row_offsets_data();
+  const unsigned int* colnums = symbolic->colnums_data();
+  const size_t* diag = symbolic->diagonal_offsets_data();
+
+  symbolic->scatter(A, factor_values);
+  double* values = factor_values.data();
+
+  // Row-by-row Doolittle algorithm. Row i is expanded into a dense work
+  // vector, updated by the finished rows above it, then packed again. The
+  // symbolic pattern contains all fill, so no entries are ever inserted.
+  ScratchVector w_work(n, 0.0);
+  double* w = w_work->data();
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t first = row_offsets[i];
+    const size_t last = row_offsets[i + 1];
+
+    for (size_t p = first; p < last; ++p)
+      w[colnums[p]] = values[p];
+
+    // Eliminate the lower triangular entries, in increasing column order
+    for (size_t p = first; p < diag[i]; ++p)
+    {
+      const unsigned int k = colnums[p];
+      const double l_ik = (w[k] /= values[diag[k]]);
+      for (size_t q = diag[k] + 1; q < row_offsets[k + 1]; ++q)
+        w[colnums[q]] -= l_ik * values[q];
+    }
+
+    double row_max = 0.0;
+    for (size_t p = first; p < last; ++p)
+    {
+      values[p] = w[colnums[p]];
+      w[colnums[p]] = 0.0;
+      if (p >= diag[i])
+        row_max = std::max(row_max, std::fabs(values[p]));
+    }
+
+    // Fall back to partial pivoting on a small pivot
+    const double pivot = std::fabs(values[diag[i]]);
+    if (pivot_flag && !(pivot > 0.0 && pivot >= pivot_threshold * row_max))
+      return false;
+    assert(pivot != 0.0);
+  }
+  return true;
+}
+
+
 void
-SparseLU::factorize()
+SparseLU::factorize_pivoted()
 {
   size_t n = A.n_rows();
 
+  // Reorder the matrix with the ordering of the symbolic analysis
+  A = Ordering::permute(A, symbolic->get_permutation());
+
+  // Fill entries are inserted, so work on the row-wise storage
+  A.decompress();
+
   // Initialize the pivot mappings such that each row maps to itself
   for (size_t i = 0; i < n; ++i)
     row_pivots[i] = i;
 
+  // Track the rows below the diagonal with an entry in each column, so that
+  // each elimination step only visits rows it modifies. Fill and pivoting
+  // append rows to these lists, so entries may be stale or duplicated.
+  std::vector<std::vector<size_t>> column_rows(n);
+  for (size_t i = 0; i < n; ++i)
+    for (const auto el: A.row_iterator(i))
+      if (el.column < i)
+        column_rows[el.column].push_back(i);
+
   // Apply Doolittle algorithm
   for (size_t j = 0; j < n; ++j)
   {
+    auto& rows = column_rows[j];
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
     // Find the row index for the largest magnitude entry in this column.
     // This is only done for sub-diagonal elements.
     if (pivot_flag)
@@ -124,7 +280,7 @@ SparseLU::factorize()
 
       size_t argmax = j;
       double max = std::fabs((a_jj) ? a_jj : 0.0);
-      for (size_t k = j + 1; k < n; ++k)
+      for (const size_t k: rows)
       {
         const double a_kj = A.el(k, j);
         if (std::fabs(a_kj) > max)
@@ -139,36 +295,53 @@ SparseLU::factorize()
 
       // Swap the current row and the row containing the largest magnitude
       // entry corresponding for the current column. This is done to improve
-      // the numerical stability of the algorithm. */
+      // the numerical stability of the algorithm. Entries of the former row
+      // j before column argmax are now below the diagonal.
       if (argmax != j)
       {
         std::swap(row_pivots[j], row_pivots[argmax]);
         A.swap_row(j, argmax);
+
+        for (const auto el: A.row_iterator(argmax))
+          if (el.column > j && el.column < argmax)
+            column_rows[el.column].push_back(argmax);
       }
     }//if pivot
 
     const double a_jj = A.diag(j);
 
+    // The upper triangular part of row j, which is used to update each row
+    std::vector<std::pair<size_t, double>> u_j;
+    for (const auto el: A.row_iterator(j))
+      if (el.column > j)
+        u_j.emplace_back(el.column, el.value);
+
     // Compute the elements of the LU decomposition
-    for (size_t i = j + 1; i < n; ++i)
+    for (const size_t i: rows)
     {
       if (A.exists(i, j))
       {
-        double& a_ij = A(i, j);
-
         // Lower triangular components. This represents the row operations
         // performed to attain the upper-triangular, row-echelon matrix.
-        a_ij /= a_jj;
+        const double a_ij = (A(i, j) /= a_jj);
 
         // Upper triangular components. This represents the row-echelon form
         // of the original matrix.
-        for (const auto el: A.row_iterator(j))
-          if (el.column > j)
-            A.add(i, el.column, -a_ij * el.value);
+        for (const auto& [k, u_jk]: u_j)
+        {
+          if (k < i && !A.exists(i, k))
+            column_rows[k].push_back(i);
+          A.add(i, k, -a_ij * u_jk);
+        }
       }//if a_ij exists
-    }//for rows > j
+    }//for rows below j
+
+    rows.clear();
+    rows.shrink_to_fit();
   }//for j
-  factorized = true;
+
+  // Pack the factors for the triangular solves
+  A.compress();
 }
 
 
@@ -214,24 +387,68 @@ SparseLU::solve(Vector& x, const Vector& b) const
   assert(b.size() == n);
   assert(x.size() == n);
 
-  // Forward solve
-  for (size_t i = 0; i < n; ++i)
+  const auto& permutation = symbolic->get_permutation();
+
+  // Work on the reordered system
+  ScratchVector y_work(n);
+  Vector& y = *y_work;
+
+  if (pivoted)
   {
-    double value = b[row_pivots[i]];
-    for (const auto el: A.row_iterator(i))
-      if (el.column < i)
-        value -= el.value * x[el.column];
-    x[i] = value;
-  }
+    // Forward solve
+    for (size_t i = 0; i < n; ++i)
+    {
+      double value = b[permutation[row_pivots[i]]];
+      for (const auto el: A.row_iterator(i))
+        if (el.column < i)
+          value -= el.value * y[el.column];
+      y[i] = value;
+    }
 
-  // Backward solve
-  for (size_t i = n - 1; i != -1; --i)
+    // Backward solve
+    for (size_t i = n - 1; i != -1; --i)
+    {
+      double value = y[i];
+      for (const auto el: A.row_iterator(i))
+        if (el.column > i)
+          value -= el.value * y[el.column];
+      y[i] = value / A.diag(i);
+    }
+  }
+  else
   {
-    double value = x[i];
-    for (const auto el: A.row_iterator(i))
-      if (el.column > i)
-        value -= el.value * x[el.column];
-    x[i] = value / A.diag(i);
+    const size_t* row_offsets = symbolic->row_offsets_data();
+    const unsigned int* colnums = symbolic->colnums_data();
+    const size_t* diag = symbolic->diagonal_offsets_data();
+    const double* values = factor_values.data();
+
+    // Forward solve
+    for (size_t i = 0; i < n; ++i)
+    {
+      double value = b[permutation[i]];
+      for (size_t p = row_offsets[i]; p < diag[i]; ++p)
+        value -= values[p] * y[colnums[p]];
+      y[i] = value;
+    }
+
+    // Backward solve
+    for (size_t i = n - 1; i != -1; --i)
+    {
+      double value = y[i];
+      for (size_t p = diag[i] + 1; p < row_offsets[i + 1]; ++p)
+        value -= values[p] * y[colnums[p]];
+      y[i] = value / values[diag[i]];
+    }
   }
+
+  // Map back to the original ordering
+  for (size_t i = 0; i < n; ++i)
+    x[permutation[i]] = y[i];
 }
 
+
+bool
+SparseLU::used_pivoting() const
+{
+  return pivoted;
+}
@@ -5,6 +5,8 @@
 
 #include "matrix.h"
 #include "Math/sparse_matrix.h"
+#include "Math/ordering.h"
+#include "symbolic_factorization.h"
 
 #include <vector>
 #include <cstddef>
@@ -70,6 +72,9 @@ namespace PDEs
         /** Attach a dense matrix to the solver. */
         void set_matrix(const Matrix& matrix) override;
 
+        /** Return a new solver with the same pivoting option. */
+        std::shared_ptr<LinearSolverBase<Matrix>> clone() const override;
+
         /** Perform an LU factorization of the matrix \f$ A \f$ in place. */
         void factorize() override;
 
@@ -81,12 +86,63 @@ namespace PDEs
       /**
        * Implementation of a sparse LU solver. For descriptions of the LU
        * decomposition solver see \ref LU.
+       *
+       * Before factorization, the matrix is symmetrically permuted with a
+       * fill-reducing ordering, see Ordering. The permutation is applied to
+       * the right-hand side and solution internally.
+       *
+       * The factorization is split into a symbolic and a numeric phase. The
+       * symbolic phase computes the ordering and the static pattern of the
+       * factors, see SymbolicFactorization. It is only repeated when a
+       * matrix with a different pattern is attached, so refactorizing a
+       * matrix whose values changed only costs the numeric phase.
+       *
+       * The numeric phase does not pivot. If pivoting is enabled and a
+       * pivot is small relative to its row, see \ref pivot_threshold, the
+       * matrix is instead factored with partial pivoting, inserting fill
+       * dynamically.
        */
       class SparseLU : public DirectSolverBase<SparseMatrix>
       {
       private:
         bool pivot_flag = true;
 
+        /** The method used to compute the fill-reducing ordering. */
+        Ordering::Method ordering;
+
+        /**
+         * The fill-reducing permutation. Entry \p k is the original index of
+         * row \p k of the factored matrix.
+         */
+        std::vector<size_t> permutation;
+
+        /**
+         * A flag for whether the permutation was provided by the user via
+         * \ref set_permutation rather than computed.
+         */
+        bool fixed_permutation = false;
+
+        /**
+         * The coordinates of the rows used by nested dissection. See
+         * \ref set_coordinates.
+         */
+        std::vector<Grid::Point> points;
+
+        /**
+         * The symbolic analysis of the attached matrix. This is shared with
+         * clones, which refactorize matrices with the same pattern.
+         */
+        std::shared_ptr<const SymbolicFactorization> symbolic;
+
+        /** The values of the factors, stored in the symbolic pattern. */
+        std::vector<double> factor_values;
+
+        /**
+         * A flag for whether the matrix was factored with partial pivoting,
+         * in which case the factors are stored in \p A.
+         */
+        bool pivoted = false;
+
         /**
          * The pivot mapping vector. The index corresponds to the initial row
          * number and the value to the pivoted row number. This is used to map the
@@ -95,23 +151,72 @@ namespace PDEs
         std::vector<size_t> row_pivots;
 
       public:
+        /**
+         * A pivot whose magnitude is below this fraction of the largest
+         * entry of its row of \f$ U \f$ triggers partial pivoting. This
+         * bounds the growth of the entries of \f$ U \f$ as in threshold
+         * partial pivoting. Diagonally dominant matrices never pivot.
+         */
+        static constexpr double pivot_threshold = 0.1;
+
         /**
          * Default constructor. Construct a sparse LU solver, optionally with
-         * row pivoting.
+         * row pivoting, which reorders the matrix with the specified
+         * \p ordering.
          */
-        SparseLU(const bool pivot = true);
+        SparseLU(const bool pivot = true,
+                 const Ordering::Method ordering =
+                     Ordering::Method::MINIMUM_DEGREE);
+
+        /**
+         * Use the specified \p permutation for all subsequent matrices
+         * instead of computing one. This allows orderings computed by the
+         * caller to be used. An empty \p permutation restores the computed
+         * ordering.
+         */
+        void set_permutation(const std::vector<size_t>& permutation);
+
+        /**
+         * Set the coordinates of the rows, such as the cell centroids of the
+         * mesh, which are required by Ordering::Method::NESTED_DISSECTION.
+         * See Ordering::nested_dissection.
+         */
+        void set_coordinates(const std::vector<Grid::Point>& points);
 
         /** Attach a matrix to the solver. */
         void set_matrix(const SparseMatrix& matrix) override;
 
         /**
-         * Perform an LU factorization on the matrix \f$ A \f$ in
-         * place. See \ref LU::factorize
+         * Return a new solver with the same pivoting and ordering options.
+         */
+        std::shared_ptr<LinearSolverBase<SparseMatrix>> clone() const override;
+
+        /**
+         * Perform an LU factorization of the reordered matrix \f$ A \f$.
+         * The symbolic analysis is reused if the pattern of \f$ A \f$ is
+         * unchanged. See \ref LU::factorize
          */
         void factorize() override;
 
         /** Solve the LU factored linear system. See \ref LU::solve */
         void solve(Vector& x, const Vector& b) const override;
+
+        /** Return whether the last factorization required pivoting. */
+        bool used_pivoting() const;
+
+      private:
+        /**
+         * Compute the factors in the symbolic pattern without pivoting.
+         * Return false if a small pivot is encountered while pivoting is
+         * enabled.
+         */
+        bool factorize_numeric();
+
+        /**
+         * Factor the reordered matrix in place with partial pivoting,
+         * inserting fill entries as they are created.
+         */
+        void factorize_pivoted();
       };
 
     }
@@ -0,0 +1,525 @@
+#include "supernodal_cholesky.h"
+
+#include "vector.h"
+#include "vector_pool.h"
+#include "multithreading.h"
+#include "dense_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <cassert>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+namespace
+{
+  constexpr size_t invalid = static_cast<size_t>(-1);
+
+
+  /**
+   * Subtract the update from a descendant panel into a target panel.
+   *
+   * The descendant panel \p l_d has \p n_cols_d columns and rows \p rows_d.
+   * Rows <tt>[a, b)</tt> of it lie in the columns of the target supernode,
+   * which start at \p first, and rows <tt>[a, n_rows_d)</tt> are updated.
+   * The update is the product of rows <tt>[a, n_rows_d)</tt> with the
+   * transpose of rows <tt>[a, b)</tt>, which is computed densely into
+   * \p work and then scattered into the target panel. The local row of each
+   * global row in the target panel is given by \p local.
+   */
+  void
+  update_panel(const double* l_d,
+               const size_t n_cols_d,
+               const unsigned int* rows_d,
+               const size_t n_rows_d,
+               const size_t a,
+               const size_t b,
+               double* l_s,
+               const size_t n_cols_s,
+               const size_t first,
+               const size_t* local,
+               std::vector<double>& work)
+  {
+    const size_t m = n_rows_d - a;
+    const size_t n = b - a;
+    work.assign(m * n, 0.0);
+
+    const double* l_a = l_d + a * n_cols_d;
+    DenseKernels::gemm(m, n, n_cols_d, 1.0,
+                       l_a, n_cols_d, 1,
+                       l_a, 1, n_cols_d,
+                       work.data(), n);
+
+    // Only the lower triangle of the target diagonal block is used
+    for (size_t i = 0; i < m; ++i)
+    {
+      double* l_i = l_s + local[rows_d[a + i]] * n_cols_s;
+      const double* w_i = work.data() + i * n;
+      for (size_t j = 0, n_j = std::min(i + 1, n); j < n_j; ++j)
+        l_i[rows_d[a + j] - first] -= w_i[j];
+    }
+  }
+
+
+  /**
+   * Factor a dense panel with \p n_rows rows and \p n_cols columns in place.
+   * The leading square block is factored with a dense Cholesky and the rows
+   * below are solved against it. Columns are processed in blocks of
+   * \ref DenseKernels::panel_width, and the columns to the right of each
+   * block are updated with a single \ref DenseKernels::gemm. Return false
+   * if a non-positive pivot is encountered.
+   */
+  bool
+  factor_panel(double* l, const size_t n_rows, const size_t n_cols)
+  {
+    for (size_t j0 = 0; j0 < n_cols; j0 += DenseKernels::panel_width)
+    {
+      const size_t j1 = std::min(j0 + DenseKernels::panel_width, n_cols);
+
+      // Factor the columns of the block, whose contributions from the
+      // columns left of the block have already been applied
+      for (size_t i = j0; i < n_rows; ++i)
+      {
+        double* l_i = l + i * n_cols;
+        const size_t n = std::min(i, j1);
+        for (size_t j = j0; j < n; ++j)
+        {
+          const double* l_j = l + j * n_cols;
+
+          double value = l_i[j];
+          for (size_t k = j0; k < j; ++k)
+            value -= l_i[k] * l_j[k];
+          l_i[j] = value / l_j[j];
+        }
+
+        if (i < j1)
+        {
+          double d = l_i[i];
+          for (size_t k = j0; k < i; ++k)
+            d -= l_i[k] * l_i[k];
+          if (!(d > 0.0))
+            return false;
+          l_i[i] = std::sqrt(d);
+        }
+      }
+
+      // Update the columns right of the block. Entries above the diagonal
+      // are also computed but never read.
+      if (j1 < n_cols)
+        DenseKernels::gemm(n_rows - j1, n_cols - j1, j1 - j0, -1.0,
+                           l + j1 * n_cols + j0, n_cols, 1,
+                           l + j1 * n_cols + j0, 1, n_cols,
+                           l + j1 * n_cols + j1, n_cols);
+    }
+    return true;
+  }
+}
+
+
+//################################################## Analysis
+
+void
+SupernodalCholesky::Supernodes::analyze(const SparseMatrix& matrix,
+                                        const std::vector<size_t>& permutation)
+{
+  symbolic.analyze(matrix, permutation);
+
+  const size_t n = symbolic.n_rows();
+  const auto& parent = symbolic.elimination_tree();
+  const size_t* offsets = symbolic.row_offsets_data();
+  const unsigned int* colnums = symbolic.colnums_data();
+  const size_t* diag = symbolic.diagonal_offsets_data();
+
+  // The length of column j of L, including the diagonal, is that of the
+  // upper part of row j of the symbolic pattern
+  auto column_count = [&](const size_t j) { return offsets[j + 1] - diag[j]; };
+
+  std::vector<size_t> n_children(n, 0);
+  for (size_t j = 0; j < n; ++j)
+    if (parent[j] != invalid)
+      ++n_children[parent[j]];
+
+  // Fundamental supernodes: column j + 1 extends the supernode of column j
+  // if it is the only child of j + 1 and their patterns nest
+  first_column.assign(1, 0);
+  for (size_t j = 1; j < n; ++j)
+    if (parent[j - 1] != j || n_children[j] != 1 ||
+        column_count(j - 1) != column_count(j) + 1)
+      first_column.push_back(j);
+  first_column.push_back(n);
+
+  const size_t n_super = n_supernodes();
+  std::vector<size_t> supernode_of(n);
+  for (size_t s = 0; s < n_super; ++s)
+    for (size_t j = first_column[s]; j < first_column[s + 1]; ++j)
+      supernode_of[j] = s;
+
+  // The rows of each panel are its columns followed by the pattern of its
+  // last column below the diagonal
+  row_offsets.assign(n_super + 1, 0);
+  value_offsets.assign(n_super + 1, 0);
+  for (size_t s = 0; s < n_super; ++s)
+  {
+    const size_t n_cols = first_column[s + 1] - first_column[s];
+    const size_t n_rows = n_cols - 1 + column_count(first_column[s + 1] - 1);
+    row_offsets[s + 1] = row_offsets[s] + n_rows;
+    value_offsets[s + 1] = value_offsets[s] + n_rows * n_cols;
+  }
+
+  rows.resize(row_offsets[n_super]);
+  for (size_t s = 0; s < n_super; ++s)
+  {
+    size_t p = row_offsets[s];
+    for (size_t j = first_column[s]; j < first_column[s + 1]; ++j)
+      rows[p++] = j;
+
+    const size_t last = first_column[s + 1] - 1;
+    for (size_t q = diag[last] + 1; q < offsets[last + 1]; ++q)
+      rows[p++] = colnums[q];
+  }
+
+  // Supernode d updates each distinct supernode containing one of its rows
+  // below its own columns
+  std::vector<std::vector<size_t>> update_lists(n_super);
+  std::vector<size_t> mark(n_super, invalid);
+  for (size_t d = 0; d < n_super; ++d)
+  {
+    const size_t n_cols = first_column[d + 1] - first_column[d];
+    for (size_t p = row_offsets[d] + n_cols; p < row_offsets[d + 1]; ++p)
+    {
+      const size_t s = supernode_of[rows[p]];
+      if (mark[s] != d)
+      {
+        mark[s] = d;
+        update_lists[s].push_back(d);
+      }
+    }
+  }
+
+  update_offsets.assign(n_super + 1, 0);
+  for (size_t s = 0; s < n_super; ++s)
+    update_offsets[s + 1] = update_offsets[s] + update_lists[s].size();
+  updates.clear();
+  updates.reserve(update_offsets[n_super]);
+  for (const auto& list: update_lists)
+    updates.insert(updates.end(), list.begin(), list.end());
+
+  // Group the supernodes by height in the supernodal elimination tree.
+  // Parents always follow their children.
+  std::vector<size_t> height(n_super, 0);
+  size_t max_height = 0;
+  for (size_t s = 0; s < n_super; ++s)
+  {
+    max_height = std::max(max_height, height[s]);
+    const size_t p = parent[first_column[s + 1] - 1];
+    if (p != invalid)
+    {
+      const size_t sp = supernode_of[p];
+      height[sp] = std::max(height[sp], height[s] + 1);
+    }
+  }
+
+  level_offsets.assign(max_height + 2, 0);
+  for (size_t s = 0; s < n_super; ++s)
+    ++level_offsets[height[s] + 1];
+  for (size_t l = 0; l <= max_height; ++l)
+    level_offsets[l + 1] += level_offsets[l];
+
+  levels.resize(n_super);
+  std::vector<size_t> next(level_offsets.begin(), level_offsets.end() - 1);
+  for (size_t s = 0; s < n_super; ++s)
+    levels[next[height[s]]++] = s;
+
+  // Map each source entry of the lower triangle to its panel position
+  const auto inverse = Ordering::invert(permutation);
+  value_map.clear();
+  value_map.reserve(matrix.n_nonzero_entries());
+  for (size_t row = 0; row < n; ++row)
+  {
+    if (matrix.row_length(row) == 0)
+      continue;
+
+    const size_t i = inverse[row];
+    for (const auto el: matrix.row_iterator(row))
+    {
+      const size_t j = inverse[el.column];
+      if (i < j)
+      {
+        value_map.push_back(invalid);
+        continue;
+      }
+
+      const size_t s = supernode_of[j];
+      const auto first = rows.begin() + row_offsets[s];
+      const auto last = rows.begin() + row_offsets[s + 1];
+      const auto it = std::lower_bound(first, last, i);
+      assert(it != last && *it == i);
+
+      const size_t n_cols = first_column[s + 1] - first_column[s];
+      value_map.push_back(value_offsets[s] + (it - first) * n_cols +
+                          (j - first_column[s]));
+    }
+  }
+}
+
+
+size_t
+SupernodalCholesky::Supernodes::n_supernodes() const
+{
+  return first_column.size() - 1;
+}
+
+//################################################## Solver
+
+SupernodalCholesky::SupernodalCholesky(const Ordering::Method ordering) :
+    DirectSolverBase<SparseMatrix>(), ordering(ordering)
+{}
+
+
+void
+SupernodalCholesky::set_permutation(const std::vector<size_t>& permutation)
+{
+  this->permutation = permutation;
+  fixed_permutation = !permutation.empty();
+  supernodes.reset();
+}
+
+
+void
+SupernodalCholesky::set_coordinates(const std::vector<Grid::Point>& points)
+{
+  this->points = points;
+  supernodes.reset();
+}
+
+
+std::shared_ptr<LinearSolverBase<SparseMatrix>>
+SupernodalCholesky::clone() const
+{
+  auto solver = std::make_shared<SupernodalCholesky>(ordering);
+  if (fixed_permutation)
+    solver->set_permutation(permutation);
+  solver->points = points;
+  solver->supernodes = supernodes;
+  return solver;
+}
+
+
+void
+SupernodalCholesky::factorize()
+{
+  // The symbolic analysis is only redone when the pattern changes
+  if (!supernodes || !supernodes->symbolic.matches(A))
+  {
+    if (!fixed_permutation)
+      permutation = Ordering::compute(ordering, A, points);
+    assert(permutation.size() == A.n_rows());
+
+    auto analysis = std::make_shared<Supernodes>();
+    analysis->analyze(A, permutation);
+    supernodes = analysis;
+  }
+
+  const Supernodes& sn = *supernodes;
+  const size_t n = sn.symbolic.n_rows();
+  const size_t n_super = sn.n_supernodes();
+
+  // Scatter the lower triangle of the reordered matrix into the panels
+  factor_values.assign(sn.value_offsets[n_super], 0.0);
+  size_t e = 0;
+  for (size_t row = 0; row < n; ++row)
+  {
+    if (A.row_length(row) == 0)
+      continue;
+
+    for (const auto el: A.row_iterator(row))
+    {
+      const size_t pos = sn.value_map[e++];
+      if (pos != invalid)
+        factor_values[pos] = el.value;
+    }
+  }
+
+  // Factor a single supernode using the scratch of the calling thread. The
+  // local row map is reset after use so that it is only allocated once.
+  auto factor_supernode = [&](const size_t s,
+                              std::vector<size_t>& local,
+                              std::vector<double>& work)
+  {
+    const size_t first = sn.first_column[s];
+    const size_t n_cols = sn.first_column[s + 1] - first;
+    const size_t n_rows = sn.row_offsets[s + 1] - sn.row_offsets[s];
+    const unsigned int* rows = sn.rows.data() + sn.row_offsets[s];
+    double* l_s = factor_values.data() + sn.value_offsets[s];
+
+    for (size_t i = 0; i < n_rows; ++i)
+      local[rows[i]] = i;
+
+    // Apply the updates from the descendants
+    for (size_t u = sn.update_offsets[s]; u < sn.update_offsets[s + 1]; ++u)
+    {
+      const size_t d = sn.updates[u];
+      const size_t n_cols_d = sn.first_column[d + 1] - sn.first_column[d];
+      const size_t n_rows_d = sn.row_offsets[d + 1] - sn.row_offsets[d];
+      const unsigned int* rows_d = sn.rows.data() + sn.row_offsets[d];
+
+      const unsigned int* a =
+          std::lower_bound(rows_d + n_cols_d, rows_d + n_rows_d, first);
+      const unsigned int* b =
+          std::lower_bound(a, rows_d + n_rows_d, first + n_cols);
+      update_panel(factor_values.data() + sn.value_offsets[d], n_cols_d,
+                   rows_d, n_rows_d, a - rows_d, b - rows_d,
+                   l_s, n_cols, first, local.data(), work);
+    }
+
+    for (size_t i = 0; i < n_rows; ++i)
+      local[rows[i]] = invalid;
+
+    return factor_panel(l_s, n_rows, n_cols);
+  };
+
+  // Factor the supernodes level by level from the leaves of the tree. Levels
+  // with a single supernode, which make up the top of the tree, are factored
+  // without starting a thread team.
+  const int n_threads = MultiThreading::n_threads(factor_values.size());
+  std::vector<std::vector<size_t>> local(n_threads);
+  std::vector<std::vector<double>> work(n_threads);
+  for (auto& map: local)
+    map.assign(n, invalid);
+
+  bool failed = false;
+  for (size_t l = 0; l + 1 < sn.level_offsets.size() && !failed; ++l)
+  {
+    const auto begin = static_cast<long>(sn.level_offsets[l]);
+    const auto end = static_cast<long>(sn.level_offsets[l + 1]);
+    const int n_level_threads =
+        static_cast<int>(std::min<long>(n_threads, end - begin));
+
+    if (n_level_threads == 1)
+    {
+      for (long k = begin; k < end && !failed; ++k)
+        failed = !factor_supernode(sn.levels[k], local[0], work[0]);
+      continue;
+    }
+
+    #pragma omp parallel num_threads(n_level_threads)
+    {
+#ifdef _OPENMP
+      const int t = omp_get_thread_num();
+#else
+      const int t = 0;
+#endif
+
+      #pragma omp for schedule(dynamic, 1)
+      for (long k = begin; k < end; ++k)
+        if (!factor_supernode(sn.levels[k], local[t], work[t]))
+        {
+          #pragma omp atomic write
+          failed = true;
+        }
+    }
+  }
+
+  if (failed)
+    throw std::runtime_error(
+        "SupernodalCholesky: The matrix is not positive definite.");
+  factorized = true;
+}
+
+
+void
+SupernodalCholesky::solve(Vector& x, const Vector& b) const
+{
+  const Supernodes& sn = *supernodes;
+  const size_t n = sn.symbolic.n_rows();
+  const size_t n_super = sn.n_supernodes();
+  assert(factorized);
+  assert(b.size() == n);
+  assert(x.size() == n);
+
+  const auto& permutation = sn.symbolic.get_permutation();
+
+  // Work on the reordered system
+  ScratchVector y_work(n);
+  Vector& y = *y_work;
+  for (size_t i = 0; i < n; ++i)
+    y[i] = b[permutation[i]];
+
+  // Forward solve
+  for (size_t s = 0; s < n_super; ++s)
+  {
+    const size_t first = sn.first_column[s];
+    const size_t n_cols = sn.first_column[s + 1] - first;
+    const size_t n_rows = sn.row_offsets[s + 1] - sn.row_offsets[s];
+    const unsigned int* rows = sn.rows.data() + sn.row_offsets[s];
+    const double* l = factor_values.data() + sn.value_offsets[s];
+    const double* y_s = y.data() + first;
+
+    for (size_t j = 0; j < n_cols; ++j)
+    {
+      const double* l_j = l + j * n_cols;
+
+      double value = y_s[j];
+      for (size_t k = 0; k < j; ++k)
+        value -= l_j[k] * y_s[k];
+      y[first + j] = value / l_j[j];
+    }
+
+    for (size_t i = n_cols; i < n_rows; ++i)
+    {
+      const double* l_i = l + i * n_cols;
+
+      double value = 0.0;
+      for (size_t k = 0; k < n_cols; ++k)
+        value += l_i[k] * y_s[k];
+      y[rows[i]] -= value;
+    }
+  }
+
+  // Backward solve
+  for (size_t s = n_super - 1; s != -1; --s)
+  {
+    const size_t first = sn.first_column[s];
+    const size_t n_cols = sn.first_column[s + 1] - first;
+    const size_t n_rows = sn.row_offsets[s + 1] - sn.row_offsets[s];
+    const unsigned int* rows = sn.rows.data() + sn.row_offsets[s];
+    const double* l = factor_values.data() + sn.value_offsets[s];
+    double* y_s = y.data() + first;
+
+    for (size_t i = n_cols; i < n_rows; ++i)
+    {
+      const double* l_i = l + i * n_cols;
+      const double y_i = y[rows[i]];
+      for (size_t k = 0; k < n_cols; ++k)
+        y_s[k] -= l_i[k] * y_i;
+    }
+
+    for (size_t j = n_cols - 1; j != -1; --j)
+    {
+      const double* l_j = l + j * n_cols;
+      const double y_j = (y_s[j] /= l_j[j]);
+      for (size_t k = 0; k < j; ++k)
+        y_s[k] -= l_j[k] * y_j;
+    }
+  }
+
+  // Map back to the original ordering
+  for (size_t i = 0; i < n; ++i)
+    x[permutation[i]] = y[i];
+}
+
+
+size_t
+SupernodalCholesky::n_supernodes() const
+{
+  return supernodes ? supernodes->n_supernodes() : 0;
+}
@@ -0,0 +1,166 @@
+#ifndef SUPERNODAL_CHOLESKY_H
+#define SUPERNODAL_CHOLESKY_H
+
+#include "Math/LinearSolvers/linear_solver.h"
+
+#include "Math/sparse_matrix.h"
+#include "Math/ordering.h"
+#include "symbolic_factorization.h"
+
+#include <vector>
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+
+      /**
+       * Implementation of a supernodal sparse Cholesky solver.
+       *
+       * A supernode is a set of consecutive columns of \f$ L \f$ which form a
+       * chain in the elimination tree and share the same nonzero pattern
+       * below the diagonal. Each supernode is stored as a dense row-major
+       * panel whose rows are the union of that pattern and the columns of
+       * the supernode. The factorization is left-looking over supernodes:
+       * the update from each descendant supernode is the product of two
+       * blocks of its panel, which is computed with \ref DenseKernels::gemm
+       * into a dense buffer and scattered into the target panel. The target
+       * panel is then factored in place with a dense Cholesky and triangular
+       * solve, blocked by \ref DenseKernels::panel_width columns with the
+       * trailing columns updated by \ref DenseKernels::gemm.
+       *
+       * A supernode only depends on its descendants in the supernodal
+       * elimination tree, so all supernodes at the same height of the tree
+       * are factored concurrently. Levels with a single supernode are
+       * factored serially. The number of threads is controlled by
+       * \ref MultiThreading.
+       *
+       * The ordering and symbolic analysis are handled as in
+       * \ref SparseCholesky and are reused for matrices with an unchanged
+       * pattern. This solver is best suited to the larger symmetric positive
+       * definite systems, such as the within-group diffusion operators. On
+       * two dimensional meshes most supernodes are small, so the dense
+       * kernels mostly take their unblocked path and the gain comes from
+       * the dense panel layout rather than from cache blocking.
+       */
+      class SupernodalCholesky : public DirectSolverBase<SparseMatrix>
+      {
+      private:
+        /**
+         * The supernodal partition and layout of the factor. This is built
+         * once per symbolic analysis and shared with clones.
+         */
+        struct Supernodes
+        {
+          /** The analysis the supernodes were built from. */
+          SymbolicFactorization symbolic;
+
+          /**
+           * The first column of each supernode. This has
+           * <tt>n_supernodes + 1</tt> entries.
+           */
+          std::vector<size_t> first_column;
+
+          /** The offset of the row list of each supernode in \ref rows. */
+          std::vector<size_t> row_offsets;
+
+          /**
+           * The sorted rows of each supernode panel. The first rows are the
+           * columns of the supernode itself.
+           */
+          std::vector<unsigned int> rows;
+
+          /** The offset of each dense panel in the factor values. */
+          std::vector<size_t> value_offsets;
+
+          /**
+           * The supernodes which update each supernode, stored in compressed
+           * form with \ref update_offsets.
+           */
+          std::vector<size_t> update_offsets;
+          std::vector<size_t> updates;
+
+          /**
+           * The supernodes grouped by their height in the supernodal
+           * elimination tree, stored in compressed form with
+           * \ref level_offsets. Supernodes in the same level are independent.
+           */
+          std::vector<size_t> level_offsets;
+          std::vector<size_t> levels;
+
+          /**
+           * The position in the factor values of each entry of the source
+           * matrix, enumerated row by row. Entries of the strictly upper
+           * triangle of the permuted matrix store an invalid value.
+           */
+          std::vector<size_t> value_map;
+
+          /** Build the supernodes of \p matrix with \p permutation. */
+          void analyze(const SparseMatrix& matrix,
+                       const std::vector<size_t>& permutation);
+
+          /** Return the number of supernodes. */
+          size_t n_supernodes() const;
+        };
+
+        /** The method used to compute the fill-reducing ordering. */
+        Ordering::Method ordering;
+
+        /** See \ref SparseCholesky. */
+        std::vector<size_t> permutation;
+
+        /** See \ref SparseCholesky. */
+        bool fixed_permutation = false;
+
+        /** See \ref SparseLU. */
+        std::vector<Grid::Point> points;
+
+        /** The supernodal analysis, shared with clones. */
+        std::shared_ptr<const Supernodes> supernodes;
+
+        /** The dense supernode panels of the factor. */
+        std::vector<double> factor_values;
+
+      public:
+        /**
+         * Default constructor. Construct a supernodal Cholesky solver which
+         * reorders the matrix with the specified \p ordering.
+         */
+        SupernodalCholesky(const Ordering::Method ordering =
+                               Ordering::Method::MINIMUM_DEGREE);
+
+        /** See \ref SparseLU::set_permutation. */
+        void set_permutation(const std::vector<size_t>& permutation);
+
+        /** See \ref SparseLU::set_coordinates. */
+        void set_coordinates(const std::vector<Grid::Point>& points);
+
+        /** Return a new supernodal Cholesky solver with the same ordering. */
+        std::shared_ptr<LinearSolverBase<SparseMatrix>> clone() const override;
+
+        /**
+         * Perform a supernodal Cholesky factorization on the reordered
+         * matrix \f$ A \f$. The symbolic analysis is reused if the pattern of
+         * \f$ A \f$ is unchanged. An error is thrown if the matrix is not
+         * positive definite.
+         */
+        void factorize() override;
+
+        /**
+         * Solve the Cholesky factored linear system.
+         * See \ref Cholesky::solve
+         */
+        void solve(Vector& x, const Vector& b) const override;
+
+        /** Return the number of supernodes of the factorization. */
+        size_t n_supernodes() const;
+      };
+
+    }
+  }
+}
+#endif //SUPERNODAL_CHOLESKY_H
@@ -0,0 +1,259 @@
+#include "symbolic_factorization.h"
+
+#include "Math/sparse_matrix.h"
+#include "Math/ordering.h"
+
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+namespace
+{
+  constexpr size_t invalid = static_cast<size_t>(-1);
+}
+
+
+SymbolicFactorization::SymbolicFactorization() :
+    n(0), row_offsets(1, 0)
+{}
+
+
+void
+SymbolicFactorization::analyze(const SparseMatrix& matrix,
+                               const std::vector<size_t>& permutation)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+  assert(permutation.size() == matrix.n_rows());
+  assert(matrix.n_rows() <= std::numeric_limits<unsigned int>::max());
+
+  n = matrix.n_rows();
+  this->permutation = permutation;
+  const auto inverse = Ordering::invert(permutation);
+
+  // Record the source pattern and build the lower triangle of the
+  // symmetrized, permuted pattern
+  source_row_lengths.resize(n);
+  source_colnums.clear();
+  source_colnums.reserve(matrix.n_nonzero_entries());
+  std::vector<std::vector<size_t>> lower(n);
+  for (size_t row = 0; row < n; ++row)
+  {
+    source_row_lengths[row] = matrix.row_length(row);
+    if (source_row_lengths[row] == 0)
+      continue;
+
+    for (const auto el: matrix.row_iterator(row))
+    {
+      source_colnums.push_back(el.column);
+
+      const size_t i = inverse[row];
+      const size_t j = inverse[el.column];
+      if (i > j)
+        lower[i].push_back(j);
+      else if (j > i)
+        lower[j].push_back(i);
+    }
+  }
+
+  // Compute the elimination tree with path compression (Liu)
+  parent.assign(n, invalid);
+  std::vector<size_t> ancestor(n, invalid);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t k: lower[i])
+    {
+      while (ancestor[k] != invalid && ancestor[k] != i)
+      {
+        const size_t next = ancestor[k];
+        ancestor[k] = i;
+        k = next;
+      }
+      if (ancestor[k] == invalid)
+      {
+        ancestor[k] = i;
+        parent[k] = i;
+      }
+    }
+
+  // The pattern of row i of L is the union of the paths in the elimination
+  // tree from each entry of row i of the matrix up to i
+  std::vector<size_t> mark(n, invalid);
+  std::vector<std::vector<unsigned int>> l_rows(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    mark[i] = i;
+    for (size_t k: lower[i])
+      for (; mark[k] != i; k = parent[k])
+      {
+        l_rows[i].push_back(k);
+        mark[k] = i;
+      }
+    std::sort(l_rows[i].begin(), l_rows[i].end());
+    std::vector<size_t>().swap(lower[i]);
+  }
+
+  // The pattern of U is the transpose of that of L
+  std::vector<unsigned int> u_lengths(n, 0);
+  for (size_t i = 0; i < n; ++i)
+    for (const unsigned int k: l_rows[i])
+      ++u_lengths[k];
+
+  row_offsets.assign(n + 1, 0);
+  for (size_t i = 0; i < n; ++i)
+    row_offsets[i + 1] = row_offsets[i] + l_rows[i].size() + 1 + u_lengths[i];
+
+  colnums.resize(row_offsets[n]);
+  diagonal_offsets.resize(n);
+  std::vector<size_t> u_next(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    size_t p = row_offsets[i];
+    for (const unsigned int k: l_rows[i])
+      colnums[p++] = k;
+    diagonal_offsets[i] = p;
+    colnums[p++] = i;
+    u_next[i] = p;
+  }
+
+  // Rows are visited in increasing order, so each upper part is sorted
+  for (size_t i = 0; i < n; ++i)
+    for (const unsigned int k: l_rows[i])
+      colnums[u_next[k]++] = i;
+
+  // Map each source entry to its position in the factor storage
+  value_map.resize(source_colnums.size());
+  size_t e = 0;
+  for (size_t row = 0; row < n; ++row)
+  {
+    const size_t i = inverse[row];
+    const auto first = colnums.begin() + row_offsets[i];
+    const auto last = colnums.begin() + row_offsets[i + 1];
+    for (unsigned int k = 0; k < source_row_lengths[row]; ++k, ++e)
+    {
+      const unsigned int j = inverse[source_colnums[e]];
+      const auto it = std::lower_bound(first, last, j);
+      assert(it != last && *it == j);
+      value_map[e] = it - colnums.begin();
+    }
+  }
+}
+
+
+void
+SymbolicFactorization::clear()
+{
+  n = 0;
+  permutation.clear();
+  parent.clear();
+  row_offsets.assign(1, 0);
+  colnums.clear();
+  diagonal_offsets.clear();
+  source_row_lengths.clear();
+  source_colnums.clear();
+  value_map.clear();
+}
+
+
+bool
+SymbolicFactorization::empty() const
+{
+  return n == 0;
+}
+
+
+bool
+SymbolicFactorization::matches(const SparseMatrix& matrix) const
+{
+  if (empty() || matrix.n_rows() != n || matrix.n_cols() != n ||
+      matrix.n_nonzero_entries() != source_colnums.size())
+    return false;
+
+  size_t e = 0;
+  for (size_t row = 0; row < n; ++row)
+  {
+    if (matrix.row_length(row) != source_row_lengths[row])
+      return false;
+    if (source_row_lengths[row] == 0)
+      continue;
+
+    for (const auto el: matrix.row_iterator(row))
+      if (el.column != source_colnums[e++])
+        return false;
+  }
+  return true;
+}
+
+
+void
+SymbolicFactorization::scatter(const SparseMatrix& matrix,
+                               std::vector<double>& values) const
+{
+  assert(matrix.n_rows() == n);
+  assert(matrix.n_nonzero_entries() == value_map.size());
+
+  values.assign(colnums.size(), 0.0);
+
+  size_t e = 0;
+  for (size_t row = 0; row < n; ++row)
+  {
+    if (source_row_lengths[row] == 0)
+      continue;
+
+    for (const auto el: matrix.row_iterator(row))
+      values[value_map[e++]] = el.value;
+  }
+}
+
+
+size_t
+SymbolicFactorization::n_rows() const
+{
+  return n;
+}
+
+
+size_t
+SymbolicFactorization::n_nonzero_entries() const
+{
+  return colnums.size();
+}
+
+
+const std::vector<size_t>&
+SymbolicFactorization::get_permutation() const
+{
+  return permutation;
+}
+
+
+const std::vector<size_t>&
+SymbolicFactorization::elimination_tree() const
+{
+  return parent;
+}
+
+
+const size_t*
+SymbolicFactorization::row_offsets_data() const
+{
+  return row_offsets.data();
+}
+
+
+const unsigned int*
+SymbolicFactorization::colnums_data() const
+{
+  return colnums.data();
+}
+
+
+const size_t*
+SymbolicFactorization::diagonal_offsets_data() const
+{
+  return diagonal_offsets.data();
+}
@@ -0,0 +1,130 @@
+#ifndef SYMBOLIC_FACTORIZATION_H
+#define SYMBOLIC_FACTORIZATION_H
+
+#include <cstddef>
+#include <vector>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class SparseMatrix;
+
+
+    namespace LinearSolvers
+    {
+      /**
+       * The structural part of a sparse LU or Cholesky factorization.
+       *
+       * Given a fill-reducing permutation, the analysis computes the
+       * elimination tree of the symmetrized, permuted matrix and from it the
+       * exact nonzero pattern of the factors. Without pivoting, the factors
+       * of a matrix with a symmetric pattern satisfy \f$ \text{struct}(U) =
+       * \text{struct}(L^T) \f$, so a single compressed row pattern holds the
+       * strictly lower part of \f$ L \f$, the diagonal, and the strictly
+       * upper part of \f$ U \f$. Each row is sorted and the position of its
+       * diagonal entry is cached.
+       *
+       * The analysis also records the pattern of the source matrix and where
+       * each of its entries lands in the factor storage. Matrices with the
+       * same pattern can then be refactorized numerically without repeating
+       * any of the structural work. See \ref matches and \ref scatter.
+       */
+      class SymbolicFactorization
+      {
+      private:
+        size_t n;
+
+        /** The fill-reducing permutation. See Ordering. */
+        std::vector<size_t> permutation;
+
+        /**
+         * The parent of each row in the elimination tree. Roots store an
+         * invalid value.
+         */
+        std::vector<size_t> parent;
+
+        /**
+         * The offset of the first entry of each row of the factor pattern.
+         * This has <tt>n + 1</tt> entries.
+         */
+        std::vector<size_t> row_offsets;
+
+        /** The sorted column indices of the factor pattern. */
+        std::vector<unsigned int> colnums;
+
+        /** The offset of the diagonal entry of each row. */
+        std::vector<size_t> diagonal_offsets;
+
+        /** The row lengths of the analyzed source matrix. */
+        std::vector<unsigned int> source_row_lengths;
+
+        /** The column indices of the analyzed source matrix, row by row. */
+        std::vector<unsigned int> source_colnums;
+
+        /**
+         * The position in the factor storage of each entry of the source
+         * matrix, enumerated row by row.
+         */
+        std::vector<size_t> value_map;
+
+      public:
+        /** Default constructor. Construct an empty analysis. */
+        SymbolicFactorization();
+
+        /**
+         * Analyze the pattern of \p matrix reordered with \p permutation.
+         * Entry \p k of the permutation is the original index of row \p k
+         * of the factors.
+         */
+        void analyze(const SparseMatrix& matrix,
+                     const std::vector<size_t>& permutation);
+
+        /** Delete the analysis. */
+        void clear();
+
+        /** Return whether an analysis is available. */
+        bool empty() const;
+
+        /**
+         * Return whether \p matrix has exactly the pattern of the analyzed
+         * matrix, in which case the analysis can be reused for it.
+         */
+        bool matches(const SparseMatrix& matrix) const;
+
+        /**
+         * Set \p values to the entries of \p matrix arranged in the factor
+         * storage. Fill entries are set to zero. The matrix must match the
+         * analysis.
+         */
+        void scatter(const SparseMatrix& matrix,
+                     std::vector<double>& values) const;
+
+        /** Return the number of rows. */
+        size_t n_rows() const;
+
+        /** Return the number of entries in the factor pattern. */
+        size_t n_nonzero_entries() const;
+
+        /** Return the fill-reducing permutation. */
+        const std::vector<size_t>& get_permutation() const;
+
+        /** Return the elimination tree. */
+        const std::vector<size_t>& elimination_tree() const;
+
+        /** Return the row offsets of the factor pattern. */
+        const size_t* row_offsets_data() const;
+
+        /** Return the column indices of the factor pattern. */
+        const unsigned int* colnums_data() const;
+
+        /** Return the offsets of the diagonal entries. */
+        const size_t* diagonal_offsets_data() const;
+      };
+    }
+  }
+}
+
+#endif //SYMBOLIC_FACTORIZATION_H
@@ -0,0 +1,121 @@
+#include "bicgstab.h"
+
+#include "vector.h"
+#include "vector_pool.h"
+#include "linear_operator.h"
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+
+#include <string>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+BiCGStab::BiCGStab(const Options& opts) :
+    IterativeSolverBase(opts, "BiCGStab")
+{}
+
+
+void
+BiCGStab::solve(Vector& x, const Vector& b) const
+{
+  const size_t n = A->n_rows();
+  assert(b.size() == n);
+  assert(x.size() == n);
+
+  const double norm = b.l2_norm();
+  if (norm == 0.0)
+  {
+    x = 0.0;
+    return;
+  }
+
+  // Check out the work vectors needed for the BiCGStab solver. Without a
+  // preconditioner, the preconditioned directions are the directions
+  // themselves.
+  ScratchVector r_work(n), r_hat_work(n), p_work(n), v_work(n), t_work(n);
+  ScratchVector p_hat_work(preconditioner ? n : 0);
+  ScratchVector s_hat_work(preconditioner ? n : 0);
+  Vector& r = *r_work;
+  Vector& r_hat = *r_hat_work;
+  Vector& p = *p_work;
+  Vector& v = *v_work;
+  Vector& t = *t_work;
+  Vector& p_hat = preconditioner ? *p_hat_work : p;
+  Vector& s_hat = preconditioner ? *s_hat_work : r;
+
+  // Initialize the residual and the shadow residual
+  if (x.n_nonzero_entries() > 0)
+  {
+    A->vmult(r, x);
+    r.sadd(-1.0, b);
+  }
+  else
+    r.equal(b);
+
+  if (r.l2_norm() / norm <= tolerance)
+    return;
+  r_hat = r;
+
+  double rho = 1.0, alpha = 1.0, omega = 1.0;
+
+  //======================================== Iteration loop
+  for (unsigned int nit = 0; nit < max_iterations; ++nit)
+  {
+    const double rho_new = r_hat.dot(r);
+    if (rho_new == 0.0)
+      throw std::runtime_error(
+          solver_name + ": Breakdown with an orthogonal shadow residual.");
+
+    // Update the search direction p = r + beta (p - omega v)
+    if (nit == 0)
+      p = r;
+    else
+    {
+      p.add(-omega, v);
+      p.sadd((rho_new / rho) * (alpha / omega), r);
+    }
+
+    // Biconjugate gradient step. The residual becomes the intermediate
+    // residual s = r - alpha A M^{-1} p.
+    if (preconditioner)
+      preconditioner->vmult(p_hat, p);
+    A->vmult(v, p_hat);
+    alpha = rho_new / r_hat.dot(v);
+    r.add(-alpha, v);
+
+    // Stop early if the intermediate residual has converged
+    const double s_norm = r.l2_norm();
+    if (s_norm / norm <= tolerance)
+    {
+      x.add(alpha, p_hat);
+      check(nit + 1, s_norm / norm);
+      return;
+    }
+
+    // Minimal residual step with t = A M^{-1} s
+    if (preconditioner)
+      preconditioner->vmult(s_hat, r);
+    A->vmult(t, s_hat);
+    omega = t.dot(r) / t.dot(t);
+
+    // Update the solution and the residual. The solution update must
+    // precede the residual update when the intermediate residual is not
+    // preconditioned since then s_hat is the residual.
+    x.add(alpha, p_hat);
+    x.add(omega, s_hat);
+    r.add(-omega, t);
+
+    if (check(nit + 1, r.l2_norm() / norm))
+      break;
+    if (omega == 0.0)
+      throw std::runtime_error(
+          solver_name + ": Breakdown with a zero stabilization parameter.");
+
+    rho = rho_new;
+  }
+}
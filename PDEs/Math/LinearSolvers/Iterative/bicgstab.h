@@ -0,0 +1,41 @@
+#ifndef BICGSTAB_H
+#define BICGSTAB_H
+
+#include "LinearSolvers/linear_solver.h"
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of the biconjugate gradient stabilized (BiCGStab)
+       * method.
+       *
+       * This is a short-recurrence Krylov method for non-symmetric matrices.
+       * Each iteration combines a biconjugate gradient step with a local
+       * residual minimizing step, which smooths the erratic convergence of
+       * the biconjugate gradient method. Unlike GMRES, the memory and the
+       * work per iteration are fixed, at the cost of two matrix-vector
+       * products per iteration and no guarantee of monotone convergence.
+       *
+       * The preconditioner, if any, is applied from the right so that the
+       * convergence check is on the residual of the original system.
+       *
+       * See more at https://en.wikipedia.org/wiki/Biconjugate_gradient_stabilized_method.
+       */
+      class BiCGStab : public IterativeSolverBase
+      {
+      public:
+        /** Default constructor. */
+        BiCGStab(const Options& opts = Options());
+
+        /** Solve the system using the BiCGStab method. */
+        void solve(Vector& x, const Vector& b) const override;
+      };
+    }
+  }
+}
+#endif //BICGSTAB_H
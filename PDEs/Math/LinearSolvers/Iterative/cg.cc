@@ -1,7 +1,9 @@
 #include "cg.h"
 
 #include "vector.h"
+#include "vector_pool.h"
 #include "Math/sparse_matrix.h"
+#include "LinearSolvers/Preconditioners/preconditioner.h"
 
 #include <cmath>
 #include <cassert>
@@ -26,14 +28,19 @@ CG::solve(Vector& x, const Vector& b) const
 
   double norm = b.l2_norm();
 
-  // Allocate data needed for the CG solver
-  Vector r(x.size());
-  Vector p(x.size());
-  Vector q(x.size());
+  // Check out the work vectors needed for the CG solver. Without a
+  // preconditioner, the preconditioned residual is the residual itself.
+  ScratchVector r_work(n), p_work(n), q_work(n);
+  ScratchVector z_work(preconditioner ? n : 0);
+  Vector& r = *r_work;
+  Vector& p = *p_work;
+  Vector& q = *q_work;
+  Vector& z = preconditioner ? *z_work : r;
 
   double alpha;
   double res;
-  double res_prev;
+  double rz;
+  double rz_prev;
 
   // Initialize residual, residual norms, and search directions.
   // If the residual norm is smaller than the tolerance, exit because
@@ -46,10 +53,14 @@ CG::solve(Vector& x, const Vector& b) const
   else
     r.equal(b);
 
-  res = res_prev = r.dot(r);
+  res = r.dot(r);
   if (res < tolerance)
     return;
-  p = r;
+
+  if (preconditioner)
+    preconditioner->vmult(z, r);
+  rz_prev = preconditioner ? r.dot(z) : res;
+  p = z;
 
   //======================================== Iteration loop
   size_t nit;
@@ -59,7 +70,7 @@ CG::solve(Vector& x, const Vector& b) const
     A->vmult(q, p);
 
     // Recompute alpha factor
-    alpha = res_prev / p.dot(q);
+    alpha = rz_prev / p.dot(q);
 
     // Update solution and residual vector
     x.add(alpha, p);
@@ -73,8 +84,12 @@ CG::solve(Vector& x, const Vector& b) const
     if (converged)
       break;
 
-    // If not converged, prep for next iteration
-    p.sadd(res / res_prev, r);
-    res_prev = res;
+    // If not converged, apply the preconditioner and prep for next iteration
+    if (preconditioner)
+      preconditioner->vmult(z, r);
+    rz = preconditioner ? r.dot(z) : res;
+
+    p.sadd(rz / rz_prev, z);
+    rz_prev = rz;
   }
 }
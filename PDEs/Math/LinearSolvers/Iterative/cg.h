@@ -18,6 +18,12 @@ namespace PDEs
        * constraint is imposed which requires that each subsequent search
        * direction be orthogonal to those prior.
        *
+       * When a preconditioner is set, this is the preconditioned conjugate
+       * gradient (PCG) method, where each residual \f$ r \f$ is replaced by
+       * \f$ z = M^{-1} r \f$ when forming the search directions. The
+       * preconditioner must then also be symmetric positive definite.
+       * Convergence is still checked on the unpreconditioned residual.
+       *
        * This method is only applicable for symmetric positive definite
        * matrices.
        *
@@ -0,0 +1,269 @@
+#include "chebyshev.h"
+
+#include "vector.h"
+#include "vector_pool.h"
+#include "linear_operator.h"
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+namespace
+{
+  /** The number of bisection steps for the tridiagonal eigenvalues. */
+  constexpr unsigned int n_bisection_steps = 100;
+
+
+  /**
+   * Return the number of eigenvalues smaller than \p x of the symmetric
+   * tridiagonal matrix with diagonal \p a and off-diagonal \p e, computed
+   * from the signs of the pivots of \f$ T - x I \f$ (Sturm sequence).
+   */
+  size_t
+  count_eigenvalues_below(const std::vector<double>& a,
+                          const std::vector<double>& e,
+                          const double x)
+  {
+    size_t count = 0;
+    double d = 1.0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+      d = a[i] - x - (i > 0 ? e[i - 1] * e[i - 1] / d : 0.0);
+      if (d == 0.0)
+        d = 1.0e-300;
+      if (d < 0.0)
+        ++count;
+    }
+    return count;
+  }
+
+
+  /**
+   * Return eigenvalue \p k, in increasing order and starting from one, of
+   * the symmetric tridiagonal matrix with diagonal \p a and off-diagonal
+   * \p e using bisection.
+   */
+  double
+  tridiagonal_eigenvalue(const std::vector<double>& a,
+                         const std::vector<double>& e,
+                         const size_t k)
+  {
+    // Bracket the spectrum with the Gershgorin circles
+    double lo = a[0], hi = a[0];
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+      const double radius = (i > 0 ? std::fabs(e[i - 1]) : 0.0) +
+                            (i + 1 < a.size() ? std::fabs(e[i]) : 0.0);
+      lo = std::min(lo, a[i] - radius);
+      hi = std::max(hi, a[i] + radius);
+    }
+
+    for (unsigned int it = 0; it < n_bisection_steps; ++it)
+    {
+      const double mid = 0.5 * (lo + hi);
+      if (count_eigenvalues_below(a, e, mid) >= k)
+        hi = mid;
+      else
+        lo = mid;
+    }
+    return 0.5 * (lo + hi);
+  }
+}
+
+
+std::pair<double, double>
+LinearSolvers::estimate_eigenvalues(const LinearOperator& A,
+                                    const Preconditioner* preconditioner,
+                                    const unsigned int n_steps)
+{
+  assert(n_steps > 0);
+
+  const size_t n = A.n_rows();
+  ScratchVector r_work(n), p_work(n), q_work(n);
+  ScratchVector z_work(preconditioner ? n : 0);
+  Vector& r = *r_work;
+  Vector& p = *p_work;
+  Vector& q = *q_work;
+  Vector& z = preconditioner ? *z_work : r;
+
+  // Start from a deterministic vector with components along all
+  // eigenvectors
+  for (size_t i = 0; i < n; ++i)
+    r[i] = static_cast<double>((i * 2654435761u) % 1024) / 1024.0 - 0.5;
+
+  if (preconditioner)
+    preconditioner->vmult(z, r);
+  double rz = r.dot(z);
+  p.equal(z);
+
+  // Conjugate gradient iterations, recording the Lanczos tridiagonal matrix
+  std::vector<double> diagonal, off_diagonal;
+  double alpha_prev = 0.0, beta_prev = 0.0;
+  for (unsigned int k = 0; k < n_steps && rz > 0.0; ++k)
+  {
+    A.vmult(q, p);
+    const double pq = p.dot(q);
+    if (pq <= 0.0)
+      break;
+
+    const double alpha = rz / pq;
+    diagonal.push_back(1.0 / alpha + (k > 0 ? beta_prev / alpha_prev : 0.0));
+
+    r.add(-alpha, q);
+    if (preconditioner)
+      preconditioner->vmult(z, r);
+    const double rz_new = r.dot(z);
+    const double beta = rz_new / rz;
+    off_diagonal.push_back(std::sqrt(std::max(beta, 0.0)) / alpha);
+
+    p.sadd(beta, z);
+    rz = rz_new;
+    alpha_prev = alpha;
+    beta_prev = beta;
+  }
+
+  if (diagonal.empty())
+    throw std::runtime_error(
+        "Eigenvalue estimation broke down in the first Lanczos step.");
+
+  return {tridiagonal_eigenvalue(diagonal, off_diagonal, 1),
+          tridiagonal_eigenvalue(diagonal, off_diagonal, diagonal.size())};
+}
+
+//######################################################################
+
+Chebyshev::Chebyshev(const Options& opts,
+                     const unsigned int n_lanczos_steps) :
+    IterativeSolverBase(opts, "Chebyshev"),
+    n_lanczos_steps(n_lanczos_steps)
+{}
+
+
+void
+Chebyshev::set_eigenvalue_bounds(const double lower, const double upper)
+{
+  assert(lower >= 0.0 && upper >= lower);
+  lower_bound = lower;
+  upper_bound = upper;
+}
+
+
+void
+Chebyshev::set_matrix(const SparseMatrix& matrix)
+{
+  IterativeSolverBase::set_matrix(matrix);
+  bounds_estimated = false;
+}
+
+
+void
+Chebyshev::set_operator(const LinearOperator& op)
+{
+  IterativeSolverBase::set_operator(op);
+  bounds_estimated = false;
+}
+
+
+void
+Chebyshev::set_preconditioner(std::shared_ptr<Preconditioner> pc)
+{
+  IterativeSolverBase::set_preconditioner(pc);
+  bounds_estimated = false;
+}
+
+
+void
+Chebyshev::solve(Vector& x, const Vector& b) const
+{
+  size_t n = A->n_rows();
+  assert(b.size() == n);
+  assert(x.size() == n);
+
+  // Estimate the eigenvalue bounds once per operator, if not specified
+  double lower = lower_bound, upper = upper_bound;
+  if (lower == 0.0 && upper == 0.0)
+  {
+    if (!bounds_estimated)
+    {
+      const auto bounds =
+          estimate_eigenvalues(*A, preconditioner.get(), n_lanczos_steps);
+      estimated_lower_bound = bounds.first;
+      estimated_upper_bound = 1.1 * bounds.second;
+      bounds_estimated = true;
+
+      if (verbosity > 0)
+        std::cout << solver_name << "::  Eigenvalue bounds   ["
+                  << estimated_lower_bound << ", "
+                  << estimated_upper_bound << "]\n";
+    }
+    lower = estimated_lower_bound;
+    upper = estimated_upper_bound;
+  }
+  assert(upper > lower && lower > 0.0);
+
+  const double theta = 0.5 * (upper + lower);
+  const double delta = 0.5 * (upper - lower);
+  const double sigma = theta / delta;
+
+  const double norm = b.l2_norm();
+  if (norm == 0.0)
+  {
+    x = 0.0;
+    return;
+  }
+
+  ScratchVector r_work(n), d_work(n), w_work(n);
+  ScratchVector z_work(preconditioner ? n : 0);
+  Vector& r = *r_work;
+  Vector& d = *d_work;
+  Vector& w = *w_work;
+  Vector& z = preconditioner ? *z_work : r;
+
+  // Initialize the residual and the first correction
+  if (x.n_nonzero_entries() > 0)
+  {
+    A->vmult(r, x);
+    r.sadd(-1.0, b);
+  }
+  else
+    r.equal(b);
+
+  if (r.l2_norm() / norm <= tolerance)
+    return;
+
+  if (preconditioner)
+    preconditioner->vmult(z, r);
+  d.equal(z, 1.0 / theta);
+
+  //======================================== Iteration loop
+  double rho = 1.0 / sigma;
+  for (size_t nit = 0; nit < max_iterations; ++nit)
+  {
+    // Update the solution and the residual
+    x.add(1.0, d);
+    A->vmult(w, d);
+    r.add(-1.0, w);
+
+    // Check convergence
+    if (check(nit + 1, r.l2_norm() / norm))
+      break;
+
+    // Update the correction with the Chebyshev recurrence
+    if (preconditioner)
+      preconditioner->vmult(z, r);
+
+    const double rho_new = 1.0 / (2.0 * sigma - rho);
+    d.sadd(rho_new * rho, 2.0 * rho_new / delta, z);
+    rho = rho_new;
+  }
+}
@@ -0,0 +1,124 @@
+#ifndef CHEBYSHEV_ITERATION_H
+#define CHEBYSHEV_ITERATION_H
+
+#include "LinearSolvers/linear_solver.h"
+
+#include <utility>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Estimate the smallest and largest eigenvalues of \f$ M^{-1} A \f$
+       * with \p n_steps steps of the Lanczos method, where \f$ M \f$ is the
+       * \p preconditioner, or the identity if it is null.
+       *
+       * The Lanczos tridiagonal matrix is obtained from the coefficients of
+       * preconditioned conjugate gradient iterations and its extreme
+       * eigenvalues are computed by bisection. These converge to the extreme
+       * eigenvalues from the inside of the spectrum, the largest one within
+       * a few percent after ten or so steps. This requires \f$ A \f$ and
+       * \f$ M \f$ to be symmetric positive definite. For other matrices, the
+       * iterations are stopped at a breakdown and the estimates are only
+       * approximate.
+       */
+      std::pair<double, double>
+      estimate_eigenvalues(const LinearOperator& A,
+                           const Preconditioner* preconditioner,
+                           const unsigned int n_steps = 10);
+
+      //############################################################
+
+      /**
+       * Implementation of the Chebyshev semi-iterative method.
+       *
+       * Given an interval \f$ [\lambda_{min}, \lambda_{max}] \f$ containing
+       * the eigenvalues of \f$ M^{-1} A \f$, the residual polynomial after
+       * \f$ k \f$ iterations is the scaled and shifted Chebyshev polynomial
+       * which is smallest on the interval, so that the error is reduced by
+       * at least a factor \f$ 1 / T_k(\sigma) \f$ with \f$ \sigma =
+       * (\lambda_{max} + \lambda_{min}) / (\lambda_{max} - \lambda_{min})
+       * \f$. The iterates follow from the three-term recurrence of the
+       * Chebyshev polynomials.
+       *
+       * Unlike the conjugate gradient method, the iteration requires no
+       * inner products, only matrix-vector products and applications of the
+       * preconditioner, and is therefore free of global reductions. The only
+       * reduction per iteration is the residual norm for the convergence
+       * check. The price is that eigenvalue bounds must be known. Unless set
+       * with \ref set_eigenvalue_bounds, they are estimated with \ref
+       * estimate_eigenvalues in the first solve after the operator or the
+       * preconditioner is set and reused until either is set again. The
+       * upper bound is enlarged by 10% as a safety margin. The smallest eigenvalue is
+       * resolved much more slowly by the Lanczos method than the largest, so
+       * for ill-conditioned systems its estimate is too large and the
+       * smallest eigenmodes converge slowly. The method is therefore best
+       * combined with a strong preconditioner, such as multigrid, or with
+       * bounds known a priori.
+       *
+       * The preconditioner, if any, is applied to each residual. This is
+       * intended for symmetric positive definite systems.
+       *
+       * See more at https://en.wikipedia.org/wiki/Chebyshev_iteration.
+       */
+      class Chebyshev : public IterativeSolverBase
+      {
+      private:
+        const unsigned int n_lanczos_steps;
+
+        /** The eigenvalue bounds. These are estimated when zero. */
+        double lower_bound = 0.0;
+        double upper_bound = 0.0;
+
+        /**
+         * The estimated eigenvalue bounds, which are valid when
+         * \p bounds_estimated is set.
+         */
+        mutable double estimated_lower_bound = 0.0;
+        mutable double estimated_upper_bound = 0.0;
+        mutable bool bounds_estimated = false;
+
+      public:
+        /**
+         * Default constructor. The eigenvalue bounds are estimated with
+         * \p n_lanczos_steps Lanczos steps.
+         */
+        Chebyshev(const Options& opts = Options(),
+                  const unsigned int n_lanczos_steps = 10);
+
+        /**
+         * Set the bounds on the eigenvalues of the preconditioned matrix.
+         * Setting both to zero restores the estimation.
+         */
+        void set_eigenvalue_bounds(const double lower, const double upper);
+
+        /**
+         * Attach the sparse matrix. This discards the estimated eigenvalue
+         * bounds.
+         */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /**
+         * Attach a generic linear operator. This discards the estimated
+         * eigenvalue bounds.
+         */
+        void set_operator(const LinearOperator& op) override;
+
+        /**
+         * Set the preconditioner. This discards the estimated eigenvalue
+         * bounds.
+         */
+        void
+        set_preconditioner(std::shared_ptr<Preconditioner> pc) override;
+
+        /** Solve the system using the Chebyshev iteration. */
+        void solve(Vector& x, const Vector& b) const override;
+      };
+    }
+  }
+}
+#endif //CHEBYSHEV_ITERATION_H
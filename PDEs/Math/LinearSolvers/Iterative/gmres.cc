@@ -0,0 +1,158 @@
+#include "gmres.h"
+
+#include "vector.h"
+#include "vector_pool.h"
+#include "linear_operator.h"
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+GMRES::GMRES(const unsigned int restart, const Options& opts) :
+    IterativeSolverBase(opts, "GMRES"), restart(restart)
+{
+  assert(restart > 0);
+}
+
+
+void
+GMRES::solve(Vector& x, const Vector& b) const
+{
+  const size_t n = A->n_rows();
+  const size_t m = restart;
+  assert(b.size() == n);
+  assert(x.size() == n);
+
+  const double norm = b.l2_norm();
+  if (norm == 0.0)
+  {
+    x = 0.0;
+    return;
+  }
+
+  // Check out the Krylov basis and the work vectors. Without a
+  // preconditioner, basis vectors are multiplied directly.
+  std::deque<ScratchVector> basis;
+  for (size_t i = 0; i <= m; ++i)
+    basis.emplace_back(n);
+  ScratchVector z_work(preconditioner ? n : 0);
+
+  // The Hessenberg matrix, stored column-wise, the Givens rotations, and
+  // the rotated right-hand side of the least squares problem
+  std::vector<double> h((m + 1) * m);
+  std::vector<double> cs(m), sn(m), g(m + 1), y(m);
+  const auto h_ij = [&](const size_t i, const size_t j) -> double&
+  { return h[j * (m + 1) + i]; };
+
+  //======================================== Restart loop
+  unsigned int nit = 0;
+  bool converged = false;
+  while (!converged)
+  {
+    // Compute the residual, the first basis vector, and the initial
+    // right-hand side of the least squares problem
+    Vector& r = *basis[0];
+    if (x.n_nonzero_entries() > 0)
+    {
+      A->vmult(r, x);
+      r.sadd(-1.0, b);
+    }
+    else
+      r.equal(b);
+
+    const double beta = r.l2_norm();
+    if (beta / norm <= tolerance)
+      return;
+
+    r /= beta;
+    std::fill(g.begin(), g.end(), 0.0);
+    g[0] = beta;
+
+    //======================================== Arnoldi iterations
+    size_t k = 0;
+    while (k < m)
+    {
+      const size_t j = k++;
+
+      // Compute the next basis vector w = A M^{-1} v_j
+      Vector& w = *basis[j + 1];
+      if (preconditioner)
+      {
+        preconditioner->vmult(*z_work, *basis[j]);
+        A->vmult(w, *z_work);
+      }
+      else
+        A->vmult(w, *basis[j]);
+
+      // Orthogonalize against the previous basis vectors with modified
+      // Gram-Schmidt
+      for (size_t i = 0; i <= j; ++i)
+      {
+        h_ij(i, j) = w.dot(*basis[i]);
+        w.add(-h_ij(i, j), *basis[i]);
+      }
+      const double w_norm = w.l2_norm();
+      h_ij(j + 1, j) = w_norm;
+      if (w_norm > 0.0)
+        w /= w_norm;
+
+      // Apply the previous Givens rotations to the new column
+      for (size_t i = 0; i < j; ++i)
+      {
+        const double h_0 = h_ij(i, j), h_1 = h_ij(i + 1, j);
+        h_ij(i, j) = cs[i] * h_0 + sn[i] * h_1;
+        h_ij(i + 1, j) = -sn[i] * h_0 + cs[i] * h_1;
+      }
+
+      // Compute and apply the new rotation which eliminates the
+      // subdiagonal entry
+      const double denom = std::hypot(h_ij(j, j), h_ij(j + 1, j));
+      cs[j] = h_ij(j, j) / denom;
+      sn[j] = h_ij(j + 1, j) / denom;
+      h_ij(j, j) = denom;
+      h_ij(j + 1, j) = 0.0;
+
+      g[j + 1] = -sn[j] * g[j];
+      g[j] *= cs[j];
+
+      // Check convergence. A zero subdiagonal entry indicates that the
+      // solution lies in the current subspace.
+      converged = check(++nit, std::fabs(g[j + 1]) / norm);
+      if (converged || w_norm == 0.0)
+        break;
+    }
+
+    // Solve the upper triangular system H y = g
+    for (size_t i = k; i-- > 0;)
+    {
+      double value = g[i];
+      for (size_t l = i + 1; l < k; ++l)
+        value -= h_ij(i, l) * y[l];
+      y[i] = value / h_ij(i, i);
+    }
+
+    // Update the solution with x = x + M^{-1} V y. The first basis vector
+    // is no longer needed and holds the correction.
+    Vector& u = *basis[0];
+    u.scale(y[0]);
+    for (size_t i = 1; i < k; ++i)
+      u.add(y[i], *basis[i]);
+
+    if (preconditioner)
+    {
+      preconditioner->vmult(*z_work, u);
+      x.add(1.0, *z_work);
+    }
+    else
+      x.add(1.0, u);
+  }
+}
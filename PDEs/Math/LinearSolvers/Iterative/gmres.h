@@ -0,0 +1,51 @@
+#ifndef GMRES_H
+#define GMRES_H
+
+#include "LinearSolvers/linear_solver.h"
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of the restarted generalized minimal residual method,
+       * GMRES(\f$ m \f$).
+       *
+       * Each cycle builds an orthonormal basis of the Krylov subspace
+       * \f$ \mathcal{K}_m(A M^{-1}, r_0) \f$ with the Arnoldi process using
+       * modified Gram-Schmidt orthogonalization. The resulting upper
+       * Hessenberg matrix is reduced to upper triangular form with Givens
+       * rotations as it is built, which yields the residual norm of each
+       * iteration without forming the iterate. After \f$ m \f$ iterations,
+       * the iterate is formed, the residual is recomputed, and the process
+       * restarts.
+       *
+       * The preconditioner, if any, is applied from the right, i.e. the
+       * system \f$ A M^{-1} u = b \f$ with \f$ x = M^{-1} u \f$ is solved.
+       * The minimized residual is therefore that of the original system.
+       *
+       * This method is applicable to general non-singular matrices.
+       *
+       * See more at https://en.wikipedia.org/wiki/Generalized_minimal_residual_method.
+       */
+      class GMRES : public IterativeSolverBase
+      {
+      protected:
+        /** The number of iterations between restarts. */
+        const unsigned int restart;
+
+      public:
+        /** Default constructor. */
+        GMRES(const unsigned int restart = 30,
+              const Options& opts = Options());
+
+        /** Solve the system using the GMRES method. */
+        void solve(Vector& x, const Vector& b) const override;
+      };
+    }
+  }
+}
+#endif //GMRES_H
@@ -1,6 +1,7 @@
 #include "jacobi.h"
 
 #include "vector.h"
+#include "vector_pool.h"
 #include "sparse_matrix.h"
 
 #include <cassert>
@@ -20,13 +21,17 @@ Jacobi::Jacobi(const Options& opts) :
 void
 Jacobi::solve(Vector& x, const Vector& b) const
 {
-  size_t n = A->n_rows();
+  const SparseMatrix& matrix = sparse_matrix();
+
+  size_t n = matrix.n_rows();
   assert(b.size() == n);
   assert(x.size() == n);
 
   size_t nit;
   double change;
-  Vector x_ell = x;
+  ScratchVector x_ell_work(n);
+  Vector& x_ell = *x_ell_work;
+  x_ell = x;
 
   // Iteration loop
   for (nit = 0; nit < max_iterations; ++nit)
@@ -36,10 +41,10 @@ Jacobi::solve(Vector& x, const Vector& b) const
     {
       // Compute element-wise update
       double value = b[i];
-      for (const auto el: A->row_iterator(i))
+      for (const auto el: matrix.row_iterator(i))
         if (el.column != i)
           value -= el.value * x_ell[el.column];
-      value /= A->diag(i);
+      value /= matrix.diag(i);
 
       // Increment difference
       change += std::fabs(value - x_ell[i]) / std::fabs(b[i]);
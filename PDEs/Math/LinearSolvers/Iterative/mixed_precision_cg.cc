@@ -0,0 +1,65 @@
+#include "mixed_precision_cg.h"
+
+#include "vector.h"
+#include "vector_pool.h"
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+MixedPrecisionCG::MixedPrecisionCG(const Options& opts,
+                                   const double inner_tolerance,
+                                   const unsigned int max_inner_iterations) :
+    MixedPrecisionSolverBase(opts, inner_tolerance,
+                             max_inner_iterations, "Mixed Precision CG")
+{}
+
+
+void
+MixedPrecisionCG::inner_solve(Vector& d, const Vector& r) const
+{
+  const size_t n = r.size();
+
+  // Without a preconditioner, the preconditioned residual is the residual
+  ScratchVector s_work(n), p_work(n), q_work(n);
+  ScratchVector z_work(preconditioner ? n : 0);
+  Vector& s = *s_work;
+  Vector& p = *p_work;
+  Vector& q = *q_work;
+  Vector& z = preconditioner ? *z_work : s;
+
+  d = 0.0;
+  s.equal(r);
+  if (preconditioner)
+    preconditioner->vmult(z, s);
+  p.equal(z);
+
+  double res = s.dot(s);
+  double sz_prev = preconditioner ? s.dot(z) : res;
+  const double target = inner_tolerance * inner_tolerance * res;
+
+  for (unsigned int k = 0; k < max_inner_iterations; ++k)
+  {
+    A_float.vmult(q, p);
+
+    const double alpha = sz_prev / p.dot(q);
+    d.add(alpha, p);
+    s.add(-alpha, q);
+
+    res = s.dot(s);
+    if (res <= target)
+      break;
+
+    if (preconditioner)
+      preconditioner->vmult(z, s);
+    const double sz = preconditioner ? s.dot(z) : res;
+
+    p.sadd(sz / sz_prev, z);
+    sz_prev = sz;
+  }
+}
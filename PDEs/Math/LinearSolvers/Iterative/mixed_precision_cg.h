@@ -0,0 +1,41 @@
+#ifndef MIXED_PRECISION_CG_H
+#define MIXED_PRECISION_CG_H
+
+#include "mixed_precision_solver.h"
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of a mixed precision conjugate gradient (CG) method.
+       *
+       * This is an iterative refinement scheme, see MixedPrecisionSolverBase,
+       * whose corrections are computed with preconditioned CG on the single
+       * precision matrix.
+       *
+       * This method is only applicable for symmetric positive definite
+       * matrices and preconditioners.
+       */
+      class MixedPrecisionCG : public MixedPrecisionSolverBase
+      {
+      public:
+        /** Default constructor. See MixedPrecisionSolverBase. */
+        MixedPrecisionCG(const Options& opts = Options(),
+                         const double inner_tolerance = 1.0e-3,
+                         const unsigned int max_inner_iterations = 500);
+
+      protected:
+        /**
+         * Approximately solve \f$ A d = r \f$ with preconditioned CG and the
+         * single precision matrix, starting from a zero initial guess.
+         */
+        void inner_solve(Vector& d, const Vector& r) const override;
+      };
+    }
+  }
+}
+#endif //MIXED_PRECISION_CG_H
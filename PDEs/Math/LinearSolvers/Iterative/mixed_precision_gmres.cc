@@ -0,0 +1,145 @@
+#include "mixed_precision_gmres.h"
+
+#include "vector.h"
+#include "vector_pool.h"
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+MixedPrecisionGMRES::
+MixedPrecisionGMRES(const unsigned int restart,
+                    const Options& opts,
+                    const double inner_tolerance,
+                    const unsigned int max_inner_iterations) :
+    MixedPrecisionSolverBase(opts, inner_tolerance,
+                             max_inner_iterations, "Mixed Precision GMRES"),
+    restart(restart)
+{
+  assert(restart > 0);
+}
+
+
+void
+MixedPrecisionGMRES::inner_solve(Vector& d, const Vector& r) const
+{
+  const size_t n = r.size();
+  const size_t m = restart;
+
+  // Check out the Krylov basis and the work vectors. See GMRES::solve.
+  std::deque<ScratchVector> basis;
+  for (size_t i = 0; i <= m; ++i)
+    basis.emplace_back(n);
+  ScratchVector z_work(preconditioner ? n : 0);
+
+  std::vector<double> h((m + 1) * m);
+  std::vector<double> cs(m), sn(m), g(m + 1), y(m);
+  const auto h_ij = [&](const size_t i, const size_t j) -> double&
+  { return h[j * (m + 1) + i]; };
+
+  const double target = inner_tolerance * r.l2_norm();
+
+  d = 0.0;
+  unsigned int nit = 0;
+  bool converged = false;
+  while (!converged && nit < max_inner_iterations)
+  {
+    // Residual of the correction equation
+    Vector& s = *basis[0];
+    if (nit > 0)
+    {
+      A_float.vmult(s, d);
+      s.sadd(-1.0, r);
+    }
+    else
+      s.equal(r);
+
+    const double beta = s.l2_norm();
+    if (beta <= target)
+      return;
+
+    s /= beta;
+    std::fill(g.begin(), g.end(), 0.0);
+    g[0] = beta;
+
+    //======================================== Arnoldi iterations
+    size_t k = 0;
+    while (k < m && nit < max_inner_iterations)
+    {
+      const size_t j = k++;
+      ++nit;
+
+      // Compute the next basis vector w = A M^{-1} v_j
+      Vector& w = *basis[j + 1];
+      if (preconditioner)
+      {
+        preconditioner->vmult(*z_work, *basis[j]);
+        A_float.vmult(w, *z_work);
+      }
+      else
+        A_float.vmult(w, *basis[j]);
+
+      for (size_t i = 0; i <= j; ++i)
+      {
+        h_ij(i, j) = w.dot(*basis[i]);
+        w.add(-h_ij(i, j), *basis[i]);
+      }
+      const double w_norm = w.l2_norm();
+      h_ij(j + 1, j) = w_norm;
+      if (w_norm > 0.0)
+        w /= w_norm;
+
+      for (size_t i = 0; i < j; ++i)
+      {
+        const double h_0 = h_ij(i, j), h_1 = h_ij(i + 1, j);
+        h_ij(i, j) = cs[i] * h_0 + sn[i] * h_1;
+        h_ij(i + 1, j) = -sn[i] * h_0 + cs[i] * h_1;
+      }
+
+      const double denom = std::hypot(h_ij(j, j), h_ij(j + 1, j));
+      cs[j] = h_ij(j, j) / denom;
+      sn[j] = h_ij(j + 1, j) / denom;
+      h_ij(j, j) = denom;
+      h_ij(j + 1, j) = 0.0;
+
+      g[j + 1] = -sn[j] * g[j];
+      g[j] *= cs[j];
+
+      converged = std::fabs(g[j + 1]) <= target;
+      if (converged || w_norm == 0.0)
+        break;
+    }
+
+    // Solve the upper triangular system H y = g
+    for (size_t i = k; i-- > 0;)
+    {
+      double value = g[i];
+      for (size_t l = i + 1; l < k; ++l)
+        value -= h_ij(i, l) * y[l];
+      y[i] = value / h_ij(i, i);
+    }
+
+    // Update the correction with d = d + M^{-1} V y
+    Vector& u = *basis[0];
+    u.scale(y[0]);
+    for (size_t i = 1; i < k; ++i)
+      u.add(y[i], *basis[i]);
+
+    if (preconditioner)
+    {
+      preconditioner->vmult(*z_work, u);
+      d.add(1.0, *z_work);
+    }
+    else
+      d.add(1.0, u);
+  }
+}
@@ -0,0 +1,47 @@
+#ifndef MIXED_PRECISION_GMRES_H
+#define MIXED_PRECISION_GMRES_H
+
+#include "mixed_precision_solver.h"
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of a mixed precision restarted generalized minimal
+       * residual method, GMRES(\f$ m \f$).
+       *
+       * This is an iterative refinement scheme, see MixedPrecisionSolverBase,
+       * whose corrections are computed with GMRES(\f$ m \f$) on the single
+       * precision matrix. As in GMRES, the preconditioner, if any, is applied
+       * from the right.
+       *
+       * This method is applicable to general non-singular matrices.
+       */
+      class MixedPrecisionGMRES : public MixedPrecisionSolverBase
+      {
+      protected:
+        /** The number of inner iterations between restarts. */
+        const unsigned int restart;
+
+      public:
+        /** Default constructor. See MixedPrecisionSolverBase. */
+        MixedPrecisionGMRES(const unsigned int restart = 30,
+                            const Options& opts = Options(),
+                            const double inner_tolerance = 1.0e-3,
+                            const unsigned int max_inner_iterations = 500);
+
+      protected:
+        /**
+         * Approximately solve \f$ A d = r \f$ with GMRES(\f$ m \f$) and the
+         * single precision matrix, starting from a zero initial guess.
+         */
+        void inner_solve(Vector& d, const Vector& r) const override;
+      };
+    }
+  }
+}
+#endif //MIXED_PRECISION_GMRES_H
@@ -0,0 +1,73 @@
+#include "mixed_precision_solver.h"
+
+#include "vector.h"
+#include "vector_pool.h"
+#include "Math/sparse_matrix.h"
+
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+MixedPrecisionSolverBase::
+MixedPrecisionSolverBase(const Options& opts,
+                         const double inner_tolerance,
+                         const unsigned int max_inner_iterations,
+                         const std::string name) :
+    IterativeSolverBase(opts, name),
+    inner_tolerance(inner_tolerance),
+    max_inner_iterations(max_inner_iterations)
+{ assert(inner_tolerance > 0.0 && inner_tolerance < 1.0); }
+
+
+void
+MixedPrecisionSolverBase::set_matrix(const SparseMatrix& matrix)
+{
+  IterativeSolverBase::set_matrix(matrix);
+  A_float.reinit(matrix);
+}
+
+
+void
+MixedPrecisionSolverBase::solve(Vector& x, const Vector& b) const
+{
+  const SparseMatrix& matrix = sparse_matrix();
+
+  size_t n = matrix.n_rows();
+  assert(b.size() == n);
+  assert(x.size() == n);
+
+  const double norm = b.l2_norm();
+  if (norm == 0.0)
+  {
+    x = 0.0;
+    return;
+  }
+
+  ScratchVector r_work(n), d_work(n);
+  Vector& r = *r_work;
+  Vector& d = *d_work;
+
+  //======================================== Refinement loop
+  for (unsigned int nit = 0; nit < max_iterations; ++nit)
+  {
+    // Double precision residual r = b - Ax. The zeroth iteration checks
+    // whether the initial guess is the solution.
+    A->vmult(r, x);
+    r.sadd(-1.0, b);
+    if (check(nit, r.l2_norm() / norm))
+      return;
+
+    // Single precision correction
+    inner_solve(d, r);
+    x.add(1.0, d);
+  }
+
+  // This throws if the final iterate has not converged
+  A->vmult(r, x);
+  r.sadd(-1.0, b);
+  check(max_iterations, r.l2_norm() / norm);
+}
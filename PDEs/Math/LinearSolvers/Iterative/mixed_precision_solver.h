@@ -0,0 +1,77 @@
+#ifndef MIXED_PRECISION_SOLVER_H
+#define MIXED_PRECISION_SOLVER_H
+
+#include "LinearSolvers/linear_solver.h"
+#include "Math/float_sparse_matrix.h"
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * A base class for mixed precision iterative refinement solvers.
+       *
+       * The outer iterations compute the residual \f$ r = b - A x \f$ with
+       * the double precision matrix and check convergence on it. The
+       * correction \f$ A d = r \f$ is then solved approximately by a Krylov
+       * method using a single precision copy of the matrix, see
+       * FloatSparseMatrix, and added to the solution. Since the inner
+       * iterations dominate the cost and only stream single precision values,
+       * the memory traffic is substantially reduced while the final accuracy
+       * is that of a double precision solve.
+       *
+       * The preconditioner, if any, is built from the double precision
+       * matrix and applied within the inner iterations.
+       *
+       * Derived classes implement the inner solve. A SparseMatrix must be
+       * attached.
+       */
+      class MixedPrecisionSolverBase : public IterativeSolverBase
+      {
+      protected:
+        /** The single precision copy of the attached matrix. */
+        FloatSparseMatrix A_float;
+
+        /**
+         * The relative residual reduction of each inner single precision
+         * solve.
+         */
+        const double inner_tolerance;
+
+        /** The maximum number of iterations of each inner solve. */
+        const unsigned int max_inner_iterations;
+
+      public:
+        /**
+         * Default constructor. The \p max_iterations of the options limits
+         * the number of outer refinement iterations.
+         */
+        MixedPrecisionSolverBase(const Options& opts,
+                                 const double inner_tolerance,
+                                 const unsigned int max_inner_iterations,
+                                 const std::string name);
+
+        /**
+         * Attach the sparse matrix to the solver and build its single
+         * precision copy. This must be called again after the matrix is
+         * modified.
+         */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /** Solve the system with mixed precision iterative refinement. */
+        void solve(Vector& x, const Vector& b) const override;
+
+      protected:
+        /**
+         * Approximately solve \f$ A d = r \f$ with the single precision
+         * matrix, starting from a zero initial guess.
+         */
+        virtual void inner_solve(Vector& d, const Vector& r) const = 0;
+      };
+    }
+  }
+}
+#endif //MIXED_PRECISION_SOLVER_H
@@ -0,0 +1,105 @@
+#include "multicolor_relaxation.h"
+
+#include "vector.h"
+#include "ordering.h"
+#include "multithreading.h"
+#include "Math/sparse_matrix.h"
+
+#include <string>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+void
+MulticolorRelaxation::reinit(const SparseMatrix& matrix)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+
+  n = matrix.n_rows();
+  rows = Ordering::multicolor(matrix, color_offsets);
+
+  row_offsets.assign(n + 1, 0);
+  colnums.clear();
+  values.clear();
+  colnums.reserve(matrix.n_nonzero_entries());
+  values.reserve(matrix.n_nonzero_entries());
+  inverse_diagonal.assign(n, 0.0);
+  for (size_t k = 0; k < n; ++k)
+  {
+    const size_t i = rows[k];
+    double a_ii = 0.0;
+    if (matrix.row_length(i) > 0)
+      for (const auto el: matrix.row_iterator(i))
+      {
+        if (el.column == i)
+          a_ii = el.value;
+        else
+        {
+          colnums.push_back(el.column);
+          values.push_back(el.value);
+        }
+      }
+    row_offsets[k + 1] = values.size();
+
+    if (a_ii == 0.0)
+      throw std::runtime_error(
+          "MulticolorRelaxation: Zero diagonal entry in row " +
+          std::to_string(i) + ".");
+    inverse_diagonal[k] = 1.0 / a_ii;
+  }
+}
+
+
+size_t
+MulticolorRelaxation::n_colors() const
+{
+  return color_offsets.empty() ? 0 : color_offsets.size() - 1;
+}
+
+
+void
+MulticolorRelaxation::sweep(Vector& x,
+                            const Vector& b,
+                            const double omega,
+                            const bool forward) const
+{
+  assert(x.size() == n);
+  assert(b.size() == n);
+
+  const size_t* ptr = row_offsets.data();
+  const unsigned int* cols = colnums.data();
+  const double* vals = values.data();
+  const double* d_inv = inverse_diagonal.data();
+  const size_t* row = rows.data();
+  const double* b_ptr = b.data();
+  double* x_ptr = x.data();
+
+  const size_t n_c = n_colors();
+  const int n_threads = MultiThreading::n_threads(values.size() + n);
+
+  // The rows of each color only depend on rows of other colors, so each
+  // color is relaxed concurrently with a synchronization between colors
+  #pragma omp parallel num_threads(n_threads)
+  for (size_t c = 0; c < n_c; ++c)
+  {
+    const size_t color = forward ? c : n_c - 1 - c;
+    const long begin = static_cast<long>(color_offsets[color]);
+    const long end = static_cast<long>(color_offsets[color + 1]);
+
+    #pragma omp for schedule(static)
+    for (long k = begin; k < end; ++k)
+    {
+      double value = b_ptr[row[k]];
+      for (size_t p = ptr[k]; p < ptr[k + 1]; ++p)
+        value -= vals[p] * x_ptr[cols[p]];
+
+      double& x_i = x_ptr[row[k]];
+      x_i += omega * (value * d_inv[k] - x_i);
+    }
+  }
+}
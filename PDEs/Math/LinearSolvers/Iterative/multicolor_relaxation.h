@@ -0,0 +1,84 @@
+#ifndef MULTICOLOR_RELAXATION_H
+#define MULTICOLOR_RELAXATION_H
+
+#include <vector>
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class Vector;
+    class SparseMatrix;
+
+
+    namespace LinearSolvers
+    {
+      /**
+       * Parallel Gauss-Seidel and SOR sweeps with a multicolor ordering.
+       *
+       * The rows are colored with Ordering::multicolor so that rows of the
+       * same color are not coupled. A sweep relaxes the colors one after
+       * another and the rows within each color concurrently, so, unlike a
+       * sweep in natural order, it scales with the number of threads. For
+       * 5-point stencils on orthogonal meshes, this is red-black
+       * Gauss-Seidel.
+       *
+       * The off-diagonal entries are copied into compressed storage in the
+       * colored row order with the inverse diagonal split out ahead of time,
+       * so the inner loop has no branch and each color is a contiguous range
+       * of rows. A backward sweep visits the colors in reverse order, so a
+       * forward sweep followed by a backward sweep is a symmetric operator
+       * for symmetric matrices.
+       */
+      class MulticolorRelaxation
+      {
+      private:
+        size_t n = 0;
+
+        /**
+         * The rows grouped by color. The rows of color \p c lie in
+         * <tt>[color_offsets[c], color_offsets[c + 1])</tt> of \p rows.
+         */
+        std::vector<size_t> color_offsets;
+        std::vector<size_t> rows;
+
+        /** The off-diagonal entries of the rows in colored order. */
+        std::vector<size_t> row_offsets;
+        std::vector<unsigned int> colnums;
+        std::vector<double> values;
+
+        /** The inverse of the diagonal entries in colored order. */
+        std::vector<double> inverse_diagonal;
+
+      public:
+        /** Default constructor. */
+        MulticolorRelaxation() = default;
+
+        /**
+         * Color \p matrix and copy its entries. An error is thrown if a
+         * diagonal entry is zero.
+         */
+        void reinit(const SparseMatrix& matrix);
+
+        /** Return the number of colors. */
+        size_t n_colors() const;
+
+        /**
+         * Apply a relaxation sweep to \f$ A x = b \f$ with relaxation
+         * parameter \p omega, i.e. for each row \f$ x_i \leftarrow (1 -
+         * \omega) x_i + \omega a_{ii}^{-1} (b_i - \sum_{j \neq i} a_{ij}
+         * x_j) \f$. The colors are visited in increasing order if
+         * \p forward is set, otherwise in decreasing order.
+         */
+        void sweep(Vector& x,
+                   const Vector& b,
+                   const double omega = 1.0,
+                   const bool forward = true) const;
+      };
+    }
+  }
+}
+#endif //MULTICOLOR_RELAXATION_H
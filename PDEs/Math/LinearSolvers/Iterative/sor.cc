@@ -1,6 +1,8 @@
 #include "sor.h"
 
 #include "vector.h"
+#include "vector_pool.h"
+#include "multithreading.h"
 #include "Math/sparse_matrix.h"
 
 #include <cmath>
@@ -12,6 +14,59 @@ using namespace Math;
 using namespace LinearSolvers;
 
 
+namespace
+{
+  /**
+   * Return the change between iterates used by the SOR convergence checks,
+   * \f$ \sum_i |x_i - x^\ell_i| / |b_i| \f$.
+   */
+  double
+  compute_change(const Vector& x, const Vector& x_ell, const Vector& b)
+  {
+    const long n = static_cast<long>(x.size());
+    const int n_threads = MultiThreading::n_threads(x.size());
+
+    double change = 0.0;
+    #pragma omp parallel for num_threads(n_threads) schedule(static) \
+            reduction(+: change)
+    for (long i = 0; i < n; ++i)
+      change += std::fabs(x[i] - x_ell[i]) / std::fabs(b[i]);
+    return change;
+  }
+}
+
+
+void
+LinearSolvers::gauss_seidel_sweep(const SparseMatrix& matrix,
+                                  const Vector& inverse_diagonal,
+                                  Vector& x,
+                                  const Vector& b,
+                                  const bool forward)
+{
+  const size_t n = matrix.n_rows();
+  assert(inverse_diagonal.size() == n);
+  assert(x.size() == n);
+  assert(b.size() == n);
+
+  const auto relax = [&](const size_t i)
+  {
+    double value = b[i];
+    for (const auto el: matrix.row_iterator(i))
+      if (el.column != i)
+        value -= el.value * x[el.column];
+    x[i] = value * inverse_diagonal[i];
+  };
+
+  if (forward)
+    for (size_t i = 0; i < n; ++i)
+      relax(i);
+  else
+    for (size_t i = n; i-- > 0;)
+      relax(i);
+}
+
+//######################################################################
+
 SOR::SOR(const double omega,
          const Options& opts,
          const std::string solver_name) :
@@ -29,10 +84,24 @@ SSOR::SSOR(const double omega, const Options& opts) :
 {}
 
 
+MulticolorSOR::MulticolorSOR(const double omega,
+                             const Options& opts,
+                             const std::string solver_name) :
+    SOR(omega, opts, solver_name)
+{}
+
+
+MulticolorSSOR::MulticolorSSOR(const double omega, const Options& opts) :
+    MulticolorSOR(omega, opts, "Multicolor SSOR")
+{}
+
+
 void
 SOR::solve(Vector& x, const Vector& b) const
 {
-  size_t n = A->n_rows();
+  const SparseMatrix& matrix = sparse_matrix();
+
+  size_t n = matrix.n_rows();
   assert(b.size() == n);
   assert(x.size() == n);
 
@@ -43,15 +112,15 @@ SOR::solve(Vector& x, const Vector& b) const
   for (nit = 0; nit < max_iterations; ++nit)
   {
     change = 0.0;
-    for (size_t i = 0; i < A->n_rows(); ++i)
+    for (size_t i = 0; i < n; ++i)
     {
       // Compute element-wise update
       double value = 0.0;
-      for (const auto el: A->row_iterator(i))
+      for (const auto el: matrix.row_iterator(i))
         if (el.column != i)
           value += el.value * x[el.column];
 
-      double a_ii = A->diag(i);
+      double a_ii = matrix.diag(i);
       value = x[i] + omega * ((b[i] - value) / a_ii - x[i]);
 
       // Increment difference
@@ -69,13 +138,17 @@ SOR::solve(Vector& x, const Vector& b) const
 void
 SSOR::solve(Vector& x, const Vector& b) const
 {
-  size_t n = A->n_rows();
+  const SparseMatrix& matrix = sparse_matrix();
+
+  size_t n = matrix.n_rows();
   assert(b.size() == n);
   assert(x.size() == n);
 
   size_t nit;
   double change;
-  Vector x_ell = x;
+  ScratchVector x_ell_work(n);
+  Vector& x_ell = *x_ell_work;
+  x_ell = x;
 
   // Iteration loop
   for (nit = 0; nit < max_iterations; ++nit)
@@ -86,11 +159,11 @@ SSOR::solve(Vector& x, const Vector& b) const
     for (size_t i = 0; i < n; ++i)
     {
       double s = 0.0;
-      for (const auto el: A->row_iterator(i))
+      for (const auto el: matrix.row_iterator(i))
         if (el.column != i)
           s += el.value * x[el.column];
 
-      double a_ii = A->diag(i);
+      double a_ii = matrix.diag(i);
       x[i] += omega * ((b[i] - s) / a_ii - x[i]);
     }
 
@@ -98,11 +171,11 @@ SSOR::solve(Vector& x, const Vector& b) const
     for (size_t i = n - 1; i != -1; --i)
     {
       double s = 0.0;
-      for (const auto el: A->row_iterator(i))
+      for (const auto el: matrix.row_iterator(i))
         if (el.column != i)
           s += el.value * x[el.column];
 
-      double a_ii = A->diag(i);
+      double a_ii = matrix.diag(i);
       x[i] += omega * ((b[i] - s) / a_ii - x[i]);
       change += std::fabs(x[i] - x_ell[i]) / std::fabs(b[i]);
     }
@@ -113,3 +186,58 @@ SSOR::solve(Vector& x, const Vector& b) const
       break;
   }
 }
+
+
+void
+MulticolorSOR::set_matrix(const SparseMatrix& matrix)
+{
+  SOR::set_matrix(matrix);
+  relaxation.reinit(matrix);
+}
+
+
+void
+MulticolorSOR::solve(Vector& x, const Vector& b) const
+{
+  size_t n = sparse_matrix().n_rows();
+  assert(b.size() == n);
+  assert(x.size() == n);
+
+  ScratchVector x_ell_work(n);
+  Vector& x_ell = *x_ell_work;
+
+  // Iteration loop
+  for (size_t nit = 0; nit < max_iterations; ++nit)
+  {
+    x_ell.equal(x);
+    relaxation.sweep(x, b, omega, true);
+
+    // Check convergence
+    if (check(nit + 1, compute_change(x, x_ell, b)))
+      break;
+  }
+}
+
+
+void
+MulticolorSSOR::solve(Vector& x, const Vector& b) const
+{
+  size_t n = sparse_matrix().n_rows();
+  assert(b.size() == n);
+  assert(x.size() == n);
+
+  ScratchVector x_ell_work(n);
+  Vector& x_ell = *x_ell_work;
+
+  // Iteration loop
+  for (size_t nit = 0; nit < max_iterations; ++nit)
+  {
+    x_ell.equal(x);
+    relaxation.sweep(x, b, omega, true);
+    relaxation.sweep(x, b, omega, false);
+
+    // Check convergence
+    if (check(nit + 1, compute_change(x, x_ell, b)))
+      break;
+  }
+}
@@ -2,6 +2,7 @@
 #define SOR_H
 
 #include "LinearSolvers/linear_solver.h"
+#include "LinearSolvers/Iterative/multicolor_relaxation.h"
 
 
 namespace PDEs
@@ -10,6 +11,22 @@ namespace PDEs
   {
     namespace LinearSolvers
     {
+      /**
+       * Apply a Gauss-Seidel sweep in natural order to \f$ A x = b \f$, i.e.
+       * for each row \f$ x_i \leftarrow a_{ii}^{-1} (b_i - \sum_{j \neq i}
+       * a_{ij} x_j) \f$, where \p inverse_diagonal holds the inverse of the
+       * diagonal entries of \p matrix. The rows are visited in increasing
+       * order if \p forward is set, otherwise in decreasing order. This is
+       * sequential, see MulticolorRelaxation for a parallel alternative.
+       */
+      void gauss_seidel_sweep(const SparseMatrix& matrix,
+                              const Vector& inverse_diagonal,
+                              Vector& x,
+                              const Vector& b,
+                              const bool forward = true);
+
+      //############################################################
+
       /**
        * Implementation of the successive over-relaxation (SOR) iterative
        * method.
@@ -76,6 +93,59 @@ namespace PDEs
         void
         solve(Vector& x, const Vector& b) const override;
       };
+
+      //############################################################
+
+      /**
+       * Implementation of the SOR iterative method with a multicolor
+       * ordering of the rows.
+       *
+       * Rows of the same color are not coupled, so they are relaxed
+       * concurrently, see MulticolorRelaxation. The iterates differ from
+       * those of SOR in natural order, but the convergence rate is
+       * generally comparable. With \f$ \omega = 1 \f$ on a 5-point stencil,
+       * this is red-black Gauss-Seidel.
+       */
+      class MulticolorSOR : public SOR
+      {
+      protected:
+        MulticolorRelaxation relaxation;
+
+      public:
+        /** Default constructor. */
+        MulticolorSOR(const double omega = 1.5,
+                      const Options& opts = Options(),
+                      const std::string solver_name = "Multicolor SOR");
+
+        /** Attach the sparse matrix and compute its coloring. */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /** Solve the system using the multicolor SOR method. */
+        void solve(Vector& x, const Vector& b) const override;
+      };
+
+
+      /**
+       * Implementation of the SSOR iterative method with a multicolor
+       * ordering of the rows. The backward sweep visits the colors in
+       * reverse order, so the iteration is symmetric.
+       *
+       * With few colors, the backward sweep largely repeats the forward
+       * sweep, e.g. with two colors it only relaxes the first color again,
+       * so this converges more slowly than SSOR in natural order. It is
+       * mainly useful where a symmetric operator is required, such as a
+       * smoother for multigrid preconditioners of conjugate gradients.
+       */
+      class MulticolorSSOR : public MulticolorSOR
+      {
+      public:
+        /** Default constructor. */
+        MulticolorSSOR(const double omega = 1.5,
+                       const Options& opts = Options());
+
+        /** Solve the system using the multicolor SSOR method. */
+        void solve(Vector& x, const Vector& b) const override;
+      };
     }
   }
 }
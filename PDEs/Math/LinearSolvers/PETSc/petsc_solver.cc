@@ -26,30 +26,84 @@ PETScSolver::PETScSolver(const std::string solver_type,
 {}
 
 
+PETScSolver::~PETScSolver()
+{
+  // Solvers owned by drivers often outlive PetscFinalize, after which no
+  // PETSc routine may be called. The memory is reclaimed at exit.
+  PetscBool finalized;
+  PetscFinalized(&finalized);
+  if (finalized)
+    return;
+
+  KSPDestroy(&ksp);
+  MatDestroy(&A);
+}
+
+
+void
+PETScSolver::set_reuse_preconditioner(const bool flag)
+{
+  reuse_preconditioner = flag;
+  if (ksp)
+    KSPSetReusePreconditioner(ksp, flag ? PETSC_TRUE : PETSC_FALSE);
+}
+
+
 void
 PETScSolver::set_matrix(const SparseMatrix& matrix)
 {
-  PETScUtils::create_petsc_matrix(A, matrix);
+  // Refill the preallocated matrix when the sparsity pattern is unchanged,
+  // otherwise, the solver context must be reset before the new matrix is
+  // created since its dimensions may differ.
+  if (A && same_sparsity_pattern(matrix))
+    PETScUtils::fill_petsc_matrix(A, matrix);
+  else
+  {
+    if (ksp)
+      KSPReset(ksp);
+    MatDestroy(&A);
 
-  KSPCreate(PETSC_COMM_WORLD, &ksp);
-  KSPSetOperators(ksp, A, A);
-  KSPSetType(ksp, solver_type.c_str());
+    PETScUtils::create_petsc_matrix(A, matrix);
+    store_sparsity_pattern(matrix);
+  }
+
+  // The solver context is only configured once
+  if (!ksp)
+  {
+    KSPCreate(PETSC_COMM_WORLD, &ksp);
+    KSPSetType(ksp, solver_type.c_str());
 
-  KSPGetPC(ksp, &pc);
-  PCSetType(pc, preconditioner_type.c_str());
+    KSPGetPC(ksp, &pc);
+    PCSetType(pc, preconditioner_type.c_str());
 
-  KSPSetConvergenceTest(ksp, &KSPConvergenceTest, NULL, NULL);
+    KSPSetConvergenceTest(ksp, &KSPConvergenceTest, NULL, NULL);
 
-  KSPSetTolerances(ksp, tolerance,
-                   PETSC_DEFAULT, PETSC_DEFAULT, max_iterations);
+    KSPSetTolerances(ksp, tolerance,
+                     PETSC_DEFAULT, PETSC_DEFAULT, max_iterations);
 
-  if (verbosity > 1)
-    KSPMonitorSet(ksp, &KSPMonitor, NULL, NULL);
+    if (verbosity > 1)
+      KSPMonitorSet(ksp, &KSPMonitor, NULL, NULL);
 
+    KSPSetReusePreconditioner(
+        ksp, reuse_preconditioner ? PETSC_TRUE : PETSC_FALSE);
+  }
+
+  KSPSetOperators(ksp, A, A);
   KSPSetUp(ksp);
 }
 
 
+std::shared_ptr<LinearSolverBase<SparseMatrix>>
+PETScSolver::clone() const
+{
+  auto solver = std::make_shared<PETScSolver>(
+      solver_type, preconditioner_type,
+      Options(tolerance, max_iterations, verbosity));
+  solver->set_reuse_preconditioner(reuse_preconditioner);
+  return solver;
+}
+
+
 void
 PETScSolver::solve(Vector& x, const Vector& b) const
 {
@@ -103,6 +157,46 @@ PETScSolver::solve(Vector& x, const Vector& b) const
 }
 
 
+bool
+PETScSolver::same_sparsity_pattern(const SparseMatrix& matrix) const
+{
+  if (matrix.n_rows() + 1 != row_offsets.size() ||
+      matrix.n_nonzero_entries() != colnums.size())
+    return false;
+
+  for (size_t i = 0; i < matrix.n_rows(); ++i)
+  {
+    if (matrix.row_length(i) != row_offsets[i + 1] - row_offsets[i])
+      return false;
+
+    if (matrix.row_length(i) > 0)
+    {
+      size_t p = row_offsets[i];
+      for (const auto el: matrix.row_iterator(i))
+        if (el.column != colnums[p++])
+          return false;
+    }
+  }
+  return true;
+}
+
+
+void
+PETScSolver::store_sparsity_pattern(const SparseMatrix& matrix)
+{
+  row_offsets.assign(matrix.n_rows() + 1, 0);
+  colnums.clear();
+  colnums.reserve(matrix.n_nonzero_entries());
+  for (size_t i = 0; i < matrix.n_rows(); ++i)
+  {
+    if (matrix.row_length(i) > 0)
+      for (const auto el: matrix.row_iterator(i))
+        colnums.push_back(el.column);
+    row_offsets[i + 1] = colnums.size();
+  }
+}
+
+
 PetscErrorCode
 PETScSolver::KSPConvergenceTest(KSP solver, PetscInt it, PetscReal rnorm,
                                 KSPConvergedReason* reason, void*)
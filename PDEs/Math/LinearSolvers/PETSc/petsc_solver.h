@@ -5,6 +5,7 @@
 #include "PETScUtils/petsc_utils.h"
 
 #include <petscksp.h>
+#include <vector>
 
 
 namespace PDEs
@@ -16,13 +17,20 @@ namespace PDEs
 
       /**
        * Implementation of a PETSc solver.
+       *
+       * The PETSc matrix and solver context persist across calls to
+       * \ref set_matrix. When a matrix with the same sparsity pattern as the
+       * previous one is attached, as is the case when only the time step
+       * changes in a transient, the preallocated PETSc matrix is refilled in
+       * place and the solver context is reused. Otherwise, the PETSc matrix
+       * is reallocated and the solver context is reset.
        */
       class PETScSolver : public LinearSolverBase<SparseMatrix>
       {
       protected:
-        Mat A;
-        KSP ksp;
-        PC pc;
+        Mat A = NULL;
+        KSP ksp = NULL;
+        PC pc = NULL;
 
         std::string solver_type = KSPCG;
         std::string preconditioner_type = PCNONE;
@@ -31,6 +39,16 @@ namespace PDEs
         unsigned int max_iterations;
         unsigned int verbosity = 0;
 
+        /**
+         * A flag for whether the preconditioner is kept when a matrix with
+         * the same sparsity pattern is attached.
+         */
+        bool reuse_preconditioner = false;
+
+        /** The sparsity pattern of the PETSc matrix in compressed format. */
+        std::vector<size_t> row_offsets;
+        std::vector<size_t> colnums;
+
       public:
         using LinearSolverBase::solve;
 
@@ -44,13 +62,43 @@ namespace PDEs
                     const std::string preconditioner_type = PCNONE,
                     const Options& opts = Options());
 
-        /** Attach a sparse matrix to the solver. */
+        /**
+         * Destroy the PETSc matrix and solver context. Nothing is done when
+         * PETSc has already been finalized.
+         */
+        ~PETScSolver();
+
+        PETScSolver(const PETScSolver&) = delete;
+        PETScSolver& operator=(const PETScSolver&) = delete;
+
+        /**
+         * Set whether the preconditioner built for a previously attached
+         * matrix should be kept when a matrix with the same sparsity pattern
+         * is attached. This avoids rebuilding expensive preconditioners, such
+         * as factorizations, when the matrix changes only slightly, at the
+         * cost of more iterations.
+         */
+        void set_reuse_preconditioner(const bool flag);
+
+        /**
+         * Attach a sparse matrix to the solver. If the sparsity pattern
+         * matches that of the previous matrix, the PETSc matrix is refilled
+         * and the solver context is reused.
+         */
         void set_matrix(const SparseMatrix& matrix) override;
 
+        /** Return a new PETSc solver with the same settings. */
+        std::shared_ptr<LinearSolverBase<SparseMatrix>> clone() const override;
+
         /** Solve the system using PETSc. */
         void solve(Vector& x, const Vector& b) const override;
 
       private:
+        /** Return whether \p matrix has the stored sparsity pattern. */
+        bool same_sparsity_pattern(const SparseMatrix& matrix) const;
+
+        /** Store the sparsity pattern of \p matrix. */
+        void store_sparsity_pattern(const SparseMatrix& matrix);
 
         /**A routine used to monitor the progress of the PETSc solver. */
         static PetscErrorCode
@@ -0,0 +1,392 @@
+#include "amg.h"
+
+#include "matrix.h"
+#include "vector_pool.h"
+#include "LinearSolvers/Iterative/sor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+namespace
+{
+  constexpr size_t invalid = static_cast<size_t>(-1);
+
+  /** The number of power iterations for the spectral radius estimates. */
+  constexpr unsigned int n_power_iterations = 15;
+
+  /**
+   * The number of smoothing sweeps on the coarsest level when it is too large
+   * to be solved directly.
+   */
+  constexpr unsigned int n_coarse_sweeps = 10;
+
+  /**
+   * The ratio of the largest eigenvalue estimate to the smallest eigenvalue
+   * targeted by the Chebyshev smoother.
+   */
+  constexpr double chebyshev_ratio = 30.0;
+
+
+  /**
+   * Estimate the spectral radius of \f$ D^{-1} A \f$ with power iterations.
+   */
+  double
+  estimate_max_eigenvalue(const SparseMatrix& A,
+                          const Vector& inverse_diagonal)
+  {
+    const size_t n = A.n_rows();
+    ScratchVector v_work(n), w_work(n);
+    Vector& v = *v_work;
+    Vector& w = *w_work;
+
+    // Start from a deterministic vector which is not smooth
+    for (size_t i = 0; i < n; ++i)
+      v[i] = 1.0 + static_cast<double>(i % 7);
+    v /= v.l2_norm();
+
+    double lambda = 0.0;
+    for (unsigned int k = 0; k < n_power_iterations; ++k)
+    {
+      A.vmult(w, v);
+      w.scale(inverse_diagonal);
+      lambda = w.l2_norm();
+      if (lambda == 0.0)
+        break;
+      v.equal(w);
+      v /= lambda;
+    }
+    return lambda;
+  }
+}
+
+
+AMGPreconditioner::AMGPreconditioner(const Smoother smoother,
+                                     const double strength_threshold,
+                                     const unsigned int n_smoothing_steps,
+                                     const size_t max_coarse_size,
+                                     const unsigned int max_levels) :
+    smoother(smoother),
+    strength_threshold(strength_threshold),
+    n_smoothing_steps(n_smoothing_steps),
+    max_coarse_size(max_coarse_size),
+    max_levels(max_levels)
+{
+  assert(n_smoothing_steps > 0);
+  assert(max_levels > 0);
+}
+
+
+void
+AMGPreconditioner::set_matrix(const SparseMatrix& matrix)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+
+  levels.clear();
+  levels.emplace_back();
+  levels.back().A = matrix;
+  levels.back().A.compress();
+
+  while (true)
+  {
+    const SparseMatrix& A = levels.back().A;
+    const size_t n = A.n_rows();
+
+    // Set up the smoother
+    Vector& inverse_diagonal = levels.back().inverse_diagonal;
+    inverse_diagonal.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double a_ii = A.diag_el(i);
+      if (a_ii == 0.0)
+        throw std::runtime_error(
+            "AMGPreconditioner: Zero diagonal entry in row " +
+            std::to_string(i) + " on level " +
+            std::to_string(levels.size() - 1) + ".");
+      inverse_diagonal[i] = 1.0 / a_ii;
+    }
+    levels.back().max_eigenvalue =
+        estimate_max_eigenvalue(A, inverse_diagonal);
+    if (smoother == Smoother::MULTICOLOR_GAUSS_SEIDEL)
+      levels.back().relaxation.reinit(A);
+
+    if (n <= max_coarse_size || levels.size() == max_levels)
+      break;
+
+    // Stop when the coarsening stagnates
+    size_t n_aggregates;
+    const auto aggregates = aggregate(A, n_aggregates);
+    if (n_aggregates == 0 || n_aggregates >= n)
+      break;
+
+    // Build the tentative prolongator, which interpolates constants exactly
+    std::vector<size_t> aggregate_sizes(n_aggregates, 0);
+    for (const auto a: aggregates)
+      if (a != invalid)
+        ++aggregate_sizes[a];
+
+    SparseMatrix T(n, n_aggregates);
+    for (size_t i = 0; i < n; ++i)
+      if (aggregates[i] != invalid)
+        T.set(i, aggregates[i],
+              1.0 / std::sqrt(static_cast<double>(
+                  aggregate_sizes[aggregates[i]])));
+    T.compress();
+
+    // Smooth the prolongator, P = T - omega D^{-1} A T. The sparsity pattern
+    // of A T contains that of T since the diagonal of A is non-zero.
+    const double omega = 4.0 / (3.0 * levels.back().max_eigenvalue);
+
+    SparseMatrix P;
+    A.mmult(P, T);
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (P.row_length(i) == 0)
+        continue;
+
+      const double factor = -omega * inverse_diagonal[i];
+      for (auto el: P.row_iterator(i))
+        el.value *= factor;
+    }
+    for (size_t i = 0; i < n; ++i)
+      if (aggregates[i] != invalid)
+        P.add(i, aggregates[i], T(i, aggregates[i]));
+
+    // Form the Galerkin coarse operator, A_c = P^T A P
+    SparseMatrix AP, A_coarse;
+    A.mmult(AP, P);
+    P.Tmmult(A_coarse, AP);
+
+    levels.back().P = std::move(P);
+    levels.emplace_back();
+    levels.back().A = std::move(A_coarse);
+  }
+
+  // Set up the Chebyshev smoothers once the levels no longer move, since
+  // they reference the operators
+  const SparseMatrix& A_coarse = levels.back().A;
+  if (smoother == Smoother::CHEBYSHEV)
+    for (size_t l = 0; l < levels.size(); ++l)
+      if (l + 1 < levels.size() || A_coarse.n_rows() > max_coarse_size)
+      {
+        levels[l].chebyshev = std::make_shared<ChebyshevPreconditioner>(
+            n_smoothing_steps, chebyshev_ratio);
+        levels[l].chebyshev->set_matrix(levels[l].A);
+      }
+
+  // Factorize the coarsest operator when it is small enough
+  if (A_coarse.n_rows() <= max_coarse_size)
+  {
+    Matrix dense(A_coarse.n_rows(), A_coarse.n_cols(), 0.0);
+    for (size_t i = 0; i < A_coarse.n_rows(); ++i)
+    {
+      if (A_coarse.row_length(i) == 0)
+        continue;
+
+      for (const auto el: A_coarse.row_iterator(i))
+        dense(i, el.column) = el.value;
+    }
+    coarse_solver.set_matrix(dense);
+  }
+}
+
+
+void
+AMGPreconditioner::vmult(Vector& z, const Vector& r) const
+{
+  assert(!levels.empty());
+  assert(r.size() == levels[0].A.n_rows());
+  assert(z.size() == r.size());
+
+  // Work on a copy when the source and destination are the same
+  if (&z == &r)
+  {
+    ScratchVector r_copy(r.size());
+    r_copy->equal(r);
+    vmult(z, *r_copy);
+    return;
+  }
+
+  z = 0.0;
+  v_cycle(0, z, r);
+}
+
+
+size_t
+AMGPreconditioner::n_levels() const
+{
+  return levels.size();
+}
+
+
+double
+AMGPreconditioner::operator_complexity() const
+{
+  if (levels.empty())
+    return 0.0;
+
+  double nnz = 0.0;
+  for (const auto& level: levels)
+    nnz += static_cast<double>(level.A.n_nonzero_entries());
+  return nnz / static_cast<double>(levels[0].A.n_nonzero_entries());
+}
+
+
+std::vector<size_t>
+AMGPreconditioner::aggregate(const SparseMatrix& A,
+                             size_t& n_aggregates) const
+{
+  const size_t n = A.n_rows();
+
+  // Find the strong connections of each unknown
+  std::vector<size_t> strong_offsets(n + 1, 0);
+  std::vector<size_t> strong;
+  strong.reserve(A.n_nonzero_entries());
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (A.row_length(i) > 0)
+    {
+      const double a_ii = std::fabs(A.diag_el(i));
+      for (const auto el: A.row_iterator(i))
+        if (el.column != i &&
+            std::fabs(el.value) >= strength_threshold *
+                                   std::sqrt(a_ii *
+                                             std::fabs(A.diag_el(el.column))))
+          strong.push_back(el.column);
+    }
+    strong_offsets[i + 1] = strong.size();
+  }
+
+  std::vector<size_t> aggregates(n, invalid);
+  n_aggregates = 0;
+
+  // Form aggregates from the neighborhoods whose unknowns are all free
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (aggregates[i] != invalid || strong_offsets[i] == strong_offsets[i + 1])
+      continue;
+
+    bool free = true;
+    for (size_t p = strong_offsets[i]; p < strong_offsets[i + 1] && free; ++p)
+      free = aggregates[strong[p]] == invalid;
+    if (!free)
+      continue;
+
+    aggregates[i] = n_aggregates;
+    for (size_t p = strong_offsets[i]; p < strong_offsets[i + 1]; ++p)
+      aggregates[strong[p]] = n_aggregates;
+    ++n_aggregates;
+  }
+
+  // Attach the remaining unknowns to a neighboring aggregate from the first
+  // pass, without chaining through unknowns attached in this pass
+  const std::vector<size_t> roots(aggregates);
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (aggregates[i] != invalid)
+      continue;
+
+    for (size_t p = strong_offsets[i]; p < strong_offsets[i + 1]; ++p)
+      if (roots[strong[p]] != invalid)
+      {
+        aggregates[i] = roots[strong[p]];
+        break;
+      }
+  }
+
+  // Group whatever remains with its free strong neighbors. Unknowns without
+  // strong connections are left out of the coarse space since the smoother
+  // alone resolves them.
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (aggregates[i] != invalid || strong_offsets[i] == strong_offsets[i + 1])
+      continue;
+
+    aggregates[i] = n_aggregates;
+    for (size_t p = strong_offsets[i]; p < strong_offsets[i + 1]; ++p)
+      if (aggregates[strong[p]] == invalid)
+        aggregates[strong[p]] = n_aggregates;
+    ++n_aggregates;
+  }
+  return aggregates;
+}
+
+
+void
+AMGPreconditioner::v_cycle(const size_t l, Vector& x, const Vector& b) const
+{
+  const Level& level = levels[l];
+  const size_t n = level.A.n_rows();
+
+  // Coarsest level
+  if (l + 1 == levels.size())
+  {
+    if (n <= max_coarse_size)
+      coarse_solver.solve(x, b);
+    else
+      for (unsigned int k = 0; k < n_coarse_sweeps; ++k)
+        smooth(l, x, b, k % 2 == 0);
+    return;
+  }
+
+  // Pre-smoothing
+  smooth(l, x, b, true);
+
+  // Coarse grid correction
+  const size_t n_coarse = levels[l + 1].A.n_rows();
+  ScratchVector r_work(n), b_coarse_work(n_coarse), x_coarse_work(n_coarse, 0.0);
+  Vector& r = *r_work;
+
+  level.A.vmult(r, x);
+  r.sadd(-1.0, b);
+  level.P.Tvmult(*b_coarse_work, r);
+  v_cycle(l + 1, *x_coarse_work, *b_coarse_work);
+  level.P.vmult_add(x, *x_coarse_work);
+
+  // Post-smoothing
+  smooth(l, x, b, false);
+}
+
+
+void
+AMGPreconditioner::smooth(const size_t l,
+                          Vector& x,
+                          const Vector& b,
+                          const bool forward) const
+{
+  const Level& level = levels[l];
+
+  if (smoother == Smoother::GAUSS_SEIDEL)
+  {
+    for (unsigned int k = 0; k < n_smoothing_steps; ++k)
+      gauss_seidel_sweep(level.A, level.inverse_diagonal, x, b, forward);
+    return;
+  }
+
+  if (smoother == Smoother::MULTICOLOR_GAUSS_SEIDEL)
+  {
+    for (unsigned int k = 0; k < n_smoothing_steps; ++k)
+      level.relaxation.sweep(x, b, 1.0, forward);
+    return;
+  }
+
+  // Apply the Chebyshev polynomial to the residual
+  const size_t n = level.A.n_rows();
+  ScratchVector r_work(n), z_work(n);
+  Vector& r = *r_work;
+  Vector& z = *z_work;
+
+  level.A.vmult(r, x);
+  r.sadd(-1.0, b);
+  level.chebyshev->vmult(z, r);
+  x.add(1.0, z);
+}
@@ -0,0 +1,151 @@
+#ifndef AMG_H
+#define AMG_H
+
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+#include "LinearSolvers/Direct/lu.h"
+#include "LinearSolvers/Iterative/multicolor_relaxation.h"
+#include "LinearSolvers/Preconditioners/chebyshev_preconditioner.h"
+#include "Math/sparse_matrix.h"
+#include "vector.h"
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of a smoothed aggregation algebraic multigrid (AMG)
+       * preconditioner.
+       *
+       * The hierarchy is built from the matrix alone. On each level:
+       *   - Entries are classified as strong connections when
+       *     \f$ |a_{ij}| \geq \theta \sqrt{|a_{ii} a_{jj}|} \f$.
+       *   - The unknowns are grouped into aggregates of strongly connected
+       *     neighborhoods.
+       *   - The tentative prolongator \f$ T \f$ interpolates the constant
+       *     vector, the near null space of diffusion operators, exactly by
+       *     injecting each aggregate value onto its members.
+       *   - The prolongator is smoothed with damped Jacobi, \f$ P = (I -
+       *     \omega D^{-1} A) T \f$ with \f$ \omega = 4 / (3 \rho(D^{-1}A))
+       *     \f$, which improves the energy of the coarse basis functions.
+       *   - The coarse operator is the Galerkin product \f$ A_c = P^T A P
+       *     \f$, computed with SparseMatrix::mmult and SparseMatrix::Tmmult.
+       *
+       * Coarsening stops when the operator is small enough, which is then
+       * solved with a dense LU decomposition.
+       *
+       * Applying the preconditioner performs a single V-cycle with a zero
+       * initial guess. The smoother is either Gauss-Seidel, with forward
+       * sweeps before and backward sweeps after the coarse grid correction so
+       * that the cycle is symmetric for symmetric matrices, or a Chebyshev
+       * polynomial in \f$ D^{-1} A \f$ targeting the upper part of its
+       * spectrum, see ChebyshevPreconditioner, which only requires
+       * matrix-vector products and is therefore parallel. Gauss-Seidel sweeps
+       * in natural order are sequential. Sweeps with a multicolor ordering,
+       * see MulticolorRelaxation, are parallel, but the smoothing property
+       * depends on the coloring, so they are not the default.
+       */
+      class AMGPreconditioner : public Preconditioner
+      {
+      public:
+        /** The available smoothers. */
+        enum class Smoother
+        {
+          GAUSS_SEIDEL = 0,             ///< Gauss-Seidel sweeps
+          CHEBYSHEV = 1,                ///< Chebyshev polynomial smoothing
+          MULTICOLOR_GAUSS_SEIDEL = 2   ///< Multicolor Gauss-Seidel sweeps
+        };
+
+      private:
+        /** The data of a level of the multigrid hierarchy. */
+        struct Level
+        {
+          SparseMatrix A;
+
+          /** The prolongator from the next coarser level. */
+          SparseMatrix P;
+
+          /** The inverse of the diagonal entries of \p A. */
+          Vector inverse_diagonal;
+
+          /** An estimate of the spectral radius of \f$ D^{-1} A \f$. */
+          double max_eigenvalue = 0.0;
+
+          /** The multicolor Gauss-Seidel sweeps, if used. */
+          MulticolorRelaxation relaxation;
+
+          /** The Chebyshev smoother, if used. */
+          std::shared_ptr<ChebyshevPreconditioner> chebyshev;
+        };
+
+        const Smoother smoother;
+        const double strength_threshold;
+        const unsigned int n_smoothing_steps;
+        const size_t max_coarse_size;
+        const unsigned int max_levels;
+
+        std::vector<Level> levels;
+
+        /** The solver for the coarsest level. */
+        LU coarse_solver;
+
+      public:
+        /**
+         * Default constructor. The \p n_smoothing_steps are the number of
+         * Gauss-Seidel sweeps or the degree of the Chebyshev polynomial
+         * applied before and after each coarse grid correction.
+         */
+        AMGPreconditioner(const Smoother smoother = Smoother::GAUSS_SEIDEL,
+                          const double strength_threshold = 0.08,
+                          const unsigned int n_smoothing_steps = 1,
+                          const size_t max_coarse_size = 500,
+                          const unsigned int max_levels = 20);
+
+        /** Build the multigrid hierarchy for \p matrix. */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /** Apply a single V-cycle to \p r with a zero initial guess. */
+        void vmult(Vector& z, const Vector& r) const override;
+
+        /** Return the number of levels of the hierarchy. */
+        size_t n_levels() const;
+
+        /**
+         * Return the operator complexity, i.e. the total number of non-zeros
+         * of the operators on all levels relative to that of the finest.
+         */
+        double operator_complexity() const;
+
+      private:
+        /**
+         * Group the unknowns of \p A into aggregates of strongly connected
+         * neighborhoods. Return the aggregate of each unknown and set
+         * \p n_aggregates.
+         */
+        std::vector<size_t>
+        aggregate(const SparseMatrix& A, size_t& n_aggregates) const;
+
+        /** Apply the V-cycle on level \p l to solve \f$ A_l x = b \f$. */
+        void
+        v_cycle(const size_t l, Vector& x, const Vector& b) const;
+
+        /**
+         * Apply the smoother on level \p l to \f$ A_l x = b \f$. The
+         * \p forward flag gives the direction of Gauss-Seidel sweeps.
+         */
+        void
+        smooth(const size_t l,
+               Vector& x,
+               const Vector& b,
+               const bool forward) const;
+      };
+    }
+  }
+}
+#endif //AMG_H
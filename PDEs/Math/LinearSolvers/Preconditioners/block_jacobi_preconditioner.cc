@@ -0,0 +1,39 @@
+#include "block_jacobi_preconditioner.h"
+
+#include "vector.h"
+#include "Math/sparse_matrix.h"
+
+#include <string>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+BlockJacobiPreconditioner::
+BlockJacobiPreconditioner(const unsigned int n_groups) :
+    n_groups(n_groups)
+{
+  assert(n_groups > 0);
+}
+
+
+void
+BlockJacobiPreconditioner::set_matrix(const SparseMatrix& matrix)
+{
+  if (matrix.n_rows() % n_groups != 0)
+    throw std::runtime_error(
+        "BlockJacobiPreconditioner: The number of rows is not a multiple "
+        "of the number of groups " + std::to_string(n_groups) + ".");
+  blocks.set_matrix(matrix, n_groups);
+}
+
+
+void
+BlockJacobiPreconditioner::vmult(Vector& z, const Vector& r) const
+{
+  blocks.solve(z, r);
+}
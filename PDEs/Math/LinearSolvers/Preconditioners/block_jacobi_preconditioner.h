@@ -0,0 +1,56 @@
+#ifndef BLOCK_JACOBI_PRECONDITIONER_H
+#define BLOCK_JACOBI_PRECONDITIONER_H
+
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+#include "LinearSolvers/Direct/batched_lu.h"
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of the block-Jacobi preconditioner over the groups of
+       * each cell.
+       *
+       * The multigroup unknowns are ordered such that the \p n_groups
+       * unknowns of each cell are contiguous, so the diagonal blocks of size
+       * \p n_groups hold all of the within-cell coupling, i.e. removal,
+       * scattering, and fission. The preconditioner is \f$ M =
+       * \operatorname{blockdiag}(A) \f$, which is inverted exactly for every
+       * cell at once with BatchedLU. Only the spatial coupling between cells
+       * is left to the iterative solver, which is typically far better
+       * conditioned than the strong energy coupling in heterogeneous cores.
+       *
+       * With a single group this reduces to JacobiPreconditioner.
+       */
+      class BlockJacobiPreconditioner : public Preconditioner
+      {
+      private:
+        const unsigned int n_groups;
+
+        /** The factorized diagonal blocks. */
+        BatchedLU blocks;
+
+      public:
+        /** Default constructor. */
+        BlockJacobiPreconditioner(const unsigned int n_groups);
+
+        /**
+         * Extract and factorize the diagonal blocks of \p matrix. An error is
+         * thrown if any block is singular.
+         */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /**
+         * Apply the preconditioner by solving with each diagonal block. It is
+         * acceptable for \p z and \p r to be the same vector.
+         */
+        void vmult(Vector& z, const Vector& r) const override;
+      };
+    }
+  }
+}
+#endif //BLOCK_JACOBI_PRECONDITIONER_H
@@ -0,0 +1,91 @@
+#include "chebyshev_preconditioner.h"
+
+#include "vector.h"
+#include "vector_pool.h"
+#include "Polynomials/polynomial.h"
+#include "Math/sparse_matrix.h"
+#include "LinearSolvers/Iterative/chebyshev.h"
+
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+ChebyshevPreconditioner::ChebyshevPreconditioner(
+    const unsigned int degree,
+    const double smoothing_ratio,
+    const unsigned int n_lanczos_steps) :
+    degree(degree),
+    smoothing_ratio(smoothing_ratio),
+    n_lanczos_steps(n_lanczos_steps)
+{
+  assert(degree > 0);
+  assert(smoothing_ratio == 0.0 || smoothing_ratio > 1.0);
+}
+
+
+void
+ChebyshevPreconditioner::set_matrix(const SparseMatrix& matrix)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+
+  this->matrix = &matrix;
+  jacobi.set_matrix(matrix);
+
+  // The largest eigenvalue is underestimated, so enlarge it
+  const auto bounds = estimate_eigenvalues(matrix, &jacobi, n_lanczos_steps);
+  upper_bound = 1.1 * bounds.second;
+  lower_bound = smoothing_ratio > 0.0 ? upper_bound / smoothing_ratio
+                                      : bounds.first;
+}
+
+
+void
+ChebyshevPreconditioner::vmult(Vector& z, const Vector& r) const
+{
+  assert(matrix != nullptr);
+  const size_t n = matrix->n_rows();
+  assert(r.size() == n);
+  assert(z.size() == n);
+
+  const double theta = 0.5 * (upper_bound + lower_bound);
+  const double delta = 0.5 * (upper_bound - lower_bound);
+  const double sigma = theta / delta;
+
+  ScratchVector res_work(n), d_work(n), w_work(n);
+  Vector& res = *res_work;
+  Vector& d = *d_work;
+  Vector& w = *w_work;
+
+  // The first iterate is the scaled residual. The residual is copied first
+  // in case the source and destination are the same.
+  res.equal(r);
+  jacobi.vmult(d, res);
+  d /= theta;
+  z.equal(d);
+
+  double rho = 1.0 / sigma;
+  for (unsigned int k = 1; k < degree; ++k)
+  {
+    matrix->vmult(w, d);
+    res.add(-1.0, w);
+    jacobi.vmult(w, res);
+
+    const double rho_new = 1.0 / (2.0 * sigma - rho);
+    d.sadd(rho_new * rho, 2.0 * rho_new / delta, w);
+    z.add(1.0, d);
+    rho = rho_new;
+  }
+}
+
+
+double
+ChebyshevPreconditioner::reduction_factor() const
+{
+  const double sigma =
+      (upper_bound + lower_bound) / (upper_bound - lower_bound);
+  return 1.0 / Polynomials::chebyshev(degree, sigma);
+}
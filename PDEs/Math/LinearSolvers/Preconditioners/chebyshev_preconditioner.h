@@ -0,0 +1,80 @@
+#ifndef CHEBYSHEV_PRECONDITIONER_H
+#define CHEBYSHEV_PRECONDITIONER_H
+
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+#include "LinearSolvers/Preconditioners/jacobi_preconditioner.h"
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of a Chebyshev polynomial preconditioner.
+       *
+       * Applying the preconditioner performs \p degree steps of the
+       * Chebyshev iteration on \f$ D^{-1} A \f$, where \f$ D \f$ is the
+       * diagonal of \f$ A \f$, with a zero initial guess. This is a fixed
+       * polynomial in \f$ D^{-1} A \f$ times \f$ D^{-1} \f$, which is
+       * symmetric positive definite for symmetric positive definite
+       * matrices, so it may be used with the conjugate gradient method. It
+       * requires only matrix-vector products and no inner products.
+       *
+       * The eigenvalue bounds are estimated from a few Lanczos steps when
+       * the matrix is set, see \ref estimate_eigenvalues. By default, the
+       * polynomial targets the whole estimated spectrum, which makes it an
+       * approximate inverse. When a \p smoothing_ratio is given, it instead
+       * targets \f$ [\lambda_{max} / r, \lambda_{max}] \f$ and only damps
+       * the upper part of the spectrum, which is what a multigrid smoother
+       * requires.
+       *
+       * The attached matrix is referenced rather than copied, so it must
+       * outlive the preconditioner.
+       */
+      class ChebyshevPreconditioner : public Preconditioner
+      {
+      private:
+        const unsigned int degree;
+        const double smoothing_ratio;
+        const unsigned int n_lanczos_steps;
+
+        const SparseMatrix* matrix = nullptr;
+
+        /** The diagonal scaling. */
+        JacobiPreconditioner jacobi;
+
+        /** The eigenvalue interval targeted by the polynomial. */
+        double lower_bound = 0.0;
+        double upper_bound = 0.0;
+
+      public:
+        /**
+         * Default constructor. The polynomial has degree \p degree, i.e.
+         * applying it requires <tt>degree - 1</tt> matrix-vector products.
+         * A \p smoothing_ratio of zero targets the whole spectrum.
+         */
+        ChebyshevPreconditioner(const unsigned int degree = 4,
+                                const double smoothing_ratio = 0.0,
+                                const unsigned int n_lanczos_steps = 10);
+
+        /** Attach \p matrix and estimate its eigenvalue bounds. */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /** Apply the preconditioner. */
+        void vmult(Vector& z, const Vector& r) const override;
+
+        /**
+         * Return the factor by which the polynomial is guaranteed to reduce
+         * error components within the targeted interval, i.e. \f$ 1 /
+         * T_k(\sigma) \f$ with the Chebyshev polynomial \f$ T_k \f$ of the
+         * degree and \f$ \sigma = (\lambda_{max} + \lambda_{min}) /
+         * (\lambda_{max} - \lambda_{min}) \f$.
+         */
+        double reduction_factor() const;
+      };
+    }
+  }
+}
+#endif //CHEBYSHEV_PRECONDITIONER_H
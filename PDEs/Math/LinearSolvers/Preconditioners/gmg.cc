@@ -0,0 +1,246 @@
+#include "gmg.h"
+
+#include "matrix.h"
+#include "vector_pool.h"
+#include "LinearSolvers/Iterative/sor.h"
+#include "ortho_grids.h"
+
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+GMGPreconditioner::GMGPreconditioner(const std::shared_ptr<Grid::Mesh> mesh,
+                                     const unsigned int n_groups,
+                                     const Cycle cycle,
+                                     const Smoother smoother,
+                                     const unsigned int n_smoothing_steps,
+                                     const size_t max_coarse_size) :
+    n_groups(n_groups),
+    cycle(cycle),
+    smoother(smoother),
+    n_smoothing_steps(n_smoothing_steps),
+    max_coarse_size(max_coarse_size)
+{
+  assert(mesh != nullptr);
+  assert(n_groups > 0);
+  assert(n_smoothing_steps > 0);
+
+  // Coarsen until the coarsest operator is small enough for a direct solve
+  levels.emplace_back();
+  levels.back().mesh = mesh;
+  while (levels.back().mesh->cells.size() * n_groups > max_coarse_size)
+  {
+    Level& fine = levels.back();
+    auto coarse_mesh = Grid::coarsen_orthomesh(*fine.mesh, fine.parent_ids);
+    if (coarse_mesh->cells.size() == fine.mesh->cells.size())
+    {
+      fine.parent_ids.clear();
+      break;
+    }
+
+    levels.emplace_back();
+    levels.back().mesh = coarse_mesh;
+  }
+}
+
+
+void
+GMGPreconditioner::set_matrix(const SparseMatrix& matrix)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+  if (matrix.n_rows() != levels[0].mesh->cells.size() * n_groups)
+    throw std::runtime_error(
+        "GMGPreconditioner: The matrix size does not match the number of "
+        "cells and groups.");
+
+  levels[0].A = matrix;
+  levels[0].A.compress();
+  for (size_t l = 0; l + 1 < levels.size(); ++l)
+  {
+    const SparseMatrix& A = levels[l].A;
+    const size_t n = A.n_rows();
+
+    // Set up the smoother
+    if (smoother == Smoother::MULTICOLOR_GAUSS_SEIDEL)
+      levels[l].relaxation.reinit(A);
+    else
+    {
+      Vector& inverse_diagonal = levels[l].inverse_diagonal;
+      inverse_diagonal.resize(n);
+      for (size_t i = 0; i < n; ++i)
+      {
+        const double a_ii = A.diag_el(i);
+        if (a_ii == 0.0)
+          throw std::runtime_error(
+              "GMGPreconditioner: Zero diagonal entry in row " +
+              std::to_string(i) + " on level " + std::to_string(l) + ".");
+        inverse_diagonal[i] = 1.0 / a_ii;
+      }
+    }
+
+    homogenize(l);
+  }
+
+  // Factorize the coarsest operator
+  const SparseMatrix& A_coarse = levels.back().A;
+  Matrix dense(A_coarse.n_rows(), A_coarse.n_cols(), 0.0);
+  for (size_t i = 0; i < A_coarse.n_rows(); ++i)
+  {
+    if (A_coarse.row_length(i) == 0)
+      continue;
+
+    for (const auto el: A_coarse.row_iterator(i))
+      dense(i, el.column) = el.value;
+  }
+  coarse_solver.set_matrix(dense);
+}
+
+
+void
+GMGPreconditioner::vmult(Vector& z, const Vector& r) const
+{
+  assert(r.size() == levels[0].A.n_rows());
+  assert(z.size() == r.size());
+
+  // Work on a copy when the source and destination are the same
+  if (&z == &r)
+  {
+    ScratchVector r_copy(r.size());
+    r_copy->equal(r);
+    vmult(z, *r_copy);
+    return;
+  }
+
+  z = 0.0;
+  apply_cycle(0, z, r, cycle);
+}
+
+
+size_t
+GMGPreconditioner::n_levels() const
+{
+  return levels.size();
+}
+
+
+void
+GMGPreconditioner::homogenize(const size_t l)
+{
+  const Level& fine = levels[l];
+  const Grid::Mesh& fine_mesh = *fine.mesh;
+  const Grid::Mesh& coarse_mesh = *levels[l + 1].mesh;
+  const std::vector<size_t>& parent_ids = fine.parent_ids;
+  const SparseMatrix& A = fine.A;
+  const size_t G = n_groups;
+
+  SparseMatrix A_coarse(coarse_mesh.cells.size() * G,
+                        coarse_mesh.cells.size() * G);
+  for (size_t i = 0; i < A.n_rows(); ++i)
+  {
+    if (A.row_length(i) == 0)
+      continue;
+
+    const size_t p = i / G, P = parent_ids[p];
+    const size_t row = P * G + i % G;
+    for (const auto el: A.row_iterator(i))
+    {
+      const size_t q = el.column / G, Q = parent_ids[q];
+      const size_t column = el.column % G;
+
+      // Within-cell terms and couplings within the agglomerate are summed.
+      // The latter cancel with their contribution to the diagonal.
+      if (P == Q)
+      {
+        A_coarse.add(row, P * G + column, el.value);
+        continue;
+      }
+
+      // Scale couplings across coarse faces by the ratio of the cell center
+      // distances. The fine diagonal holds the unscaled coupling, so the
+      // difference is moved to the coarse diagonal to preserve row sums.
+      const double ratio =
+          fine_mesh.cells[p].centroid.distance(fine_mesh.cells[q].centroid) /
+          coarse_mesh.cells[P].centroid.distance(coarse_mesh.cells[Q].centroid);
+      A_coarse.add(row, Q * G + column, ratio * el.value);
+      A_coarse.add(row, P * G + column, (1.0 - ratio) * el.value);
+    }
+  }
+  A_coarse.compress();
+  levels[l + 1].A = std::move(A_coarse);
+}
+
+
+void
+GMGPreconditioner::apply_cycle(const size_t l,
+                               Vector& x,
+                               const Vector& b,
+                               const Cycle type) const
+{
+  // Coarsest level
+  if (l + 1 == levels.size())
+  {
+    coarse_solver.solve(x, b);
+    return;
+  }
+
+  const Level& level = levels[l];
+  const size_t n = level.A.n_rows();
+  const size_t n_coarse = levels[l + 1].A.n_rows();
+  const size_t G = n_groups;
+
+  // Pre-smoothing
+  smooth(l, x, b, true);
+
+  // Restrict the residual by summing over the agglomerates
+  ScratchVector r_work(n), b_coarse_work(n_coarse, 0.0);
+  ScratchVector x_coarse_work(n_coarse, 0.0);
+  Vector& r = *r_work;
+  Vector& b_coarse = *b_coarse_work;
+  Vector& x_coarse = *x_coarse_work;
+
+  level.A.vmult(r, x);
+  r.sadd(-1.0, b);
+  for (size_t i = 0; i < n; ++i)
+    b_coarse[level.parent_ids[i / G] * G + i % G] += r[i];
+
+  // Coarse grid correction. W-cycles repeat the cycle on the coarse level,
+  // F-cycles follow it with a V-cycle.
+  apply_cycle(l + 1, x_coarse, b_coarse, type);
+  if (type == Cycle::W)
+    apply_cycle(l + 1, x_coarse, b_coarse, Cycle::W);
+  else if (type == Cycle::F)
+    apply_cycle(l + 1, x_coarse, b_coarse, Cycle::V);
+
+  // Prolongate the correction by injection
+  for (size_t i = 0; i < n; ++i)
+    x[i] += x_coarse[level.parent_ids[i / G] * G + i % G];
+
+  // Post-smoothing
+  smooth(l, x, b, false);
+}
+
+
+void
+GMGPreconditioner::smooth(const size_t l,
+                          Vector& x,
+                          const Vector& b,
+                          const bool forward) const
+{
+  if (smoother == Smoother::MULTICOLOR_GAUSS_SEIDEL)
+  {
+    for (unsigned int k = 0; k < n_smoothing_steps; ++k)
+      levels[l].relaxation.sweep(x, b, 1.0, forward);
+    return;
+  }
+
+  for (unsigned int k = 0; k < n_smoothing_steps; ++k)
+    gauss_seidel_sweep(levels[l].A, levels[l].inverse_diagonal,
+                       x, b, forward);
+}
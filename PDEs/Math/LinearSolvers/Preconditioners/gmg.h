@@ -0,0 +1,165 @@
+#ifndef GMG_H
+#define GMG_H
+
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+#include "LinearSolvers/Direct/lu.h"
+#include "LinearSolvers/Iterative/multicolor_relaxation.h"
+#include "Math/sparse_matrix.h"
+#include "vector.h"
+#include "mesh.h"
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of a geometric multigrid (GMG) preconditioner for
+       * multi-group finite volume operators on orthogonal meshes.
+       *
+       * The hierarchy of meshes is built by repeatedly agglomerating 2 cells
+       * in 1D and 2x2 cells in 2D with Grid::coarsen_orthomesh. Unknowns
+       * are ordered cell-wise with the groups of each cell contiguous. The
+       * coarse operators are homogenized from the next finer operator rather
+       * than computed algebraically:
+       *   - The within-cell terms, i.e. the volume integrated cross sections
+       *     and boundary terms, are summed over the cells of an agglomerate,
+       *     which is the volume weighted homogenization of the cross
+       *     sections.
+       *   - The couplings of the cells on either side of a coarse face are
+       *     summed over the fine faces that make up the coarse face and
+       *     scaled by the ratio of the fine to coarse cell center distances.
+       *     This is the series homogenization of the diffusion coefficients
+       *     along the path between the coarse cell centers and reproduces
+       *     the finite volume operator rediscretized on the coarse mesh for
+       *     homogeneous media.
+       *   - Couplings within an agglomerate cancel out.
+       *
+       * Residuals are restricted by summing over the cells of each
+       * agglomerate and corrections are prolongated by injection. Each
+       * level is smoothed with Gauss-Seidel, with forward sweeps before and
+       * backward sweeps after the coarse grid correction so that the cycle
+       * is symmetric for symmetric matrices. The sweeps are either in
+       * natural order or, in parallel, with a multicolor ordering, see
+       * MulticolorRelaxation, which is red-black Gauss-Seidel for 5-point
+       * stencils. The coarsest level is solved with a dense LU
+       * decomposition.
+       *
+       * Since piecewise constant transfers are not accurate enough for
+       * V-cycles to converge independently of the mesh size, W- and F-cycles
+       * are available. These visit the coarse levels more often at a cost
+       * which remains proportional to the number of unknowns. V- and
+       * W-cycles are symmetric for symmetric matrices and may be used with
+       * CG. The F-cycle applies two different coarse cycles in sequence, so
+       * it is not symmetric and should be used with GMRES or BiCGStab.
+       */
+      class GMGPreconditioner : public Preconditioner
+      {
+      public:
+        /** The available multigrid cycles. */
+        enum class Cycle
+        {
+          V = 0,  ///< One coarse grid correction per level
+          W = 1,  ///< Two coarse grid corrections per level
+          F = 2   ///< An F-cycle followed by a V-cycle on the coarse level
+        };
+
+        /** The available smoothers. */
+        enum class Smoother
+        {
+          GAUSS_SEIDEL = 0,             ///< Gauss-Seidel sweeps
+          MULTICOLOR_GAUSS_SEIDEL = 1   ///< Multicolor Gauss-Seidel sweeps
+        };
+
+      private:
+        /** The data of a level of the multigrid hierarchy. */
+        struct Level
+        {
+          std::shared_ptr<Grid::Mesh> mesh;
+
+          /** The coarse cell ID of each cell. Empty on the coarsest level. */
+          std::vector<size_t> parent_ids;
+
+          SparseMatrix A;
+
+          /** The inverse of the diagonal entries of \p A. */
+          Vector inverse_diagonal;
+
+          /** The multicolor Gauss-Seidel sweeps on \p A, if used. */
+          MulticolorRelaxation relaxation;
+        };
+
+        const unsigned int n_groups;
+        const Cycle cycle;
+        const Smoother smoother;
+        const unsigned int n_smoothing_steps;
+        const size_t max_coarse_size;
+
+        std::vector<Level> levels;
+
+        /** The solver for the coarsest level. */
+        LU coarse_solver;
+
+      public:
+        /**
+         * Default constructor. The mesh hierarchy is built from \p mesh
+         * until the number of unknowns is at most \p max_coarse_size or the
+         * mesh cannot be coarsened further. The \p n_smoothing_steps are the
+         * number of Gauss-Seidel sweeps applied before and after each coarse
+         * grid correction.
+         */
+        GMGPreconditioner(const std::shared_ptr<Grid::Mesh> mesh,
+                          const unsigned int n_groups,
+                          const Cycle cycle = Cycle::V,
+                          const Smoother smoother = Smoother::GAUSS_SEIDEL,
+                          const unsigned int n_smoothing_steps = 2,
+                          const size_t max_coarse_size = 500);
+
+        /**
+         * Homogenize \p matrix, the multi-group operator on the finest mesh,
+         * onto the coarse meshes.
+         */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /** Apply a single cycle to \p r with a zero initial guess. */
+        void vmult(Vector& z, const Vector& r) const override;
+
+        /** Return the number of levels of the hierarchy. */
+        size_t n_levels() const;
+
+      private:
+        /**
+         * Homogenize the operator on level \p l onto level <tt>l + 1</tt>.
+         */
+        void homogenize(const size_t l);
+
+        /**
+         * Apply a cycle of type \p type on level \p l to solve
+         * \f$ A_l x = b \f$.
+         */
+        void
+        apply_cycle(const size_t l,
+                    Vector& x,
+                    const Vector& b,
+                    const Cycle type) const;
+
+        /**
+         * Apply the Gauss-Seidel sweeps on level \p l to \f$ A_l x = b \f$
+         * in the direction given by \p forward.
+         */
+        void
+        smooth(const size_t l,
+               Vector& x,
+               const Vector& b,
+               const bool forward) const;
+      };
+    }
+  }
+}
+#endif //GMG_H
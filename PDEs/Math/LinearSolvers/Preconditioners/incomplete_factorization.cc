@@ -0,0 +1,419 @@
+#include "incomplete_factorization.h"
+
+#include "vector.h"
+#include "multithreading.h"
+#include "Math/sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+namespace
+{
+  constexpr size_t invalid = static_cast<size_t>(-1);
+
+  /**
+   * The minimum average number of rows per level for which the level
+   * scheduled loops are run on multiple threads.
+   */
+  constexpr size_t min_rows_per_level = 64;
+
+
+  /**
+   * Group the rows by \p level, in increasing row order within each level.
+   */
+  void
+  sort_by_level(const std::vector<size_t>& level,
+                std::vector<size_t>& offsets,
+                std::vector<size_t>& rows)
+  {
+    size_t n_levels = 0;
+    for (const auto l: level)
+      n_levels = std::max(n_levels, l + 1);
+
+    offsets.assign(n_levels + 1, 0);
+    for (const auto l: level)
+      ++offsets[l + 1];
+    for (size_t l = 0; l < n_levels; ++l)
+      offsets[l + 1] += offsets[l];
+
+    rows.resize(level.size());
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < level.size(); ++i)
+      rows[next[level[i]]++] = i;
+  }
+}
+
+
+IncompleteFactorization::
+IncompleteFactorization(const std::string name) :
+    name(name)
+{}
+
+
+void
+IncompleteFactorization::vmult(Vector& z, const Vector& r) const
+{
+  assert(r.size() == n);
+  assert(z.size() == n);
+
+  const double* r_ptr = r.data();
+  double* z_ptr = z.data();
+
+  // Forward substitution with the unit lower triangular factor
+  const auto forward = [&](const size_t i)
+  {
+    double value = r_ptr[i];
+    for (size_t p = row_offsets[i]; p < diagonal_offsets[i]; ++p)
+      value -= values[p] * z_ptr[colnums[p]];
+    z_ptr[i] = value;
+  };
+
+  // Backward substitution with the upper triangular factor
+  const auto backward = [&](const size_t i)
+  {
+    double value = z_ptr[i];
+    for (size_t p = diagonal_offsets[i] + 1; p < row_offsets[i + 1]; ++p)
+      value -= values[p] * z_ptr[colnums[p]];
+    z_ptr[i] = value / values[diagonal_offsets[i]];
+  };
+
+  // On a single thread, the natural row order has better locality
+  const int n_threads = n_level_threads();
+  if (n_threads == 1)
+  {
+    for (size_t i = 0; i < n; ++i)
+      forward(i);
+    for (size_t i = n; i-- > 0;)
+      backward(i);
+    return;
+  }
+
+  #pragma omp parallel num_threads(n_threads)
+  {
+    for (size_t l = 0; l + 1 < lower_level_offsets.size(); ++l)
+    {
+      const long begin = static_cast<long>(lower_level_offsets[l]);
+      const long end = static_cast<long>(lower_level_offsets[l + 1]);
+
+      #pragma omp for schedule(static)
+      for (long s = begin; s < end; ++s)
+        forward(lower_levels[s]);
+    }
+
+    for (size_t l = 0; l + 1 < upper_level_offsets.size(); ++l)
+    {
+      const long begin = static_cast<long>(upper_level_offsets[l]);
+      const long end = static_cast<long>(upper_level_offsets[l + 1]);
+
+      #pragma omp for schedule(static)
+      for (long s = begin; s < end; ++s)
+        backward(upper_levels[s]);
+    }
+  }
+}
+
+
+size_t
+IncompleteFactorization::n_lower_levels() const
+{
+  return lower_level_offsets.empty() ? 0 : lower_level_offsets.size() - 1;
+}
+
+
+size_t
+IncompleteFactorization::n_upper_levels() const
+{
+  return upper_level_offsets.empty() ? 0 : upper_level_offsets.size() - 1;
+}
+
+
+bool
+IncompleteFactorization::copy_matrix(const SparseMatrix& matrix)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+
+  // Check whether the sparsity pattern is unchanged
+  bool same_pattern = matrix.n_rows() == n &&
+                      matrix.n_nonzero_entries() == values.size();
+  for (size_t i = 0; i < n && same_pattern; ++i)
+  {
+    if (matrix.row_length(i) != row_offsets[i + 1] - row_offsets[i])
+    {
+      same_pattern = false;
+      break;
+    }
+    if (matrix.row_length(i) == 0)
+      continue;
+
+    size_t p = row_offsets[i];
+    for (const auto el: matrix.row_iterator(i))
+      if (el.column != colnums[p++])
+      {
+        same_pattern = false;
+        break;
+      }
+  }
+
+  // Rebuild the sparsity pattern and the level schedules
+  if (!same_pattern)
+  {
+    n = matrix.n_rows();
+    row_offsets.assign(n + 1, 0);
+    diagonal_offsets.assign(n, invalid);
+    colnums.clear();
+    colnums.reserve(matrix.n_nonzero_entries());
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (matrix.row_length(i) > 0)
+        for (const auto el: matrix.row_iterator(i))
+        {
+          if (el.column == i)
+            diagonal_offsets[i] = colnums.size();
+          colnums.push_back(el.column);
+        }
+      row_offsets[i + 1] = colnums.size();
+
+      if (diagonal_offsets[i] == invalid)
+      {
+        n = 0;
+        throw std::runtime_error(
+            name + ": Missing diagonal entry in row " +
+            std::to_string(i) + ".");
+      }
+    }
+    values.resize(colnums.size());
+    compute_levels();
+  }
+
+  // Copy the values
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (matrix.row_length(i) == 0)
+      continue;
+
+    size_t p = row_offsets[i];
+    for (const auto el: matrix.row_iterator(i))
+      values[p++] = el.value;
+  }
+  return !same_pattern;
+}
+
+
+int
+IncompleteFactorization::n_level_threads() const
+{
+  const size_t n_levels = std::max(n_lower_levels(), n_upper_levels());
+  if (n_levels == 0 || n / n_levels < min_rows_per_level)
+    return 1;
+  return static_cast<int>(MultiThreading::n_threads(values.size()));
+}
+
+
+void
+IncompleteFactorization::compute_levels()
+{
+  std::vector<size_t> level(n, 0);
+
+  // Each row follows the rows it depends on in the lower triangular solve
+  for (size_t i = 0; i < n; ++i)
+    for (size_t p = row_offsets[i]; p < diagonal_offsets[i]; ++p)
+      level[i] = std::max(level[i], level[colnums[p]] + 1);
+  sort_by_level(level, lower_level_offsets, lower_levels);
+
+  // And in reverse for the upper triangular solve
+  std::fill(level.begin(), level.end(), 0);
+  for (size_t i = n; i-- > 0;)
+    for (size_t p = diagonal_offsets[i] + 1; p < row_offsets[i + 1]; ++p)
+      level[i] = std::max(level[i], level[colnums[p]] + 1);
+  sort_by_level(level, upper_level_offsets, upper_levels);
+}
+
+//################################################## ILUPreconditioner
+
+
+ILUPreconditioner::ILUPreconditioner() :
+    IncompleteFactorization("ILUPreconditioner")
+{}
+
+
+void
+ILUPreconditioner::set_matrix(const SparseMatrix& matrix)
+{
+  copy_matrix(matrix);
+
+  size_t first_zero_pivot = invalid;
+  #pragma omp parallel num_threads(n_level_threads())
+  {
+    // The position of each column within the current row
+    std::vector<size_t> position(n, invalid);
+
+    for (size_t l = 0; l + 1 < lower_level_offsets.size(); ++l)
+    {
+      const long begin = static_cast<long>(lower_level_offsets[l]);
+      const long end = static_cast<long>(lower_level_offsets[l + 1]);
+
+      #pragma omp for schedule(static)
+      for (long s = begin; s < end; ++s)
+      {
+        const size_t i = lower_levels[s];
+        for (size_t p = row_offsets[i]; p < row_offsets[i + 1]; ++p)
+          position[colnums[p]] = p;
+
+        // Eliminate the strictly lower entries in increasing column order,
+        // dropping updates outside the sparsity pattern
+        for (size_t p = row_offsets[i]; p < diagonal_offsets[i]; ++p)
+        {
+          const size_t k = colnums[p];
+          const double l_ik = (values[p] /= values[diagonal_offsets[k]]);
+          for (size_t q = diagonal_offsets[k] + 1; q < row_offsets[k + 1]; ++q)
+          {
+            const size_t j = position[colnums[q]];
+            if (j != invalid)
+              values[j] -= l_ik * values[q];
+          }
+        }
+
+        for (size_t p = row_offsets[i]; p < row_offsets[i + 1]; ++p)
+          position[colnums[p]] = invalid;
+
+        if (values[diagonal_offsets[i]] == 0.0)
+        {
+          #pragma omp critical
+          first_zero_pivot = std::min(first_zero_pivot, i);
+        }
+      }
+    }
+  }
+
+  if (first_zero_pivot != invalid)
+    throw std::runtime_error(
+        name + ": Zero pivot encountered in row " +
+        std::to_string(first_zero_pivot) + ".");
+}
+
+//################################################## ICPreconditioner
+
+
+ICPreconditioner::ICPreconditioner() :
+    IncompleteFactorization("ICPreconditioner")
+{}
+
+
+void
+ICPreconditioner::set_matrix(const SparseMatrix& matrix)
+{
+  // Find the transposed entry of each strictly lower entry. These are
+  // distinct, so the pattern is symmetric if each one exists and the
+  // strictly lower and upper triangles have as many entries.
+  if (copy_matrix(matrix))
+  {
+    size_t n_lower = 0;
+    bool symmetric = true;
+    transpose_offsets.assign(values.size(), invalid);
+    for (size_t i = 0; i < n && symmetric; ++i)
+      for (size_t p = row_offsets[i]; p < diagonal_offsets[i]; ++p)
+      {
+        const size_t k = colnums[p];
+        const auto first = colnums.begin() + diagonal_offsets[k] + 1;
+        const auto last = colnums.begin() + row_offsets[k + 1];
+        const auto it = std::lower_bound(first, last, i);
+        if (it == last || *it != i)
+        {
+          symmetric = false;
+          break;
+        }
+        transpose_offsets[p] = it - colnums.begin();
+        ++n_lower;
+      }
+
+    if (!symmetric || 2 * n_lower + n != values.size())
+    {
+      n = 0;
+      throw std::runtime_error(
+          name + ": The sparsity pattern is not symmetric.");
+    }
+  }
+
+  // Compute the incomplete Cholesky factor in the strictly lower triangle
+  // and the diagonal
+  size_t first_bad_pivot = invalid;
+  const int n_threads = n_level_threads();
+  #pragma omp parallel num_threads(n_threads)
+  {
+    // The position of each column within the strictly lower part of the
+    // current row
+    std::vector<size_t> position(n, invalid);
+
+    for (size_t l = 0; l + 1 < lower_level_offsets.size(); ++l)
+    {
+      const long begin = static_cast<long>(lower_level_offsets[l]);
+      const long end = static_cast<long>(lower_level_offsets[l + 1]);
+
+      #pragma omp for schedule(static)
+      for (long s = begin; s < end; ++s)
+      {
+        const size_t i = lower_levels[s];
+        for (size_t p = row_offsets[i]; p < diagonal_offsets[i]; ++p)
+          position[colnums[p]] = p;
+
+        // Compute l_ik = (a_ik - sum_{j < k} l_ij l_kj) / l_kk over the
+        // common sparsity pattern of rows i and k
+        double d = values[diagonal_offsets[i]];
+        for (size_t p = row_offsets[i]; p < diagonal_offsets[i]; ++p)
+        {
+          const size_t k = colnums[p];
+          double value = values[p];
+          for (size_t q = row_offsets[k]; q < diagonal_offsets[k]; ++q)
+          {
+            const size_t j = position[colnums[q]];
+            if (j != invalid)
+              value -= values[j] * values[q];
+          }
+          values[p] = value / values[diagonal_offsets[k]];
+          d -= values[p] * values[p];
+        }
+
+        for (size_t p = row_offsets[i]; p < diagonal_offsets[i]; ++p)
+          position[colnums[p]] = invalid;
+
+        if (d <= 0.0)
+        {
+          #pragma omp critical
+          first_bad_pivot = std::min(first_bad_pivot, i);
+          d = 1.0;
+        }
+        values[diagonal_offsets[i]] = std::sqrt(d);
+      }
+    }
+  }
+
+  if (first_bad_pivot != invalid)
+    throw std::runtime_error(
+        name + ": Non-positive pivot encountered in row " +
+        std::to_string(first_bad_pivot) + ". The matrix is not positive "
+        "definite.");
+
+  // Convert to the LU form shared with ILU(0). The diagonal is squared
+  // only after all off-diagonal entries are scaled.
+  const long n_rows = static_cast<long>(n);
+  #pragma omp parallel for num_threads(n_threads) schedule(static)
+  for (long i = 0; i < n_rows; ++i)
+    for (size_t p = row_offsets[i]; p < diagonal_offsets[i]; ++p)
+    {
+      const double l_kk = values[diagonal_offsets[colnums[p]]];
+      values[transpose_offsets[p]] = l_kk * values[p];
+      values[p] /= l_kk;
+    }
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static)
+  for (long i = 0; i < n_rows; ++i)
+    values[diagonal_offsets[i]] *= values[diagonal_offsets[i]];
+}
@@ -0,0 +1,172 @@
+#ifndef INCOMPLETE_FACTORIZATION_H
+#define INCOMPLETE_FACTORIZATION_H
+
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * A base class for incomplete factorization preconditioners with zero
+       * fill-in.
+       *
+       * The factors share the sparsity pattern of the matrix, so they are
+       * stored as a single compressed sparse row copy of the matrix where the
+       * strictly lower triangle holds the unit lower triangular factor
+       * \f$ L \f$ and the remainder holds the upper triangular factor
+       * \f$ U \f$, with \f$ M = L U \f$. Setting up the preconditioner again
+       * with a matrix with the same sparsity pattern only copies the values
+       * and refactorizes.
+       *
+       * The triangular solves, and the factorizations, are parallelized with
+       * level scheduling. Row \p i of the lower triangular solve depends on
+       * the rows of the columns in the strictly lower part of row \p i, so
+       * each row is assigned a level one greater than the largest level of
+       * these rows. All rows of a level are independent and are processed
+       * concurrently, with a synchronization between levels. The upper
+       * triangular solve is scheduled likewise in reverse. For a finite
+       * volume discretization on a structured mesh, the levels are the
+       * wavefronts of cells through the mesh.
+       */
+      class IncompleteFactorization : public Preconditioner
+      {
+      protected:
+        size_t n = 0;
+
+        /** The compressed sparsity pattern of the matrix. */
+        std::vector<size_t> row_offsets;
+        std::vector<unsigned int> colnums;
+        std::vector<size_t> diagonal_offsets;
+
+        /** The values of the factors. */
+        std::vector<double> values;
+
+        /**
+         * The rows grouped by level for the lower triangular solve. The rows
+         * of level \p l lie in <tt>[lower_level_offsets[l],
+         * lower_level_offsets[l + 1])</tt> of \p lower_levels.
+         */
+        std::vector<size_t> lower_level_offsets;
+        std::vector<size_t> lower_levels;
+
+        /** The rows grouped by level for the upper triangular solve. */
+        std::vector<size_t> upper_level_offsets;
+        std::vector<size_t> upper_levels;
+
+        /** The name of the preconditioner used in error messages. */
+        const std::string name;
+
+      public:
+        /** Default constructor. */
+        IncompleteFactorization(const std::string name);
+
+        /**
+         * Apply the preconditioner by forward and backward substitution with
+         * the incomplete factors. It is acceptable for \p z and \p r to be
+         * the same vector.
+         */
+        void vmult(Vector& z, const Vector& r) const override;
+
+        /** Return the number of levels of the lower triangular solve. */
+        size_t n_lower_levels() const;
+
+        /** Return the number of levels of the upper triangular solve. */
+        size_t n_upper_levels() const;
+
+      protected:
+        /**
+         * Copy the values of \p matrix. If the sparsity pattern differs from
+         * the stored one, the pattern and the level schedules are rebuilt
+         * first and true is returned. An error is thrown if a diagonal entry
+         * is missing.
+         */
+        bool copy_matrix(const SparseMatrix& matrix);
+
+        /**
+         * Return the number of threads used for the level-scheduled loops.
+         * A single thread is used when the levels are too narrow to amortize
+         * the synchronization between them.
+         */
+        int n_level_threads() const;
+
+      private:
+        /** Compute the level schedules from the sparsity pattern. */
+        void compute_levels();
+      };
+
+      //############################################################
+
+      /**
+       * Implementation of the incomplete LU factorization with zero fill-in,
+       * ILU(0).
+       *
+       * The factorization is the row-wise IKJ variant of Gaussian elimination
+       * where updates to entries outside the sparsity pattern are dropped.
+       * Row \p i only depends on the rows of its strictly lower part, so the
+       * rows are factorized level by level with the lower triangular
+       * schedule.
+       *
+       * This is applicable to general matrices with non-zero diagonal
+       * entries, such as the non-symmetric multigroup diffusion operator.
+       */
+      class ILUPreconditioner : public IncompleteFactorization
+      {
+      public:
+        /** Default constructor. */
+        ILUPreconditioner();
+
+        /**
+         * Compute the incomplete factorization of \p matrix. An error is
+         * thrown if a zero pivot is encountered.
+         */
+        void set_matrix(const SparseMatrix& matrix) override;
+      };
+
+
+      /**
+       * Implementation of the incomplete Cholesky factorization with zero
+       * fill-in, IC(0).
+       *
+       * The incomplete factor \f$ \tilde{L} \f$ with \f$ M = \tilde{L}
+       * \tilde{L}^T \f$ is computed row by row from the lower triangle only,
+       * which halves the work of ILU(0). It is then stored in the form
+       * \f$ L U \f$ with \f$ L = \tilde{L} D^{-1} \f$ and \f$ U = D
+       * \tilde{L}^T \f$, where \f$ D \f$ is the diagonal of \f$ \tilde{L}
+       * \f$, so that the triangular solves are shared with ILU(0).
+       *
+       * This is applicable to symmetric positive definite matrices, such as
+       * the within-group diffusion operator, and requires a symmetric
+       * sparsity pattern.
+       */
+      class ICPreconditioner : public IncompleteFactorization
+      {
+      private:
+        /**
+         * The position of the transposed entry of each entry in the strictly
+         * lower triangle, indexed by the position of the entry.
+         */
+        std::vector<size_t> transpose_offsets;
+
+      public:
+        /** Default constructor. */
+        ICPreconditioner();
+
+        /**
+         * Compute the incomplete factorization of \p matrix. An error is
+         * thrown if the sparsity pattern is not symmetric or a non-positive
+         * pivot is encountered.
+         */
+        void set_matrix(const SparseMatrix& matrix) override;
+      };
+    }
+  }
+}
+#endif //INCOMPLETE_FACTORIZATION_H
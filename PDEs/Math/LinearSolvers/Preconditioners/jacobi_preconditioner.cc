@@ -0,0 +1,51 @@
+#include "jacobi_preconditioner.h"
+
+#include "multithreading.h"
+#include "Math/sparse_matrix.h"
+
+#include <string>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+void
+JacobiPreconditioner::set_matrix(const SparseMatrix& matrix)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+
+  const size_t n = matrix.n_rows();
+  inverse_diagonal.resize(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double a_ii = matrix.diag_el(i);
+    if (a_ii == 0.0)
+      throw std::runtime_error(
+          "JacobiPreconditioner: Zero diagonal entry in row " +
+          std::to_string(i) + ".");
+    inverse_diagonal[i] = 1.0 / a_ii;
+  }
+}
+
+
+void
+JacobiPreconditioner::vmult(Vector& z, const Vector& r) const
+{
+  const size_t n = inverse_diagonal.size();
+  assert(r.size() == n);
+  assert(z.size() == n);
+
+  const double* d_ptr = inverse_diagonal.data();
+  const double* r_ptr = r.data();
+  double* z_ptr = z.data();
+
+  const long n_rows = static_cast<long>(n);
+  #pragma omp parallel for num_threads(MultiThreading::n_threads(n)) \
+          schedule(static)
+  for (long i = 0; i < n_rows; ++i)
+    z_ptr[i] = d_ptr[i] * r_ptr[i];
+}
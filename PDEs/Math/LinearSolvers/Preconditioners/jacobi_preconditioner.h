@@ -0,0 +1,39 @@
+#ifndef JACOBI_PRECONDITIONER_H
+#define JACOBI_PRECONDITIONER_H
+
+#include "LinearSolvers/Preconditioners/preconditioner.h"
+#include "vector.h"
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    namespace LinearSolvers
+    {
+      /**
+       * Implementation of the point-Jacobi preconditioner. This uses the
+       * diagonal of the matrix, \f$ M = D \f$, so that applying the
+       * preconditioner amounts to scaling each entry by the inverse of the
+       * corresponding diagonal entry.
+       */
+      class JacobiPreconditioner : public Preconditioner
+      {
+      private:
+        /** The inverse of the diagonal entries of the matrix. */
+        Vector inverse_diagonal;
+
+      public:
+        /**
+         * Store the inverse diagonal of \p matrix. An error is thrown if a
+         * diagonal entry is zero.
+         */
+        void set_matrix(const SparseMatrix& matrix) override;
+
+        /** Apply the preconditioner, i.e. \f$ z = D^{-1} r \f$. */
+        void vmult(Vector& z, const Vector& r) const override;
+      };
+    }
+  }
+}
+#endif //JACOBI_PRECONDITIONER_H
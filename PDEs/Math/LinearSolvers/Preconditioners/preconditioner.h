@@ -0,0 +1,45 @@
+#ifndef PRECONDITIONER_H
+#define PRECONDITIONER_H
+
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class Vector;
+    class SparseMatrix;
+
+
+    namespace LinearSolvers
+    {
+      /**
+       * An abstract base class for preconditioners.
+       *
+       * A preconditioner approximates the inverse of a matrix \f$ A \f$ with
+       * an operator \f$ M^{-1} \f$ which is cheap to apply. It is built from
+       * the matrix once via \ref set_matrix and then applied via \ref vmult
+       * within each iteration of an iterative solver. See
+       * IterativeSolverBase::set_preconditioner.
+       */
+      class Preconditioner
+      {
+      public:
+        /** Default destructor. */
+        virtual ~Preconditioner() = default;
+
+        /**
+         * Build the preconditioner from \p matrix. This must be called again
+         * after the matrix is modified.
+         */
+        virtual void set_matrix(const SparseMatrix& matrix) = 0;
+
+        /** Apply the preconditioner, i.e. \f$ z = M^{-1} r \f$. */
+        virtual void vmult(Vector& z, const Vector& r) const = 0;
+      };
+    }
+  }
+}
+#endif //PRECONDITIONER_H
@@ -1,8 +1,10 @@
 #include "LinearSolvers/linear_solver.h"
+#include "LinearSolvers/Preconditioners/preconditioner.h"
 
 #include "vector.h"
 #include "matrix.h"
 #include "Math/sparse_matrix.h"
+#include "Math/sell_matrix.h"
 
 #include <iomanip>
 #include <cassert>
@@ -31,6 +33,14 @@ LinearSolverBase<MatrixType>::set_matrix(const MatrixType& matrix)
 }
 
 
+template<class MatrixType>
+std::shared_ptr<LinearSolverBase<MatrixType>>
+LinearSolverBase<MatrixType>::clone() const
+{
+  return nullptr;
+}
+
+
 template class LinearSolvers::LinearSolverBase<Matrix>;
 template class LinearSolvers::LinearSolverBase<SparseMatrix>;
 
@@ -69,6 +79,7 @@ Options::Options(const double tolerance,
 
 IterativeSolverBase::
 IterativeSolverBase(const Options& opts, const std::string name) :
+    use_sell(opts.use_sell),
     tolerance(opts.tolerance),
     max_iterations(opts.max_iterations),
     verbosity(opts.verbosity),
@@ -81,7 +92,50 @@ IterativeSolverBase::
 set_matrix(const SparseMatrix& matrix)
 {
   LinearSolverBase<SparseMatrix>::set_matrix(matrix);
+  A_sparse = &matrix;
   A = &matrix;
+
+  if (use_sell)
+  {
+    if (!A_sell)
+      A_sell = std::make_shared<SELLMatrix>();
+    A_sell->reinit(matrix);
+    A = A_sell.get();
+  }
+
+  if (preconditioner)
+    preconditioner->set_matrix(matrix);
+}
+
+
+void
+IterativeSolverBase::
+set_operator(const LinearOperator& op)
+{
+  assert(op.n_rows() == op.n_cols());
+  A_sparse = dynamic_cast<const SparseMatrix*>(&op);
+  A = &op;
+}
+
+
+void
+IterativeSolverBase::
+set_preconditioner(std::shared_ptr<Preconditioner> pc)
+{
+  preconditioner = pc;
+  if (preconditioner && A_sparse)
+    preconditioner->set_matrix(*A_sparse);
+}
+
+
+const SparseMatrix&
+IterativeSolverBase::
+sparse_matrix() const
+{
+  if (!A_sparse)
+    throw std::runtime_error(
+        solver_name + " requires the operator to be a SparseMatrix.");
+  return *A_sparse;
 }
 
 
@@ -2,6 +2,7 @@
 #define LINEAR_SOLVER_BASE_H
 
 #include <cstddef>
+#include <memory>
 #include <string>
 
 
@@ -13,10 +14,16 @@ namespace PDEs
     class Vector;
     class Matrix;
     class SparseMatrix;
+    class LinearOperator;
+    class SELLMatrix;
 
 
     namespace LinearSolvers
     {
+      //forward declarations
+      class Preconditioner;
+
+
       /**
        * A base class from which all linear solvers must derive. This is
        * templated on the MatrixType in order to accommodate both dense matrices
@@ -26,6 +33,9 @@ namespace PDEs
       class LinearSolverBase
       {
       public:
+        /** Default destructor. */
+        virtual ~LinearSolverBase() = default;
+
         /** Abstract method for solving a linear system. */
         virtual void solve(Vector& x, const Vector& b) const = 0;
 
@@ -34,6 +44,13 @@ namespace PDEs
 
         /** Attach a matrix to the solver. */
         virtual void set_matrix(const MatrixType& matrix);
+
+        /**
+         * Return a new solver with the same settings and no attached matrix.
+         * This allows several factorized systems to be kept alive at once.
+         * Solvers which do not support this return a null pointer.
+         */
+        virtual std::shared_ptr<LinearSolverBase<MatrixType>> clone() const;
       };
 
       //############################################################
@@ -78,6 +95,13 @@ namespace PDEs
         unsigned int max_iterations;
         unsigned int verbosity;
 
+        /**
+         * A flag for whether iterative solvers should convert attached sparse
+         * matrices to the SELL-C-\f$ \sigma \f$ format for matrix-vector
+         * products. See SELLMatrix.
+         */
+        bool use_sell = false;
+
         Options(const double tolerance = 1.0e-6,
                 const unsigned int max_iterations = 500,
                 const unsigned int verbosity = 0);
@@ -86,11 +110,35 @@ namespace PDEs
 
       /**
        * Base class for iterative solvers. This is defaulted to sparse matrices.
+       *
+       * Iterative solvers store the system as a LinearOperator so that any
+       * matrix format which implements a matrix-vector product can be used.
+       * Solvers which require access to individual matrix entries must use
+       * \ref sparse_matrix.
        */
       class IterativeSolverBase : public LinearSolverBase<SparseMatrix>
       {
       protected:
-        const SparseMatrix* A;
+        const LinearOperator* A;
+
+        /**
+         * The attached sparse matrix, if any. This is used by solvers which
+         * require access to individual matrix entries.
+         */
+        const SparseMatrix* A_sparse = nullptr;
+
+        /**
+         * A SELL-C-\f$ \sigma \f$ copy of the attached sparse matrix, used
+         * for matrix-vector products when \p use_sell is set.
+         */
+        std::shared_ptr<SELLMatrix> A_sell;
+        bool use_sell = false;
+
+        /**
+         * The preconditioner, if any. Solvers which support preconditioning
+         * apply it to each residual, see \ref set_preconditioner.
+         */
+        std::shared_ptr<Preconditioner> preconditioner;
 
         double tolerance;
         unsigned int max_iterations;
@@ -111,11 +159,42 @@ namespace PDEs
         IterativeSolverBase(const Options& opts = Options(),
                             const std::string name = "Undefined");
 
-        /** Attach the sparse matrix to the iterative linear solver. */
+        /**
+         * Attach the sparse matrix to the iterative linear solver. When
+         * \p use_sell is set, matrix-vector products are performed with a
+         * SELL-C-\f$ \sigma \f$ copy of the matrix, so this must be called
+         * again after the matrix is modified.
+         */
         void set_matrix(const SparseMatrix& matrix) override;
 
+        /**
+         * Attach a generic linear operator to the iterative linear solver.
+         * Only solvers which require nothing more than a matrix-vector
+         * product support operators which are not a SparseMatrix.
+         */
+        virtual void set_operator(const LinearOperator& op);
+
+        /**
+         * Set the preconditioner. If a sparse matrix is attached, the
+         * preconditioner is built from it immediately and it is rebuilt
+         * whenever a new matrix is attached with \ref set_matrix. When a
+         * generic operator is attached, the preconditioner is used as is and
+         * must be built by the caller. Passing a null pointer removes the
+         * preconditioner.
+         *
+         * Krylov solvers apply the preconditioner to each residual. The
+         * stationary solvers, i.e. Jacobi and SOR, ignore it.
+         */
+        virtual void set_preconditioner(std::shared_ptr<Preconditioner> pc);
+
 
       protected:
+        /**
+         * Return the attached sparse matrix. This throws an error if the
+         * attached operator is not a SparseMatrix.
+         */
+        const SparseMatrix& sparse_matrix() const;
+
         /**
          * Check whether the solver has converged. This is an abstract class that
          * should be overridden with the appropriate check for convergence for
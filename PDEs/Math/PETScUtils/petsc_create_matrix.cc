@@ -4,6 +4,9 @@
 #include "matrix.h"
 #include "Math/sparse_matrix.h"
 
+#include <vector>
+#include <algorithm>
+
 
 using namespace PDEs;
 using namespace Math;
@@ -47,12 +50,52 @@ PETScUtils::create_petsc_matrix(Mat& A, const Matrix& mat)
 void
 PETScUtils::create_petsc_matrix(Mat& A, const SparseMatrix& mat)
 {
-  create_petsc_matrix(A, static_cast<PetscInt>(mat.n_rows()),
-                      static_cast<PetscInt>(mat.n_cols()));
+  const auto n_rows = static_cast<PetscInt>(mat.n_rows());
+  const auto n_cols = static_cast<PetscInt>(mat.n_cols());
+
+  // Get the number of entries per row for preallocation
+  std::vector<PetscInt> row_lengths(n_rows);
+  PetscInt max_row_length = 0;
+  for (PetscInt i = 0; i < n_rows; ++i)
+  {
+    row_lengths[i] = static_cast<PetscInt>(mat.row_length(i));
+    max_row_length = std::max(max_row_length, row_lengths[i]);
+  }
+
+  // Zero entries are kept so that the pattern matches the sparse matrix
+  MatCreate(PETSC_COMM_WORLD, &A);
+  MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, n_rows, n_cols);
+  MatSetType(A, MATAIJ);
+  MatSetFromOptions(A);
+  MatSeqAIJSetPreallocation(A, 0, row_lengths.data());
+  MatMPIAIJSetPreallocation(A, max_row_length, NULL, max_row_length, NULL);
+
+  fill_petsc_matrix(A, mat);
+}
+
+
+void
+PETScUtils::fill_petsc_matrix(Mat& A, const SparseMatrix& mat)
+{
+  std::vector<PetscInt> columns;
+  std::vector<PetscScalar> values;
+  for (size_t i = 0; i < mat.n_rows(); ++i)
+  {
+    if (mat.row_length(i) == 0)
+      continue;
+
+    columns.clear();
+    values.clear();
+    for (const auto el: mat.row_iterator(i))
+    {
+      columns.push_back(static_cast<PetscInt>(el.column));
+      values.push_back(static_cast<PetscScalar>(el.value));
+    }
 
-  // Add data to the PETSc matrix
-  for (const auto el: mat)
-    MatSetValue(A, el.row, el.column, el.value, ADD_VALUES);
+    const auto row = static_cast<PetscInt>(i);
+    MatSetValues(A, 1, &row, static_cast<PetscInt>(columns.size()),
+                 columns.data(), values.data(), INSERT_VALUES);
+  }
 
   MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
   MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
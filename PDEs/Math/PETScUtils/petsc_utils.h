@@ -35,11 +35,21 @@ namespace PDEs
       /** Create a PETSc matrix from a Matrix. */
       void create_petsc_matrix(Mat& A, const Matrix& mat);
 
-      /** Create a PETSc matrix from a SparseMatrix. */
+      /**
+       * Create a PETSc matrix from a SparseMatrix. The AIJ storage is
+       * preallocated from the row lengths of \p mat and every stored entry,
+       * including explicit zeros, becomes part of the PETSc sparsity pattern
+       * so that the matrix can later be refilled with \ref fill_petsc_matrix.
+       */
       void create_petsc_matrix(Mat& A, const SparseMatrix& mat);
 
-      //  void InitMatrixSparsity(Mat& A, PetscInt n,
-      //                          const std::vector<PetscInt>& nnz_per_row);
+      /**
+       * Overwrite the values of the PETSc matrix \p A with those of \p mat.
+       * The matrix must have been created from a SparseMatrix with the same
+       * sparsity pattern. The values are inserted row-wise and no memory is
+       * allocated.
+       */
+      void fill_petsc_matrix(Mat& A, const SparseMatrix& mat);
 
       /** Copy the contents of a PETSc vector \p x to Vector \p vec. */
       void copy_petsc_vector(Vec& x, Vector& vec);
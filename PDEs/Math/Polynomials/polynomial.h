@@ -36,7 +36,9 @@ namespace PDEs
       /**
        * Evaluate the order \p n Chebyshev polynomial at \p x.
        *
-       * \note \p x should be in the range [-1, 1].
+       * \note The recurrence is valid for any \p x. Outside of the range
+       *       [-1, 1], the polynomial grows exponentially with \p n, which
+       *       determines the convergence rate of Chebyshev iterations.
        */
       double chebyshev(const unsigned int n, const double x);
     }
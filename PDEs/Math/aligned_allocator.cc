@@ -0,0 +1,66 @@
+#include "aligned_allocator.h"
+
+#include <cstdlib>
+#include <cassert>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+
+using namespace PDEs;
+using namespace Math;
+
+
+namespace
+{
+  bool huge_pages = false;
+}
+
+
+void*
+Math::aligned_malloc(const size_t n_bytes, const size_t alignment)
+{
+  assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  if (n_bytes == 0)
+    return nullptr;
+
+  // When huge pages are enabled, large allocations are aligned to huge page
+  // boundaries so that they can be backed by huge pages. Otherwise, the
+  // padding to a huge page multiple would be wasted. std::aligned_alloc
+  // requires the size to be a multiple of the alignment.
+  const bool huge = huge_pages && n_bytes >= huge_page_size;
+  const size_t align = huge ? huge_page_size : alignment;
+  const size_t size = (n_bytes + align - 1) / align * align;
+
+  void* ptr = std::aligned_alloc(align, size);
+  if (!ptr)
+    throw std::bad_alloc();
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (huge)
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+  return ptr;
+}
+
+
+void
+Math::aligned_free(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+
+void
+Math::use_huge_pages(const bool flag)
+{
+  huge_pages = flag;
+}
+
+
+bool
+Math::use_huge_pages()
+{
+  return huge_pages;
+}
@@ -0,0 +1,107 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    /**
+     * The default alignment of vector storage, in bytes. This is the size of
+     * a cache line and of an AVX-512 register.
+     */
+    constexpr size_t default_alignment = 64;
+
+    /**
+     * When huge pages are enabled, allocations of at least this many bytes
+     * are aligned to a huge page boundary and backed by transparent huge
+     * pages. See \ref use_huge_pages.
+     */
+    constexpr size_t huge_page_size = size_t(2) << 20;
+
+    /**
+     * Allocate \p n_bytes of storage aligned to \p alignment bytes, which
+     * must be a power of two. This throws \p std::bad_alloc on failure.
+     */
+    void* aligned_malloc(const size_t n_bytes, const size_t alignment);
+
+    /** Free storage allocated with \ref aligned_malloc. */
+    void aligned_free(void* ptr) noexcept;
+
+    /**
+     * Set whether large allocations should request transparent huge pages
+     * from the operating system. This reduces TLB misses when streaming
+     * through large vectors. It is disabled by default and has no effect on
+     * systems without transparent huge page support.
+     */
+    void use_huge_pages(const bool flag);
+
+    /** Return whether large allocations request transparent huge pages. */
+    bool use_huge_pages();
+
+
+    /**
+     * A standard library compatible allocator which returns storage aligned
+     * to \p Alignment bytes. This allows kernels to use aligned SIMD loads
+     * and guarantees that the first entry of a vector starts a cache line.
+     */
+    template<typename T, size_t Alignment = default_alignment>
+    class AlignedAllocator
+    {
+      static_assert(Alignment >= alignof(T) &&
+                    (Alignment & (Alignment - 1)) == 0,
+                    "The alignment must be a power of two.");
+
+    public:
+      using value_type = T;
+
+      template<typename U>
+      struct rebind
+      {
+        using other = AlignedAllocator<U, Alignment>;
+      };
+
+      AlignedAllocator() noexcept = default;
+
+      template<typename U>
+      AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+      {}
+
+      /** Allocate aligned storage for \p n objects. */
+      T* allocate(const size_t n)
+      {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+          throw std::bad_alloc();
+        return static_cast<T*>(aligned_malloc(n * sizeof(T), Alignment));
+      }
+
+      /** Free storage obtained from \ref allocate. */
+      void deallocate(T* ptr, const size_t) noexcept
+      {
+        aligned_free(ptr);
+      }
+    };
+
+
+    template<typename T, typename U, size_t Alignment>
+    bool operator==(const AlignedAllocator<T, Alignment>&,
+                    const AlignedAllocator<U, Alignment>&) noexcept
+    {
+      return true;
+    }
+
+
+    template<typename T, typename U, size_t Alignment>
+    bool operator!=(const AlignedAllocator<T, Alignment>&,
+                    const AlignedAllocator<U, Alignment>&) noexcept
+    {
+      return false;
+    }
+  }
+}
+
+#endif //ALIGNED_ALLOCATOR_H
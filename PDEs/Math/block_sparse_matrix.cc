@@ -0,0 +1,349 @@
+#include "block_sparse_matrix.h"
+
+#include "vector.h"
+#include "sparse_matrix.h"
+#include "sparsity_pattern.h"
+#include "multithreading.h"
+
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+
+//################################################## Constructors
+
+BlockSparseMatrix::BlockSparseMatrix() :
+    block_rows(0), block_cols(0), bs(1),
+    diagonal_off_diagonal_blocks(false),
+    block_row_offsets(1, 0)
+{}
+
+
+BlockSparseMatrix::
+BlockSparseMatrix(const SparsityPattern& block_pattern,
+                  const unsigned int block_size,
+                  const bool diagonal_off_diagonal_blocks)
+{
+  reinit(block_pattern, block_size, diagonal_off_diagonal_blocks);
+}
+
+
+void
+BlockSparseMatrix::
+reinit(const SparsityPattern& block_pattern,
+       const unsigned int block_size,
+       const bool diagonal_off_diagonal_blocks)
+{
+  assert(block_pattern.is_compressed());
+  assert(block_pattern.n_rows() == block_pattern.n_cols());
+  assert(block_size > 0);
+
+  block_rows = block_pattern.n_rows();
+  block_cols = block_pattern.n_cols();
+  bs = block_size;
+  this->diagonal_off_diagonal_blocks = diagonal_off_diagonal_blocks;
+
+  assert(block_cols <= std::numeric_limits<unsigned int>::max());
+  diagonal_values.assign(block_rows * bs * bs, 0.0);
+
+  // Pack the off-diagonal blocks of the pattern. These are already sorted.
+  block_row_offsets.assign(block_rows + 1, 0);
+  block_colnums.clear();
+  for (size_t br = 0; br < block_rows; ++br)
+  {
+    for (unsigned int k = 0; k < block_pattern.row_length(br); ++k)
+    {
+      const size_t bc = block_pattern.column(br, k);
+      if (bc != br)
+        block_colnums.push_back(bc);
+    }
+    block_row_offsets[br + 1] = block_colnums.size();
+  }
+
+  const size_t block_entries = diagonal_off_diagonal_blocks ? bs : bs * bs;
+  off_diagonal_values.assign(block_colnums.size() * block_entries, 0.0);
+}
+
+
+void
+BlockSparseMatrix::copy_from(const SparseMatrix& matrix,
+                             const unsigned int block_size)
+{
+  assert(block_size > 0);
+  assert(matrix.n_rows() == matrix.n_cols());
+  assert(matrix.n_rows() % block_size == 0);
+
+  // Determine the block structure and whether any off-diagonal block has
+  // entries off of its diagonal
+  const size_t n_blocks = matrix.n_rows() / block_size;
+  SparsityPattern block_pattern(n_blocks, n_blocks);
+
+  bool diagonal_only = true;
+  for (size_t i = 0; i < matrix.n_rows(); ++i)
+  {
+    if (matrix.row_length(i) == 0)
+      continue;
+
+    for (const auto el: matrix.row_iterator(i))
+    {
+      const size_t br = i / block_size, bc = el.column / block_size;
+      block_pattern.add(br, bc);
+      if (br != bc && i % block_size != el.column % block_size)
+        diagonal_only = false;
+    }
+  }
+  block_pattern.compress();
+
+  // Allocate and copy the values
+  reinit(block_pattern, block_size, diagonal_only);
+  for (size_t i = 0; i < matrix.n_rows(); ++i)
+  {
+    if (matrix.row_length(i) == 0)
+      continue;
+
+    for (const auto el: matrix.row_iterator(i))
+      set(i, el.column, el.value);
+  }
+}
+
+
+BlockSparseMatrix&
+BlockSparseMatrix::operator=(const double value)
+{
+  std::fill(diagonal_values.begin(), diagonal_values.end(), value);
+  std::fill(off_diagonal_values.begin(), off_diagonal_values.end(), value);
+  return *this;
+}
+
+//################################################## Capacity
+
+size_t
+BlockSparseMatrix::n_rows() const
+{
+  return block_rows * bs;
+}
+
+
+size_t
+BlockSparseMatrix::n_cols() const
+{
+  return block_cols * bs;
+}
+
+
+size_t
+BlockSparseMatrix::n_block_rows() const
+{
+  return block_rows;
+}
+
+
+size_t
+BlockSparseMatrix::n_block_cols() const
+{
+  return block_cols;
+}
+
+
+unsigned int
+BlockSparseMatrix::block_size() const
+{
+  return bs;
+}
+
+
+size_t
+BlockSparseMatrix::n_nonzero_entries() const
+{
+  return diagonal_values.size() + off_diagonal_values.size();
+}
+
+
+bool
+BlockSparseMatrix::has_diagonal_off_diagonal_blocks() const
+{
+  return diagonal_off_diagonal_blocks;
+}
+
+//################################################## Data Access
+
+double
+BlockSparseMatrix::el(const size_t i, const size_t j) const
+{
+  const double* ptr = locate(i, j);
+  return (ptr) ? *ptr : 0.0;
+}
+
+
+double*
+BlockSparseMatrix::diagonal_block(const size_t block_row)
+{
+  assert(block_row < block_rows);
+  return diagonal_values.data() + block_row * bs * bs;
+}
+
+
+const double*
+BlockSparseMatrix::diagonal_block(const size_t block_row) const
+{
+  assert(block_row < block_rows);
+  return diagonal_values.data() + block_row * bs * bs;
+}
+
+
+const double*
+BlockSparseMatrix::locate(const size_t i, const size_t j) const
+{
+  assert(i < n_rows());
+  assert(j < n_cols());
+
+  const size_t br = i / bs, bc = j / bs;
+  const unsigned int ii = i % bs, jj = j % bs;
+
+  // Direct access for the diagonal blocks
+  if (br == bc)
+    return diagonal_block(br) + ii * bs + jj;
+
+  if (diagonal_off_diagonal_blocks && ii != jj)
+    return nullptr;
+
+  // Search the off-diagonal blocks of the block row
+  const auto first = block_colnums.begin() + block_row_offsets[br];
+  const auto last = block_colnums.begin() + block_row_offsets[br + 1];
+  const auto it = std::lower_bound(first, last, bc);
+  if (it == last || *it != bc)
+    return nullptr;
+
+  const size_t block = it - block_colnums.begin();
+  return (diagonal_off_diagonal_blocks) ?
+         off_diagonal_values.data() + block * bs + ii :
+         off_diagonal_values.data() + block * bs * bs + ii * bs + jj;
+}
+
+//################################################## Modifiers
+
+void
+BlockSparseMatrix::set(const size_t i, const size_t j, const double value)
+{
+  double* ptr = const_cast<double*>(locate(i, j));
+  assert(ptr && "The element is not within the block structure.");
+  *ptr = value;
+}
+
+
+void
+BlockSparseMatrix::add(const size_t i, const size_t j, const double value)
+{
+  double* ptr = const_cast<double*>(locate(i, j));
+  assert(ptr && "The element is not within the block structure.");
+  *ptr += value;
+}
+
+//################################################## Matrix-Vector
+
+void
+BlockSparseMatrix::vmult(Vector& y,
+                         const Vector& x,
+                         const bool adding) const
+{
+  assert(x.size() == n_cols());
+  assert(y.size() == n_rows());
+  assert(&x != &y);
+
+  // Split the block rows into chunks with an equal number of blocks, which
+  // are approximately equal amounts of work, one per thread
+  const int n_threads = MultiThreading::n_threads(n_nonzero_entries());
+
+  std::vector<size_t> bounds = {0, block_rows};
+  if (n_threads > 1)
+  {
+    std::vector<size_t> offsets(block_rows + 1);
+    for (size_t br = 0; br <= block_rows; ++br)
+      offsets[br] = br + block_row_offsets[br];
+    bounds = MultiThreading::partition(offsets.data(), block_rows, n_threads);
+  }
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t)
+  {
+    const size_t begin = bounds[t], end = bounds[t + 1];
+    switch (bs)
+    {
+      case 1: vmult_kernel<1>(y.data(), x.data(), adding, begin, end); break;
+      case 2: vmult_kernel<2>(y.data(), x.data(), adding, begin, end); break;
+      case 3: vmult_kernel<3>(y.data(), x.data(), adding, begin, end); break;
+      case 4: vmult_kernel<4>(y.data(), x.data(), adding, begin, end); break;
+      case 7: vmult_kernel<7>(y.data(), x.data(), adding, begin, end); break;
+      case 8: vmult_kernel<8>(y.data(), x.data(), adding, begin, end); break;
+      default: vmult_kernel<0>(y.data(), x.data(), adding, begin, end);
+    }
+  }
+}
+
+
+Vector
+BlockSparseMatrix::operator*(const Vector& x) const
+{
+  Vector y(n_rows());
+  vmult(y, x);
+  return y;
+}
+
+
+template<unsigned int BS>
+void
+BlockSparseMatrix::vmult_kernel(double* y,
+                                const double* x,
+                                const bool adding,
+                                const size_t begin,
+                                const size_t end) const
+{
+  const unsigned int b = (BS > 0) ? BS : bs;
+  const size_t block_entries = diagonal_off_diagonal_blocks ? b : b * b;
+
+  const unsigned int* col_ptr =
+      block_colnums.data() + block_row_offsets[begin];
+  const double* a_ptr =
+      off_diagonal_values.data() + block_row_offsets[begin] * block_entries;
+  const double* d_ptr = diagonal_values.data() + begin * b * b;
+
+  y += begin * b;
+  for (size_t br = begin; br < end; ++br, y += b, d_ptr += b * b)
+  {
+    // Dense diagonal block contribution
+    const double* x_br = x + br * b;
+    for (unsigned int i = 0; i < b; ++i)
+    {
+      double val = adding ? y[i] : 0.0;
+      for (unsigned int j = 0; j < b; ++j)
+        val += d_ptr[i * b + j] * x_br[j];
+      y[i] = val;
+    }
+
+    // Off-diagonal block contributions
+    const unsigned int* const eor = block_colnums.data() +
+                                    block_row_offsets[br + 1];
+    if (diagonal_off_diagonal_blocks)
+      for (; col_ptr != eor; ++col_ptr, a_ptr += b)
+      {
+        const double* x_bc = x + static_cast<size_t>(*col_ptr) * b;
+        for (unsigned int i = 0; i < b; ++i)
+          y[i] += a_ptr[i] * x_bc[i];
+      }
+    else
+      for (; col_ptr != eor; ++col_ptr, a_ptr += b * b)
+      {
+        const double* x_bc = x + static_cast<size_t>(*col_ptr) * b;
+        for (unsigned int i = 0; i < b; ++i)
+        {
+          double val = 0.0;
+          for (unsigned int j = 0; j < b; ++j)
+            val += a_ptr[i * b + j] * x_bc[j];
+          y[i] += val;
+        }
+      }
+  }
+}
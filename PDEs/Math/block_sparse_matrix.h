@@ -0,0 +1,205 @@
+#ifndef BLOCK_SPARSE_MATRIX_H
+#define BLOCK_SPARSE_MATRIX_H
+
+#include "linear_operator.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class Vector;
+    class SparseMatrix;
+    class SparsityPattern;
+
+
+    /**
+     * Implementation of a block sparse row (BSR) matrix with square blocks.
+     *
+     * The matrix is partitioned into <tt>block_size x block_size</tt> blocks
+     * and only the location of each non-zero block is stored, so that a single
+     * column index is loaded for an entire block. This is a natural fit for
+     * multigroup operators, where the block size is the number of groups, the
+     * diagonal blocks hold the within-cell scattering and fission coupling,
+     * and the off-diagonal blocks hold the face coupling between neighboring
+     * cells.
+     *
+     * The diagonal blocks are stored separately as dense, contiguous, row-major
+     * blocks. This provides direct access to the block diagonal, e.g. for
+     * block-Jacobi type methods. The off-diagonal blocks are stored in block
+     * compressed sparse row format. Optionally, off-diagonal blocks can be
+     * stored as diagonal blocks, holding only <tt>block_size</tt> values. This
+     * is the case for multigroup diffusion, where face coupling only occurs
+     * within a group, and avoids storing and multiplying by explicit zeros.
+     *
+     * Matrix-vector products dispatch to kernels compiled for a fixed block
+     * size for common group structures and fall back to a generic kernel
+     * otherwise.
+     */
+    class BlockSparseMatrix : public LinearOperator
+    {
+    private:
+      size_t block_rows;
+      size_t block_cols;
+      unsigned int bs;
+
+      /**
+       * A flag for whether the off-diagonal blocks only store their
+       * diagonal entries.
+       */
+      bool diagonal_off_diagonal_blocks;
+
+      /** The dense, row-major diagonal blocks. */
+      std::vector<double> diagonal_values;
+
+      /**
+       * The offset of the first off-diagonal block of each block row within
+       * \ref block_colnums. This has <tt>n_block_rows() + 1</tt> entries.
+       */
+      std::vector<size_t> block_row_offsets;
+
+      /** The sorted block column indices of the off-diagonal blocks. */
+      std::vector<unsigned int> block_colnums;
+
+      /** The contiguously stored values of the off-diagonal blocks. */
+      std::vector<double> off_diagonal_values;
+
+    public:
+      //################################################## Constructors
+
+      /** Default constructor. Construct an empty block sparse matrix. */
+      BlockSparseMatrix();
+
+      /**
+       * Construct a block sparse matrix from a sparsity pattern that describes
+       * the location of the non-zero blocks. See \ref reinit.
+       */
+      BlockSparseMatrix(const SparsityPattern& block_pattern,
+                        const unsigned int block_size,
+                        const bool diagonal_off_diagonal_blocks = false);
+
+      /**
+       * Reinitialize the block sparse matrix from a compressed sparsity
+       * pattern that describes the location of the non-zero blocks. All
+       * diagonal blocks are allocated, whether in the pattern or not. If
+       * \p diagonal_off_diagonal_blocks is set, only the diagonal entries of
+       * the off-diagonal blocks are stored. All values are set to zero.
+       */
+      void reinit(const SparsityPattern& block_pattern,
+                  const unsigned int block_size,
+                  const bool diagonal_off_diagonal_blocks = false);
+
+      /**
+       * Copy the entries of a sparse matrix into block format with the
+       * specified \p block_size. Off-diagonal blocks are stored as diagonal
+       * blocks if none of them have entries off of their diagonal.
+       */
+      void copy_from(const SparseMatrix& matrix,
+                     const unsigned int block_size);
+
+      /** Set all stored values to a scalar \p value. */
+      BlockSparseMatrix& operator=(const double value);
+
+      //################################################## Capacity
+
+      /** Return the number of rows. */
+      size_t n_rows() const override;
+
+      /** Return the number of columns. */
+      size_t n_cols() const override;
+
+      /** Return the number of block rows. */
+      size_t n_block_rows() const;
+
+      /** Return the number of block columns. */
+      size_t n_block_cols() const;
+
+      /** Return the size of the blocks. */
+      unsigned int block_size() const;
+
+      /** Return the number of stored values. */
+      size_t n_nonzero_entries() const;
+
+      /**
+       * Return whether the off-diagonal blocks only store their diagonal
+       * entries.
+       */
+      bool has_diagonal_off_diagonal_blocks() const;
+
+      //################################################## Data Access
+
+      /**
+       * Return the element at row \p i and column \p j. If the element is not
+       * stored, zero is returned.
+       */
+      double el(const size_t i, const size_t j) const;
+
+      /**
+       * Return a pointer to the dense, row-major diagonal block of
+       * \p block_row.
+       */
+      double* diagonal_block(const size_t block_row);
+
+      /**
+       * Return a pointer to the dense, row-major diagonal block of
+       * \p block_row.
+       */
+      const double* diagonal_block(const size_t block_row) const;
+
+      //################################################## Modifiers
+
+      /**
+       * Set the element at row \p i and column \p j. The element must be
+       * within the allocated block structure.
+       */
+      void set(const size_t i, const size_t j, const double value);
+
+      /**
+       * Add \p value to the element at row \p i and column \p j. The element
+       * must be within the allocated block structure.
+       */
+      void add(const size_t i, const size_t j, const double value);
+
+      //################################################## Matrix-Vector
+
+      /**
+       * Compute a matrix-vector product \f$ y = A x \f$ using block
+       * operations. The optional \p adding flag dictates whether to write or
+       * add to the destination vector \p y. The block rows are split among
+       * threads in chunks with an equal number of blocks.
+       */
+      void vmult(Vector& y,
+                 const Vector& x,
+                 const bool adding = false) const override;
+
+      /** Return a matrix-vector product \f$ A x \f$. */
+      Vector operator*(const Vector& x) const;
+
+    private:
+      /**
+       * Return a pointer to the location of element \p i, \p j or a null
+       * pointer if it is not stored.
+       */
+      const double* locate(const size_t i, const size_t j) const;
+
+      /**
+       * The block matrix-vector product kernel over the block rows in
+       * <tt>[begin, end)</tt>. When \p BS is non-zero, the block size is
+       * fixed at compile time so that the block loops can be fully unrolled
+       * and vectorized. Otherwise, the runtime block size is used.
+       */
+      template<unsigned int BS>
+      void vmult_kernel(double* y,
+                        const double* x,
+                        const bool adding,
+                        const size_t begin,
+                        const size_t end) const;
+    };
+  }
+}
+
+#endif //BLOCK_SPARSE_MATRIX_H
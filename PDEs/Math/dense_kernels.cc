@@ -0,0 +1,239 @@
+#include "dense_kernels.h"
+
+#include "aligned_allocator.h"
+
+#include <algorithm>
+#include <vector>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace DenseKernels;
+
+
+namespace
+{
+  using Buffer = std::vector<double, AlignedAllocator<double>>;
+
+
+  /**
+   * Pack the \p mc by \p kc block of \f$ A \f$ starting at \p a into panels
+   * of \ref tile_rows rows stored column by column. Rows beyond \p mc are
+   * padded with zeros.
+   */
+  void
+  pack_a(const size_t mc, const size_t kc,
+         const double* a, const size_t rs, const size_t cs,
+         double* buffer)
+  {
+    for (size_t i0 = 0; i0 < mc; i0 += tile_rows)
+    {
+      const size_t mr = std::min(tile_rows, mc - i0);
+      for (size_t p = 0; p < kc; ++p)
+      {
+        for (size_t r = 0; r < mr; ++r)
+          buffer[r] = a[(i0 + r) * rs + p * cs];
+        for (size_t r = mr; r < tile_rows; ++r)
+          buffer[r] = 0.0;
+        buffer += tile_rows;
+      }
+    }
+  }
+
+
+  /**
+   * Pack the \p kc by \p nc block of \f$ B \f$ starting at \p b into panels
+   * of \ref tile_cols columns stored row by row. Columns beyond \p nc are
+   * padded with zeros.
+   */
+  void
+  pack_b(const size_t kc, const size_t nc,
+         const double* b, const size_t rs, const size_t cs,
+         double* buffer)
+  {
+    for (size_t j0 = 0; j0 < nc; j0 += tile_cols)
+    {
+      const size_t nr = std::min(tile_cols, nc - j0);
+      for (size_t p = 0; p < kc; ++p)
+      {
+        const double* b_p = b + p * rs + j0 * cs;
+        if (cs == 1)
+          std::copy(b_p, b_p + nr, buffer);
+        else
+          for (size_t s = 0; s < nr; ++s)
+            buffer[s] = b_p[s * cs];
+        for (size_t s = nr; s < tile_cols; ++s)
+          buffer[s] = 0.0;
+        buffer += tile_cols;
+      }
+    }
+  }
+
+
+  /**
+   * Multiply a packed panel of \f$ A \f$ by a packed panel of \f$ B \f$ and
+   * add the leading \p mr by \p nr part of the scaled result to \f$ C \f$.
+   * The full register tile is always computed so that the loops have fixed
+   * trip counts.
+   */
+  void
+  micro_kernel(const size_t kc,
+               const double alpha,
+               const double* a,
+               const double* b,
+               double* c, const size_t ldc,
+               const size_t mr, const size_t nr)
+  {
+    double tile[tile_rows][tile_cols] = {};
+    for (size_t p = 0; p < kc; ++p, a += tile_rows, b += tile_cols)
+      for (size_t r = 0; r < tile_rows; ++r)
+      {
+        const double a_r = a[r];
+        for (size_t s = 0; s < tile_cols; ++s)
+          tile[r][s] += a_r * b[s];
+      }
+
+    for (size_t r = 0; r < mr; ++r)
+      for (size_t s = 0; s < nr; ++s)
+        c[r * ldc + s] += alpha * tile[r][s];
+  }
+}
+
+
+void
+DenseKernels::gemm(const size_t m, const size_t n, const size_t k,
+                   const double alpha,
+                   const double* a, const size_t a_rs, const size_t a_cs,
+                   const double* b, const size_t b_rs, const size_t b_cs,
+                   double* c, const size_t ldc)
+{
+  if (m == 0 || n == 0 || k == 0 || alpha == 0.0)
+    return;
+
+  // Small products, in the order which streams through rows of B and C
+  if (m * n * k < min_blocked_work)
+  {
+    for (size_t i = 0; i < m; ++i)
+    {
+      double* c_i = c + i * ldc;
+      for (size_t p = 0; p < k; ++p)
+      {
+        const double a_ip = alpha * a[i * a_rs + p * a_cs];
+        const double* b_p = b + p * b_rs;
+        if (b_cs == 1)
+          for (size_t j = 0; j < n; ++j)
+            c_i[j] += a_ip * b_p[j];
+        else
+          for (size_t j = 0; j < n; ++j)
+            c_i[j] += a_ip * b_p[j * b_cs];
+      }
+    }
+    return;
+  }
+
+  // Blocked product on packed panels
+  Buffer a_packed(block_rows * block_inner);
+  Buffer b_packed(block_inner *
+                  ((std::min(n, block_cols) + tile_cols - 1) / tile_cols) *
+                  tile_cols);
+
+  for (size_t jc = 0; jc < n; jc += block_cols)
+  {
+    const size_t nc = std::min(block_cols, n - jc);
+    for (size_t pc = 0; pc < k; pc += block_inner)
+    {
+      const size_t kc = std::min(block_inner, k - pc);
+      pack_b(kc, nc, b + pc * b_rs + jc * b_cs, b_rs, b_cs, b_packed.data());
+
+      for (size_t ic = 0; ic < m; ic += block_rows)
+      {
+        const size_t mc = std::min(block_rows, m - ic);
+        pack_a(mc, kc, a + ic * a_rs + pc * a_cs, a_rs, a_cs, a_packed.data());
+
+        for (size_t jr = 0; jr < nc; jr += tile_cols)
+          for (size_t ir = 0; ir < mc; ir += tile_rows)
+            micro_kernel(kc, alpha,
+                         a_packed.data() + ir * kc,
+                         b_packed.data() + jr * kc,
+                         c + (ic + ir) * ldc + jc + jr, ldc,
+                         std::min(tile_rows, mc - ir),
+                         std::min(tile_cols, nc - jr));
+      }
+    }
+  }
+}
+
+
+void
+DenseKernels::gemv(const size_t m, const size_t n,
+                   const double alpha,
+                   const double* a, const size_t lda,
+                   const double* x, double* y)
+{
+  // Rows are processed in groups so that each entry of x is loaded once
+  // per group
+  size_t i = 0;
+  for (; i + 4 <= m; i += 4)
+  {
+    const double* a_0 = a + i * lda;
+    const double* a_1 = a_0 + lda;
+    const double* a_2 = a_1 + lda;
+    const double* a_3 = a_2 + lda;
+
+    double v_0 = 0.0, v_1 = 0.0, v_2 = 0.0, v_3 = 0.0;
+    for (size_t j = 0; j < n; ++j)
+    {
+      const double x_j = x[j];
+      v_0 += a_0[j] * x_j;
+      v_1 += a_1[j] * x_j;
+      v_2 += a_2[j] * x_j;
+      v_3 += a_3[j] * x_j;
+    }
+    y[i] += alpha * v_0;
+    y[i + 1] += alpha * v_1;
+    y[i + 2] += alpha * v_2;
+    y[i + 3] += alpha * v_3;
+  }
+
+  for (; i < m; ++i)
+  {
+    const double* a_i = a + i * lda;
+
+    double v = 0.0;
+    for (size_t j = 0; j < n; ++j)
+      v += a_i[j] * x[j];
+    y[i] += alpha * v;
+  }
+}
+
+
+void
+DenseKernels::gemv_transpose(const size_t m, const size_t n,
+                             const double alpha,
+                             const double* a, const size_t lda,
+                             const double* x, double* y)
+{
+  // Rows are processed in groups so that each entry of y is loaded and
+  // stored once per group
+  size_t i = 0;
+  for (; i + 4 <= m; i += 4)
+  {
+    const double* a_0 = a + i * lda;
+    const double* a_1 = a_0 + lda;
+    const double* a_2 = a_1 + lda;
+    const double* a_3 = a_2 + lda;
+
+    const double x_0 = alpha * x[i], x_1 = alpha * x[i + 1];
+    const double x_2 = alpha * x[i + 2], x_3 = alpha * x[i + 3];
+    for (size_t j = 0; j < n; ++j)
+      y[j] += a_0[j] * x_0 + a_1[j] * x_1 + a_2[j] * x_2 + a_3[j] * x_3;
+  }
+
+  for (; i < m; ++i)
+  {
+    const double* a_i = a + i * lda;
+    const double x_i = alpha * x[i];
+    for (size_t j = 0; j < n; ++j)
+      y[j] += a_i[j] * x_i;
+  }
+}
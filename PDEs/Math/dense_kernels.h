@@ -0,0 +1,88 @@
+#ifndef DENSE_KERNELS_H
+#define DENSE_KERNELS_H
+
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    /**
+     * Cache-blocked kernels for dense row-major matrices.
+     *
+     * Operands are described by a pointer to their first entry and a row and
+     * column stride, so that transposed operands and sub-blocks of a larger
+     * matrix are passed without copying. Entry \f$ (i, j) \f$ of an operand
+     * is <tt>ptr[i * row_stride + j * column_stride]</tt>.
+     */
+    namespace DenseKernels
+    {
+      /**
+       * The number of rows and columns of the register tile computed by the
+       * innermost kernel of \ref gemm.
+       */
+      constexpr size_t tile_rows = 4;
+      constexpr size_t tile_cols = 8;
+
+      /**
+       * The dimensions of the blocks of \f$ A \f$ and \f$ B \f$ which are
+       * packed into contiguous panels. A packed block of \f$ A \f$ is sized
+       * to remain in the L2 cache while a packed panel of \f$ B \f$ streams
+       * through the L1 cache.
+       */
+      constexpr size_t block_rows = 64;
+      constexpr size_t block_inner = 256;
+      constexpr size_t block_cols = 1024;
+
+      /**
+       * Products with fewer multiply-adds than this are computed with simple
+       * loops since packing is not amortized.
+       */
+      constexpr size_t min_blocked_work = 32768;
+
+      /**
+       * The number of columns factored together in the blocked dense
+       * factorizations. The trailing matrix is updated once per panel with
+       * \ref gemm.
+       */
+      constexpr size_t panel_width = 64;
+
+      /**
+       * Compute \f$ C = C + \alpha A B \f$ where \f$ A \f$ is \p m by \p k,
+       * \f$ B \f$ is \p k by \p n, and the row-major \f$ C \f$ has leading
+       * dimension \p ldc.
+       */
+      void
+      gemm(const size_t m, const size_t n, const size_t k,
+           const double alpha,
+           const double* a, const size_t a_row_stride,
+           const size_t a_column_stride,
+           const double* b, const size_t b_row_stride,
+           const size_t b_column_stride,
+           double* c, const size_t ldc);
+
+      /**
+       * Compute \f$ y = y + \alpha A x \f$ where \f$ A \f$ is an \p m by
+       * \p n row-major matrix with leading dimension \p lda.
+       */
+      void
+      gemv(const size_t m, const size_t n,
+           const double alpha,
+           const double* a, const size_t lda,
+           const double* x, double* y);
+
+      /**
+       * Compute \f$ y = y + \alpha A^T x \f$ where \f$ A \f$ is an \p m by
+       * \p n row-major matrix with leading dimension \p lda.
+       */
+      void
+      gemv_transpose(const size_t m, const size_t n,
+                     const double alpha,
+                     const double* a, const size_t lda,
+                     const double* x, double* y);
+    }
+  }
+}
+
+#endif //DENSE_KERNELS_H
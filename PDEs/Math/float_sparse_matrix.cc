@@ -0,0 +1,110 @@
+#include "float_sparse_matrix.h"
+
+#include "vector.h"
+#include "sparse_matrix.h"
+#include "multithreading.h"
+
+#include <limits>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+
+//################################################## Constructors
+
+FloatSparseMatrix::FloatSparseMatrix() :
+    rows(0), cols(0), row_offsets(1, 0)
+{}
+
+
+FloatSparseMatrix::FloatSparseMatrix(const SparseMatrix& matrix)
+{
+  reinit(matrix);
+}
+
+
+void
+FloatSparseMatrix::reinit(const SparseMatrix& matrix)
+{
+  assert(matrix.n_cols() <= std::numeric_limits<unsigned int>::max());
+
+  rows = matrix.n_rows();
+  cols = matrix.n_cols();
+
+  row_offsets.assign(rows + 1, 0);
+  for (size_t i = 0; i < rows; ++i)
+    row_offsets[i + 1] = row_offsets[i] + matrix.row_length(i);
+
+  colnums.resize(row_offsets[rows]);
+  values.resize(row_offsets[rows]);
+  for (size_t i = 0; i < rows; ++i)
+  {
+    if (matrix.row_length(i) == 0)
+      continue;
+
+    size_t k = row_offsets[i];
+    for (const auto el: matrix.row_iterator(i))
+    {
+      colnums[k] = el.column;
+      values[k++] = static_cast<float>(el.value);
+    }
+  }
+}
+
+//################################################## Capacity
+
+size_t
+FloatSparseMatrix::n_rows() const
+{
+  return rows;
+}
+
+
+size_t
+FloatSparseMatrix::n_cols() const
+{
+  return cols;
+}
+
+
+size_t
+FloatSparseMatrix::n_nonzero_entries() const
+{
+  return values.size();
+}
+
+//################################################## Matrix-Vector
+
+void
+FloatSparseMatrix::vmult(Vector& y,
+                         const Vector& x,
+                         const bool adding) const
+{
+  assert(x.size() == cols);
+  assert(y.size() == rows);
+  assert(&x != &y);
+
+  const int n_threads = MultiThreading::n_threads(values.size());
+  const auto bounds =
+      MultiThreading::partition(row_offsets.data(), rows, n_threads);
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t)
+  {
+    const double* x_ptr = x.data();
+    double* dst_ptr = y.data();
+    const unsigned int* col_ptr = colnums.data() + row_offsets[bounds[t]];
+    const float* a_ij = values.data() + row_offsets[bounds[t]];
+
+    for (size_t row = bounds[t]; row < bounds[t + 1]; ++row)
+    {
+      const float* const eor = values.data() + row_offsets[row + 1];
+
+      double val = adding ? dst_ptr[row] : 0.0;
+      while (a_ij != eor)
+        val += static_cast<double>(*a_ij++) * x_ptr[*col_ptr++];
+      dst_ptr[row] = val;
+    }
+  }
+}
@@ -0,0 +1,94 @@
+#ifndef FLOAT_SPARSE_MATRIX_H
+#define FLOAT_SPARSE_MATRIX_H
+
+#include "linear_operator.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class Vector;
+    class SparseMatrix;
+
+
+    /**
+     * Implementation of a compressed sparse row matrix with single precision
+     * values.
+     *
+     * The values are stored as \p float while the matrix-vector product
+     * accumulates in \p double. Since sparse matrix-vector products are
+     * limited by memory bandwidth, halving the size of the values reduces
+     * the memory traffic of the product by roughly a third with 32-bit
+     * column indices. The rounding of the entries limits the accuracy of the
+     * product to about seven digits, which is sufficient for inner solves
+     * within an iterative refinement scheme. See MixedPrecisionSolverBase.
+     *
+     * This format is read-only. It is built from a SparseMatrix and is meant
+     * to be used as a LinearOperator.
+     */
+    class FloatSparseMatrix : public LinearOperator
+    {
+    private:
+      size_t rows;
+      size_t cols;
+
+      /**
+       * The offset of the first entry of each row within \ref colnums and
+       * \ref values. This has <tt>n_rows() + 1</tt> entries.
+       */
+      std::vector<size_t> row_offsets;
+
+      /** The contiguously stored column indices. */
+      std::vector<unsigned int> colnums;
+
+      /** The contiguously stored single precision values. */
+      std::vector<float> values;
+
+    public:
+      //################################################## Constructors
+
+      /** Default constructor. Construct an empty matrix. */
+      FloatSparseMatrix();
+
+      /** Construct from a sparse matrix. See \ref reinit. */
+      FloatSparseMatrix(const SparseMatrix& matrix);
+
+      /**
+       * Reinitialize from a sparse matrix. The values are rounded to single
+       * precision.
+       */
+      void reinit(const SparseMatrix& matrix);
+
+      //################################################## Capacity
+
+      /** Return the number of rows. */
+      size_t n_rows() const override;
+
+      /** Return the number of columns. */
+      size_t n_cols() const override;
+
+      /** Return the number of non-zero entries. */
+      size_t n_nonzero_entries() const;
+
+      //################################################## Matrix-Vector
+
+      /**
+       * Compute a matrix-vector product \f$ y = A x \f$ with double precision
+       * accumulation. The optional \p adding flag dictates whether to write
+       * or add to the destination vector \p y. The rows are split among
+       * threads such that each thread processes an equal number of non-zero
+       * entries.
+       */
+      void vmult(Vector& y,
+                 const Vector& x,
+                 const bool adding = false) const override;
+    };
+  }
+}
+
+#endif //FLOAT_SPARSE_MATRIX_H
@@ -0,0 +1,49 @@
+#ifndef LINEAR_OPERATOR_H
+#define LINEAR_OPERATOR_H
+
+#include <cstddef>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class Vector;
+
+
+    /**
+     * An abstract base class for linear operators.
+     *
+     * A linear operator is anything that can be applied to a vector. This is
+     * the only functionality required by Krylov-type iterative solvers, which
+     * allows them to work with assembled matrices in any storage format as
+     * well as with matrix-free operators.
+     */
+    class LinearOperator
+    {
+    public:
+      /** Default destructor. */
+      virtual ~LinearOperator() = default;
+
+      /** Return the number of rows. */
+      virtual size_t n_rows() const = 0;
+
+      /** Return the number of columns. */
+      virtual size_t n_cols() const = 0;
+
+      /**
+       * Apply the operator to a vector, i.e. \f$ y = A x \f$.
+       *
+       * The optional \p adding flag dictates whether to write or add to the
+       * destination vector \p y.
+       */
+      virtual void
+      vmult(Vector& y,
+            const Vector& x,
+            const bool adding = false) const = 0;
+    };
+  }
+}
+
+#endif //LINEAR_OPERATOR_H
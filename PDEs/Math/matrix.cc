@@ -1,6 +1,9 @@
 #include "matrix.h"
 #include "vector.h"
+#include "vector_pool.h"
+#include "dense_kernels.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <iomanip>
@@ -11,28 +14,69 @@ using namespace Math;
 
 //################################################## Constructors
 
+namespace
+{
+  /** Return the leading dimension used for rows with \p n_cols entries. */
+  size_t
+  padded_length(const size_t n_cols)
+  {
+    if (n_cols < Matrix::padding_threshold)
+      return n_cols;
+    const size_t a = Matrix::row_alignment;
+    return (n_cols + a - 1) / a * a;
+  }
+}
+
+
+Matrix::Matrix(Matrix&& other)
+{
+  swap(other);
+}
+
+
+Matrix::Matrix(const size_t n_rows,
+               const size_t n_cols)
+{
+  resize(n_rows, n_cols, 0.0);
+}
+
+
 Matrix::
-Matrix(const std::initializer_list<std::initializer_list<double>>& list) :
-    values(list.begin(), list.end())
-{}
+Matrix(const std::initializer_list<std::initializer_list<double>>& list)
+{
+  resize(list.size(), list.size() > 0 ? list.begin()->size() : 0, 0.0);
+
+  size_t i = 0;
+  for (const auto& row: list)
+  {
+    assert(row.size() == cols);
+    std::copy(row.begin(), row.end(), data(i++));
+  }
+}
 
 
 template<typename InputIterator>
-Matrix::Matrix(const InputIterator first, const InputIterator last) :
-  values(std::distance(first, last), Vector((*first).size()))
+Matrix::Matrix(const InputIterator first, const InputIterator last)
 {
-  std::copy(first, last, begin());
-  for (const auto& row: values)
-    assert(row.size() == n_cols());
+  const size_t n = std::distance(first, last);
+  resize(n, n > 0 ? (*first).size() : 0, 0.0);
+
+  size_t i = 0;
+  for (auto it = first; it != last; ++it, ++i)
+  {
+    assert((*it).size() == cols);
+    std::copy((*it).begin(), (*it).end(), data(i));
+  }
 }
 template Matrix::Matrix(const Vector*, const Vector*);
 
 
 Matrix::Matrix(const size_t n_rows,
                const size_t n_cols,
-               const double value) :
-    values(n_rows, Vector(n_cols, value))
-{}
+               const double value)
+{
+  resize(n_rows, n_cols, value);
+}
 
 
 Matrix::Matrix(const size_t n_rows,
@@ -40,39 +84,35 @@ Matrix::Matrix(const size_t n_rows,
                const double* value_ptr)
 {
   resize(n_rows, n_cols, 0.0);
-  for (size_t i = 0; i < n_rows; ++i)
-    for (size_t j = 0; j < n_cols; ++j, ++value_ptr)
-      values[i][j] = *value_ptr;
+  for (size_t i = 0; i < n_rows; ++i, value_ptr += n_cols)
+    std::copy(value_ptr, value_ptr + n_cols, data(i));
 }
 
 
 Matrix::Matrix(const Vector& diagonal)
 {
-  size_t n = diagonal.size();
-  resize(n, n, 0.0);
-  for (size_t i = 0; i < n; ++i)
-    values[i][i] = diagonal[i];
+  set_diagonal(diagonal);
 }
 
 
 Matrix::Matrix(Vector&& diagonal)
 {
-  size_t n = diagonal.size();
-  resize(n, n, 0.0);
-  for (size_t i = 0; i < n; ++i)
-    values[i][i] = std::move(diagonal[i]);
+  set_diagonal(diagonal);
 }
 
 
 Matrix::Matrix(const std::initializer_list<double>& diagonal)
 {
-  *this = Matrix(Vector(diagonal));
+  set_diagonal(Vector(diagonal));
 }
 
 
 Matrix&
 Matrix::operator=(const Matrix& other)
 {
+  rows = other.rows;
+  cols = other.cols;
+  ld = other.ld;
   values = other.values;
   return *this;
 }
@@ -81,7 +121,11 @@ Matrix::operator=(const Matrix& other)
 Matrix&
 Matrix::operator=(Matrix&& other)
 {
+  rows = other.rows;
+  cols = other.cols;
+  ld = other.ld;
   values = std::move(other.values);
+  other.clear();
   return *this;
 }
 
@@ -92,8 +136,8 @@ Matrix::operator=(const double value)
   if (empty())
     resize(1, 1, value);
   else
-    for (auto& row: values)
-      row = value; // full row assignment to a scalar
+    for (size_t i = 0; i < rows; ++i)
+      std::fill(begin(i), end(i), value);
   return *this;
 }
 
@@ -102,14 +146,14 @@ Matrix::operator=(const double value)
 size_t
 Matrix::n_rows() const
 {
-  return values.size();
+  return rows;
 }
 
 
 size_t
 Matrix::n_cols() const
 {
-  return values.front().size();
+  return cols;
 }
 
 
@@ -124,8 +168,8 @@ size_t
 Matrix::n_nonzero_entries() const
 {
   size_t count = 0;
-  for (const auto& row: values)
-    count += row.n_nonzero_entries();
+  for (size_t i = 0; i < rows; ++i)
+    count += cols - std::count(begin(i), end(i), 0.0);
   return count;
 }
 
@@ -133,61 +177,56 @@ Matrix::n_nonzero_entries() const
 bool
 Matrix::empty() const
 {
-  return values.empty();
-}
-
-//################################################## Data Access
-
-Vector&
-Matrix::operator[](const size_t i)
-{
-  return values.at(i);
+  return rows == 0;
 }
 
 
-const Vector&
-Matrix::operator[](const size_t i) const
+size_t
+Matrix::leading_dimension() const
 {
-  return values.at(i);
+  return ld;
 }
 
+//################################################## Data Access
 
-Vector&
-Matrix::operator()(const size_t i)
+double*
+Matrix::operator[](const size_t i)
 {
-  return values.at(i);
+  return data(i);
 }
 
 
-const Vector&
-Matrix::operator()(const size_t i) const
+const double*
+Matrix::operator[](const size_t i) const
 {
-  return values.at(i);
+  return data(i);
 }
 
 
 double&
 Matrix::operator()(const size_t i, const size_t j)
 {
-  return values.at(i)(j);
+  assert(i < rows && j < cols);
+  return values[i * ld + j];
 }
 
 
 const double&
 Matrix::operator()(const size_t i, const size_t j) const
 {
-  return values.at(i)(j);
+  assert(i < rows && j < cols);
+  return values[i * ld + j];
 }
 
 
-Vector*
+double*
 Matrix::data()
 {
   return values.data();
 }
 
 
-const Vector*
+const double*
 Matrix::data() const
 {
   return values.data();
@@ -197,70 +236,46 @@ Matrix::data() const
 double*
 Matrix::data(const size_t i)
 {
-  return values.at(i).data();
+  assert(i < rows);
+  return values.data() + i * ld;
 }
 
 
 const double*
 Matrix::data(const size_t i) const
 {
-  return values.at(i).data();
-}
-
-
-Matrix::iterator
-Matrix::begin()
-{
-  return values.begin();
-}
-
-
-Matrix::iterator
-Matrix::end()
-{
-  return values.end();
-}
-
-
-Matrix::const_iterator
-Matrix::begin() const
-{
-  return values.begin();
-}
-
-
-Matrix::const_iterator
-Matrix::end() const
-{
-  return values.end();
+  assert(i < rows);
+  return values.data() + i * ld;
 }
 
 
 Vector::iterator
 Matrix::begin(const size_t i)
 {
-  return values.at(i).begin();
+  assert(i < rows);
+  return values.begin() + i * ld;
 }
 
 
 Vector::iterator
 Matrix::end(const size_t i)
 {
-  return values.at(i).end();
+  return begin(i) + cols;
 }
 
 
 Vector::const_iterator
 Matrix::begin(const size_t i) const
 {
-  return values.at(i).begin();
+  assert(i < rows);
+  return values.begin() + i * ld;
 }
 
 
 Vector::const_iterator
 Matrix::end(const size_t i) const
 {
-  return values.at(i).end();
+  return begin(i) + cols;
 }
 
 //################################################## Modifiers
@@ -268,6 +283,7 @@ Matrix::end(const size_t i) const
 void
 Matrix::clear()
 {
+  rows = cols = ld = 0;
   values.clear();
 }
 
@@ -276,9 +292,7 @@ void
 Matrix::resize(const size_t n_rows,
                const size_t n_cols)
 {
-  values.resize(n_rows);
-  for (auto& row : values)
-    row.resize(n_cols);
+  resize(n_rows, n_cols, 0.0);
 }
 
 
@@ -287,16 +301,34 @@ Matrix::resize(const size_t n_rows,
                const size_t n_cols,
                const double value)
 {
-  values.resize(n_rows);
-  for (auto& row : values)
-    row.resize(n_cols, value);
+  if (n_rows == rows && n_cols == cols)
+    return;
+
+  // Copy the retained entries into a buffer with the new layout
+  const size_t new_ld = padded_length(n_cols);
+  Vector::storage_type new_values(n_rows * new_ld, 0.0);
+  for (size_t i = 0; i < n_rows; ++i)
+  {
+    double* dst = new_values.data() + i * new_ld;
+    const size_t n_kept = i < rows ? std::min(cols, n_cols) : 0;
+    if (n_kept > 0)
+      std::copy(data(i), data(i) + n_kept, dst);
+    std::fill(dst + n_kept, dst + n_cols, value);
+  }
+
+  rows = n_rows;
+  cols = n_cols;
+  ld = new_ld;
+  values.swap(new_values);
 }
 
 
 void
 Matrix::swap_row(const size_t i, const size_t k)
 {
-  values.at(i).swap(values.at(k));
+  assert(i < rows && k < rows);
+  if (i != k)
+    std::swap_ranges(begin(i), end(i), begin(k));
 }
 
 
@@ -305,13 +337,16 @@ Matrix::swap_column(const size_t j, const size_t k)
 {
   assert(j < n_cols() && k < n_cols());
   for (size_t i = 0; i < n_rows(); ++i)
-    std::swap(values[i][j], values[i][k]);
+    std::swap((*this)(i, j), (*this)(i, k));
 }
 
 
 void
 Matrix::swap(Matrix& other)
 {
+  std::swap(rows, other.rows);
+  std::swap(cols, other.cols);
+  std::swap(ld, other.ld);
   values.swap(other.values);
 }
 
@@ -323,13 +358,13 @@ Matrix::set_diagonal(const Vector& diagonal)
   {
     resize(diagonal.size(), diagonal.size(), 0.0);
     for (size_t i = 0; i < diagonal.size(); ++i)
-      values[i][i] = diagonal[i];
+      (*this)(i, i) = diagonal[i];
   } else
   {
     size_t min_dim = std::min(n_rows(), n_cols());
     assert(diagonal.size() == min_dim);
     for (size_t i = 0; i < min_dim; ++i)
-      values[i][i] = diagonal[i];
+      (*this)(i, i) = diagonal[i];
   }
 }
 
@@ -337,19 +372,7 @@ Matrix::set_diagonal(const Vector& diagonal)
 void
 Matrix::set_diagonal(Vector&& diagonal)
 {
-  if (empty())
-  {
-    size_t n = diagonal.size();
-    resize(n, n, 0.0);
-    for (size_t i = 0; i < n; ++i)
-      values[i][i] = std::move(diagonal[i]);
-  } else
-  {
-    size_t min_dim = std::min(n_rows(), n_cols());
-    assert(diagonal.size() == min_dim);
-    for (size_t i = 0; i < min_dim; ++i)
-      values[i][i] = std::move(diagonal[i]);
-  }
+  set_diagonal(static_cast<const Vector&>(diagonal));
 }
 
 
@@ -369,7 +392,7 @@ Matrix::set_diagonal(const double value)
   {
     size_t min_dim = std::min(n_rows(), n_cols());
     for (size_t i = 0; i < min_dim; ++i)
-      values[i][i] = value;
+      (*this)(i, i) = value;
   }
 }
 
@@ -378,8 +401,8 @@ Matrix::set_diagonal(const double value)
 Matrix&
 Matrix::scale(const double factor)
 {
-  for (auto& row: values)
-    row *= factor;
+  for (auto& value: values)
+    value *= factor;
   return *this;
 }
 
@@ -540,20 +563,12 @@ Matrix::mmult(Matrix& C,
   assert(C.n_rows() == n_rows());
   assert(C.n_cols() == B.n_cols());
   assert(B.n_rows() == n_cols());
+  assert(&C != this && &C != &B);
 
-  for (size_t i = 0; i < C.n_rows(); ++i)
-  {
-    double* c_ij = C.data(i);
-    const double* a_i = data(i);
-
-    for (size_t j = 0; j < C.n_cols(); ++j, ++c_ij)
-    {
-      double value = adding ? *c_ij : 0.0;
-      for (size_t k = 0; k < n_cols(); ++k)
-        value += a_i[k] * B(k, j);
-      *c_ij = value;
-    }
-  }
+  if (!adding)
+    std::fill(C.values.begin(), C.values.end(), 0.0);
+  DenseKernels::gemm(C.rows, C.cols, cols, 1.0,
+                     data(), ld, 1, B.data(), B.ld, 1, C.data(), C.ld);
 }
 
 
@@ -565,20 +580,12 @@ Matrix::Tmmult(Matrix& C,
   assert(C.n_rows() == n_cols());
   assert(C.n_cols() == B.n_cols());
   assert(B.n_rows() == n_rows());
+  assert(&C != this && &C != &B);
 
-
-  for (size_t i = 0; i < C.n_rows(); ++i)
-  {
-    double* c_ij = C.data(i);
-
-    for (size_t j = 0; j < C.n_cols(); ++j, ++c_ij)
-    {
-      double value = adding ? *c_ij : 0.0;
-      for (size_t k = 0; k < n_rows(); ++k)
-        value += values[k][i] * B(k, j);
-      *c_ij = value;
-    }
-  }
+  if (!adding)
+    std::fill(C.values.begin(), C.values.end(), 0.0);
+  DenseKernels::gemm(C.rows, C.cols, rows, 1.0,
+                     data(), 1, ld, B.data(), B.ld, 1, C.data(), C.ld);
 }
 
 
@@ -590,22 +597,12 @@ Matrix::mTmult(Matrix& C,
   assert(C.n_rows() == n_rows());
   assert(C.n_cols() == B.n_rows());
   assert(B.n_cols() == n_cols());
+  assert(&C != this && &C != &B);
 
-  for (size_t i = 0; i < C.n_rows(); ++i)
-  {
-    double* c_ij = C.data(i);
-    const double* a_i = data(i);
-
-    for (size_t j = 0; j < C.n_cols(); ++j, ++c_ij)
-    {
-      const double* b_jk = B.data(j);
-
-      double value = adding ? *c_ij : 0.0;
-      for (size_t k = 0; k < n_cols(); ++k, ++b_jk)
-        value += a_i[k] * *b_jk;
-      *c_ij = value;
-    }
-  }
+  if (!adding)
+    std::fill(C.values.begin(), C.values.end(), 0.0);
+  DenseKernels::gemm(C.rows, C.cols, cols, 1.0,
+                     data(), ld, 1, B.data(), 1, B.ld, C.data(), C.ld);
 }
 
 
@@ -617,21 +614,12 @@ Matrix::TTmult(Matrix& C,
   assert(C.n_rows() == n_cols());
   assert(C.n_cols() == B.n_rows());
   assert(B.n_cols() == n_rows());
+  assert(&C != this && &C != &B);
 
-  for (size_t i = 0; i < C.n_rows(); ++i)
-  {
-    double* c_ij = C.data(i);
-
-    for (size_t j = 0; j < C.n_cols(); ++j, ++c_ij)
-    {
-      const double* b_jk = B.data(j);
-
-      double value = adding ? *c_ij : 0.0;
-      for (size_t k = 0; k < n_rows(); ++k, ++b_jk)
-        value += values[k][i] * *b_jk;
-      *c_ij = value;
-    }
-  }
+  if (!adding)
+    std::fill(C.values.begin(), C.values.end(), 0.0);
+  DenseKernels::gemm(C.rows, C.cols, rows, 1.0,
+                     data(), 1, ld, B.data(), 1, B.ld, C.data(), C.ld);
 }
 
 //################################################## Matrix-Vector
@@ -645,17 +633,17 @@ Matrix::vmult(Vector& y,
   assert(x.size() == n_cols());
   assert(y.size() == n_rows());
 
-  double* y_i = y.data();
-  for (size_t i = 0; i < n_rows(); ++i, ++y_i)
+  // Products in place work on a copy of the source
+  ScratchVector x_copy(&x == &y ? x.size() : 0);
+  const double* x_ptr = x.data();
+  if (&x == &y)
   {
-    const double* a_ij = data(i);
-    const double* x_j = x.data();
-
-    double v = adding ? *y_i : 0.0;
-    for (size_t j = 0; j < n_cols(); ++j, ++a_ij, ++x_j)
-      v += *a_ij * *x_j;
-    *y_i = v;
+    *x_copy = x;
+    x_ptr = x_copy->data();
   }
+
+  if (!adding) y = 0.0;
+  DenseKernels::gemv(rows, cols, 1.0, data(), ld, x_ptr, y.data());
 }
 
 
@@ -685,16 +673,17 @@ Matrix::Tvmult(Vector& y,
   assert(x.size() == n_rows());
   assert(y.size() == n_cols());
 
-  if (!adding) y = 0.0;
-  for (size_t i = 0; i < n_rows(); ++i)
+  // Products in place work on a copy of the source
+  ScratchVector x_copy(&x == &y ? x.size() : 0);
+  const double* x_ptr = x.data();
+  if (&x == &y)
   {
-    const double x_i = x[i];
-    const double* a_ij = data(i);
-
-    double* y_j = y.data();
-    for (size_t j = 0; j < n_cols(); ++j, ++a_ij, ++y_j)
-      *y_j += *a_ij * x_i;
+    *x_copy = x;
+    x_ptr = x_copy->data();
   }
+
+  if (!adding) y = 0.0;
+  DenseKernels::gemv_transpose(rows, cols, 1.0, data(), ld, x_ptr, y.data());
 }
 
 
@@ -726,7 +715,7 @@ Matrix::str(const bool scientific,
 
   for (size_t i = 0; i < n_rows(); ++i)
   {
-    const double* a_ij = values[i].data();
+    const double* a_ij = data(i);
     for (uint64_t j = 0; j < n_cols(); ++j)
       ss << std::setw(w) << *a_ij++;
     ss << std::endl;
@@ -750,14 +739,19 @@ Matrix::print(std::ostream& os,
 bool
 Matrix::operator==(const Matrix& other) const
 {
-  return values == other.values;
+  if (rows != other.rows || cols != other.cols)
+    return false;
+  for (size_t i = 0; i < rows; ++i)
+    if (!std::equal(begin(i), end(i), other.begin(i)))
+      return false;
+  return true;
 }
 
 
 bool
 Matrix::operator!=(const Matrix& other) const
 {
-  return !(values == other.values);
+  return !(*this == other);
 }
 
 
@@ -1,6 +1,8 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include "vector.h"
+
 #include <iostream>
 #include <sstream>
 
@@ -12,21 +14,31 @@ namespace PDEs
 {
   namespace Math
   {
-    // forward declarations
-    class Vector;
-
-
     /**
      * Implementation of a general linear algebra dense matrix.
+     *
+     * The entries are stored in a single contiguous, row-major buffer. Each
+     * row starts <tt>leading_dimension()</tt> entries after the previous
+     * one. Rows with at least \ref padding_threshold entries are padded to a
+     * multiple of \ref row_alignment entries so that every row starts on a
+     * cache line. Products are computed with the cache-blocked kernels in
+     * DenseKernels.
      */
     class Matrix
     {
     public:
-      using iterator = std::vector<Vector>::iterator;
-      using const_iterator = std::vector<Vector>::const_iterator;
+      /** The number of entries in a cache line. */
+      static constexpr size_t row_alignment = 8;
+
+      /** Rows with at least this many entries are padded. */
+      static constexpr size_t padding_threshold = 16;
 
     protected:
-      std::vector<Vector> values;
+      size_t rows = 0;
+      size_t cols = 0;
+      size_t ld = 0;
+
+      Vector::storage_type values;
 
     public:
       //################################################## Constructors
@@ -38,7 +50,7 @@ namespace PDEs
       Matrix(const Matrix& other) = default;
 
       /** Move constructor. Steal the internal data from another matrix. */
-      Matrix(Matrix&& other) = default;
+      Matrix(Matrix&& other);
 
       /** Construct a matrix with \p n_rows and \p n_cols. */
       Matrix(const size_t n_rows,
@@ -109,19 +121,16 @@ namespace PDEs
       /** Return whether the matrix is empty (no allocated entries) or not. */
       bool empty() const;
 
-      //################################################## Data Access
-
-      /** Read and write access for row \p i. */
-      Vector& operator[](const size_t i);
+      /** Return the distance between the first entries of consecutive rows. */
+      size_t leading_dimension() const;
 
-      /** Read access for row \p i. */
-      const Vector& operator[](const size_t i) const;
+      //################################################## Data Access
 
       /** Read and write access for row \p i. */
-      Vector& operator()(const size_t i);
+      double* operator[](const size_t i);
 
       /** Read access for row \p i. */
-      const Vector& operator()(const size_t i) const;
+      const double* operator[](const size_t i) const;
 
       /** Read and write access for row \p i column \p j. */
       double& operator()(const size_t i, const size_t j);
@@ -129,11 +138,14 @@ namespace PDEs
       /** Read access for row \p i column \p j. */
       const double& operator()(const size_t i, const size_t j) const;
 
-      /** Return a pointer the underlying rows. */
-      Vector* data();
+      /**
+       * Return a pointer to the underlying buffer. Row \p i starts at entry
+       * <tt>i * leading_dimension()</tt>.
+       */
+      double* data();
 
-      /** Return a constant pointer to the underlying rows. */
-      const Vector* data() const;
+      /** Return a constant pointer to the underlying buffer. */
+      const double* data() const;
 
       /** Return a pointer to the underlying data on row \p i. */
       double* data(const size_t i);
@@ -141,32 +153,20 @@ namespace PDEs
       /** Return a constant pointer to the underlying data on row \p i. */
       const double* data(const size_t i) const;
 
-      /** Return an iterator to the first row. */
-      iterator begin();
-
-      /** Return an iterator that designates the end of the rows. */
-      iterator end();
-
-      /** Return a constant iterator to the first row of the matrix.*/
-      const_iterator begin() const;
-
-      /** Return a constant iterator that designates the end of the rows. */
-      const_iterator end() const;
-
       /** Return an iterator to the first entry of row \p i.*/
-      std::vector<double>::iterator
+      Vector::iterator
       begin(const size_t i);
 
       /** Return an iterator that designates the end of row \p i. */
-      std::vector<double>::iterator
+      Vector::iterator
       end(const size_t i);
 
       /** Return a constant iterator to the first entry of row \p i. */
-      std::vector<double>::const_iterator
+      Vector::const_iterator
       begin(const size_t i) const;
 
       /** Return a constant iterator that designates the end of row \p i. */
-      std::vector<double>::const_iterator
+      Vector::const_iterator
       end(const size_t i) const;
 
       //################################################## Modifiers
@@ -0,0 +1,70 @@
+#include "multithreading.h"
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+using namespace PDEs;
+using namespace Math;
+
+
+namespace
+{
+  /** The user-specified maximum number of threads. Zero means unset. */
+  unsigned int max_threads = 0;
+}
+
+
+void
+MultiThreading::set_n_threads(const unsigned int n_threads)
+{
+  max_threads = n_threads;
+}
+
+
+unsigned int
+MultiThreading::n_threads()
+{
+#ifdef _OPENMP
+  if (max_threads > 0)
+    return max_threads;
+  return std::max(omp_get_max_threads(), 1);
+#else
+  return 1;
+#endif
+}
+
+
+unsigned int
+MultiThreading::n_threads(const size_t work)
+{
+  const size_t max_useful = std::max<size_t>(work / min_work_per_thread, 1);
+  return static_cast<unsigned int>(
+      std::min<size_t>(n_threads(), max_useful));
+}
+
+
+std::vector<size_t>
+MultiThreading::partition(const size_t* offsets,
+                          const size_t n_rows,
+                          const unsigned int n_parts)
+{
+  assert(n_parts > 0);
+
+  // Place each boundary at the first row whose offset reaches an equal share
+  // of the total work
+  const size_t total = offsets[n_rows] - offsets[0];
+  std::vector<size_t> bounds(n_parts + 1, n_rows);
+  bounds[0] = 0;
+  for (unsigned int p = 1; p < n_parts; ++p)
+  {
+    const size_t target = offsets[0] + (total * p) / n_parts;
+    const size_t* it = std::lower_bound(offsets, offsets + n_rows, target);
+    bounds[p] = std::max<size_t>(it - offsets, bounds[p - 1]);
+  }
+  return bounds;
+}
@@ -0,0 +1,64 @@
+#ifndef MULTITHREADING_H
+#define MULTITHREADING_H
+
+#include <cstddef>
+#include <vector>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    /**
+     * Utilities for controlling the shared-memory parallelism used by the
+     * linear algebra kernels.
+     *
+     * Threading is provided by OpenMP. When the code is compiled without
+     * OpenMP support, all kernels run on a single thread and these routines
+     * only report that.
+     */
+    namespace MultiThreading
+    {
+      /**
+       * The minimum amount of work, in non-zero entries, assigned to each
+       * thread. Kernels with less work than this per thread use fewer
+       * threads so that small problems do not pay the threading overhead.
+       */
+      constexpr size_t min_work_per_thread = 8192;
+
+      /**
+       * Set the maximum number of threads used by the linear algebra kernels.
+       * A value of zero restores the default, which is the OpenMP default
+       * and is typically set via the \p OMP_NUM_THREADS environment variable.
+       */
+      void set_n_threads(const unsigned int n_threads);
+
+      /**
+       * Return the maximum number of threads used by the linear algebra
+       * kernels.
+       */
+      unsigned int n_threads();
+
+      /**
+       * Return the number of threads to use for a kernel with \p work units
+       * of work. This is limited by \ref min_work_per_thread and is always at
+       * least one.
+       */
+      unsigned int n_threads(const size_t work);
+
+      /**
+       * Partition a range of rows into \p n_parts contiguous chunks with an
+       * approximately equal amount of work per chunk. The work is described
+       * by the <tt>n_rows + 1</tt> cumulative \p offsets, such as the row
+       * offsets of a compressed sparse matrix. The result contains
+       * <tt>n_parts + 1</tt> row boundaries.
+       */
+      std::vector<size_t>
+      partition(const size_t* offsets,
+                const size_t n_rows,
+                const unsigned int n_parts);
+    }
+  }
+}
+
+#endif //MULTITHREADING_H
@@ -0,0 +1,691 @@
+#include "ordering.h"
+
+#include "sparse_matrix.h"
+#include "sparsity_pattern.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+
+
+namespace
+{
+  using Graph = std::vector<std::vector<size_t>>;
+
+  constexpr size_t invalid = static_cast<size_t>(-1);
+
+
+  /**
+   * Return the adjacency lists of the symmetrized sparsity pattern of a
+   * matrix, excluding the diagonal. Each list is sorted.
+   */
+  Graph
+  build_graph(const SparseMatrix& matrix)
+  {
+    assert(matrix.n_rows() == matrix.n_cols());
+
+    const size_t n = matrix.n_rows();
+    Graph graph(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (matrix.row_length(i) == 0)
+        continue;
+
+      for (const auto el: matrix.row_iterator(i))
+        if (el.column != i)
+        {
+          graph[i].push_back(el.column);
+          graph[el.column].push_back(i);
+        }
+    }
+
+    for (auto& adj: graph)
+    {
+      std::sort(adj.begin(), adj.end());
+      adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+    }
+    return graph;
+  }
+
+
+  /**
+   * Perform a breadth-first search from \p root over the nodes which are
+   * not yet numbered. The visited nodes are stored in \p visited in the
+   * order they are reached and their distance from \p root in \p level.
+   * Return the eccentricity of \p root. The caller must reset \p level for
+   * the visited nodes.
+   */
+  size_t
+  level_structure(const Graph& graph,
+                  const std::vector<bool>& numbered,
+                  const size_t root,
+                  std::vector<size_t>& level,
+                  std::vector<size_t>& visited)
+  {
+    visited.assign(1, root);
+    level[root] = 0;
+    for (size_t k = 0; k < visited.size(); ++k)
+    {
+      const size_t u = visited[k];
+      for (const size_t v: graph[u])
+        if (!numbered[v] && level[v] == invalid)
+        {
+          level[v] = level[u] + 1;
+          visited.push_back(v);
+        }
+    }
+    return level[visited.back()];
+  }
+
+
+  /**
+   * Return a pseudo-peripheral node of the component containing \p start
+   * using the algorithm of George and Liu.
+   */
+  size_t
+  pseudo_peripheral_node(const Graph& graph,
+                         const std::vector<bool>& numbered,
+                         const size_t start,
+                         std::vector<size_t>& level)
+  {
+    std::vector<size_t> visited;
+
+    size_t root = start;
+    size_t eccentricity =
+        level_structure(graph, numbered, root, level, visited);
+    while (true)
+    {
+      // Choose the minimum degree node on the last level
+      size_t candidate = root;
+      for (const size_t v: visited)
+        if (level[v] == eccentricity &&
+            (candidate == root ||
+             graph[v].size() < graph[candidate].size()))
+          candidate = v;
+
+      for (const size_t v: visited)
+        level[v] = invalid;
+
+      const size_t candidate_eccentricity =
+          level_structure(graph, numbered, candidate, level, visited);
+      if (candidate_eccentricity <= eccentricity)
+      {
+        for (const size_t v: visited)
+          level[v] = invalid;
+        return root;
+      }
+
+      root = candidate;
+      eccentricity = candidate_eccentricity;
+    }
+  }
+
+
+  /**
+   * Recursively order the \p rows by geometric nested dissection, appending
+   * the result to \p order. The \p side flags must be zero on entry and are
+   * zero on exit.
+   */
+  void
+  dissect(const Graph& graph,
+          const std::function<const Grid::Point&(size_t)>& point,
+          std::vector<size_t>& rows,
+          const size_t leaf_size,
+          std::vector<char>& side,
+          std::vector<size_t>& order)
+  {
+    // Determine the longest extent of the bounding box
+    unsigned int axis = 0;
+    double max_extent = 0.0;
+    for (unsigned int d = 0; d < 3 && rows.size() > leaf_size; ++d)
+    {
+      const auto [min, max] = std::minmax_element(
+          rows.begin(), rows.end(),
+          [&](const size_t i, const size_t j)
+          { return point(i)[d] < point(j)[d]; });
+      const double extent = point(*max)[d] - point(*min)[d];
+      if (extent > max_extent)
+      {
+        axis = d;
+        max_extent = extent;
+      }
+    }
+
+    // Small or geometrically degenerate subsets keep their relative order
+    if (rows.size() <= leaf_size || max_extent == 0.0)
+    {
+      std::sort(rows.begin(), rows.end());
+      order.insert(order.end(), rows.begin(), rows.end());
+      return;
+    }
+
+    // Bisect at the median coordinate, breaking ties by index
+    const auto mid = rows.begin() + rows.size() / 2;
+    std::nth_element(rows.begin(), mid, rows.end(),
+                     [&](const size_t i, const size_t j)
+                     {
+                       const double xi = point(i)[axis];
+                       const double xj = point(j)[axis];
+                       return xi < xj || (xi == xj && i < j);
+                     });
+
+    std::vector<size_t> left(rows.begin(), mid);
+    std::vector<size_t> right(mid, rows.end());
+    for (const size_t i: left)
+      side[i] = 1;
+    for (const size_t i: right)
+      side[i] = 2;
+
+    // Rows of the left half coupled to the right half form the separator
+    std::vector<size_t> separator;
+    auto is_separator = [&](const size_t i)
+    {
+      for (const size_t j: graph[i])
+        if (side[j] == 2)
+          return true;
+      return false;
+    };
+    for (const size_t i: left)
+      if (is_separator(i))
+        separator.push_back(i);
+    left.erase(std::remove_if(left.begin(), left.end(), is_separator),
+               left.end());
+
+    for (const size_t i: rows)
+      side[i] = 0;
+    rows.clear();
+    rows.shrink_to_fit();
+
+    dissect(graph, point, left, leaf_size, side, order);
+    dissect(graph, point, right, leaf_size, side, order);
+    order.insert(order.end(), separator.begin(), separator.end());
+  }
+}
+
+
+std::vector<size_t>
+Ordering::reverse_cuthill_mckee(const SparseMatrix& matrix)
+{
+  const Graph graph = build_graph(matrix);
+  const size_t n = graph.size();
+
+  std::vector<size_t> order;
+  order.reserve(n);
+
+  std::vector<bool> numbered(n, false);
+  std::vector<size_t> level(n, invalid);
+  for (size_t start = 0; start < n; ++start)
+  {
+    if (numbered[start])
+      continue;
+
+    // Cuthill-McKee on this component, visiting neighbors by degree
+    const size_t root = pseudo_peripheral_node(graph, numbered, start, level);
+    size_t k = order.size();
+    order.push_back(root);
+    numbered[root] = true;
+    for (; k < order.size(); ++k)
+    {
+      std::vector<size_t> next;
+      for (const size_t v: graph[order[k]])
+        if (!numbered[v])
+        {
+          next.push_back(v);
+          numbered[v] = true;
+        }
+
+      std::stable_sort(next.begin(), next.end(),
+                       [&graph](const size_t i, const size_t j)
+                       { return graph[i].size() < graph[j].size(); });
+      order.insert(order.end(), next.begin(), next.end());
+    }
+  }
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+
+std::vector<size_t>
+Ordering::approximate_minimum_degree(const SparseMatrix& matrix)
+{
+  // The quotient graph. Each uneliminated variable has a list of adjacent
+  // variables and a list of adjacent elements. Each element, which is
+  // identified by the pivot it was formed from, has a list of the variables
+  // it contains. The lists are pruned lazily as variables and elements are
+  // absorbed.
+  Graph variables = build_graph(matrix);
+  const size_t n = variables.size();
+  Graph elements(n), element_variables(n);
+
+  enum class Status : char { VARIABLE, ELEMENT, ABSORBED };
+  std::vector<Status> status(n, Status::VARIABLE);
+
+  // The supervariable size of each representative variable, which is zero
+  // for variables merged into another or eliminated. The members of each
+  // supervariable are stored as linked lists.
+  std::vector<size_t> weight(n, 1);
+  std::vector<size_t> next_member(n, invalid), last_member(n);
+  std::iota(last_member.begin(), last_member.end(), 0);
+
+  // The approximate external degree of each variable, which is below n, and
+  // the doubly linked list of variables of each degree
+  std::vector<size_t> degree(n);
+  std::vector<size_t> head(n, invalid), next(n, invalid), prev(n, invalid);
+  const auto insert = [&](const size_t i)
+  {
+    const size_t d = degree[i];
+    prev[i] = invalid;
+    next[i] = head[d];
+    if (head[d] != invalid)
+      prev[head[d]] = i;
+    head[d] = i;
+  };
+  const auto remove = [&](const size_t i)
+  {
+    if (prev[i] != invalid)
+      next[prev[i]] = next[i];
+    else
+      head[degree[i]] = next[i];
+    if (next[i] != invalid)
+      prev[next[i]] = prev[i];
+  };
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    degree[i] = variables[i].size();
+    insert(i);
+  }
+
+  // Scratch for |Le \ Lp| of each element and the external degree of each
+  // variable of Lp. Marks below n tag Lp by its pivot, marks from n upwards
+  // are unique tags for comparing adjacency lists.
+  std::vector<long> external(n, -1);
+  std::vector<size_t> mark(n, invalid), hash(n);
+  size_t tag = n;
+  std::vector<size_t> touched, pivot_variables;
+
+  std::vector<size_t> order;
+  order.reserve(n);
+  const auto eliminate = [&](const size_t i)
+  {
+    for (size_t j = i; j != invalid; j = next_member[j])
+      order.push_back(j);
+  };
+
+  size_t n_remaining = n;
+  size_t min_degree = 0;
+  while (n_remaining > 0)
+  {
+    //======================================== Select the pivot
+    while (head[min_degree] == invalid)
+      ++min_degree;
+    const size_t p = head[min_degree];
+    remove(p);
+
+    n_remaining -= weight[p];
+    status[p] = Status::ELEMENT;
+    eliminate(p);
+
+    //======================================== Form the new element
+    // Lp is the union of the adjacent variables and the variables of the
+    // adjacent elements, which are absorbed into the new element
+    pivot_variables.clear();
+    mark[p] = p;
+    size_t pivot_degree = 0;
+    const auto add_variable = [&](const size_t i)
+    {
+      if (mark[i] != p && status[i] == Status::VARIABLE && weight[i] > 0)
+      {
+        mark[i] = p;
+        pivot_variables.push_back(i);
+        pivot_degree += weight[i];
+        remove(i);
+      }
+    };
+
+    for (const size_t i: variables[p])
+      add_variable(i);
+    for (const size_t e: elements[p])
+      if (status[e] == Status::ELEMENT)
+      {
+        for (const size_t i: element_variables[e])
+          add_variable(i);
+        status[e] = Status::ABSORBED;
+        element_variables[e].clear();
+        element_variables[e].shrink_to_fit();
+      }
+    variables[p].clear();
+    variables[p].shrink_to_fit();
+    elements[p].clear();
+    elements[p].shrink_to_fit();
+
+    //======================================== Compute |Le \ Lp|
+    // Each element adjacent to a variable of Lp starts at its size and is
+    // reduced by the variables of Lp it contains
+    touched.clear();
+    for (const size_t i: pivot_variables)
+      for (const size_t e: elements[i])
+      {
+        if (status[e] != Status::ELEMENT)
+          continue;
+
+        if (external[e] < 0)
+        {
+          auto& le = element_variables[e];
+          le.erase(std::remove_if(le.begin(), le.end(),
+                                  [&](const size_t j)
+                                  { return weight[j] == 0; }),
+                   le.end());
+
+          long size = 0;
+          for (const size_t j: le)
+            size += weight[j];
+          external[e] = size;
+          touched.push_back(e);
+        }
+        external[e] -= weight[i];
+      }
+
+    //======================================== Update the variables of Lp
+    for (const size_t i: pivot_variables)
+    {
+      // Prune the element list. Elements contained in Lp are absorbed.
+      size_t element_degree = 0;
+      size_t h = 0;
+      auto& ei = elements[i];
+      size_t k = 0;
+      for (const size_t e: ei)
+        if (status[e] == Status::ELEMENT)
+        {
+          if (external[e] == 0)
+            status[e] = Status::ABSORBED;
+          else
+          {
+            element_degree += external[e];
+            h += e;
+            ei[k++] = e;
+          }
+        }
+      ei.resize(k);
+
+      // Prune the variable list. Variables of Lp are reached through p.
+      size_t variable_degree = 0;
+      auto& ai = variables[i];
+      k = 0;
+      for (const size_t j: ai)
+        if (status[j] == Status::VARIABLE && weight[j] > 0 && mark[j] != p)
+        {
+          variable_degree += weight[j];
+          h += j;
+          ai[k++] = j;
+        }
+      ai.resize(k);
+
+      // Variables only adjacent to p are eliminated along with it
+      if (ei.empty() && ai.empty())
+      {
+        pivot_degree -= weight[i];
+        n_remaining -= weight[i];
+        weight[i] = 0;
+        status[i] = Status::ABSORBED;
+        eliminate(i);
+        continue;
+      }
+
+      ei.push_back(p);
+      hash[i] = h % n;
+      external[i] = static_cast<long>(variable_degree + element_degree);
+    }
+
+    for (const size_t e: touched)
+      external[e] = -1;
+
+    //======================================== Detect supervariables
+    // Variables of Lp with identical adjacency are indistinguishable and
+    // are merged. Candidates are those with equal hashes.
+    pivot_variables.erase(
+        std::remove_if(pivot_variables.begin(), pivot_variables.end(),
+                       [&](const size_t i) { return weight[i] == 0; }),
+        pivot_variables.end());
+    std::sort(pivot_variables.begin(), pivot_variables.end(),
+              [&](const size_t i, const size_t j)
+              { return hash[i] < hash[j] || (hash[i] == hash[j] && i < j); });
+
+    for (size_t a = 0; a < pivot_variables.size(); ++a)
+    {
+      const size_t i = pivot_variables[a];
+      if (weight[i] == 0)
+        continue;
+
+      bool marked = false;
+      for (size_t b = a + 1; b < pivot_variables.size() &&
+                             hash[pivot_variables[b]] == hash[i]; ++b)
+      {
+        const size_t j = pivot_variables[b];
+        if (weight[j] == 0 ||
+            variables[i].size() != variables[j].size() ||
+            elements[i].size() != elements[j].size())
+          continue;
+
+        // Mark the adjacency of i with a unique tag, then compare
+        if (!marked)
+        {
+          ++tag;
+          for (const size_t v: variables[i])
+            mark[v] = tag;
+          for (const size_t e: elements[i])
+            mark[e] = tag;
+          marked = true;
+        }
+
+        bool same = true;
+        for (const size_t v: variables[j])
+          same = same && mark[v] == tag;
+        for (const size_t e: elements[j])
+          same = same && mark[e] == tag;
+        if (!same)
+          continue;
+
+        // Merge j into i
+        weight[i] += weight[j];
+        weight[j] = 0;
+        external[j] = -1;
+        next_member[last_member[i]] = j;
+        last_member[i] = last_member[j];
+        variables[j].clear();
+        variables[j].shrink_to_fit();
+        elements[j].clear();
+        elements[j].shrink_to_fit();
+      }
+    }
+
+    //======================================== Finalize the degrees
+    // The approximate external degree is bounded by the number of
+    // remaining variables, the previous degree plus the new element, and
+    // the sum of the external sizes of the adjacent elements.
+    auto& lp = element_variables[p];
+    lp.clear();
+    for (const size_t i: pivot_variables)
+    {
+      if (weight[i] == 0)
+        continue;
+
+      const size_t others = pivot_degree - weight[i];
+      const size_t d = std::min({n_remaining - weight[i],
+                                 degree[i] + others,
+                                 static_cast<size_t>(external[i]) + others});
+      external[i] = -1;
+      degree[i] = d;
+      insert(i);
+      min_degree = std::min(min_degree, d);
+      lp.push_back(i);
+    }
+    lp.shrink_to_fit();
+  }
+  return order;
+}
+
+
+std::vector<size_t>
+Ordering::nested_dissection(const SparseMatrix& matrix,
+                            const std::vector<Grid::Point>& points,
+                            const size_t leaf_size)
+{
+  const Graph graph = build_graph(matrix);
+  const size_t n = graph.size();
+
+  assert(!points.empty() || n == 0);
+  assert(n % std::max<size_t>(points.size(), 1) == 0);
+  const size_t block_size = points.empty() ? 1 : n / points.size();
+  const auto point = [&points, block_size](const size_t i) -> const Grid::Point&
+  { return points[i / block_size]; };
+
+  std::vector<size_t> order;
+  order.reserve(n);
+
+  std::vector<size_t> rows(n);
+  std::iota(rows.begin(), rows.end(), 0);
+  std::vector<char> side(n, 0);
+  dissect(graph, point, rows, std::max<size_t>(leaf_size, 1), side, order);
+  return order;
+}
+
+
+std::vector<size_t>
+Ordering::nested_dissection(const SparseMatrix& matrix,
+                            const Grid::Mesh& mesh,
+                            const size_t leaf_size)
+{
+  std::vector<Grid::Point> centroids;
+  centroids.reserve(mesh.cells.size());
+  for (const auto& cell: mesh.cells)
+    centroids.push_back(cell.centroid);
+  return nested_dissection(matrix, centroids, leaf_size);
+}
+
+
+std::vector<size_t>
+Ordering::compute(const Method method,
+                  const SparseMatrix& matrix,
+                  const std::vector<Grid::Point>& points)
+{
+  switch (method)
+  {
+    case Method::RCM:
+      return reverse_cuthill_mckee(matrix);
+    case Method::MINIMUM_DEGREE:
+      return approximate_minimum_degree(matrix);
+    case Method::NESTED_DISSECTION:
+      if (points.empty())
+        throw std::runtime_error(
+            "Nested dissection requires the coordinates of the rows.");
+      return nested_dissection(matrix, points);
+    default:
+    {
+      std::vector<size_t> order(matrix.n_rows());
+      std::iota(order.begin(), order.end(), 0);
+      return order;
+    }
+  }
+}
+
+
+std::vector<size_t>
+Ordering::multicolor(const SparseMatrix& matrix,
+                     std::vector<size_t>& color_offsets)
+{
+  const Graph graph = build_graph(matrix);
+  const size_t n = graph.size();
+
+  // Assign the smallest color not used by a colored neighbor. The last row
+  // to mark each color is tracked, so the marks need no resetting.
+  std::vector<size_t> colors(n, invalid);
+  std::vector<size_t> marked_by;
+  size_t n_colors = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (const size_t j: graph[i])
+      if (colors[j] != invalid)
+        marked_by[colors[j]] = i;
+
+    size_t color = 0;
+    while (color < n_colors && marked_by[color] == i)
+      ++color;
+    if (color == n_colors)
+    {
+      marked_by.push_back(invalid);
+      ++n_colors;
+    }
+    colors[i] = color;
+  }
+
+  // Group the rows by color
+  color_offsets.assign(n_colors + 1, 0);
+  for (size_t i = 0; i < n; ++i)
+    ++color_offsets[colors[i] + 1];
+  for (size_t c = 0; c < n_colors; ++c)
+    color_offsets[c + 1] += color_offsets[c];
+
+  std::vector<size_t> order(n);
+  std::vector<size_t> position(color_offsets.begin(), color_offsets.end() - 1);
+  for (size_t i = 0; i < n; ++i)
+    order[position[colors[i]]++] = i;
+  return order;
+}
+
+
+std::vector<size_t>
+Ordering::invert(const std::vector<size_t>& permutation)
+{
+  std::vector<size_t> inverse(permutation.size(), invalid);
+  for (size_t k = 0; k < permutation.size(); ++k)
+  {
+    assert(permutation[k] < permutation.size());
+    assert(inverse[permutation[k]] == invalid);
+    inverse[permutation[k]] = k;
+  }
+  return inverse;
+}
+
+
+SparseMatrix
+Ordering::permute(const SparseMatrix& matrix,
+                  const std::vector<size_t>& permutation)
+{
+  assert(matrix.n_rows() == matrix.n_cols());
+  assert(permutation.size() == matrix.n_rows());
+
+  const size_t n = matrix.n_rows();
+  const auto inverse = invert(permutation);
+
+  SparsityPattern pattern(n, n);
+  for (size_t k = 0; k < n; ++k)
+  {
+    if (matrix.row_length(permutation[k]) == 0)
+      continue;
+
+    for (const auto el: matrix.row_iterator(permutation[k]))
+      pattern.add(k, inverse[el.column]);
+  }
+  pattern.compress();
+
+  SparseMatrix permuted;
+  permuted.reinit(pattern);
+  for (size_t k = 0; k < n; ++k)
+  {
+    if (matrix.row_length(permutation[k]) == 0)
+      continue;
+
+    for (const auto el: matrix.row_iterator(permutation[k]))
+      permuted(k, inverse[el.column]) = el.value;
+  }
+  return permuted;
+}
@@ -0,0 +1,136 @@
+#ifndef ORDERING_H
+#define ORDERING_H
+
+#include "cartesian_vector.h"
+#include "mesh.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class SparseMatrix;
+
+
+    /**
+     * Fill-reducing and bandwidth-reducing orderings for sparse direct
+     * solvers.
+     *
+     * All orderings operate on the graph of the symmetrized sparsity pattern
+     * \f$ A + A^T \f$ and return a permutation in which entry \p k is the
+     * original index of the row placed at position \p k. The permuted matrix
+     * is then \f$ P A P^T \f$ with \f$ (P A P^T)_{kl} = A_{p_k p_l} \f$.
+     */
+    namespace Ordering
+    {
+      /** The available ordering methods. */
+      enum class Method
+      {
+        NATURAL = 0,            ///< The identity permutation
+        RCM = 1,                ///< Reverse Cuthill-McKee
+        MINIMUM_DEGREE = 2,     ///< Approximate minimum degree
+        NESTED_DISSECTION = 3   ///< Geometric nested dissection
+      };
+
+      /**
+       * Return the reverse Cuthill-McKee ordering of a matrix. This reduces
+       * the bandwidth, and therefore the envelope in which fill can occur.
+       * Each connected component is started from a pseudo-peripheral node.
+       */
+      std::vector<size_t>
+      reverse_cuthill_mckee(const SparseMatrix& matrix);
+
+      /**
+       * Return an approximate minimum degree (AMD) ordering of a matrix.
+       *
+       * The elimination is performed on the quotient graph, in which each
+       * eliminated node becomes an element representing the clique formed
+       * by its neighbors, so the fill is never formed explicitly. At each
+       * step, the node with the smallest approximate external degree is
+       * eliminated, with the degrees bounded as by Amestoy, Davis, and Duff
+       * rather than computed exactly. Indistinguishable nodes are merged
+       * into supervariables, nodes only adjacent to the pivot are
+       * eliminated with it, and elements contained in the new element are
+       * absorbed. This generally produces much less fill than
+       * \ref reverse_cuthill_mckee on two and three dimensional meshes.
+       */
+      std::vector<size_t>
+      approximate_minimum_degree(const SparseMatrix& matrix);
+
+      /**
+       * Return a geometric nested dissection ordering of a matrix.
+       *
+       * The rows are recursively bisected at the median coordinate along the
+       * longest extent of their bounding box. The rows of one half which
+       * couple to the other half form a separator, which is numbered after
+       * both halves. Subsets with fewer than \p leaf_size rows keep their
+       * relative order.
+       *
+       * The \p points give the location of each row. When there are fewer
+       * points than rows, each point is shared by a block of
+       * <tt>n_rows / points.size()</tt> consecutive rows, as is the case for
+       * cell-wise multigroup unknowns and cell centroids.
+       */
+      std::vector<size_t>
+      nested_dissection(const SparseMatrix& matrix,
+                        const std::vector<Grid::Point>& points,
+                        const size_t leaf_size = 64);
+
+      /**
+       * Return a geometric nested dissection ordering of a matrix whose rows
+       * are the cell-wise unknowns on \p mesh, using the cell centroids as
+       * coordinates. See above.
+       */
+      std::vector<size_t>
+      nested_dissection(const SparseMatrix& matrix,
+                        const Grid::Mesh& mesh,
+                        const size_t leaf_size = 64);
+
+      /**
+       * Return a multicolor ordering of a matrix.
+       *
+       * The rows are colored greedily in their natural order with the
+       * smallest color not used by any of their neighbors, so that rows of
+       * the same color are not coupled and can be relaxed concurrently. The
+       * rows are then grouped by color, keeping their relative order within
+       * each color. The rows of color \p c are found at positions
+       * <tt>[color_offsets[c], color_offsets[c + 1])</tt> of the ordering.
+       * For a 5-point stencil on an orthogonal mesh, this is the red-black
+       * ordering.
+       */
+      std::vector<size_t>
+      multicolor(const SparseMatrix& matrix,
+                 std::vector<size_t>& color_offsets);
+
+      /**
+       * Return the ordering of a matrix computed with the specified
+       * \p method. Nested dissection requires the coordinates of the rows,
+       * see \ref nested_dissection, and throws an error if no \p points
+       * are given.
+       */
+      std::vector<size_t>
+      compute(const Method method,
+              const SparseMatrix& matrix,
+              const std::vector<Grid::Point>& points = {});
+
+      /** Return the inverse of a \p permutation. */
+      std::vector<size_t>
+      invert(const std::vector<size_t>& permutation);
+
+      /**
+       * Return the symmetrically permuted matrix \f$ P A P^T \f$. The
+       * result is compressed and retains all entries of \p matrix, including
+       * explicitly stored zeros.
+       */
+      SparseMatrix
+      permute(const SparseMatrix& matrix,
+              const std::vector<size_t>& permutation);
+    }
+  }
+}
+
+#endif //ORDERING_H
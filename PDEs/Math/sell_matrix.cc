@@ -0,0 +1,314 @@
+#include "sell_matrix.h"
+
+#include "vector.h"
+#include "sparse_matrix.h"
+#include "multithreading.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cassert>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PDES_SELL_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+
+using namespace PDEs;
+using namespace Math;
+
+
+namespace
+{
+  constexpr unsigned int C = SELLMatrix::chunk_size;
+
+  /** The user-specified upper bound on the instruction set. */
+  SELLMatrix::SIMD simd_limit = SELLMatrix::SIMD::AVX512;
+
+
+  /** Write the accumulated sums of a chunk to the original rows. */
+  inline void
+  store_chunk(const double* sum,
+              const size_t* row_map,
+              const size_t n_rows,
+              double* y,
+              const bool adding)
+  {
+    for (unsigned int l = 0; l < C; ++l)
+    {
+      const size_t row = row_map[l];
+      if (row < n_rows)
+        y[row] = adding ? y[row] + sum[l] : sum[l];
+    }
+  }
+
+
+  /** The portable kernel. The lane loop is written to auto-vectorize. */
+  void
+  vmult_scalar(const size_t* chunk_offsets,
+               const unsigned int* colnums,
+               const double* values,
+               const size_t* row_map,
+               const size_t n_rows,
+               const size_t begin,
+               const size_t end,
+               const double* x,
+               double* y,
+               const bool adding)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      double sum[C] = {};
+      for (size_t k = chunk_offsets[c]; k < chunk_offsets[c + 1]; k += C)
+        for (unsigned int l = 0; l < C; ++l)
+          sum[l] += values[k + l] * x[colnums[k + l]];
+      store_chunk(sum, row_map + c * C, n_rows, y, adding);
+    }
+  }
+
+
+#ifdef PDES_SELL_X86_KERNELS
+  /** The AVX2 kernel, using two four-wide gathers per column of a chunk. */
+  __attribute__((target("avx2,fma"))) void
+  vmult_avx2(const size_t* chunk_offsets,
+             const unsigned int* colnums,
+             const double* values,
+             const size_t* row_map,
+             const size_t n_rows,
+             const size_t begin,
+             const size_t end,
+             const double* x,
+             double* y,
+             const bool adding)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      __m256d lo = _mm256_setzero_pd();
+      __m256d hi = _mm256_setzero_pd();
+      for (size_t k = chunk_offsets[c]; k < chunk_offsets[c + 1]; k += C)
+      {
+        const auto idx_ptr = reinterpret_cast<const __m128i*>(colnums + k);
+        const __m128i idx_lo = _mm_loadu_si128(idx_ptr);
+        const __m128i idx_hi = _mm_loadu_si128(idx_ptr + 1);
+
+        lo = _mm256_fmadd_pd(_mm256_loadu_pd(values + k),
+                             _mm256_i32gather_pd(x, idx_lo, 8), lo);
+        hi = _mm256_fmadd_pd(_mm256_loadu_pd(values + k + 4),
+                             _mm256_i32gather_pd(x, idx_hi, 8), hi);
+      }
+
+      double sum[C];
+      _mm256_storeu_pd(sum, lo);
+      _mm256_storeu_pd(sum + 4, hi);
+      store_chunk(sum, row_map + c * C, n_rows, y, adding);
+    }
+  }
+
+
+  /** The AVX-512 kernel, using one eight-wide gather per column. */
+  __attribute__((target("avx512f"))) void
+  vmult_avx512(const size_t* chunk_offsets,
+               const unsigned int* colnums,
+               const double* values,
+               const size_t* row_map,
+               const size_t n_rows,
+               const size_t begin,
+               const size_t end,
+               const double* x,
+               double* y,
+               const bool adding)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      __m512d acc = _mm512_setzero_pd();
+      for (size_t k = chunk_offsets[c]; k < chunk_offsets[c + 1]; k += C)
+      {
+        const auto idx_ptr = reinterpret_cast<const __m256i*>(colnums + k);
+        const __m256i idx = _mm256_loadu_si256(idx_ptr);
+        acc = _mm512_fmadd_pd(_mm512_loadu_pd(values + k),
+                              _mm512_i32gather_pd(idx, x, 8), acc);
+      }
+
+      double sum[C];
+      _mm512_storeu_pd(sum, acc);
+      store_chunk(sum, row_map + c * C, n_rows, y, adding);
+    }
+  }
+#endif
+
+
+  /** Determine the best instruction set supported by the CPU. */
+  SELLMatrix::SIMD
+  detect_simd_support()
+  {
+#ifdef PDES_SELL_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      return SELLMatrix::SIMD::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return SELLMatrix::SIMD::AVX2;
+#endif
+    return SELLMatrix::SIMD::SCALAR;
+  }
+}
+
+//################################################## Constructors
+
+SELLMatrix::SELLMatrix() :
+    rows(0), cols(0), sigma(C), chunk_offsets(1, 0)
+{}
+
+
+SELLMatrix::SELLMatrix(const SparseMatrix& matrix, const unsigned int sigma)
+{
+  reinit(matrix, sigma);
+}
+
+
+void
+SELLMatrix::reinit(const SparseMatrix& matrix, const unsigned int sigma)
+{
+  assert(sigma >= C && sigma % C == 0);
+  assert(matrix.n_cols() <= std::numeric_limits<int>::max());
+
+  rows = matrix.n_rows();
+  cols = matrix.n_cols();
+  this->sigma = sigma;
+
+  // Sort rows by decreasing length within each window of sigma rows
+  const size_t n_chunks = (rows + C - 1) / C;
+  row_map.resize(n_chunks * C);
+  std::iota(row_map.begin(), row_map.end(), 0);
+  std::fill(row_map.begin() + rows, row_map.end(), rows);
+
+  const auto longer = [&matrix](const size_t i, const size_t j)
+  { return matrix.row_length(i) > matrix.row_length(j); };
+  for (size_t first = 0; first < rows; first += sigma)
+  {
+    const size_t last = std::min<size_t>(first + sigma, rows);
+    std::stable_sort(row_map.begin() + first,
+                     row_map.begin() + last, longer);
+  }
+
+  // Size each chunk by its longest row
+  chunk_offsets.assign(n_chunks + 1, 0);
+  for (size_t c = 0; c < n_chunks; ++c)
+  {
+    size_t width = 0;
+    for (unsigned int l = 0; l < C; ++l)
+    {
+      const size_t row = row_map[c * C + l];
+      if (row < rows)
+        width = std::max<size_t>(width, matrix.row_length(row));
+    }
+    chunk_offsets[c + 1] = chunk_offsets[c] + width * C;
+  }
+
+  // Fill the chunks column-major. Padding entries have a zero value and
+  // reuse the last column of the row so that no new entries of the source
+  // vector are touched.
+  colnums.assign(chunk_offsets[n_chunks], 0);
+  values.assign(chunk_offsets[n_chunks], 0.0);
+  for (size_t c = 0; c < n_chunks; ++c)
+    for (unsigned int l = 0; l < C; ++l)
+    {
+      const size_t row = row_map[c * C + l];
+      if (row >= rows)
+        continue;
+
+      size_t k = chunk_offsets[c] + l;
+      unsigned int last_col = 0;
+      if (matrix.row_length(row) > 0)
+        for (const auto el: matrix.row_iterator(row))
+        {
+          colnums[k] = last_col = el.column;
+          values[k] = el.value;
+          k += C;
+        }
+      for (; k < chunk_offsets[c + 1]; k += C)
+        colnums[k] = last_col;
+    }
+}
+
+//################################################## Capacity
+
+size_t
+SELLMatrix::n_rows() const
+{
+  return rows;
+}
+
+
+size_t
+SELLMatrix::n_cols() const
+{
+  return cols;
+}
+
+
+size_t
+SELLMatrix::n_chunks() const
+{
+  return chunk_offsets.size() - 1;
+}
+
+
+size_t
+SELLMatrix::n_stored_entries() const
+{
+  return values.size();
+}
+
+//################################################## Matrix-Vector
+
+void
+SELLMatrix::vmult(Vector& y,
+                  const Vector& x,
+                  const bool adding) const
+{
+  assert(x.size() == cols);
+  assert(y.size() == rows);
+  assert(&x != &y);
+
+  using Kernel = void (*)(const size_t*, const unsigned int*,
+                          const double*, const size_t*, const size_t,
+                          const size_t, const size_t,
+                          const double*, double*, const bool);
+
+  Kernel kernel = vmult_scalar;
+#ifdef PDES_SELL_X86_KERNELS
+  switch (simd_support())
+  {
+    case SIMD::AVX512: kernel = vmult_avx512; break;
+    case SIMD::AVX2: kernel = vmult_avx2; break;
+    default: break;
+  }
+#endif
+
+  // Split the chunks among threads by the number of stored entries
+  const int n_threads = MultiThreading::n_threads(values.size());
+  const auto bounds = MultiThreading::partition(chunk_offsets.data(),
+                                                n_chunks(), n_threads);
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t)
+    kernel(chunk_offsets.data(), colnums.data(), values.data(),
+           row_map.data(), rows, bounds[t], bounds[t + 1],
+           x.data(), y.data(), adding);
+}
+
+
+SELLMatrix::SIMD
+SELLMatrix::simd_support()
+{
+  static const SIMD supported = detect_simd_support();
+  return std::min(supported, simd_limit);
+}
+
+
+void
+SELLMatrix::limit_simd_support(const SIMD level)
+{
+  simd_limit = level;
+}
@@ -0,0 +1,135 @@
+#ifndef SELL_MATRIX_H
+#define SELL_MATRIX_H
+
+#include "linear_operator.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class Vector;
+    class SparseMatrix;
+
+
+    /**
+     * Implementation of a sliced ELLPACK (SELL-C-\f$ \sigma \f$) sparse
+     * matrix for fast matrix-vector products.
+     *
+     * Rows are grouped into chunks of \ref chunk_size consecutive rows. Each
+     * chunk is padded to its longest row and stored column-major, so that
+     * the \f$ j \f$'th entries of all rows in a chunk are contiguous and can
+     * be processed as a single SIMD vector. To limit padding, rows are sorted
+     * by length within windows of \f$ \sigma \f$ rows before chunking. Rows
+     * of finite volume diffusion matrices are nearly uniform in length, so
+     * very little padding is required.
+     *
+     * This format is read-only. It is built from a SparseMatrix and is meant
+     * to be used as a LinearOperator. The matrix-vector product uses explicit
+     * AVX-512 or AVX2 kernels when the CPU supports them, as determined at
+     * runtime, and a portable kernel otherwise.
+     */
+    class SELLMatrix : public LinearOperator
+    {
+    public:
+      /** The number of rows per chunk. This is the SIMD width. */
+      static constexpr unsigned int chunk_size = 8;
+
+      /** The instruction sets available for the matrix-vector product. */
+      enum class SIMD
+      {
+        SCALAR = 0,
+        AVX2 = 1,
+        AVX512 = 2
+      };
+
+    private:
+      size_t rows;
+      size_t cols;
+
+      /** The sorting window size, in rows. */
+      unsigned int sigma;
+
+      /**
+       * The offset of the first entry of each chunk within \ref colnums and
+       * \ref values. This has <tt>n_chunks + 1</tt> entries.
+       */
+      std::vector<size_t> chunk_offsets;
+
+      /** The column-major, padded column indices of each chunk. */
+      std::vector<unsigned int> colnums;
+
+      /** The column-major, padded values of each chunk. */
+      std::vector<double> values;
+
+      /**
+       * The original row of each sorted row position. Padding rows in the
+       * last chunk map to <tt>n_rows()</tt>.
+       */
+      std::vector<size_t> row_map;
+
+    public:
+      //################################################## Constructors
+
+      /** Default constructor. Construct an empty matrix. */
+      SELLMatrix();
+
+      /** Construct from a sparse matrix. See \ref reinit. */
+      SELLMatrix(const SparseMatrix& matrix, const unsigned int sigma = 256);
+
+      /**
+       * Reinitialize from a sparse matrix. Rows are sorted by length within
+       * windows of \p sigma rows, which must be a multiple of
+       * \ref chunk_size. A \p sigma of \ref chunk_size disables sorting.
+       */
+      void reinit(const SparseMatrix& matrix, const unsigned int sigma = 256);
+
+      //################################################## Capacity
+
+      /** Return the number of rows. */
+      size_t n_rows() const override;
+
+      /** Return the number of columns. */
+      size_t n_cols() const override;
+
+      /** Return the number of chunks. */
+      size_t n_chunks() const;
+
+      /**
+       * Return the number of stored entries, including padding. The ratio
+       * of this to the number of non-zero entries measures the padding
+       * overhead.
+       */
+      size_t n_stored_entries() const;
+
+      //################################################## Matrix-Vector
+
+      /**
+       * Compute a matrix-vector product \f$ y = A x \f$. The optional
+       * \p adding flag dictates whether to write or add to the destination
+       * vector \p y. Chunks are split among threads.
+       */
+      void vmult(Vector& y,
+                 const Vector& x,
+                 const bool adding = false) const override;
+
+      /**
+       * Return the instruction set used by the matrix-vector product on this
+       * machine.
+       */
+      static SIMD simd_support();
+
+      /**
+       * Restrict the instruction set used by the matrix-vector product, e.g.
+       * for benchmarking. The level is capped at what the CPU supports.
+       */
+      static void limit_simd_support(const SIMD level);
+    };
+  }
+}
+
+#endif //SELL_MATRIX_H
@@ -1,4 +1,6 @@
 #include "sparse_matrix.h"
+#include "sparsity_pattern.h"
+#include "multithreading.h"
 #include "matrix.h"
 #include "vector.h"
 
@@ -7,6 +9,8 @@
 #include <algorithm>
 #include <numeric>
 #include <iomanip>
+#include <limits>
+#include <utility>
 #include <cassert>
 
 
@@ -59,8 +63,8 @@ SparseMatrix::Iterator::Entry
 SparseMatrix::Iterator::operator*() const
 {
   return {row,
-          matrix->colnums[row][index],
-          matrix->values[row][index]};
+          matrix->column(row, index),
+          matrix->row_values(row)[index]};
 }
 
 
@@ -165,8 +169,8 @@ SparseMatrix::ConstIterator::ConstEntry
 SparseMatrix::ConstIterator::operator*() const
 {
   return {row,
-          matrix->colnums[row][index],
-          matrix->values[row][index]};
+          matrix->column(row, index),
+          matrix->row_values(row)[index]};
 }
 
 
@@ -296,15 +300,52 @@ SparseMatrix::reinit(const size_t n_rows, const size_t n_cols)
 
   values.clear();
   values.resize(n_rows);
+
+  compressed = false;
+  row_offsets.clear();
+  packed_colnums.clear();
+  packed_values.clear();
+  diagonal_offsets.clear();
+}
+
+
+void
+SparseMatrix::reinit(const SparsityPattern& pattern)
+{
+  assert(pattern.is_compressed());
+  reinit(pattern.n_rows(), pattern.n_cols());
+
+  // Adopt the compressed structure of the pattern with zero values
+  row_offsets = pattern.row_offsets;
+  packed_colnums = pattern.packed_colnums;
+  packed_values.assign(packed_colnums.size(), 0.0);
+
+  // Cache the diagonal positions
+  diagonal_offsets.assign(rows, -1);
+  for (size_t row = 0; row < rows; ++row)
+    for (size_t offset = row_offsets[row];
+         offset < row_offsets[row + 1]; ++offset)
+      if (packed_colnums[offset] == row)
+        diagonal_offsets[row] = offset;
+
+  // Release the row-wise storage
+  colnums = std::vector<std::vector<size_t>>();
+  values = std::vector<std::vector<double>>();
+
+  has_entries = !packed_values.empty();
+  compressed = true;
 }
 
 
 SparseMatrix&
 SparseMatrix::operator=(const double value)
 {
-  for (auto& row: values)
-    for (auto& el: row)
-      el = value;
+  if (compressed)
+    std::fill(packed_values.begin(), packed_values.end(), value);
+  else
+    for (auto& row: values)
+      for (auto& el: row)
+        el = value;
   return *this;
 }
 
@@ -312,11 +353,7 @@ SparseMatrix::operator=(const double value)
 void
 SparseMatrix::copy_from(const Matrix& matrix)
 {
-  rows = matrix.n_rows();
-  cols = matrix.n_cols();
-
-  colnums.resize(n_rows());
-  values.resize(n_rows());
+  reinit(matrix.n_rows(), matrix.n_cols());
 
   for (size_t row = 0; row < rows; ++row)
     for (size_t col = 0; col < cols; ++col)
@@ -335,6 +372,12 @@ SparseMatrix::copy_from(const SparseMatrix& matrix)
   colnums = matrix.colnums;
   values = matrix.values;
   has_entries = matrix.has_entries;
+
+  compressed = matrix.compressed;
+  row_offsets = matrix.row_offsets;
+  packed_colnums = matrix.packed_colnums;
+  packed_values = matrix.packed_values;
+  diagonal_offsets = matrix.diagonal_offsets;
 }
 
 //################################################## Capacity
@@ -356,7 +399,9 @@ SparseMatrix::n_cols() const
 size_t
 SparseMatrix::n_nonzero_entries() const
 {
-  return std::accumulate(colnums.begin(), colnums.end(), 0,
+  if (compressed)
+    return packed_values.size();
+  return std::accumulate(colnums.begin(), colnums.end(), size_t(0),
                          [](size_t v, const std::vector<size_t>& row) { return v + row.size(); });
 }
 
@@ -365,6 +410,9 @@ unsigned int
 SparseMatrix::row_length(const size_t row) const
 {
   assert(row < rows);
+  if (compressed)
+    return row_offsets[row + 1] - row_offsets[row];
+
   assert(colnums[row].size() == values[row].size());
   return colnums[row].size();
 }
@@ -374,7 +422,15 @@ bool
 SparseMatrix::empty() const
 {
   return (rows == 0 && cols == 0 &&
-          colnums.empty() && values.empty());
+          colnums.empty() && values.empty() &&
+          packed_values.empty());
+}
+
+
+bool
+SparseMatrix::is_compressed() const
+{
+  return compressed;
 }
 
 
@@ -391,7 +447,7 @@ SparseMatrix::operator()(const size_t i, const size_t j)
 {
   const unsigned int idx = index(i, j);
   assert(idx != -1);
-  return values[i][idx];
+  return row_values(i)[idx];
 }
 
 
@@ -400,7 +456,7 @@ SparseMatrix::operator()(const size_t i, const size_t j) const
 {
   const unsigned int idx = index(i, j);
   assert(idx != -1);
-  return values[i][idx];
+  return row_values(i)[idx];
 }
 
 
@@ -408,13 +464,20 @@ double
 SparseMatrix::el(const size_t i, const size_t j)
 {
   const unsigned int idx = index(i, j);
-  return (idx != -1) ? values[i][idx] : 0.0;
+  return (idx != -1) ? row_values(i)[idx] : 0.0;
 }
 
 
 double&
 SparseMatrix::diag(const size_t i)
 {
+  if (compressed)
+  {
+    assert(i < rows);
+    assert(diagonal_offsets[i] != -1);
+    return packed_values[diagonal_offsets[i]];
+  }
+
   const unsigned int idx = index(i, i);
   assert(idx != -1);
   return values[i][idx];
@@ -424,6 +487,13 @@ SparseMatrix::diag(const size_t i)
 const double&
 SparseMatrix::diag(const size_t i) const
 {
+  if (compressed)
+  {
+    assert(i < rows);
+    assert(diagonal_offsets[i] != -1);
+    return packed_values[diagonal_offsets[i]];
+  }
+
   const unsigned int idx = index(i, i);
   assert(idx != -1);
   return values[i][idx];
@@ -433,6 +503,13 @@ SparseMatrix::diag(const size_t i) const
 double
 SparseMatrix::diag_el(const size_t i) const
 {
+  if (compressed)
+  {
+    assert(i < rows);
+    const size_t offset = diagonal_offsets[i];
+    return (offset != -1) ? packed_values[offset] : 0.0;
+  }
+
   const unsigned int idx = index(i, i);
   return (idx != -1) ? values[i][idx] : 0.0;
 }
@@ -443,7 +520,8 @@ SparseMatrix::column(const size_t row, const unsigned int index) const
 {
   assert(row < rows);
   assert(index < row_length(row));
-  return colnums[row][index];
+  return (compressed) ? packed_colnums[row_offsets[row] + index] :
+                        colnums[row][index];
 }
 
 
@@ -453,7 +531,20 @@ SparseMatrix::index(const size_t row, const size_t column) const
   assert(row < rows);
   assert(column < cols);
 
-  // Binary search for the
+  // Binary search for the column on the compressed row
+  if (compressed)
+  {
+    const auto first = packed_colnums.begin() + row_offsets[row];
+    const auto last = packed_colnums.begin() + row_offsets[row + 1];
+
+    auto it = std::lower_bound(first, last, column);
+    if (it != last && *it == column)
+      return it - first;
+    else
+      return -1;
+  }
+
+  // Binary search for the column on the row
   auto it = std::lower_bound(colnums[row].begin(),
                              colnums[row].end(), column);
   if (it != colnums[row].end() && *it == column)
@@ -488,7 +579,7 @@ SparseMatrix::begin(const size_t row)
 
   // Find the next non-empty row
   size_t r = row;
-  while (r != row && colnums[r].size() == 0)
+  while (r < rows && row_length(r) == 0)
     ++r;
 
   // Return the appropriate row, or end
@@ -530,7 +621,7 @@ SparseMatrix::begin(const size_t row) const
 
   // Find the next non-empty row
   size_t r = row;
-  while (r != row && colnums[r].size() == 0)
+  while (r < rows && row_length(r) == 0)
     ++r;
 
   // Return the appropriate row, or end
@@ -571,6 +662,77 @@ SparseMatrix::clear()
   rows = cols = 0;
   colnums.clear();
   values.clear();
+
+  compressed = false;
+  row_offsets.clear();
+  packed_colnums.clear();
+  packed_values.clear();
+  diagonal_offsets.clear();
+}
+
+
+void
+SparseMatrix::compress()
+{
+  if (compressed)
+    return;
+
+  // Define the row offsets
+  row_offsets.assign(rows + 1, 0);
+  for (size_t row = 0; row < rows; ++row)
+    row_offsets[row + 1] = row_offsets[row] + colnums[row].size();
+
+  // Pack the column indices and values into contiguous storage
+  const size_t nnz = row_offsets[rows];
+  packed_colnums.resize(nnz);
+  packed_values.resize(nnz);
+  diagonal_offsets.assign(rows, -1);
+  for (size_t row = 0; row < rows; ++row)
+  {
+    assert(cols <= std::numeric_limits<unsigned int>::max());
+
+    size_t offset = row_offsets[row];
+    for (unsigned int k = 0; k < colnums[row].size(); ++k, ++offset)
+    {
+      packed_colnums[offset] = colnums[row][k];
+      packed_values[offset] = values[row][k];
+      if (colnums[row][k] == row)
+        diagonal_offsets[row] = offset;
+    }
+  }
+
+  // Release the row-wise storage
+  colnums = std::vector<std::vector<size_t>>();
+  values = std::vector<std::vector<double>>();
+  compressed = true;
+}
+
+
+void
+SparseMatrix::decompress()
+{
+  if (!compressed)
+    return;
+
+  // Unpack the contiguous storage into row-wise lists
+  colnums.assign(rows, std::vector<size_t>());
+  values.assign(rows, std::vector<double>());
+  for (size_t row = 0; row < rows; ++row)
+  {
+    const size_t first = row_offsets[row];
+    const size_t last = row_offsets[row + 1];
+    colnums[row].assign(packed_colnums.begin() + first,
+                        packed_colnums.begin() + last);
+    values[row].assign(packed_values.begin() + first,
+                       packed_values.begin() + last);
+  }
+
+  // Release the compressed storage
+  row_offsets = std::vector<size_t>();
+  packed_colnums = std::vector<unsigned int>();
+  packed_values = std::vector<double>();
+  diagonal_offsets = std::vector<size_t>();
+  compressed = false;
 }
 
 
@@ -584,6 +746,24 @@ SparseMatrix::set(const size_t row, const size_t column, const double value)
 
   has_entries = true;
 
+  // Override existing compressed entries, otherwise decompress to insert
+  if (compressed)
+  {
+    if (row == column && diagonal_offsets[row] != -1)
+    {
+      packed_values[diagonal_offsets[row]] = value;
+      return;
+    }
+
+    const unsigned int idx = index(row, column);
+    if (idx != -1)
+    {
+      packed_values[row_offsets[row] + idx] = value;
+      return;
+    }
+    decompress();
+  }
+
   // If the row is empty or the column number is larger than all
   // current entries on the row, add to the back of the row.
   if (colnums[row].size() == 0 || colnums[row].back() < column)
@@ -620,9 +800,16 @@ SparseMatrix::add(const size_t row, const size_t column, const double value)
 
   has_entries = true;
 
+  // Direct access to cached compressed diagonal entries
+  if (compressed && row == column && diagonal_offsets[row] != -1)
+  {
+    packed_values[diagonal_offsets[row]] += value;
+    return;
+  }
+
   const unsigned int idx = index(row, column);
   if (idx == -1) set(row, column, value);
-  else values[row][idx] += value;
+  else row_values(row)[idx] += value;
 }
 
 
@@ -631,6 +818,7 @@ SparseMatrix::swap_row(const size_t i, const size_t k)
 {
   assert(i < rows);
   assert(k < rows);
+  decompress();
   colnums[i].swap(colnums[k]);
   values[i].swap(values[k]);
 }
@@ -645,6 +833,12 @@ SparseMatrix::swap(SparseMatrix& other)
 
   colnums.swap(other.colnums);
   values.swap(other.values);
+
+  std::swap(compressed, other.compressed);
+  row_offsets.swap(other.row_offsets);
+  packed_colnums.swap(other.packed_colnums);
+  packed_values.swap(other.packed_values);
+  diagonal_offsets.swap(other.diagonal_offsets);
 }
 
 //################################################## Scaling Operations
@@ -652,9 +846,13 @@ SparseMatrix::swap(SparseMatrix& other)
 SparseMatrix&
 SparseMatrix::scale(const double factor)
 {
-  for (auto& row_vals: values)
-    for (auto& el: row_vals)
+  if (compressed)
+    for (auto& el: packed_values)
       el *= factor;
+  else
+    for (auto& row_vals: values)
+      for (auto& el: row_vals)
+        el *= factor;
   return *this;
 }
 
@@ -711,14 +909,16 @@ sadd(const double a,
      const double b,
      const SparseMatrix& B)
 {
-  assert(colnums == B.colnums);
+  assert(rows == B.rows && cols == B.cols);
   for (size_t row = 0; row < rows; ++row)
   {
-    double* a_ij = &values[row][0];
-    const double* b_ij = &B.values[row][0];
+    assert(row_length(row) == B.row_length(row));
+
+    double* a_ij = row_values(row);
+    const double* b_ij = B.row_values(row);
     const double* const eor = a_ij + row_length(row);
 
-    for (; a_ij != eor; ++a_ij)
+    for (; a_ij != eor; ++a_ij, ++b_ij)
       *a_ij = a * *a_ij + b * *b_ij;
   }
   return *this;
@@ -739,6 +939,28 @@ SparseMatrix::add(const double b, const SparseMatrix& B)
 }
 
 
+SparseMatrix&
+SparseMatrix::add(const Vector& b, const SparseMatrix& B)
+{
+  assert(rows == B.rows && cols == B.cols);
+  assert(b.size() == rows);
+  for (size_t row = 0; row < rows; ++row)
+  {
+    assert(row_length(row) == B.row_length(row));
+    if (b[row] == 0.0)
+      continue;
+
+    double* a_ij = row_values(row);
+    const double* b_ij = B.row_values(row);
+    const double* const eor = a_ij + row_length(row);
+
+    for (; a_ij != eor; ++a_ij, ++b_ij)
+      *a_ij += b[row] * *b_ij;
+  }
+  return *this;
+}
+
+
 SparseMatrix&
 SparseMatrix::operator+=(const SparseMatrix& B)
 {
@@ -776,7 +998,44 @@ vmult(Vector& y,
   assert(x.size() == cols);
   assert(y.size() == rows);
 
-  double* dst_ptr = &y[0];
+  // Work on a copy when the source and destination are the same
+  if (&x == &y)
+  {
+    const Vector x_copy(x);
+    vmult(y, x_copy, adding);
+    return;
+  }
+
+  double* dst_ptr = y.data();
+
+  // Compressed kernel with contiguous access to all rows. The rows are split
+  // into chunks with an equal number of non-zeros, one per thread.
+  if (compressed)
+  {
+    const int n_threads = MultiThreading::n_threads(packed_values.size());
+    const auto bounds =
+        MultiThreading::partition(row_offsets.data(), rows, n_threads);
+
+    #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+    for (int t = 0; t < n_threads; ++t)
+    {
+      const double* x_ptr = x.data();
+      const unsigned int* col_ptr =
+          packed_colnums.data() + row_offsets[bounds[t]];
+      const double* a_ij = packed_values.data() + row_offsets[bounds[t]];
+
+      for (size_t row = bounds[t]; row < bounds[t + 1]; ++row)
+      {
+        const double* const eor = packed_values.data() + row_offsets[row + 1];
+
+        double val = adding ? dst_ptr[row] : 0.0;
+        while (a_ij != eor)
+          val += *a_ij++ * x_ptr[*col_ptr++];
+        dst_ptr[row] = val;
+      }
+    }
+    return;
+  }
 
   for (size_t row = 0; row < rows; ++row)
   {
@@ -814,11 +1073,46 @@ Tvmult(Vector& y,
        const Vector& x,
        const bool adding) const
 {
-  assert(x.size() == cols);
-  assert(y.size() == rows);
+  assert(x.size() == rows);
+  assert(y.size() == cols);
+
+  // Work on a copy when the source and destination are the same
+  if (&x == &y)
+  {
+    const Vector x_copy(x);
+    Tvmult(y, x_copy, adding);
+    return;
+  }
 
-  double* dst_ptr = &y[0];
-  const double* x_ptr = &x[0];
+  // The parallel compressed kernel handles initialization itself
+  const int n_threads = (compressed) ?
+      MultiThreading::n_threads(packed_values.size()) : 1;
+  if (n_threads > 1)
+  {
+    Tvmult_parallel(y, x, adding, n_threads);
+    return;
+  }
+
+  if (!adding)
+    y = 0.0;
+
+  double* dst_ptr = y.data();
+  const double* x_ptr = x.data();
+
+  // Compressed kernel with contiguous access to all rows
+  if (compressed)
+  {
+    const unsigned int* col_ptr = packed_colnums.data();
+    const double* a_ij = packed_values.data();
+
+    for (size_t row = 0; row < rows; ++row, ++x_ptr)
+    {
+      const double* const eor = packed_values.data() + row_offsets[row + 1];
+      while (a_ij != eor)
+        dst_ptr[*col_ptr++] += *a_ij++ * *x_ptr;
+    }
+    return;
+  }
 
   for (size_t row = 0; row < rows; ++row, ++x_ptr)
   {
@@ -835,7 +1129,243 @@ Tvmult(Vector& y,
 void
 SparseMatrix::Tvmult_add(Vector& y, const Vector& x) const
 {
-  vmult(y, x, true);
+  Tvmult(y, x, true);
+}
+
+
+void
+SparseMatrix::mmult(SparseMatrix& C, const SparseMatrix& B) const
+{
+  assert(cols == B.rows);
+  assert(&C != this && &C != &B);
+
+  // The kernels work on compressed storage
+  if (!compressed || !B.compressed)
+  {
+    SparseMatrix A_copy(*this), B_copy(B);
+    A_copy.compress();
+    B_copy.compress();
+    A_copy.mmult(C, B_copy);
+    return;
+  }
+
+  const size_t invalid = -1;
+  const size_t n = B.cols;
+  assert(n <= std::numeric_limits<unsigned int>::max());
+
+  const int n_threads = MultiThreading::n_threads(packed_values.size());
+  const auto bounds =
+      MultiThreading::partition(row_offsets.data(), rows, n_threads);
+
+  // Symbolic pass counting the distinct columns of each row of the product
+  std::vector<size_t> offsets(rows + 1, 0);
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t)
+  {
+    std::vector<size_t> marker(n, invalid);
+    for (size_t row = bounds[t]; row < bounds[t + 1]; ++row)
+    {
+      size_t count = 0;
+      for (size_t p = row_offsets[row]; p < row_offsets[row + 1]; ++p)
+      {
+        const size_t k = packed_colnums[p];
+        for (size_t q = B.row_offsets[k]; q < B.row_offsets[k + 1]; ++q)
+        {
+          const size_t j = B.packed_colnums[q];
+          if (marker[j] != row)
+          {
+            marker[j] = row;
+            ++count;
+          }
+        }
+      }
+      offsets[row + 1] = count;
+    }
+  }
+  for (size_t row = 0; row < rows; ++row)
+    offsets[row + 1] += offsets[row];
+
+  C.reinit(rows, n);
+  C.row_offsets = std::move(offsets);
+  C.packed_colnums.resize(C.row_offsets[rows]);
+  C.packed_values.resize(C.row_offsets[rows]);
+  C.diagonal_offsets.assign(rows, -1);
+
+  // Numeric pass accumulating each row and sorting it by column
+  #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t)
+  {
+    std::vector<size_t> position(n, invalid);
+    std::vector<std::pair<unsigned int, double>> entries;
+    for (size_t row = bounds[t]; row < bounds[t + 1]; ++row)
+    {
+      const size_t start = C.row_offsets[row];
+      size_t next = start;
+      for (size_t p = row_offsets[row]; p < row_offsets[row + 1]; ++p)
+      {
+        const size_t k = packed_colnums[p];
+        const double a_ik = packed_values[p];
+        for (size_t q = B.row_offsets[k]; q < B.row_offsets[k + 1]; ++q)
+        {
+          const size_t j = B.packed_colnums[q];
+          if (position[j] == invalid || position[j] < start)
+          {
+            position[j] = next;
+            C.packed_colnums[next] = j;
+            C.packed_values[next++] = a_ik * B.packed_values[q];
+          }
+          else
+            C.packed_values[position[j]] += a_ik * B.packed_values[q];
+        }
+      }
+
+      entries.clear();
+      for (size_t p = start; p < next; ++p)
+        entries.emplace_back(C.packed_colnums[p], C.packed_values[p]);
+      std::sort(entries.begin(), entries.end(),
+                [](const auto& a, const auto& b)
+                { return a.first < b.first; });
+
+      for (size_t p = start; p < next; ++p)
+      {
+        C.packed_colnums[p] = entries[p - start].first;
+        C.packed_values[p] = entries[p - start].second;
+        if (C.packed_colnums[p] == row)
+          C.diagonal_offsets[row] = p;
+      }
+    }
+  }
+
+  // Release the row-wise storage
+  C.colnums = std::vector<std::vector<size_t>>();
+  C.values = std::vector<std::vector<double>>();
+  C.has_entries = !C.packed_values.empty();
+  C.compressed = true;
+}
+
+
+void
+SparseMatrix::Tmmult(SparseMatrix& C, const SparseMatrix& B) const
+{
+  assert(rows == B.rows);
+  transpose().mmult(C, B);
+}
+
+
+SparseMatrix
+SparseMatrix::transpose() const
+{
+  if (!compressed)
+  {
+    SparseMatrix copy(*this);
+    copy.compress();
+    return copy.transpose();
+  }
+
+  assert(rows <= std::numeric_limits<unsigned int>::max());
+
+  SparseMatrix T(cols, rows);
+  T.row_offsets.assign(cols + 1, 0);
+  for (const auto j: packed_colnums)
+    ++T.row_offsets[j + 1];
+  for (size_t j = 0; j < cols; ++j)
+    T.row_offsets[j + 1] += T.row_offsets[j];
+
+  // Scatter the entries row by row so that each row of the transpose is
+  // sorted by column
+  T.packed_colnums.resize(packed_colnums.size());
+  T.packed_values.resize(packed_values.size());
+  T.diagonal_offsets.assign(cols, -1);
+  std::vector<size_t> next(T.row_offsets.begin(), T.row_offsets.end() - 1);
+  for (size_t row = 0; row < rows; ++row)
+    for (size_t p = row_offsets[row]; p < row_offsets[row + 1]; ++p)
+    {
+      const size_t j = packed_colnums[p];
+      const size_t q = next[j]++;
+      T.packed_colnums[q] = row;
+      T.packed_values[q] = packed_values[p];
+      if (j == row)
+        T.diagonal_offsets[j] = q;
+    }
+
+  T.colnums = std::vector<std::vector<size_t>>();
+  T.values = std::vector<std::vector<double>>();
+  T.has_entries = has_entries;
+  T.compressed = true;
+  return T;
+}
+
+
+void
+SparseMatrix::Tvmult_parallel(Vector& y,
+                              const Vector& x,
+                              const bool adding,
+                              const int n_threads) const
+{
+  assert(compressed);
+
+  // Each thread scatters the contributions of an equal share of non-zeros
+  // into a private buffer spanning only the columns its rows touch. For
+  // banded matrices, these column ranges barely overlap.
+  const auto bounds =
+      MultiThreading::partition(row_offsets.data(), rows, n_threads);
+
+  std::vector<size_t> first_col(n_threads, 0);
+  std::vector<size_t> last_col(n_threads, 0);
+  std::vector<std::vector<double>> buffers(n_threads);
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t)
+  {
+    const size_t begin = row_offsets[bounds[t]];
+    const size_t end = row_offsets[bounds[t + 1]];
+    if (begin == end)
+      continue;
+
+    const auto minmax = std::minmax_element(packed_colnums.begin() + begin,
+                                            packed_colnums.begin() + end);
+    first_col[t] = *minmax.first;
+    last_col[t] = *minmax.second + 1;
+
+    auto& buffer = buffers[t];
+    buffer.assign(last_col[t] - first_col[t], 0.0);
+    double* dst_ptr = buffer.data() - first_col[t];
+
+    const unsigned int* col_ptr = packed_colnums.data() + begin;
+    const double* a_ij = packed_values.data() + begin;
+    for (size_t row = bounds[t]; row < bounds[t + 1]; ++row)
+    {
+      const double x_row = x[row];
+      const double* const eor = packed_values.data() + row_offsets[row + 1];
+      while (a_ij != eor)
+        dst_ptr[*col_ptr++] += *a_ij++ * x_row;
+    }
+  }
+
+  // Reduce the buffers into the result. The columns are split evenly so that
+  // each entry of the result is written by exactly one thread.
+  double* y_ptr = y.data();
+
+  #pragma omp parallel for num_threads(n_threads) schedule(static, 1)
+  for (int t = 0; t < n_threads; ++t)
+  {
+    const size_t begin = (cols * t) / n_threads;
+    const size_t end = (cols * (t + 1)) / n_threads;
+
+    if (!adding)
+      std::fill(y_ptr + begin, y_ptr + end, 0.0);
+
+    for (int s = 0; s < n_threads; ++s)
+    {
+      const size_t first = std::max(begin, first_col[s]);
+      const size_t last = std::min(end, last_col[s]);
+
+      const double* src_ptr = buffers[s].data() - first_col[s];
+      for (size_t j = first; j < last; ++j)
+        y_ptr[j] += src_ptr[j];
+    }
+  }
 }
 
 
@@ -864,7 +1394,7 @@ SparseMatrix::str(const bool formatted,
       {
         const unsigned int idx = index(row, col);
         if (idx != -1)
-          ss << std::setw(w) << values[row][idx] << " ";
+          ss << std::setw(w) << row_values(row)[idx] << " ";
         else
           ss << std::setw(w) << std::to_string(0.0) << " ";
       }
@@ -876,8 +1406,8 @@ SparseMatrix::str(const bool formatted,
        << "-----------------------" << std::endl;
     for (size_t row = 0; row < rows; ++row)
       for (unsigned int index = 0; index < row_length(row); ++index)
-        ss << "(" << row << ", " << colnums[row][index] << ")\t"
-           << values[row][index] << std::endl;
+        ss << "(" << row << ", " << column(row, index) << ")\t"
+           << row_values(row)[index] << std::endl;
     ss << std::endl;
   }
   return ss.str();
@@ -928,9 +1458,23 @@ SparseMatrix::print_row(const size_t row,
 bool
 SparseMatrix::operator==(const SparseMatrix& other) const
 {
-  return (has_entries == other.has_entries &&
-          rows == other.rows && cols == other.cols &&
-          colnums == other.colnums && values == other.values);
+  if (has_entries != other.has_entries ||
+      rows != other.rows || cols != other.cols)
+    return false;
+
+  // Compare entry by entry so that storage formats may differ
+  for (size_t row = 0; row < rows; ++row)
+  {
+    if (row_length(row) != other.row_length(row))
+      return false;
+
+    const double* a_ij = row_values(row);
+    const double* b_ij = other.row_values(row);
+    for (unsigned int k = 0; k < row_length(row); ++k)
+      if (column(row, k) != other.column(row, k) || a_ij[k] != b_ij[k])
+        return false;
+  }
+  return true;
 }
 
 
@@ -939,6 +1483,24 @@ SparseMatrix::operator!=(const SparseMatrix& other) const
 { return !(*this == other); }
 
 
+double*
+SparseMatrix::row_values(const size_t row)
+{
+  assert(row < rows);
+  return (compressed) ? packed_values.data() + row_offsets[row] :
+                        values[row].data();
+}
+
+
+const double*
+SparseMatrix::row_values(const size_t row) const
+{
+  assert(row < rows);
+  return (compressed) ? packed_values.data() + row_offsets[row] :
+                        values[row].data();
+}
+
+
 SparseMatrix
 Math::operator*(const double factor, const SparseMatrix& A)
 {
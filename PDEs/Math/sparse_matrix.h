@@ -1,6 +1,8 @@
 #ifndef SPARSE_MATRIX_H
 #define SPARSE_MATRIX_H
 
+#include "linear_operator.h"
+
 #include <iostream>
 #include <sstream>
 #include <cstddef>
@@ -14,12 +16,23 @@ namespace PDEs
     //forward declarations
     class Vector;
     class Matrix;
+    class SparsityPattern;
 
 
     /**
      * Implementation of a list of lists sparse matrix.
+     *
+     * Entries are stored row-wise in separately allocated column and value
+     * lists, which allows for cheap insertion of new entries while building
+     * the matrix. Once the sparsity pattern is final, \ref compress can be
+     * called to pack the matrix into compressed sparse row (CSR) format. In
+     * this format, the row offsets, 32-bit column indices, and values live in
+     * three contiguous arrays and the position of each diagonal entry is
+     * cached. All routines remain valid on a compressed matrix. Modifying
+     * existing entries keeps the compressed format, while inserting a new
+     * entry or swapping rows automatically decompresses the matrix.
      */
-    class SparseMatrix
+    class SparseMatrix : public LinearOperator
     {
     public:
       /**
@@ -240,6 +253,28 @@ namespace PDEs
        */
       std::vector<std::vector<double>> values;
 
+      /** A flag for whether the matrix is stored in compressed format. */
+      bool compressed;
+
+      /**
+       * The offset of the first entry of each row within the compressed
+       * storage. This has <tt>n_rows() + 1</tt> entries so that the entries
+       * of row \p i lie in <tt>[row_offsets[i], row_offsets[i + 1])</tt>.
+       */
+      std::vector<size_t> row_offsets;
+
+      /** The contiguously stored column indices in compressed format. */
+      std::vector<unsigned int> packed_colnums;
+
+      /** The contiguously stored values in compressed format. */
+      std::vector<double> packed_values;
+
+      /**
+       * The offset of each diagonal entry within the compressed storage. If
+       * a diagonal entry does not exist, an invalid value is stored.
+       */
+      std::vector<size_t> diagonal_offsets;
+
     public:
       //################################################## Constructors
 
@@ -259,6 +294,15 @@ namespace PDEs
        */
       void reinit(const size_t n_rows, const size_t n_cols);
 
+      /**
+       * Reinitialize the sparse matrix from a compressed sparsity pattern.
+       *
+       * The matrix is allocated in compressed format with every entry of the
+       * \p pattern present and set to zero. Assembly into the matrix then
+       * only overwrites existing values and never modifies its structure.
+       */
+      void reinit(const SparsityPattern& pattern);
+
       /** Copy the non-zero contents of a dense matrix. */
       void copy_from(const Matrix& matrix);
 
@@ -268,10 +312,10 @@ namespace PDEs
       //################################################## Capacity
 
       /** Return the number of rows. */
-      size_t n_rows() const;
+      size_t n_rows() const override;
 
       /** Return the number of columns. */
-      size_t n_cols() const;
+      size_t n_cols() const override;
 
       /** Return the number of non-zero entries. */
       size_t
@@ -283,6 +327,9 @@ namespace PDEs
       /** Return whether the sparse matrix is empty or not. */
       bool empty() const;
 
+      /** Return whether the sparse matrix is in compressed format. */
+      bool is_compressed() const;
+
       /**
        * Return whether an entry for a \p row and \p column has been allocated.
        */
@@ -391,11 +438,29 @@ namespace PDEs
       /** Delete the contents of the sparse matrix. */
       void clear();
 
+      /**
+       * Pack the sparse matrix into compressed sparse row format.
+       *
+       * The row-wise lists are released and the entries are moved into
+       * contiguous arrays. The diagonal positions are cached so that
+       * \ref diag no longer requires a search. Calling this on a compressed
+       * matrix does nothing.
+       */
+      void compress();
+
+      /**
+       * Unpack a compressed sparse matrix back into row-wise lists so that
+       * new entries can be inserted cheaply. Calling this on an uncompressed
+       * matrix does nothing.
+       */
+      void decompress();
+
       /**
        * Set the entry for the specified \p row and \p column to \p value.
        *
        * If the entry is initialized, override the value. If it is not,
-       * initialize  it.
+       * initialize  it. Initializing a new entry on a compressed matrix
+       * decompresses it.
        */
       void set(const size_t row, const size_t column, const double value);
 
@@ -403,10 +468,14 @@ namespace PDEs
        * Add \p value to the entry at the specified \p row and \p column.
        *
        * If the entry is not initialized, then set it, otherwise add to it.
+       * Initializing a new entry on a compressed matrix decompresses it.
        */
       void add(const size_t row, const size_t column, const double value);
 
-      /** Swap the contents of two rows of the sparse matrix. */
+      /**
+       * Swap the contents of two rows of the sparse matrix. This decompresses
+       * a compressed matrix.
+       */
       void swap_row(const size_t i, const size_t k);
 
       /** Swap the contents of two sparse matrices. */
@@ -470,6 +539,15 @@ namespace PDEs
        */
       SparseMatrix& add(const double b, const SparseMatrix& B);
 
+      /**
+       * Element-wise addition by a sparse matrix with row-wise scaling, i.e.
+       * \f$ A = A + \text{diag}(b) B \f$.
+       *
+       * \note To avoid expensive modifications to underlying structure, the
+       *       matrices must have the same sparsity pattern.
+       */
+      SparseMatrix& add(const Vector& b, const SparseMatrix& B);
+
       /**
        * Element-wise addition by another sparse matrix.
        *
@@ -501,13 +579,17 @@ namespace PDEs
        * The optional \p adding flag dictates whether to write or add to the
        * destination vector \p y.
        *
+       * For compressed matrices, the rows are split among threads such that
+       * each thread processes an equal number of non-zero entries. See
+       * MultiThreading for controlling the number of threads.
+       *
        * \note It is acceptable for the vectors \f$ x \f$ and \f$ y \f$ to be
        *    the same for square matrices.
        */
       void
       vmult(Vector& y,
             const Vector& x,
-            const bool adding = false) const;
+            const bool adding = false) const override;
 
       /**
        * Add a matrix-vector product to the destination vector.
@@ -528,6 +610,9 @@ namespace PDEs
        * The optional \p adding flag dictates whether to write or add to the
        * destination vector \p y.
        *
+       * For compressed matrices, this is multithreaded in the same way as
+       * \ref vmult using thread-private accumulation buffers.
+       *
        * \note It is acceptable for the vectors \f$ x \f$ and \f$ y \f$ to be
        *    the same for square matrices.
        */
@@ -540,6 +625,34 @@ namespace PDEs
       void
       Tvmult_add(Vector& y, const Vector& x) const;
 
+      //################################################## Matrix-Matrix
+      //                                                   Multiplication
+
+      /**
+       * Compute a sparse matrix-matrix product, i.e. \f$ C = A B \f$. The
+       * result is compressed and holds all structurally non-zero entries of
+       * the product.
+       *
+       * This uses the row-wise formulation of Gustavson, where row \p i of
+       * \f$ C \f$ is the combination of the rows of \f$ B \f$ selected by
+       * the entries of row \p i of \f$ A \f$. A symbolic pass first counts
+       * the entries of each row so that the numeric pass writes directly into
+       * the compressed storage of the result. Both passes split the rows
+       * among threads as in \ref vmult.
+       */
+      void
+      mmult(SparseMatrix& C, const SparseMatrix& B) const;
+
+      /**
+       * Compute a transpose sparse matrix-matrix product, i.e. \f$ C = A^T B
+       * \f$. The transpose is formed explicitly, see \ref transpose.
+       */
+      void
+      Tmmult(SparseMatrix& C, const SparseMatrix& B) const;
+
+      /** Return the transpose of the sparse matrix in compressed format. */
+      SparseMatrix transpose() const;
+
       //################################################## Print Utilities
 
       /** Return the sparse matrix as a string with the specified formatting. */
@@ -579,6 +692,25 @@ namespace PDEs
       /** Return whether any entries of two sparse matrices are equivalent. */
       bool operator!=(const SparseMatrix& other) const;
 
+    private:
+      /** Return a pointer to the first value on \p row. */
+      double* row_values(const size_t row);
+
+      /** Return a constant pointer to the first value on \p row. */
+      const double* row_values(const size_t row) const;
+
+      /**
+       * The multithreaded transpose matrix-vector product for compressed
+       * matrices. Each thread accumulates into a private buffer and the
+       * buffers are then reduced column-wise, avoiding write conflicts.
+       */
+      void Tvmult_parallel(Vector& y,
+                           const Vector& x,
+                           const bool adding,
+                           const int n_threads) const;
+
+    public:
+
       //################################################## Friends
 
       friend SparseMatrix
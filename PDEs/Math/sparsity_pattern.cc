@@ -0,0 +1,140 @@
+#include "sparsity_pattern.h"
+
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+
+//################################################## Constructors
+
+SparsityPattern::SparsityPattern()
+{
+  reinit(0, 0);
+}
+
+
+SparsityPattern::SparsityPattern(const size_t n_rows, const size_t n_cols)
+{
+  reinit(n_rows, n_cols);
+}
+
+
+void
+SparsityPattern::reinit(const size_t n_rows, const size_t n_cols)
+{
+  rows = n_rows;
+  cols = n_cols;
+  compressed = false;
+
+  colnums.clear();
+  colnums.resize(n_rows);
+
+  row_offsets.clear();
+  packed_colnums.clear();
+}
+
+//################################################## Capacity
+
+size_t
+SparsityPattern::n_rows() const
+{
+  return rows;
+}
+
+
+size_t
+SparsityPattern::n_cols() const
+{
+  return cols;
+}
+
+
+size_t
+SparsityPattern::n_nonzero_entries() const
+{
+  assert(compressed);
+  return packed_colnums.size();
+}
+
+
+unsigned int
+SparsityPattern::row_length(const size_t row) const
+{
+  assert(row < rows);
+  return (compressed) ? row_offsets[row + 1] - row_offsets[row] :
+                        colnums[row].size();
+}
+
+
+bool
+SparsityPattern::is_compressed() const
+{
+  return compressed;
+}
+
+//################################################## Data Access
+
+size_t
+SparsityPattern::column(const size_t row, const unsigned int index) const
+{
+  assert(compressed);
+  assert(index < row_length(row));
+  return packed_colnums[row_offsets[row] + index];
+}
+
+
+bool
+SparsityPattern::exists(const size_t row, const size_t column) const
+{
+  assert(compressed);
+  assert(row < rows);
+  assert(column < cols);
+
+  const auto first = packed_colnums.begin() + row_offsets[row];
+  const auto last = packed_colnums.begin() + row_offsets[row + 1];
+  return std::binary_search(first, last, column);
+}
+
+//################################################## Modifiers
+
+void
+SparsityPattern::add(const size_t row, const size_t column)
+{
+  assert(!compressed);
+  assert(row < rows);
+  assert(column < cols);
+  colnums[row].push_back(column);
+}
+
+
+void
+SparsityPattern::compress()
+{
+  if (compressed)
+    return;
+  assert(cols <= std::numeric_limits<unsigned int>::max());
+
+  // Sort and remove duplicates from each row, then define the row offsets
+  row_offsets.assign(rows + 1, 0);
+  for (size_t row = 0; row < rows; ++row)
+  {
+    auto& row_cols = colnums[row];
+    std::sort(row_cols.begin(), row_cols.end());
+    row_cols.erase(std::unique(row_cols.begin(), row_cols.end()),
+                   row_cols.end());
+    row_offsets[row + 1] = row_offsets[row] + row_cols.size();
+  }
+
+  // Pack the column indices into contiguous storage
+  packed_colnums.resize(row_offsets[rows]);
+  for (size_t row = 0; row < rows; ++row)
+    std::copy(colnums[row].begin(), colnums[row].end(),
+              packed_colnums.begin() + row_offsets[row]);
+
+  // Release the row-wise storage
+  colnums = std::vector<std::vector<size_t>>();
+  compressed = true;
+}
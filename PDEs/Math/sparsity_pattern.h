@@ -0,0 +1,116 @@
+#ifndef SPARSITY_PATTERN_H
+#define SPARSITY_PATTERN_H
+
+#include <cstddef>
+#include <vector>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    //forward declarations
+    class SparseMatrix;
+
+
+    /**
+     * A description of the locations of the non-zero entries of a sparse
+     * matrix.
+     *
+     * Entries are first accumulated row-wise via \ref add, in any order and
+     * with duplicates allowed. Calling \ref compress sorts and removes
+     * duplicates from each row, then packs the pattern into compressed sparse
+     * row format. A compressed pattern is used to reinitialize a SparseMatrix
+     * so that its full structure is allocated up front and assembly only ever
+     * overwrites existing values.
+     */
+    class SparsityPattern
+    {
+    private:
+      size_t rows;
+      size_t cols;
+
+      /** A flag for whether the pattern has been compressed. */
+      bool compressed;
+
+      /** Row-wise storage of the column indices used while building. */
+      std::vector<std::vector<size_t>> colnums;
+
+      /**
+       * The offset of the first entry of each row within \ref packed_colnums.
+       * This has <tt>n_rows() + 1</tt> entries.
+       */
+      std::vector<size_t> row_offsets;
+
+      /** The contiguously stored, sorted column indices of each row. */
+      std::vector<unsigned int> packed_colnums;
+
+    public:
+      //################################################## Constructors
+
+      /** Default constructor. Construct an empty sparsity pattern. */
+      SparsityPattern();
+
+      /** Construct a sparsity pattern with \p n_rows and \p n_cols. */
+      SparsityPattern(const size_t n_rows, const size_t n_cols);
+
+      /**
+       * Reinitialize the sparsity pattern with \p n_rows and \p n_cols.
+       *
+       * This clears the existing data.
+       */
+      void reinit(const size_t n_rows, const size_t n_cols);
+
+      //################################################## Capacity
+
+      /** Return the number of rows. */
+      size_t n_rows() const;
+
+      /** Return the number of columns. */
+      size_t n_cols() const;
+
+      /**
+       * Return the number of non-zero entries. The pattern must be
+       * compressed.
+       */
+      size_t n_nonzero_entries() const;
+
+      /** Return the number of entries on a \p row. */
+      unsigned int row_length(const size_t row) const;
+
+      /** Return whether the pattern has been compressed. */
+      bool is_compressed() const;
+
+      //################################################## Data Access
+
+      /**
+       * Return the column index for a particular \p index of a \p row. The
+       * pattern must be compressed.
+       */
+      size_t column(const size_t row, const unsigned int index) const;
+
+      /**
+       * Return whether an entry exists at \p row and \p column. The pattern
+       * must be compressed.
+       */
+      bool exists(const size_t row, const size_t column) const;
+
+      //################################################## Modifiers
+
+      /** Add an entry at the specified \p row and \p column. */
+      void add(const size_t row, const size_t column);
+
+      /**
+       * Sort and remove duplicate entries from each row and pack the pattern
+       * into contiguous storage. No entries can be added afterwards.
+       */
+      void compress();
+
+      //################################################## Friends
+
+      friend class SparseMatrix;
+    };
+  }
+}
+
+#endif //SPARSITY_PATTERN_H
@@ -1,4 +1,5 @@
 #include "vector.h"
+#include "multithreading.h"
 #include "macros.h"
 
 #include <cmath>
@@ -9,6 +10,25 @@
 using namespace PDEs;
 using namespace Math;
 
+
+namespace
+{
+  /**
+   * Inform the compiler that vector storage is aligned so that vectorized
+   * loops can use aligned loads. See AlignedAllocator.
+   */
+  template<typename T>
+  inline T*
+  assume_aligned(T* ptr)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<T*>(__builtin_assume_aligned(ptr, default_alignment));
+#else
+    return ptr;
+#endif
+  }
+}
+
 //################################################## Contructors
 
 Vector::Vector(const std::initializer_list<double>& list) :
@@ -91,6 +111,13 @@ Vector::empty() const
   return values.empty();
 }
 
+
+size_t
+Vector::capacity() const
+{
+  return values.capacity();
+}
+
 //################################################## Data Access
 
 double&
@@ -513,6 +540,74 @@ Math::l2_norm(const Vector& x)
   return x.l2_norm();
 }
 
+//################################################## Fused Operations
+
+double
+Math::l1_norm_diff(const Vector& x, const Vector& y)
+{
+  assert(x.size() == y.size());
+
+  const size_t n = x.size();
+  const double* x_ptr = assume_aligned(x.data());
+  const double* y_ptr = assume_aligned(y.data());
+  const int n_threads = MultiThreading::n_threads(n);
+
+  double norm = 0.0;
+  #pragma omp parallel for num_threads(n_threads) reduction(+:norm)
+  for (size_t i = 0; i < n; ++i)
+    norm += std::fabs(x_ptr[i] - y_ptr[i]);
+  return norm;
+}
+
+
+void
+Math::axpby(const double a, const Vector& x, const double b, Vector& y)
+{
+  waxpby(y, a, x, b, y);
+}
+
+
+void
+Math::waxpby(Vector& w,
+             const double a, const Vector& x,
+             const double b, const Vector& y)
+{
+  assert(x.size() == y.size());
+  if (w.size() != x.size())
+    w.resize(x.size());
+
+  const size_t n = x.size();
+  double* w_ptr = assume_aligned(w.data());
+  const double* x_ptr = assume_aligned(x.data());
+  const double* y_ptr = assume_aligned(y.data());
+  const int n_threads = MultiThreading::n_threads(n);
+
+  #pragma omp parallel for num_threads(n_threads)
+  for (size_t i = 0; i < n; ++i)
+    w_ptr[i] = a * x_ptr[i] + b * y_ptr[i];
+}
+
+
+std::pair<double, double>
+Math::dot_and_norm(const Vector& x, const Vector& y)
+{
+  assert(x.size() == y.size());
+
+  const size_t n = x.size();
+  const double* x_ptr = assume_aligned(x.data());
+  const double* y_ptr = assume_aligned(y.data());
+  const int n_threads = MultiThreading::n_threads(n);
+
+  double dot = 0.0, norm = 0.0;
+  #pragma omp parallel for num_threads(n_threads) reduction(+:dot, norm)
+  for (size_t i = 0; i < n; ++i)
+  {
+    dot += x_ptr[i] * y_ptr[i];
+    norm += x_ptr[i] * x_ptr[i];
+  }
+  return {dot, std::sqrt(norm)};
+}
+
 
 double
 Math::lp_norm(const Vector& x, const double p)
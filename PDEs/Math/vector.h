@@ -1,10 +1,13 @@
 #ifndef VECTOR_H
 #define VECTOR_H
 
+#include "aligned_allocator.h"
+
 #include <iostream>
 #include <sstream>
 
 #include <cstddef>
+#include <utility>
 #include <vector>
 
 
@@ -14,15 +17,19 @@ namespace PDEs
   {
     /**
      * Implementation of a general linear algebra vector.
+     *
+     * The entries are stored contiguously and aligned to
+     * \ref default_alignment bytes. See AlignedAllocator.
      */
     class Vector
     {
     public:
-      using iterator = std::vector<double>::iterator;
-      using const_iterator = std::vector<double>::const_iterator;
+      using storage_type = std::vector<double, AlignedAllocator<double>>;
+      using iterator = storage_type::iterator;
+      using const_iterator = storage_type::const_iterator;
 
     protected:
-      std::vector<double> values;
+      storage_type values;
 
     public:
       //################################################## Constructors
@@ -75,6 +82,12 @@ namespace PDEs
       /*** Return whether the vector is empty (no allocated entries) or not. */
       bool empty() const;
 
+      /**
+       * Return the number of entries the vector can hold without
+       * reallocating.
+       */
+      size_t capacity() const;
+
       //################################################## Data Access
 
       /** Read and write access for entry \p i. */
@@ -290,6 +303,36 @@ namespace PDEs
     /** Return the \f$ \ell_p \f$-norm of a vector. */
     double lp_norm(const Vector& x, const double p);
 
+    //################################################## Fused Operations
+
+    /**
+     * Return the \f$ \ell_1 \f$-norm of the difference between two vectors,
+     * i.e. \f$ \| x - y \|_1 \f$. This is computed in a single pass without
+     * forming the difference.
+     */
+    double l1_norm_diff(const Vector& x, const Vector& y);
+
+    /**
+     * Compute \f$ y = a x + b y \f$ in a single pass. This is equivalent to
+     * <tt>y.sadd(b, a, x)</tt>.
+     */
+    void axpby(const double a, const Vector& x, const double b, Vector& y);
+
+    /**
+     * Compute \f$ w = a x + b y \f$ in a single pass. The destination \p w
+     * is only reallocated if its size differs and may be the same vector as
+     * \p x or \p y.
+     */
+    void waxpby(Vector& w,
+                const double a, const Vector& x,
+                const double b, const Vector& y);
+
+    /**
+     * Return the dot product \f$ x \cdot y \f$ and the \f$ \ell_2 \f$-norm
+     * of \f$ x \f$, computed in a single pass.
+     */
+    std::pair<double, double> dot_and_norm(const Vector& x, const Vector& y);
+
     /** Insert a vector into an output stream. */
     std::ostream& operator<<(std::ostream& os, const Vector& x);
   }
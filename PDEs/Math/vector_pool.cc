@@ -0,0 +1,113 @@
+#include "vector_pool.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+using namespace PDEs;
+using namespace Math;
+
+//################################################## VectorPool
+
+std::unique_ptr<Vector>
+VectorPool::acquire(const size_t n)
+{
+  if (available.empty())
+    return std::make_unique<Vector>(n);
+
+  // Find the smallest vector which can hold n entries without reallocating,
+  // otherwise the largest vector
+  size_t best = 0;
+  for (size_t k = 1; k < available.size(); ++k)
+  {
+    const size_t cap = available[k]->capacity();
+    const size_t best_cap = available[best]->capacity();
+    if (best_cap < n ? cap > best_cap : (cap >= n && cap < best_cap))
+      best = k;
+  }
+
+  auto vector = std::move(available[best]);
+  available[best] = std::move(available.back());
+  available.pop_back();
+
+  vector->resize(n);
+  return vector;
+}
+
+
+void
+VectorPool::release(std::unique_ptr<Vector> vector)
+{
+  assert(vector);
+  available.push_back(std::move(vector));
+}
+
+
+size_t
+VectorPool::n_available() const
+{
+  return available.size();
+}
+
+
+void
+VectorPool::clear()
+{
+  available.clear();
+  available.shrink_to_fit();
+}
+
+
+VectorPool&
+VectorPool::thread_pool()
+{
+  static thread_local VectorPool pool;
+  return pool;
+}
+
+//################################################## ScratchVector
+
+ScratchVector::ScratchVector(const size_t n) :
+    vector(VectorPool::thread_pool().acquire(n))
+{}
+
+
+ScratchVector::ScratchVector(const size_t n, const double value) :
+    vector(VectorPool::thread_pool().acquire(n))
+{
+  std::fill(vector->begin(), vector->end(), value);
+}
+
+
+ScratchVector::~ScratchVector()
+{
+  VectorPool::thread_pool().release(std::move(vector));
+}
+
+
+Vector&
+ScratchVector::operator*()
+{
+  return *vector;
+}
+
+
+const Vector&
+ScratchVector::operator*() const
+{
+  return *vector;
+}
+
+
+Vector*
+ScratchVector::operator->()
+{
+  return vector.get();
+}
+
+
+const Vector*
+ScratchVector::operator->() const
+{
+  return vector.get();
+}
@@ -0,0 +1,92 @@
+#ifndef VECTOR_POOL_H
+#define VECTOR_POOL_H
+
+#include "vector.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace PDEs
+{
+  namespace Math
+  {
+    /**
+     * A pool of work vectors which are reused across calls.
+     *
+     * Routines which need temporary vectors, such as iterative solvers, check
+     * them out of the pool rather than allocating them, and return them when
+     * done. Returned vectors keep their storage, so once the pool has warmed
+     * up, repeated calls with the same problem size perform no heap
+     * allocation. Each thread has its own pool, see \ref thread_pool, so no
+     * locking is required.
+     *
+     * Vectors should be checked out through ScratchVector, which returns them
+     * to the pool automatically.
+     */
+    class VectorPool
+    {
+    private:
+      /** The vectors which are not checked out. */
+      std::vector<std::unique_ptr<Vector>> available;
+
+    public:
+      /**
+       * Check out a vector with \p n entries. The vector with the smallest
+       * sufficient capacity is used. If there is none, the largest available
+       * vector is grown, or a new one is created. The entries are not
+       * initialized.
+       */
+      std::unique_ptr<Vector> acquire(const size_t n);
+
+      /** Return a vector to the pool. */
+      void release(std::unique_ptr<Vector> vector);
+
+      /** Return the number of vectors available in the pool. */
+      size_t n_available() const;
+
+      /** Free all vectors available in the pool. */
+      void clear();
+
+      /** Return the pool of the calling thread. */
+      static VectorPool& thread_pool();
+    };
+
+
+    /**
+     * A work vector checked out of the calling thread's VectorPool for the
+     * lifetime of this object. This is used like a reference to a Vector.
+     */
+    class ScratchVector
+    {
+    private:
+      std::unique_ptr<Vector> vector;
+
+    public:
+      /**
+       * Check out a vector with \p n entries. The entries are not
+       * initialized.
+       */
+      explicit ScratchVector(const size_t n);
+
+      /** Check out a vector with \p n entries set to \p value. */
+      ScratchVector(const size_t n, const double value);
+
+      /** Return the vector to the pool. */
+      ~ScratchVector();
+
+      ScratchVector(const ScratchVector&) = delete;
+      ScratchVector& operator=(const ScratchVector&) = delete;
+
+      /** Access the vector. */
+      Vector& operator*();
+      const Vector& operator*() const;
+
+      Vector* operator->();
+      const Vector* operator->() const;
+    };
+  }
+}
+
+#endif //VECTOR_POOL_H
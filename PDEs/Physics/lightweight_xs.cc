@@ -12,18 +12,25 @@ namespace PDEs
     {}
 
 
-    void LightWeightCrossSections::
+    bool LightWeightCrossSections::
     update(const std::vector<double>& args)
     {
       if (!ref_xs->sigma_a_function)
-        return;
+        return false;
 
+      bool changed = false;
       const auto& f = ref_xs->sigma_a_function;
       for (unsigned int g = 0; g < ref_xs->n_groups; ++g)
       {
-        const double sig_a = f(g, args, ref_xs->sigma_a[g]);
-        sigma_t[g] = sig_a + ref_xs->sigma_s[g];
+        const double sig_t = f(g, args, ref_xs->sigma_a[g]) +
+                             ref_xs->sigma_s[g];
+        if (sig_t != sigma_t[g])
+        {
+          sigma_t[g] = sig_t;
+          changed = true;
+        }
       }
+      return changed;
     }
   }
 }
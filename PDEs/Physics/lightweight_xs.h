@@ -34,9 +34,10 @@ namespace PDEs
        *
        * This routine calls the stored functions within the reference
        * CrossSections for the update. Said functions should have the structure
-       * of the \p args argument encoded with in.
+       * of the \p args argument encoded with in. Return whether any of the
+       * cross-section values changed.
        */
-      void update(const std::vector<double>& args);
+      bool update(const std::vector<double>& args);
 
 
     };
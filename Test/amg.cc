@@ -0,0 +1,195 @@
+#include "test_utilities.h"
+
+#include "multithreading.h"
+#include "LinearSolvers/Iterative/cg.h"
+#include "LinearSolvers/Iterative/gmres.h"
+#include "LinearSolvers/Preconditioners/amg.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+using Smoother = AMGPreconditioner::Smoother;
+
+
+/** Wrap AMG to count V-cycles, i.e. preconditioned iterations. */
+class CountingAMG : public AMGPreconditioner
+{
+public:
+  using AMGPreconditioner::AMGPreconditioner;
+
+  mutable size_t n_cycles = 0;
+
+  void
+  vmult(Vector& z, const Vector& r) const override
+  {
+    ++n_cycles;
+    AMGPreconditioner::vmult(z, r);
+  }
+};
+
+
+/** Return the maximum difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+  return diff;
+}
+
+
+/**
+ * Solve the symmetric problem on an \p n_cells by \p n_cells mesh with
+ * AMG-preconditioned CG. Return the number of iterations, or zero if the
+ * residual check fails.
+ */
+size_t
+solve_cg(const size_t n_cells,
+         const Smoother smoother,
+         const std::string& label,
+         const double scale = 1.0)
+{
+  const auto mesh = create_square_mesh(n_cells);
+  const SparseMatrix A = assemble(*mesh, true, scale);
+  const Vector b = create_rhs(A.n_rows());
+
+  const auto amg = smoother == Smoother::CHEBYSHEV
+                   ? std::make_shared<CountingAMG>(smoother, 0.08, 2)
+                   : std::make_shared<CountingAMG>(smoother);
+  CG cg(Options(1.0e-10, 500));
+  cg.set_matrix(A);
+  cg.set_preconditioner(amg);
+
+  Vector x(b.size(), 0.0);
+  cg.solve(x, b);
+  const bool passed = check_residual(
+      label + ", " + std::to_string(n_cells) + "^2 cells",
+      relative_residual(A, x, b), 1.0e-9);
+  return passed ? amg->n_cycles : 0;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  const auto mesh = create_square_mesh(60);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix N = assemble(*mesh, false);
+  const Vector b = create_rhs(S.n_rows());
+
+  // The hierarchy coarsens geometrically with a small complexity
+  AMGPreconditioner amg;
+  amg.set_matrix(S);
+  std::cout << "AMG levels " << amg.n_levels() << ", operator complexity "
+            << amg.operator_complexity() << std::endl;
+  passed &= check("hierarchy",
+                  amg.n_levels() > 2 && amg.operator_complexity() > 1.0 &&
+                  amg.operator_complexity() < 2.0);
+
+  // A V-cycle with symmetric Gauss-Seidel smoothing is a symmetric
+  // positive definite operator for symmetric matrices
+  Vector u(b.size()), v(b.size()), Mu(b.size()), Mv(b.size());
+  for (size_t i = 0; i < u.size(); ++i)
+  {
+    u[i] = std::sin(0.37 * i);
+    v[i] = std::cos(0.11 * i * i);
+  }
+  amg.vmult(Mu, u);
+  amg.vmult(Mv, v);
+  const double uMv = u.dot(Mv), vMu = v.dot(Mu);
+  passed &= check("symmetric V-cycle",
+                  std::fabs(uMv - vMu) < 1.0e-12 * std::fabs(uMv) &&
+                  u.dot(Mu) > 0.0 && v.dot(Mv) > 0.0);
+
+  // Operators smaller than the coarse size are solved directly
+  const auto small_mesh = create_square_mesh(10);
+  const SparseMatrix S_small = assemble(*small_mesh, true);
+  const Vector b_small = create_rhs(S_small.n_rows());
+  AMGPreconditioner direct;
+  direct.set_matrix(S_small);
+  Vector x_small(b_small.size());
+  direct.vmult(x_small, b_small);
+  passed &= check("small operators have a single level",
+                  direct.n_levels() == 1);
+  passed &= check_residual("small operators are solved directly",
+                           relative_residual(S_small, x_small, b_small),
+                           1.0e-12);
+
+  // Iterations are nearly independent of the mesh size for each smoother
+  for (const auto& [smoother, label]:
+       {std::make_pair(Smoother::GAUSS_SEIDEL, "GS"),
+        std::make_pair(Smoother::MULTICOLOR_GAUSS_SEIDEL, "multicolor GS"),
+        std::make_pair(Smoother::CHEBYSHEV, "Chebyshev")})
+  {
+    const std::string name = std::string("CG + AMG (") + label + ")";
+    const size_t n_coarse = solve_cg(50, smoother, name);
+    const size_t n_fine = solve_cg(150, smoother, name);
+    passed &= check(name + ", " + std::to_string(n_coarse) + " and " +
+                    std::to_string(n_fine) + " iterations",
+                    n_coarse > 0 && n_fine > 0 && n_fine < 25 &&
+                    n_fine <= n_coarse + 5);
+  }
+
+  // Rebuilding with new values matches a fresh hierarchy
+  const SparseMatrix S_scaled = assemble(*mesh, true, 2.0);
+  amg.set_matrix(S_scaled);
+  AMGPreconditioner fresh;
+  fresh.set_matrix(S_scaled);
+  Vector z(b.size()), z_fresh(b.size());
+  amg.vmult(z, b);
+  fresh.vmult(z_fresh, b);
+  passed &= check("rebuilt hierarchy", z == z_fresh);
+  passed &= solve_cg(60, Smoother::GAUSS_SEIDEL,
+                     "CG + AMG, new values", 2.0) > 0;
+
+  // The parallel smoothers do not depend on the number of threads beyond
+  // rounding
+  for (const Smoother smoother: {Smoother::MULTICOLOR_GAUSS_SEIDEL,
+                                 Smoother::CHEBYSHEV})
+  {
+    Vector z_serial(b.size());
+    for (const unsigned int n_threads: {1, 4})
+    {
+      MultiThreading::set_n_threads(n_threads);
+      AMGPreconditioner parallel(smoother);
+      parallel.set_matrix(S);
+      parallel.vmult(z, b);
+      if (n_threads == 1)
+        z_serial = z;
+    }
+    passed &= check(std::string(smoother == Smoother::CHEBYSHEV
+                                ? "Chebyshev" : "multicolor Gauss-Seidel") +
+                    " smoothing on 4 threads",
+                    max_difference(z, z_serial) <
+                    1.0e-10 * z_serial.linfty_norm());
+  }
+  MultiThreading::set_n_threads(0);
+
+  // Non-symmetric problems with GMRES
+  GMRES gmres(30, Options(1.0e-10, 500));
+  gmres.set_matrix(N);
+  gmres.set_preconditioner(std::make_shared<AMGPreconditioner>());
+  Vector x(b.size(), 0.0);
+  gmres.solve(x, b);
+  passed &= check_residual("GMRES(30) + AMG",
+                           relative_residual(N, x, b), 1.0e-9);
+
+  const SparseMatrix N_scaled = assemble(*mesh, false, 2.0);
+  gmres.set_matrix(N_scaled);
+  x = 0.0;
+  gmres.solve(x, b);
+  passed &= check_residual("GMRES(30) + AMG, new values",
+                           relative_residual(N_scaled, x, b), 1.0e-9);
+
+  return passed ? 0 : 1;
+}
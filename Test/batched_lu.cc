@@ -0,0 +1,175 @@
+#include "test_utilities.h"
+
+#include "matrix.h"
+#include "multithreading.h"
+#include "LinearSolvers/Direct/batched_lu.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Fill \p solver with \p n_blocks deterministic blocks of size
+ * \p block_size. The blocks are diagonally dominant. With
+ * \p needs_pivoting, the dominant entries are shifted one column to the
+ * right and the leading entry is zero, so the blocks are only factored
+ * with row exchanges.
+ */
+void
+fill_blocks(BatchedLU& solver,
+            const size_t n_blocks,
+            const size_t block_size,
+            const bool needs_pivoting)
+{
+  solver.reinit(n_blocks, block_size);
+  for (size_t b = 0; b < n_blocks; ++b)
+    for (size_t i = 0; i < block_size; ++i)
+      for (size_t j = 0; j < block_size; ++j)
+      {
+        const size_t dominant = needs_pivoting ? (i + 1) % block_size : i;
+        double value = std::sin(0.3 * b + 1.7 * i + 0.9 * j);
+        if (j == dominant)
+          value += 2.0 * block_size;
+        if (needs_pivoting && i == 0 && j == 0)
+          value = 0.0;
+        solver(b, i, j) = value;
+      }
+}
+
+
+/**
+ * Return the maximum relative residual of the block systems \f$ A_b x_b =
+ * b_b \f$, with the blocks taken from \p reference before factorization.
+ */
+double
+block_residual(const BatchedLU& reference,
+               const Vector& x,
+               const Vector& b)
+{
+  const size_t G = reference.get_block_size();
+  double residual = 0.0;
+  for (size_t k = 0; k < reference.n_blocks(); ++k)
+    for (size_t i = 0; i < G; ++i)
+    {
+      double r = b[k * G + i];
+      for (size_t j = 0; j < G; ++j)
+        r -= reference(k, i, j) * x[k * G + j];
+      residual = std::max(residual, std::fabs(r) / b.linfty_norm());
+    }
+  return residual;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // Each block size with a batch that does not fill the last chunk
+  const size_t n_blocks = 1003;
+  for (size_t G = 1; G <= 8; ++G)
+    for (const bool needs_pivoting: {false, true})
+    {
+      if (G == 1 && needs_pivoting)
+        continue;
+
+      BatchedLU solver;
+      fill_blocks(solver, n_blocks, G, needs_pivoting);
+      const BatchedLU reference(solver);
+      solver.factorize();
+
+      const Vector b = create_rhs(n_blocks * G);
+      Vector x(b.size());
+      solver.solve(x, b);
+
+      // In-place solves
+      Vector y(b);
+      solver.solve(y, y);
+
+      const std::string label = std::to_string(G) + " x " +
+                                std::to_string(G) + " blocks" +
+                                (needs_pivoting ? " with pivoting" : "");
+      passed &= check_residual(label, block_residual(reference, x, b),
+                               1.0e-13);
+      passed &= check(label + ", in place", x == y);
+    }
+
+  // The blocks are factored independently, so threads do not change the
+  // result
+  Vector x_serial;
+  for (const unsigned int n_threads: {1, 4})
+  {
+    MultiThreading::set_n_threads(n_threads);
+    BatchedLU solver;
+    fill_blocks(solver, n_blocks, 5, true);
+    solver.factorize();
+
+    const Vector b = create_rhs(n_blocks * 5);
+    Vector x(b.size());
+    solver.solve(x, b);
+    if (n_threads == 1)
+      x_serial = x;
+    passed &= check(std::to_string(n_threads) + " threads", x == x_serial);
+  }
+  MultiThreading::set_n_threads(0);
+
+  // Dense blocks set individually
+  BatchedLU dense;
+  dense.reinit(3, 2);
+  dense.set_block(1, Matrix({{0.0, 2.0}, {3.0, 1.0}}));
+  dense.set_block(0, Matrix({{1.0, 0.0}, {0.0, 1.0}}));
+  dense.set_block(2, Matrix({{4.0, 1.0}, {1.0, 3.0}}));
+  dense.factorize();
+  Vector x_dense(6);
+  dense.solve(x_dense, Vector({1.0, 2.0, 2.0, 3.0, 5.0, 4.0}));
+  passed &= check("individually set blocks",
+                  x_dense == Vector({1.0, 2.0, 2.0 / 3.0, 1.0, 1.0, 1.0}));
+
+  // The cell-wise group blocks of a diffusion operator
+  const auto mesh = create_square_mesh(30);
+  for (const double scale: {1.0, 2.0})
+  {
+    const SparseMatrix A = assemble(*mesh, false, scale);
+    BatchedLU cells;
+    cells.set_matrix(A, 2);
+
+    const Vector b = create_rhs(A.n_rows());
+    Vector x(b.size());
+    cells.solve(x, b);
+
+    double residual = 0.0;
+    for (size_t i = 0; i < A.n_rows(); ++i)
+    {
+      double r = b[i];
+      for (const auto entry: A.row_iterator(i))
+        if (entry.column / 2 == i / 2)
+          r -= entry.value * x[entry.column];
+      residual = std::max(residual, std::fabs(r) / b.linfty_norm());
+    }
+    passed &= check_residual("cell blocks of the diffusion operator, scale " +
+                             std::to_string(static_cast<int>(scale)),
+                             residual, 1.0e-13);
+  }
+
+  // Singular blocks are rejected
+  BatchedLU singular;
+  singular.reinit(4, 2);
+  for (size_t b = 0; b < 4; ++b)
+  {
+    singular(b, 0, 0) = singular(b, 1, 1) = 1.0;
+    singular(b, 0, 1) = singular(b, 1, 0) = b == 2 ? 1.0 : 0.0;
+  }
+  bool threw = false;
+  try { singular.factorize(); }
+  catch (const std::exception&) { threw = true; }
+  passed &= check("singular blocks are rejected", threw);
+
+  return passed ? 0 : 1;
+}
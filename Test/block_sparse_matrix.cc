@@ -0,0 +1,152 @@
+#include "test_utilities.h"
+
+#include "block_sparse_matrix.h"
+#include "LinearSolvers/Iterative/cg.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Build a symmetric positive definite multigroup operator on an
+ * <tt>n x n</tt> grid of cells with \p n_groups unknowns per cell. The
+ * groups of a cell are densely coupled. Neighboring cells are coupled
+ * within each group only or, with \p full_blocks, also across groups. With
+ * \p empty_cell, the rows of that cell are left empty.
+ */
+SparseMatrix
+create_matrix(const size_t n,
+              const unsigned int n_groups,
+              const bool full_blocks = false,
+              const size_t empty_cell = size_t(-1))
+{
+  const size_t n_rows = n * n * n_groups;
+  SparseMatrix A(n_rows, n_rows);
+  const auto couple = [&](const size_t i, const size_t j, const double v)
+  {
+    if (i / n_groups == empty_cell || j / n_groups == empty_cell)
+      return;
+    A.add(i, j, v);
+    A.add(j, i, v);
+    A.add(i, i, -v + 0.01);
+    A.add(j, j, -v + 0.01);
+  };
+
+  for (size_t cx = 0; cx < n; ++cx)
+    for (size_t cy = 0; cy < n; ++cy)
+    {
+      const size_t c = cx * n + cy;
+      for (unsigned int g = 0; g < n_groups; ++g)
+      {
+        const size_t i = c * n_groups + g;
+        if (c != empty_cell)
+          A.add(i, i, 0.1 * (g + 1));
+        for (unsigned int h = g + 1; h < n_groups; ++h)
+          couple(i, c * n_groups + h, -0.05 * (h - g));
+
+        // Couple to the next cells in x and y
+        for (const size_t nbr: {cx + 1 < n ? c + n : c, cy + 1 < n ? c + 1 : c})
+        {
+          if (nbr == c)
+            continue;
+          couple(i, nbr * n_groups + g, -1.0 - 0.1 * g);
+          if (full_blocks)
+            couple(i, nbr * n_groups + (g + 1) % n_groups, -0.02);
+        }
+      }
+    }
+  A.compress();
+  return A;
+}
+
+
+/** Check a block copy of \p A against \p A itself. */
+bool
+check_block_copy(const std::string& name,
+                 SparseMatrix& A,
+                 const unsigned int n_groups,
+                 const bool diagonal_blocks)
+{
+  BlockSparseMatrix B;
+  B.copy_from(A, n_groups);
+
+  bool same_entries = B.n_rows() == A.n_rows() &&
+                      B.block_size() == n_groups &&
+                      B.has_diagonal_off_diagonal_blocks() == diagonal_blocks;
+  for (const auto entry: A)
+    same_entries &= B.el(entry.row, entry.column) == entry.value;
+
+  Vector x(A.n_cols());
+  for (size_t i = 0; i < x.size(); ++i)
+    x[i] = std::cos(0.3 * i);
+
+  Vector y_csr(A.n_rows()), y_bsr(A.n_rows(), 1.0);
+  A.vmult(y_csr, x);
+  B.vmult(y_bsr, x);
+
+  // The adding product doubles the result
+  Vector y_add(y_bsr);
+  B.vmult(y_add, x, true);
+
+  double diff = 0.0, add_diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    diff = std::max(diff, std::fabs(y_csr[i] - y_bsr[i]));
+    add_diff = std::max(add_diff, std::fabs(2.0 * y_csr[i] - y_add[i]));
+  }
+  return check(name, same_entries && diff < 1.0e-12 && add_diff < 1.0e-12);
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // Each fixed block size kernel and the generic kernel
+  for (const unsigned int n_groups: {1, 2, 3, 4, 5, 7, 8})
+  {
+    SparseMatrix A = create_matrix(12, n_groups);
+    passed &= check_block_copy(std::to_string(n_groups) +
+                               " groups, within-group coupling",
+                               A, n_groups, true);
+
+    SparseMatrix A_full = create_matrix(12, n_groups, true);
+    passed &= check_block_copy(std::to_string(n_groups) +
+                               " groups, full coupling blocks",
+                               A_full, n_groups, n_groups == 1);
+  }
+
+  // Empty rows are skipped when copying
+  SparseMatrix A_empty = create_matrix(12, 3, false, 40);
+  passed &= check_block_copy("3 groups with an empty block row",
+                             A_empty, 3, true);
+
+  // Value updates keep the block structure
+  SparseMatrix A = create_matrix(30, 7);
+  BlockSparseMatrix B;
+  B.copy_from(A, 7);
+  B.add(5, 5, 1.0);
+  B.set(6, 3, -0.25);
+  A.add(5, 5, 1.0);
+  A.set(6, 3, -0.25);
+  passed &= check("set and add on a block matrix",
+                  B.el(5, 5) == A.el(5, 5) && B.el(6, 3) == -0.25);
+
+  // CG through the operator interface
+  const Vector b = create_rhs(A.n_rows());
+  Vector x(b.size(), 0.0);
+  CG cg(Options(1.0e-10, 1000));
+  cg.set_operator(B);
+  cg.solve(x, b);
+  passed &= check_residual("CG with a 7 group block operator",
+                           relative_residual(A, x, b), 1.0e-9);
+
+  return passed ? 0 : 1;
+}
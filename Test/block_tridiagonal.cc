@@ -0,0 +1,127 @@
+#include "test_utilities.h"
+
+#include "LinearSolvers/Direct/block_tridiagonal.h"
+#include "LinearSolvers/Direct/lu.h"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Build a non-symmetric block tridiagonal matrix with \p n_blocks dense
+ * blocks of size \p block_size. The diagonal blocks have a zero leading
+ * entry, so they are only factored stably with pivoting. The \p scale
+ * multiplies the diagonal blocks.
+ */
+SparseMatrix
+create_matrix(const size_t n_blocks,
+              const size_t block_size,
+              const double scale = 1.0)
+{
+  const size_t n = n_blocks * block_size;
+  SparseMatrix A(n, n);
+  for (size_t bi = 0; bi < n_blocks; ++bi)
+    for (size_t r = 0; r < block_size; ++r)
+    {
+      const size_t i = bi * block_size + r;
+      for (size_t c = 0; c < block_size; ++c)
+      {
+        const size_t j = bi * block_size + c;
+        const double diag = r == c && r > 0 ? 4.0 * block_size : 0.0;
+        A.add(i, j, scale * (diag + 1.0 / (1.0 + r + 2 * c)));
+        if (bi > 0)
+          A.add(i, j - block_size, -0.3 / (1.0 + r + c));
+        if (bi + 1 < n_blocks)
+          A.add(i, j + block_size, -0.2 / (2.0 + r * c));
+      }
+    }
+  A.compress();
+  return A;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // Two-group diffusion on a 1D mesh
+  std::vector<double> verts(201);
+  for (size_t i = 0; i < verts.size(); ++i)
+    verts[i] = 0.5 * i;
+  const auto slab = Grid::create_1d_orthomesh(verts);
+  const SparseMatrix A = assemble(*slab, false);
+  const Vector b = create_rhs(A.n_rows());
+
+  BlockTridiagonalSolver solver;
+  solver.set_matrix(A);
+  Vector x(b.size());
+  solver.solve(x, b);
+  passed &= check("detected block size", solver.get_block_size() == 2);
+  passed &= check_residual("two-group slab",
+                           relative_residual(A, x, b), 1.0e-13);
+
+  // Dense blocks which require pivoting, compared with sparse LU
+  const SparseMatrix B = create_matrix(500, 5);
+  const Vector b_B = create_rhs(B.n_rows());
+  passed &= check("block structure",
+                  BlockTridiagonalSolver::is_block_tridiagonal(B, 5) &&
+                  BlockTridiagonalSolver::is_block_tridiagonal(B, 10) &&
+                  !BlockTridiagonalSolver::is_block_tridiagonal(B, 4) &&
+                  BlockTridiagonalSolver::detect_block_size(B) == 5);
+
+  BlockTridiagonalSolver block_solver(5);
+  block_solver.set_matrix(B);
+  Vector x_B(b_B.size());
+  block_solver.solve(x_B, b_B);
+  passed &= check_residual("five-group dense blocks",
+                           relative_residual(B, x_B, b_B), 1.0e-13);
+
+  SparseLU lu;
+  lu.set_matrix(B);
+  Vector x_lu(b_B.size());
+  lu.solve(x_lu, b_B);
+  double diff = 0.0;
+  for (size_t i = 0; i < x_B.size(); ++i)
+    diff = std::max(diff, std::fabs(x_B[i] - x_lu[i]));
+  passed &= check("matches sparse LU", diff < 1.0e-10);
+
+  // Refactorization with new values, and clones
+  const SparseMatrix B_scaled = create_matrix(500, 5, 2.0);
+  block_solver.set_matrix(B_scaled);
+  block_solver.solve(x_B, b_B);
+  passed &= check_residual("new values",
+                           relative_residual(B_scaled, x_B, b_B), 1.0e-13);
+
+  const auto clone = block_solver.clone();
+  clone->set_matrix(B);
+  clone->solve(x_B, b_B);
+  passed &= check_residual("clone", relative_residual(B, x_B, b_B), 1.0e-13);
+
+  // On a 2D mesh, the rows of cells form the blocks
+  const auto square = create_square_mesh(10);
+  const SparseMatrix C = assemble(*square, false);
+  passed &= check("2D mesh block size",
+                  BlockTridiagonalSolver::detect_block_size(C) == 20);
+
+  // Matrices which are not block tridiagonal are rejected
+  SparseMatrix B_far(B);
+  B_far.add(0, B.n_cols() - 1, 1.0e-3);
+  B_far.compress();
+  bool threw_detect = false, threw_size = false;
+  try { BlockTridiagonalSolver().set_matrix(B_far); }
+  catch (const std::exception&) { threw_detect = true; }
+  try { BlockTridiagonalSolver(4).set_matrix(B); }
+  catch (const std::exception&) { threw_size = true; }
+  passed &= check("non block tridiagonal matrices are rejected",
+                  threw_detect && threw_size);
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include "test_utilities.h"
+
+#include "LinearSolvers/Iterative/cg.h"
+#include "LinearSolvers/Iterative/chebyshev.h"
+#include "LinearSolvers/Preconditioners/jacobi_preconditioner.h"
+#include "LinearSolvers/Preconditioners/chebyshev_preconditioner.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Build the 1D Laplacian of size \p n, whose eigenvalues are \f$ 2 - 2
+ * \cos(k \pi / (n + 1)) \f$ for \f$ k = 1, \ldots, n \f$.
+ */
+SparseMatrix
+create_laplacian(const size_t n)
+{
+  SparseMatrix A(n, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    A.add(i, i, 2.0);
+    if (i > 0)
+      A.add(i, i - 1, -1.0);
+    if (i + 1 < n)
+      A.add(i, i + 1, -1.0);
+  }
+  A.compress();
+  return A;
+}
+
+
+/** Solve with \p solver and check the residual with respect to \p A. */
+bool
+check_solve(const std::string& name,
+            IterativeSolverBase& solver,
+            const SparseMatrix& A,
+            const Vector& b)
+{
+  Vector x(b.size(), 0.0);
+  try { solver.solve(x, b); }
+  catch (const std::exception& e)
+  {
+    std::cout << e.what() << std::endl;
+    return check(name, false);
+  }
+  return check_residual(name, relative_residual(A, x, b), 1.0e-7);
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // The Lanczos estimates lie within the spectrum, the largest one close
+  // to the largest eigenvalue
+  const size_t n = 50;
+  const double pi = std::acos(-1.0);
+  const double lambda_min = 2.0 - 2.0 * std::cos(pi / (n + 1));
+  const double lambda_max = 2.0 - 2.0 * std::cos(n * pi / (n + 1));
+
+  const SparseMatrix L = create_laplacian(n);
+  const Vector b_L = create_rhs(n);
+  const auto [lower, upper] = estimate_eigenvalues(L, nullptr, 10);
+  std::cout << "Estimated eigenvalues [" << lower << ", " << upper
+            << "], exact [" << lambda_min << ", " << lambda_max << "]"
+            << std::endl;
+  passed &= check("eigenvalue estimates",
+                  lower >= lambda_min * (1.0 - 1.0e-12) && lower < upper &&
+                  upper <= lambda_max * (1.0 + 1.0e-12) &&
+                  upper >= 0.95 * lambda_max);
+
+  // With the exact bounds, the residual is reduced by at least
+  // 2 rho^k after k iterations
+  const double tol = 1.0e-8;
+  const double sqrt_kappa = std::sqrt(lambda_max / lambda_min);
+  const double rho = (sqrt_kappa - 1.0) / (sqrt_kappa + 1.0);
+  const auto k = static_cast<unsigned int>(
+      std::ceil(std::log(2.0 / tol) / std::log(1.0 / rho)));
+
+  Chebyshev exact(Options(tol, k));
+  exact.set_matrix(L);
+  exact.set_eigenvalue_bounds(lambda_min, lambda_max);
+  passed &= check_solve("exact bounds, at most " + std::to_string(k) +
+                        " iterations", exact, L, b_L);
+
+  // Two-group problems with estimated bounds. These are estimated again
+  // for each new matrix and preconditioner, and when the bounds are reset.
+  const auto mesh = create_square_mesh(40);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix S_scaled = assemble(*mesh, true, 4.0);
+  const Vector b = create_rhs(S.n_rows());
+
+  const Options opts(1.0e-10, 5000);
+  Chebyshev chebyshev(opts);
+  chebyshev.set_matrix(S);
+  passed &= check_solve("Chebyshev", chebyshev, S, b);
+  chebyshev.set_matrix(S_scaled);
+  passed &= check_solve("Chebyshev, new values", chebyshev, S_scaled, b);
+  chebyshev.set_preconditioner(std::make_shared<JacobiPreconditioner>());
+  passed &= check_solve("Chebyshev + Jacobi", chebyshev, S_scaled, b);
+  chebyshev.set_matrix(S);
+  passed &= check_solve("Chebyshev + Jacobi, new values", chebyshev, S, b);
+
+  Chebyshev reset(opts);
+  reset.set_matrix(L);
+  reset.set_eigenvalue_bounds(lambda_min, lambda_max);
+  reset.set_eigenvalue_bounds(0.0, 0.0);
+  passed &= check_solve("Chebyshev, estimated after reset", reset, L, b_L);
+
+  Vector x_zero(b.size(), 1.0);
+  chebyshev.solve(x_zero, Vector(b.size(), 0.0));
+  passed &= check("zero right-hand side", x_zero.linfty_norm() == 0.0);
+
+  // The polynomial preconditioner is symmetric positive definite
+  ChebyshevPreconditioner polynomial(4);
+  polynomial.set_matrix(S);
+  Vector u(b.size()), v(b.size()), Mu(b.size()), Mv(b.size());
+  for (size_t i = 0; i < u.size(); ++i)
+  {
+    u[i] = std::sin(0.37 * i);
+    v[i] = std::cos(0.11 * i * i);
+  }
+  polynomial.vmult(Mu, u);
+  polynomial.vmult(Mv, v);
+  const double uMv = u.dot(Mv), vMu = v.dot(Mu);
+  passed &= check("symmetric polynomial preconditioner",
+                  std::fabs(uMv - vMu) < 1.0e-12 * std::fabs(uMv) &&
+                  u.dot(Mu) > 0.0 && v.dot(Mv) > 0.0 &&
+                  polynomial.reduction_factor() > 0.0 &&
+                  polynomial.reduction_factor() < 1.0);
+
+  // Smoothing polynomials only target the upper part of the spectrum, so
+  // they reduce fewer error components by a larger factor
+  ChebyshevPreconditioner smoother(4, 10.0);
+  smoother.set_matrix(S);
+  passed &= check("smoothing polynomial",
+                  smoother.reduction_factor() <
+                  polynomial.reduction_factor());
+
+  // Conjugate gradients with the polynomial preconditioner, rebuilt for
+  // new values
+  CG cg(opts);
+  cg.set_matrix(S);
+  cg.set_preconditioner(std::make_shared<ChebyshevPreconditioner>(4));
+  passed &= check_solve("CG + Chebyshev", cg, S, b);
+  cg.set_matrix(S_scaled);
+  passed &= check_solve("CG + Chebyshev, new values", cg, S_scaled, b);
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include "test_utilities.h"
+
+#include "LinearSolvers/Direct/lu.h"
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+
+
+/**
+ * Build an unsymmetric sparse matrix with a dominant diagonal, a few
+ * pseudo-random off-diagonal entries per row and one empty row.
+ */
+SparseMatrix
+create_matrix(const size_t n, const size_t empty_row)
+{
+  SparseMatrix A(n, n);
+  size_t seed = 12345;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (i == empty_row)
+      continue;
+    A.add(i, i, 10.0 + i % 7);
+    for (unsigned int k = 0; k < 4; ++k)
+    {
+      seed = (1103515245 * seed + 12345) % 2147483648;
+      A.add(i, seed % n, -1.0 - 0.1 * k);
+    }
+  }
+  return A;
+}
+
+
+/** Return the maximum difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+  return diff;
+}
+
+
+int main()
+{
+  const size_t n = 500, empty_row = 17;
+  SparseMatrix A = create_matrix(n, empty_row);
+
+  SparseMatrix C = A;
+  C.compress();
+
+  bool passed = true;
+  passed &= check("compress packs the matrix",
+                  C.is_compressed() && !A.is_compressed());
+  passed &= check("compress keeps the entries",
+                  C == A && C.n_nonzero_entries() == A.n_nonzero_entries());
+
+  bool same_rows = true;
+  for (size_t i = 0; i < n; ++i)
+  {
+    same_rows &= C.row_length(i) == A.row_length(i);
+    same_rows &= C.diag_el(i) == A.diag_el(i);
+  }
+  passed &= check("row lengths and cached diagonals match", same_rows);
+  passed &= check("empty row is kept", C.row_length(empty_row) == 0);
+
+  Vector x(n);
+  for (size_t i = 0; i < n; ++i)
+    x[i] = std::sin(0.1 * i);
+
+  Vector y_list(n), y_csr(n, 1.0e10);
+  A.vmult(y_list, x);
+  C.vmult(y_csr, x);
+  passed &= check("vmult matches", max_difference(y_list, y_csr) < 1.0e-12);
+
+  // Tvmult must overwrite the destination, Tvmult_add must add to it
+  A.Tvmult(y_list, x);
+  C.Tvmult(y_csr, x);
+  passed &= check("Tvmult matches", max_difference(y_list, y_csr) < 1.0e-12);
+
+  Vector y_add(y_csr);
+  C.Tvmult_add(y_add, x);
+  y_csr.scale(2.0);
+  passed &= check("Tvmult_add adds the transpose product",
+                  max_difference(y_add, y_csr) < 1.0e-12);
+
+  // In-place vmult is allowed for square matrices
+  Vector z(x);
+  A.vmult(y_list, x);
+  C.vmult(z, z);
+  passed &= check("aliased vmult matches",
+                  max_difference(y_list, z) < 1.0e-12);
+
+  // Modifying existing entries keeps the compressed format
+  C.set(3, 3, 42.0);
+  C.add(3, 3, 1.0);
+  C.diag(4) = 7.0;
+  passed &= check("existing entries are modified in place",
+                  C.is_compressed() && C.diag(3) == 43.0 &&
+                  C.diag_el(4) == 7.0);
+
+  // Inserting a new entry decompresses the matrix
+  size_t column = 0;
+  while (C.exists(5, column))
+    ++column;
+  C.add(5, column, 2.5);
+  passed &= check("new entries decompress the matrix",
+                  !C.is_compressed() && C.el(5, column) == 2.5);
+
+  C.compress();
+  passed &= check("recompress keeps the new entry",
+                  C.is_compressed() && C.el(5, column) == 2.5 &&
+                  C.n_nonzero_entries() == A.n_nonzero_entries() + 1);
+
+  // Iterators visit every entry of the compressed matrix once
+  double sum_list = 0.0, sum_csr = 0.0;
+  for (const auto entry: A)
+    sum_list += entry.value * (entry.row + 1) * (entry.column + 2);
+  SparseMatrix D = A;
+  D.compress();
+  for (const auto entry: D)
+    sum_csr += entry.value * (entry.row + 1) * (entry.column + 2);
+  passed &= check("iterators visit the same entries",
+                  std::fabs(sum_list - sum_csr) <=
+                  1.0e-12 * std::fabs(sum_list));
+
+  // Swapping rows decompresses and moves the entries
+  D.swap_row(1, 2);
+  passed &= check("swap_row moves the rows",
+                  !D.is_compressed() && D.row_length(1) == A.row_length(2) &&
+                  D.el(1, 2) == A.el(2, 2));
+
+  // Factorize a compressed matrix, which fills in and compresses the factors
+  SparseMatrix B = create_matrix(n, n);
+  B.compress();
+  const Vector b = create_rhs(n);
+  LinearSolvers::SparseLU lu;
+  lu.set_matrix(B);
+  Vector x_lu(n);
+  lu.solve(x_lu, b);
+  passed &= check_residual("SparseLU on a compressed matrix",
+                           relative_residual(B, x_lu, b), 1.0e-12);
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#include "test_utilities.h"
+
+#include "matrix.h"
+#include "LinearSolvers/Direct/lu.h"
+#include "LinearSolvers/Direct/cholesky.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/** Return an \p m by \p n matrix with deterministic entries. */
+Matrix
+create_matrix(const size_t m, const size_t n, const double seed)
+{
+  Matrix A(m, n);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      A(i, j) = std::sin(seed + 0.37 * i + 0.11 * j * j);
+  return A;
+}
+
+
+/** Return the transpose of \p A. */
+Matrix
+transpose(const Matrix& A)
+{
+  Matrix At(A.n_cols(), A.n_rows());
+  for (size_t i = 0; i < A.n_rows(); ++i)
+    for (size_t j = 0; j < A.n_cols(); ++j)
+      At(j, i) = A(i, j);
+  return At;
+}
+
+
+/** Return the maximum difference between two matrices. */
+double
+max_difference(const Matrix& A, const Matrix& B)
+{
+  if (A.n_rows() != B.n_rows() || A.n_cols() != B.n_cols())
+    return 1.0;
+  double diff = 0.0;
+  for (size_t i = 0; i < A.n_rows(); ++i)
+    for (size_t j = 0; j < A.n_cols(); ++j)
+      diff = std::max(diff, std::fabs(A(i, j) - B(i, j)));
+  return diff;
+}
+
+
+/** Return the maximum difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+  return diff;
+}
+
+
+/**
+ * Check the matrix-matrix and matrix-vector products of an \p m by \p k
+ * and a \p k by \p n matrix against the textbook loops.
+ */
+bool
+check_products(const size_t m, const size_t k, const size_t n)
+{
+  const Matrix A = create_matrix(m, k, 0.1);
+  const Matrix B = create_matrix(k, n, 0.7);
+  const Matrix At = transpose(A);
+  const Matrix Bt = transpose(B);
+
+  Matrix C_ref(m, n, 0.0);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      for (size_t l = 0; l < k; ++l)
+        C_ref(i, j) += A(i, l) * B(l, j);
+
+  Matrix C_AB(m, n), C_TB(m, n), C_AT(m, n), C_TT(m, n);
+  A.mmult(C_AB, B);
+  At.Tmmult(C_TB, B);
+  A.mTmult(C_AT, Bt);
+  At.TTmult(C_TT, Bt);
+
+  // Adding products double the result
+  Matrix C_add(C_AB);
+  A.mmult(C_add, B, true);
+  Matrix C_twice(C_ref);
+  C_twice *= 2.0;
+
+  const double tol = 1.0e-12 * k;
+  bool passed = max_difference(C_ref, C_AB) < tol &&
+                max_difference(C_ref, C_TB) < tol &&
+                max_difference(C_ref, C_AT) < tol &&
+                max_difference(C_ref, C_TT) < tol &&
+                max_difference(C_twice, C_add) < tol;
+
+  Vector x(k), y_ref(m, 0.0), y(m, 1.0), z(k, 1.0), z_ref(k, 0.0);
+  for (size_t l = 0; l < k; ++l)
+    x[l] = std::cos(0.3 * l);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t l = 0; l < k; ++l)
+      y_ref[i] += A(i, l) * x[l];
+  for (size_t i = 0; i < m; ++i)
+    for (size_t l = 0; l < k; ++l)
+      z_ref[l] += A(i, l) * y_ref[i];
+  A.vmult(y, x);
+  A.Tvmult(z, y_ref);
+  passed &= max_difference(y_ref, y) < tol &&
+            max_difference(z_ref, z) < 1.0e-12 * m * k;
+
+  return check(std::to_string(m) + " x " + std::to_string(k) + " x " +
+               std::to_string(n) + " products", passed);
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // Unblocked and blocked products, with sizes that are not multiples of
+  // the register tiles or cache blocks
+  passed &= check_products(3, 5, 2);
+  passed &= check_products(17, 9, 13);
+  passed &= check_products(150, 301, 130);
+  passed &= check_products(70, 1100, 1030);
+
+  // Blocked LU with pivoting. The leading entry is zero, so the matrix is
+  // only factored with pivoting.
+  const size_t n = 300;
+  Matrix A = create_matrix(n, n, 0.3);
+  for (size_t i = 0; i < n; ++i)
+    A(i, i) += 4.0;
+  A(0, 0) = 0.0;
+
+  Vector b(n);
+  for (size_t i = 0; i < n; ++i)
+    b[i] = 1.0 + i % 3;
+
+  const auto residual = [&b](const Matrix& M, const Vector& x)
+  {
+    Vector Mx(b.size());
+    M.vmult(Mx, x);
+    return max_difference(Mx, b) / b.linfty_norm();
+  };
+
+  LU lu;
+  lu.set_matrix(A);
+  Vector x(n);
+  lu.solve(x, b);
+  passed &= check_residual("blocked LU with pivoting",
+                           residual(A, x), 1.0e-12);
+
+  // Refactorization with new values
+  Matrix A_new(A);
+  for (size_t i = 0; i < n; ++i)
+    A_new(i, (i + 7) % n) += 1.0;
+  lu.set_matrix(A_new);
+  lu.solve(x, b);
+  passed &= check_residual("blocked LU, new values",
+                           residual(A_new, x), 1.0e-12);
+
+  // Blocked Cholesky of A^T A + I
+  Matrix S(n, n);
+  A.Tmmult(S, A);
+  for (size_t i = 0; i < n; ++i)
+    S(i, i) += 1.0;
+
+  Cholesky cholesky;
+  cholesky.set_matrix(S);
+  cholesky.solve(x, b);
+  passed &= check_residual("blocked Cholesky", residual(S, x), 1.0e-12);
+
+  return passed ? 0 : 1;
+}
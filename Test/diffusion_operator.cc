@@ -0,0 +1,114 @@
+#include "test_utilities.h"
+
+#include "NeutronDiffusion/diffusion_operator.h"
+#include "LinearSolvers/Iterative/cg.h"
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/** Fill \p op with the entries of \p A, as the assembly routines do. */
+void
+fill(NeutronDiffusion::DiffusionOperator& op, const SparseMatrix& A)
+{
+  for (const auto entry: A)
+    op.add(entry.row, entry.column, entry.value);
+}
+
+
+/** Return the maximum difference between \p A x and \p op x. */
+double
+product_difference(const SparseMatrix& A,
+                   const NeutronDiffusion::DiffusionOperator& op,
+                   const Vector& x)
+{
+  Vector y_A(x.size()), y_op(x.size(), 1.0);
+  A.vmult(y_A, x);
+  op.vmult(y_op, x);
+
+  Vector y_add(y_op);
+  op.vmult(y_add, x, true);
+
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    diff = std::max(diff, std::fabs(y_A[i] - y_op[i]));
+    diff = std::max(diff, std::fabs(2.0 * y_A[i] - y_add[i]));
+  }
+  return diff;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  const size_t n_cells = 30;
+  const auto mesh = create_square_mesh(n_cells);
+  const SparseMatrix A = assemble(*mesh, false);
+  const size_t n = A.n_rows();
+
+  Vector x(n);
+  for (size_t i = 0; i < n; ++i)
+    x[i] = std::cos(0.02 * i);
+
+  // With cross-group terms, each cell stores a dense block
+  NeutronDiffusion::DiffusionOperator coupled;
+  coupled.reinit(*mesh, 2, true);
+  fill(coupled, A);
+
+  const size_t n_faces = 2 * n_cells * (n_cells - 1);
+  passed &= check("coupled operator sizes",
+                  coupled.n_rows() == n && coupled.n_cols() == n &&
+                  coupled.n_stored_coefficients() ==
+                  4 * n_cells * n_cells + 2 * n_faces);
+  passed &= check("coupled product matches the matrix",
+                  product_difference(A, coupled, x) < 1.0e-12);
+
+  // Without cross-group terms, only the within-group diagonals are stored
+  SparseMatrix A_uncoupled(n, n);
+  for (const auto entry: A)
+    if (entry.row % 2 == entry.column % 2)
+      A_uncoupled.add(entry.row, entry.column, entry.value);
+  A_uncoupled.compress();
+
+  NeutronDiffusion::DiffusionOperator uncoupled;
+  uncoupled.reinit(*mesh, 2);
+  fill(uncoupled, A_uncoupled);
+  passed &= check("uncoupled operator stores fewer coefficients",
+                  uncoupled.n_stored_coefficients() ==
+                  2 * n_cells * n_cells + 2 * n_faces &&
+                  uncoupled.n_stored_coefficients() <
+                  A_uncoupled.n_nonzero_entries());
+  passed &= check("uncoupled product matches the matrix",
+                  product_difference(A_uncoupled, uncoupled, x) < 1.0e-12);
+
+  // Resetting and refilling, as at a new time step, gives new values
+  const SparseMatrix A_scaled = assemble(*mesh, false, 2.0);
+  coupled = 0.0;
+  fill(coupled, A_scaled);
+  passed &= check("refilled product matches the new matrix",
+                  product_difference(A_scaled, coupled, x) < 1.0e-12);
+
+  // CG with the matrix-free symmetric operator
+  const SparseMatrix S = assemble(*mesh, true);
+  NeutronDiffusion::DiffusionOperator op;
+  op.reinit(*mesh, 2, true);
+  fill(op, S);
+
+  const Vector b = create_rhs(n);
+  Vector u(n, 0.0);
+  CG cg(Options(1.0e-10, 2000));
+  cg.set_operator(op);
+  cg.solve(u, b);
+  passed &= check_residual("CG with the matrix-free operator",
+                           relative_residual(S, u, b), 1.0e-9);
+
+  return passed ? 0 : 1;
+}
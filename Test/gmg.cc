@@ -0,0 +1,205 @@
+#include "test_utilities.h"
+
+#include "multithreading.h"
+#include "LinearSolvers/Iterative/cg.h"
+#include "LinearSolvers/Iterative/gmres.h"
+#include "LinearSolvers/Preconditioners/gmg.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+using Cycle = GMGPreconditioner::Cycle;
+using Smoother = GMGPreconditioner::Smoother;
+
+
+/** Wrap GMG to count cycles, i.e. preconditioned iterations. */
+class CountingGMG : public GMGPreconditioner
+{
+public:
+  using GMGPreconditioner::GMGPreconditioner;
+
+  mutable size_t n_cycles = 0;
+
+  void
+  vmult(Vector& z, const Vector& r) const override
+  {
+    ++n_cycles;
+    GMGPreconditioner::vmult(z, r);
+  }
+};
+
+
+/** Return the maximum difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+  return diff;
+}
+
+
+/**
+ * Solve with \p solver preconditioned by a \p cycle of GMG on \p mesh and
+ * check the residual. Return the number of iterations, or zero if the
+ * residual check fails.
+ */
+size_t
+solve(const std::string& label,
+      IterativeSolverBase& solver,
+      const std::shared_ptr<Grid::Mesh> mesh,
+      const SparseMatrix& A,
+      const Cycle cycle,
+      const Smoother smoother = Smoother::GAUSS_SEIDEL)
+{
+  const Vector b = create_rhs(A.n_rows());
+  const auto gmg = std::make_shared<CountingGMG>(mesh, 2, cycle, smoother);
+  solver.set_matrix(A);
+  solver.set_preconditioner(gmg);
+
+  Vector x(b.size(), 0.0);
+  solver.solve(x, b);
+  const bool passed = check_residual(label, relative_residual(A, x, b),
+                                     1.0e-9);
+  return passed ? gmg->n_cycles : 0;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // 64^2 cells with two groups coarsen to 32^2, 16^2 and 8^2 cells, the
+  // first level with at most 500 unknowns
+  const auto mesh = create_square_mesh(64);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix N = assemble(*mesh, false);
+  const Vector b = create_rhs(S.n_rows());
+
+  GMGPreconditioner v_cycle(mesh, 2);
+  v_cycle.set_matrix(S);
+  passed &= check("hierarchy", v_cycle.n_levels() == 4);
+
+  // V- and W-cycles with Gauss-Seidel smoothing are symmetric positive
+  // definite operators for symmetric matrices. F-cycles are not symmetric.
+  Vector u(b.size()), v(b.size()), Mu(b.size()), Mv(b.size());
+  for (size_t i = 0; i < u.size(); ++i)
+  {
+    u[i] = std::sin(0.37 * i);
+    v[i] = std::cos(0.11 * i * i);
+  }
+  for (const auto& [cycle, label]: {std::make_pair(Cycle::V, "V"),
+                                    std::make_pair(Cycle::W, "W"),
+                                    std::make_pair(Cycle::F, "F")})
+  {
+    GMGPreconditioner gmg(mesh, 2, cycle);
+    gmg.set_matrix(S);
+    gmg.vmult(Mu, u);
+    gmg.vmult(Mv, v);
+    const double uMv = u.dot(Mv), vMu = v.dot(Mu);
+    const bool symmetric = std::fabs(uMv - vMu) < 1.0e-12 * std::fabs(uMv);
+    if (cycle == Cycle::F)
+      passed &= check("non-symmetric F-cycle", !symmetric);
+    else
+      passed &= check(std::string("symmetric ") + label + "-cycle",
+                      symmetric && u.dot(Mu) > 0.0 && v.dot(Mv) > 0.0);
+  }
+
+  // Meshes smaller than the coarse size are solved directly
+  const auto small_mesh = create_square_mesh(10);
+  const SparseMatrix S_small = assemble(*small_mesh, true);
+  const Vector b_small = create_rhs(S_small.n_rows());
+  GMGPreconditioner direct(small_mesh, 2);
+  direct.set_matrix(S_small);
+  Vector x_small(b_small.size());
+  direct.vmult(x_small, b_small);
+  passed &= check("small meshes have a single level",
+                  direct.n_levels() == 1);
+  passed &= check_residual("small meshes are solved directly",
+                           relative_residual(S_small, x_small, b_small),
+                           1.0e-12);
+
+  // W-cycles converge independently of the mesh size
+  std::vector<size_t> n_iterations;
+  for (const size_t n_cells: {32, 128})
+  {
+    const auto fine_mesh = create_square_mesh(n_cells);
+    CG cg(Options(1.0e-10, 500));
+    n_iterations.push_back(
+        solve("CG + GMG (W), " + std::to_string(n_cells) + "^2 cells",
+              cg, fine_mesh, assemble(*fine_mesh, true), Cycle::W));
+  }
+  passed &= check("CG + GMG (W), " + std::to_string(n_iterations[0]) +
+                  " and " + std::to_string(n_iterations[1]) + " iterations",
+                  n_iterations[0] > 0 && n_iterations[1] > 0 &&
+                  n_iterations[1] <= n_iterations[0] + 3);
+
+  // The other cycles and smoothers
+  CG cg_v(Options(1.0e-10, 500)), cg_mc(Options(1.0e-10, 500));
+  GMRES gmres_f(30, Options(1.0e-10, 500));
+  passed &= solve("CG + GMG (V)", cg_v, mesh, S, Cycle::V) > 0;
+  passed &= solve("GMRES(30) + GMG (F)", gmres_f, mesh, S, Cycle::F) > 0;
+  passed &= solve("CG + GMG (W, multicolor GS)", cg_mc, mesh, S, Cycle::W,
+                  Smoother::MULTICOLOR_GAUSS_SEIDEL) > 0;
+
+  // One-dimensional meshes are coarsened in pairs of cells
+  std::vector<double> verts(1025);
+  for (size_t i = 0; i < verts.size(); ++i)
+    verts[i] = 0.25 * i;
+  const auto slab = Grid::create_1d_orthomesh(verts);
+  CG cg_slab(Options(1.0e-10, 500));
+  passed &= solve("CG + GMG (W), 1D slab", cg_slab, slab,
+                  assemble(*slab, true), Cycle::W) > 0;
+
+  // Homogenizing new values matches a fresh hierarchy
+  const SparseMatrix S_scaled = assemble(*mesh, true, 2.0);
+  v_cycle.set_matrix(S_scaled);
+  GMGPreconditioner fresh(mesh, 2);
+  fresh.set_matrix(S_scaled);
+  Vector z(b.size()), z_fresh(b.size());
+  v_cycle.vmult(z, b);
+  fresh.vmult(z_fresh, b);
+  passed &= check("rehomogenized hierarchy", z == z_fresh);
+
+  CG cg_scaled(Options(1.0e-10, 500));
+  passed &= solve("CG + GMG (W), new values",
+                  cg_scaled, mesh, S_scaled, Cycle::W) > 0;
+
+  // Multicolor sweeps do not depend on the number of threads beyond
+  // rounding
+  Vector z_serial(b.size());
+  for (const unsigned int n_threads: {1, 4})
+  {
+    MultiThreading::set_n_threads(n_threads);
+    GMGPreconditioner parallel(mesh, 2, Cycle::W,
+                               Smoother::MULTICOLOR_GAUSS_SEIDEL);
+    parallel.set_matrix(S);
+    parallel.vmult(z, b);
+    if (n_threads == 1)
+      z_serial = z;
+  }
+  MultiThreading::set_n_threads(0);
+  passed &= check("multicolor GS on 4 threads",
+                  max_difference(z, z_serial) <
+                  1.0e-10 * z_serial.linfty_norm());
+
+  // Non-symmetric problems with GMRES
+  const SparseMatrix N_scaled = assemble(*mesh, false, 2.0);
+  GMRES gmres(30, Options(1.0e-10, 500)),
+      gmres_scaled(30, Options(1.0e-10, 500));
+  passed &= solve("GMRES(30) + GMG (W)", gmres, mesh, N, Cycle::W) > 0;
+  passed &= solve("GMRES(30) + GMG (W), new values",
+                  gmres_scaled, mesh, N_scaled, Cycle::W) > 0;
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include "test_utilities.h"
+
+#include "linear_operator.h"
+#include "LinearSolvers/Direct/lu.h"
+#include "LinearSolvers/Iterative/gmres.h"
+#include "LinearSolvers/Iterative/bicgstab.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/** A matrix-free wrapper of a sparse matrix. */
+class MatrixFree : public LinearOperator
+{
+private:
+  const SparseMatrix& A;
+
+public:
+  MatrixFree(const SparseMatrix& A) : A(A) {}
+
+  size_t n_rows() const override { return A.n_rows(); }
+  size_t n_cols() const override { return A.n_cols(); }
+
+  void
+  vmult(Vector& y, const Vector& x, const bool adding = false) const override
+  { A.vmult(y, x, adding); }
+};
+
+
+/** Return the maximum difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+  return diff;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  const auto mesh = create_square_mesh(40);
+  const SparseMatrix N = assemble(*mesh, false);
+  const SparseMatrix N_scaled = assemble(*mesh, false, 2.0);
+  const Vector b = create_rhs(N.n_rows());
+
+  SparseLU lu;
+  lu.set_matrix(N);
+  Vector x_ref(b.size());
+  lu.solve(x_ref, b);
+
+  const Options opts(1.0e-10, 20000);
+
+  // Unpreconditioned solves of the non-symmetric problem with short, usual
+  // and long restarts
+  for (const unsigned int restart: {5, 30, 200})
+  {
+    GMRES gmres(restart, opts);
+    gmres.set_matrix(N);
+    Vector x(b.size());
+    gmres.solve(x, b);
+    passed &= check_residual("GMRES(" + std::to_string(restart) + ")",
+                             relative_residual(N, x, b), 1.0e-9);
+  }
+
+  BiCGStab bicgstab(opts);
+  bicgstab.set_matrix(N);
+  Vector x(b.size());
+  bicgstab.solve(x, b);
+  passed &= check_residual("BiCGStab", relative_residual(N, x, b), 1.0e-9);
+  passed &= check("BiCGStab matches sparse LU",
+                  max_difference(x, x_ref) < 1.0e-6 * x_ref.linfty_norm());
+
+  // New values with the same solvers
+  GMRES gmres(30, opts);
+  gmres.set_matrix(N);
+  gmres.solve(x, b);
+  gmres.set_matrix(N_scaled);
+  x = 0.0;
+  gmres.solve(x, b);
+  passed &= check_residual("GMRES(30), new values",
+                           relative_residual(N_scaled, x, b), 1.0e-9);
+
+  bicgstab.set_matrix(N_scaled);
+  x = 0.0;
+  bicgstab.solve(x, b);
+  passed &= check_residual("BiCGStab, new values",
+                           relative_residual(N_scaled, x, b), 1.0e-9);
+
+  // Matrix-free operators give the same iterates as the sparse matrix
+  const MatrixFree op(N);
+  GMRES gmres_op(30, opts), gmres_sparse(30, opts);
+  BiCGStab bicgstab_op(opts), bicgstab_sparse(opts);
+  gmres_op.set_operator(op);
+  gmres_sparse.set_matrix(N);
+  bicgstab_op.set_operator(op);
+  bicgstab_sparse.set_matrix(N);
+
+  Vector x_op(b.size()), x_sparse(b.size());
+  gmres_op.solve(x_op, b);
+  gmres_sparse.solve(x_sparse, b);
+  passed &= check("GMRES(30) with a matrix-free operator", x_op == x_sparse);
+  x_op = 0.0;
+  x_sparse = 0.0;
+  bicgstab_op.solve(x_op, b);
+  bicgstab_sparse.solve(x_sparse, b);
+  passed &= check("BiCGStab with a matrix-free operator", x_op == x_sparse);
+
+  // Initial guesses are used, and zero right-hand sides give zero
+  Vector x_guess(x_ref);
+  gmres_sparse.solve(x_guess, b);
+  passed &= check("GMRES(30) from the solution",
+                  max_difference(x_guess, x_ref) <
+                  1.0e-9 * x_ref.linfty_norm());
+
+  Vector zero(b.size(), 0.0), x_zero(b.size(), 1.0);
+  gmres_sparse.solve(x_zero, zero);
+  bool zeros = x_zero.linfty_norm() == 0.0;
+  x_zero = 1.0;
+  bicgstab_sparse.solve(x_zero, zero);
+  zeros &= x_zero.linfty_norm() == 0.0;
+  passed &= check("zero right-hand sides", zeros);
+
+  // Failure to converge is reported
+  bool threw_gmres = false, threw_bicgstab = false;
+  GMRES gmres_short(30, Options(1.0e-10, 3));
+  BiCGStab bicgstab_short(Options(1.0e-10, 3));
+  gmres_short.set_matrix(N);
+  bicgstab_short.set_matrix(N);
+  x = 0.0;
+  try { gmres_short.solve(x, b); }
+  catch (const std::exception&) { threw_gmres = true; }
+  x = 0.0;
+  try { bicgstab_short.solve(x, b); }
+  catch (const std::exception&) { threw_bicgstab = true; }
+  passed &= check("non-convergence is reported",
+                  threw_gmres && threw_bicgstab);
+
+  return passed ? 0 : 1;
+}
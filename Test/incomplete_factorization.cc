@@ -0,0 +1,191 @@
+#include "test_utilities.h"
+
+#include "multithreading.h"
+#include "LinearSolvers/Iterative/cg.h"
+#include "LinearSolvers/Iterative/gmres.h"
+#include "LinearSolvers/Preconditioners/incomplete_factorization.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Build a tridiagonal matrix of size \p n. The factors of a tridiagonal
+ * matrix have no fill, so the incomplete factorizations are exact.
+ */
+SparseMatrix
+create_tridiagonal(const size_t n, const bool symmetric)
+{
+  SparseMatrix A(n, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    A.add(i, i, 3.0 + std::sin(0.1 * i));
+    if (i > 0)
+      A.add(i, i - 1, -1.0);
+    if (i + 1 < n)
+      A.add(i, i + 1, symmetric ? -1.0 : -0.7);
+  }
+  A.compress();
+  return A;
+}
+
+
+/** Return the preconditioned residual \p r of a fresh preconditioner. */
+template<typename PreconditionerType>
+Vector
+apply_fresh(const SparseMatrix& A, const Vector& r)
+{
+  PreconditionerType pc;
+  pc.set_matrix(A);
+  Vector z(r.size());
+  pc.vmult(z, r);
+  return z;
+}
+
+
+/** Solve with \p solver and check the residual with respect to \p A. */
+bool
+check_solve(const std::string& name,
+            IterativeSolverBase& solver,
+            const SparseMatrix& A,
+            const Vector& b)
+{
+  Vector x(b.size(), 0.0);
+  solver.solve(x, b);
+  return check_residual(name, relative_residual(A, x, b), 1.0e-9);
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // The incomplete factorizations of tridiagonal matrices are exact
+  const SparseMatrix T = create_tridiagonal(500, false);
+  const SparseMatrix T_sym = create_tridiagonal(500, true);
+  const Vector b_T = create_rhs(T.n_rows());
+  passed &= check_residual(
+      "ILU(0) of a tridiagonal matrix",
+      relative_residual(T, apply_fresh<ILUPreconditioner>(T, b_T), b_T),
+      1.0e-14);
+  passed &= check_residual(
+      "IC(0) of a tridiagonal matrix",
+      relative_residual(T_sym, apply_fresh<ICPreconditioner>(T_sym, b_T), b_T),
+      1.0e-14);
+
+  // The levels of a 2D mesh are its wavefronts, not its rows
+  const auto mesh = create_square_mesh(50);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix N = assemble(*mesh, false);
+  const Vector b = create_rhs(N.n_rows());
+
+  ILUPreconditioner ilu;
+  ICPreconditioner ic;
+  ilu.set_matrix(N);
+  ic.set_matrix(S);
+  std::cout << "ILU(0) levels " << ilu.n_lower_levels() << " and "
+            << ilu.n_upper_levels() << " for " << N.n_rows() << " rows"
+            << std::endl;
+  passed &= check("level schedules",
+                  ilu.n_lower_levels() < N.n_rows() / 10 &&
+                  ilu.n_upper_levels() < N.n_rows() / 10 &&
+                  ic.n_lower_levels() == ilu.n_lower_levels());
+
+  // Level-scheduled factorizations and solves are independent of the
+  // number of threads, and may be applied in place
+  Vector z_serial(b.size());
+  for (const unsigned int n_threads: {1, 4})
+  {
+    MultiThreading::set_n_threads(n_threads);
+    const Vector z_ilu = apply_fresh<ILUPreconditioner>(N, b);
+    const Vector z_ic = apply_fresh<ICPreconditioner>(S, b);
+    if (n_threads == 1)
+      z_serial = z_ilu;
+    passed &= check(std::to_string(n_threads) + " threads",
+                    z_ilu == z_serial);
+
+    Vector z_in_place(b);
+    ic.vmult(z_in_place, z_in_place);
+    passed &= check(std::to_string(n_threads) + " threads, in place",
+                    z_in_place == z_ic);
+  }
+  MultiThreading::set_n_threads(0);
+
+  // Refactorizations with new values and a new pattern match fresh
+  // factorizations
+  const SparseMatrix S_scaled = assemble(*mesh, true, 2.0);
+  const SparseMatrix N_scaled = assemble(*mesh, false, 2.0);
+  SparseMatrix N_extra(N), S_extra(S);
+  N_extra.add(0, N.n_cols() - 1, -1.0e-3);
+  S_extra.add(0, S.n_cols() - 1, -1.0e-3);
+  S_extra.add(S.n_rows() - 1, 0, -1.0e-3);
+  N_extra.compress();
+  S_extra.compress();
+
+  Vector z(b.size());
+  ilu.set_matrix(N_scaled);
+  ilu.vmult(z, b);
+  bool refactored = z == apply_fresh<ILUPreconditioner>(N_scaled, b);
+  ilu.set_matrix(N_extra);
+  ilu.vmult(z, b);
+  refactored &= z == apply_fresh<ILUPreconditioner>(N_extra, b);
+  ic.set_matrix(S_scaled);
+  ic.vmult(z, b);
+  refactored &= z == apply_fresh<ICPreconditioner>(S_scaled, b);
+  ic.set_matrix(S_extra);
+  ic.vmult(z, b);
+  refactored &= z == apply_fresh<ICPreconditioner>(S_extra, b);
+  passed &= check("refactorizations", refactored);
+
+  // Preconditioned solves, refactored through the solvers
+  const Options opts(1.0e-10, 2000);
+  GMRES gmres(30, opts);
+  CG cg(opts);
+  gmres.set_matrix(N);
+  gmres.set_preconditioner(std::make_shared<ILUPreconditioner>());
+  cg.set_matrix(S);
+  cg.set_preconditioner(std::make_shared<ICPreconditioner>());
+  passed &= check_solve("GMRES(30) + ILU(0)", gmres, N, b);
+  passed &= check_solve("CG + IC(0)", cg, S, b);
+
+  gmres.set_matrix(N_scaled);
+  cg.set_matrix(S_scaled);
+  passed &= check_solve("GMRES(30) + ILU(0), new values", gmres, N_scaled, b);
+  passed &= check_solve("CG + IC(0), new values", cg, S_scaled, b);
+
+  // Invalid matrices are rejected
+  const auto throws = [](Preconditioner&& pc, const SparseMatrix& A)
+  {
+    try { pc.set_matrix(A); }
+    catch (const std::exception&) { return true; }
+    return false;
+  };
+
+  SparseMatrix N_zero(N), S_indefinite(S), S_missing(S.n_rows(), S.n_cols());
+  N_zero.diag(0) = 0.0;
+  S_indefinite.diag(5) = -1.0;
+  for (const auto entry: S)
+    if (entry.row != 7 || entry.column != 7)
+      S_missing.add(entry.row, entry.column, entry.value);
+  S_missing.compress();
+
+  passed &= check("ILU(0) rejects zero pivots",
+                  throws(ILUPreconditioner(), N_zero));
+  passed &= check("ILU(0) rejects missing diagonals",
+                  throws(ILUPreconditioner(), S_missing));
+  passed &= check("IC(0) rejects non-symmetric patterns",
+                  throws(ICPreconditioner(), N_extra));
+  passed &= check("IC(0) rejects indefinite matrices",
+                  throws(ICPreconditioner(), S_indefinite));
+
+  return passed ? 0 : 1;
+}
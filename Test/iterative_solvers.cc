@@ -0,0 +1,171 @@
+#include "test_utilities.h"
+
+#include "LinearSolvers/Iterative/cg.h"
+#include "LinearSolvers/Iterative/gmres.h"
+#include "LinearSolvers/Iterative/bicgstab.h"
+#include "LinearSolvers/Iterative/chebyshev.h"
+#include "LinearSolvers/Iterative/sor.h"
+#include "LinearSolvers/Preconditioners/jacobi_preconditioner.h"
+#include "LinearSolvers/Preconditioners/incomplete_factorization.h"
+#include "LinearSolvers/Preconditioners/amg.h"
+#include "LinearSolvers/Preconditioners/gmg.h"
+#include "LinearSolvers/Preconditioners/chebyshev_preconditioner.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Solve \f$ A x = b \f$ with \p solver and \p pc and check the true
+ * residual. Return whether the relative residual is below \p tolerance.
+ */
+bool
+run(const std::string& name,
+    IterativeSolverBase& solver,
+    std::shared_ptr<Preconditioner> pc,
+    const SparseMatrix& A,
+    const Vector& b,
+    const double tolerance)
+{
+  std::cout << std::left << std::setw(44) << name << std::flush;
+
+  Vector x(b.size(), 0.0);
+  try
+  {
+    solver.set_matrix(A);
+    if (pc)
+      solver.set_preconditioner(pc);
+    solver.solve(x, b);
+  }
+  catch (const std::exception& e)
+  {
+    std::cout << "\n  FAILED: " << e.what() << std::endl;
+    return false;
+  }
+
+  const double residual = relative_residual(A, x, b);
+
+  const bool passed = residual <= tolerance;
+  std::cout << "  true residual " << std::scientific << std::setprecision(2)
+            << residual << (passed ? "" : "  FAILED") << std::endl;
+  return passed;
+}
+
+
+int main(int argc, char** argv)
+{
+  // 100 x 100 cells on a 100 cm x 100 cm domain by default
+  const size_t n_cells = argc > 1 ? std::stoul(argv[1]) : 100;
+  const auto mesh = create_square_mesh(n_cells);
+
+  const SparseMatrix A_sym = assemble(*mesh, true);
+  const SparseMatrix A_nonsym = assemble(*mesh, false);
+
+  const size_t n = A_sym.n_rows();
+  const Vector b = create_rhs(n);
+
+  // Print the converged iteration of each solve
+  const Options opts(1.0e-8, 20000, 1);
+  const double tol = 1.0e-6;
+
+  using AMGSmoother = AMGPreconditioner::Smoother;
+  using GMGSmoother = GMGPreconditioner::Smoother;
+  using Cycle = GMGPreconditioner::Cycle;
+
+  bool passed = true;
+
+  std::cout << "Symmetric two-group problem, " << n << " unknowns\n";
+  {
+    const SparseMatrix& A = A_sym;
+
+    CG cg(opts), cg_jac(opts), cg_ic(opts), cg_amg(opts), cg_amg_mc(opts),
+        cg_amg_cheb(opts), cg_gmg(opts), cg_gmg_mc(opts), cg_cheb(opts);
+    passed &= run("CG", cg, nullptr, A, b, tol);
+    passed &= run("CG + Jacobi", cg_jac,
+                  std::make_shared<JacobiPreconditioner>(), A, b, tol);
+    passed &= run("CG + IC(0)", cg_ic,
+                  std::make_shared<ICPreconditioner>(), A, b, tol);
+    passed &= run("CG + AMG (Gauss-Seidel)", cg_amg,
+                  std::make_shared<AMGPreconditioner>(), A, b, tol);
+    passed &= run("CG + AMG (multicolor Gauss-Seidel)", cg_amg_mc,
+                  std::make_shared<AMGPreconditioner>(
+                      AMGSmoother::MULTICOLOR_GAUSS_SEIDEL), A, b, tol);
+    passed &= run("CG + AMG (Chebyshev)", cg_amg_cheb,
+                  std::make_shared<AMGPreconditioner>(
+                      AMGSmoother::CHEBYSHEV, 0.08, 2), A, b, tol);
+    passed &= run("CG + GMG (Gauss-Seidel)", cg_gmg,
+                  std::make_shared<GMGPreconditioner>(
+                      mesh, 2, Cycle::W), A, b, tol);
+    passed &= run("CG + GMG (multicolor Gauss-Seidel)", cg_gmg_mc,
+                  std::make_shared<GMGPreconditioner>(
+                      mesh, 2, Cycle::W, GMGSmoother::MULTICOLOR_GAUSS_SEIDEL),
+                  A, b, tol);
+    passed &= run("CG + Chebyshev", cg_cheb,
+                  std::make_shared<ChebyshevPreconditioner>(4), A, b, tol);
+
+    GMRES gmres(30, opts), gmres_ilu(30, opts);
+    BiCGStab bicgstab(opts), bicgstab_amg(opts);
+    passed &= run("GMRES(30)", gmres, nullptr, A, b, tol);
+    passed &= run("GMRES(30) + ILU(0)", gmres_ilu,
+                  std::make_shared<ILUPreconditioner>(), A, b, tol);
+    passed &= run("BiCGStab", bicgstab, nullptr, A, b, tol);
+    passed &= run("BiCGStab + AMG", bicgstab_amg,
+                  std::make_shared<AMGPreconditioner>(), A, b, tol);
+
+    Chebyshev chebyshev(opts), chebyshev_ic(opts);
+    passed &= run("Chebyshev + Jacobi", chebyshev,
+                  std::make_shared<JacobiPreconditioner>(), A, b, tol);
+    passed &= run("Chebyshev + IC(0)", chebyshev_ic,
+                  std::make_shared<ICPreconditioner>(), A, b, tol);
+
+    MulticolorSOR mc_gs(1.0, Options(1.0e-10, 50000, 1));
+    MulticolorSSOR mc_ssor(1.5, Options(1.0e-10, 50000, 1));
+    passed &= run("Multicolor Gauss-Seidel", mc_gs, nullptr, A, b, tol);
+    passed &= run("Multicolor SSOR", mc_ssor, nullptr, A, b, tol);
+  }
+
+  std::cout << "\nNon-symmetric two-group problem, " << n << " unknowns\n";
+  {
+    const SparseMatrix& A = A_nonsym;
+
+    GMRES gmres(30, opts), gmres_ilu(30, opts), gmres_amg(30, opts),
+        gmres_gmg(30, opts);
+    passed &= run("GMRES(30)", gmres, nullptr, A, b, tol);
+    passed &= run("GMRES(30) + ILU(0)", gmres_ilu,
+                  std::make_shared<ILUPreconditioner>(), A, b, tol);
+    passed &= run("GMRES(30) + AMG", gmres_amg,
+                  std::make_shared<AMGPreconditioner>(), A, b, tol);
+    passed &= run("GMRES(30) + GMG", gmres_gmg,
+                  std::make_shared<GMGPreconditioner>(
+                      mesh, 2, Cycle::W), A, b, tol);
+
+    BiCGStab bicgstab(opts), bicgstab_ilu(opts), bicgstab_amg(opts),
+        bicgstab_gmg(opts);
+    passed &= run("BiCGStab", bicgstab, nullptr, A, b, tol);
+    passed &= run("BiCGStab + ILU(0)", bicgstab_ilu,
+                  std::make_shared<ILUPreconditioner>(), A, b, tol);
+    passed &= run("BiCGStab + AMG (multicolor Gauss-Seidel)", bicgstab_amg,
+                  std::make_shared<AMGPreconditioner>(
+                      AMGSmoother::MULTICOLOR_GAUSS_SEIDEL), A, b, tol);
+    passed &= run("BiCGStab + GMG (multicolor Gauss-Seidel)", bicgstab_gmg,
+                  std::make_shared<GMGPreconditioner>(
+                      mesh, 2, Cycle::W, GMGSmoother::MULTICOLOR_GAUSS_SEIDEL),
+                  A, b, tol);
+
+    MulticolorSOR mc_gs(1.0, Options(1.0e-10, 50000, 1));
+    passed &= run("Multicolor Gauss-Seidel", mc_gs, nullptr, A, b, tol);
+  }
+
+  std::cout << (passed ? "\nAll solves passed.\n" : "\nSome solves FAILED.\n");
+  return passed ? 0 : 1;
+}
@@ -14,7 +14,7 @@ int main()
   size_t n = 5;
   double h = 1.0 / (n - 1);
   std::vector<double> x_verts(n);
-  for (size_t i = 0; i < n + 1; ++i)
+  for (size_t i = 0; i < n; ++i)
     x_verts[i] = i * h;
 
   auto mesh = create_2d_orthomesh(x_verts, x_verts);
@@ -0,0 +1,92 @@
+#include "test_utilities.h"
+
+#include "Math/float_sparse_matrix.h"
+#include "LinearSolvers/Iterative/mixed_precision_cg.h"
+#include "LinearSolvers/Iterative/mixed_precision_gmres.h"
+#include "LinearSolvers/Preconditioners/jacobi_preconditioner.h"
+#include "LinearSolvers/Preconditioners/incomplete_factorization.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Solve with \p solver for the matrix \p A and, after attaching it, for
+ * \p A_new, which has the same pattern and different values. Check that
+ * both reach double precision accuracy.
+ */
+bool
+check_solver(const std::string& name,
+             IterativeSolverBase& solver,
+             const SparseMatrix& A,
+             const SparseMatrix& A_new,
+             const Vector& b)
+{
+  bool passed = true;
+
+  Vector x(b.size(), 0.0);
+  solver.set_matrix(A);
+  solver.solve(x, b);
+  passed &= check_residual(name, relative_residual(A, x, b), 1.0e-10);
+
+  x = 0.0;
+  solver.set_matrix(A_new);
+  solver.solve(x, b);
+  passed &= check_residual(name + ", new values",
+                           relative_residual(A_new, x, b), 1.0e-10);
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  const auto mesh = create_square_mesh(60);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix N = assemble(*mesh, false);
+  const Vector b = create_rhs(S.n_rows());
+
+  // The single precision copy has the same structure and rounded values
+  const FloatSparseMatrix S_float(S);
+  Vector y(b.size()), y_float(b.size(), 1.0);
+  S.vmult(y, b);
+  S_float.vmult(y_float, b);
+
+  double diff = 0.0, scale = 0.0;
+  for (size_t i = 0; i < y.size(); ++i)
+  {
+    diff = std::max(diff, std::fabs(y[i] - y_float[i]));
+    scale = std::max(scale, std::fabs(y[i]));
+  }
+  passed &= check("single precision copy",
+                  S_float.n_rows() == S.n_rows() &&
+                  S_float.n_nonzero_entries() == S.n_nonzero_entries() &&
+                  diff > 0.0 && diff < 1.0e-6 * scale);
+
+  // Refinement recovers double precision accuracy
+  const Options opts(1.0e-12, 100);
+  MixedPrecisionCG cg(opts);
+  passed &= check_solver("mixed precision CG", cg,
+                         S, assemble(*mesh, true, 2.0), b);
+
+  MixedPrecisionCG pcg(opts);
+  pcg.set_preconditioner(std::make_shared<JacobiPreconditioner>());
+  passed &= check_solver("mixed precision CG + Jacobi", pcg,
+                         S, assemble(*mesh, true, 2.0), b);
+
+  MixedPrecisionGMRES gmres(30, opts);
+  gmres.set_preconditioner(std::make_shared<ILUPreconditioner>());
+  passed &= check_solver("mixed precision GMRES + ILU", gmres,
+                         N, assemble(*mesh, false, 2.0), b);
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include "test_utilities.h"
+
+#include "multithreading.h"
+#include "LinearSolvers/Iterative/sor.h"
+#include "LinearSolvers/Iterative/multicolor_relaxation.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/** Build the 5-point Laplacian on an \p n by \p n grid. */
+SparseMatrix
+create_laplacian(const size_t n)
+{
+  SparseMatrix A(n * n, n * n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+    {
+      const size_t k = i * n + j;
+      A.add(k, k, 4.0);
+      if (i > 0)     A.add(k, k - n, -1.0);
+      if (i + 1 < n) A.add(k, k + n, -1.0);
+      if (j > 0)     A.add(k, k - 1, -1.0);
+      if (j + 1 < n) A.add(k, k + 1, -1.0);
+    }
+  A.compress();
+  return A;
+}
+
+
+/** Solve with \p solver and check the residual with respect to \p A. */
+bool
+check_solve(const std::string& name,
+            IterativeSolverBase& solver,
+            const SparseMatrix& A,
+            const Vector& b)
+{
+  Vector x(b.size(), 0.0);
+  solver.solve(x, b);
+  return check_residual(name, relative_residual(A, x, b), 1.0e-7);
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // The 5-point Laplacian is colored red-black. After a forward sweep, the
+  // rows of the last color have zero residual.
+  const SparseMatrix L = create_laplacian(40);
+  const Vector b_L = create_rhs(L.n_rows());
+
+  MulticolorRelaxation red_black;
+  red_black.reinit(L);
+  Vector x(b_L.size(), 0.0);
+  red_black.sweep(x, b_L);
+
+  Vector r(b_L.size());
+  L.vmult(r, x);
+  r.sadd(-1.0, b_L);
+  size_t n_relaxed = 0;
+  for (size_t i = 0; i < r.size(); ++i)
+    n_relaxed += std::fabs(r[i]) < 1.0e-14 * b_L.linfty_norm();
+  passed &= check("red-black coloring", red_black.n_colors() == 2);
+  passed &= check("forward sweeps relax the last color",
+                  n_relaxed == L.n_rows() / 2);
+
+  // Sweeps with no relaxation leave the iterate unchanged
+  Vector x_fixed(x);
+  red_black.sweep(x_fixed, b_L, 0.0);
+  passed &= check("zero relaxation", x_fixed == x);
+
+  // A forward sweep followed by a backward sweep is a symmetric operator
+  // for symmetric matrices
+  const auto mesh = create_square_mesh(50);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix N = assemble(*mesh, false);
+  const Vector b = create_rhs(S.n_rows());
+
+  MulticolorRelaxation relaxation;
+  relaxation.reinit(S);
+  std::cout << "Two-group operator colors " << relaxation.n_colors()
+            << std::endl;
+
+  const auto symmetric_sweep = [&relaxation](const Vector& v)
+  {
+    Vector z(v.size(), 0.0);
+    relaxation.sweep(z, v, 1.0, true);
+    relaxation.sweep(z, v, 1.0, false);
+    return z;
+  };
+  Vector u(b.size()), v(b.size());
+  for (size_t i = 0; i < u.size(); ++i)
+  {
+    u[i] = std::sin(0.37 * i);
+    v[i] = std::cos(0.11 * i * i);
+  }
+  const double uMv = u.dot(symmetric_sweep(v));
+  const double vMu = v.dot(symmetric_sweep(u));
+  passed &= check("symmetric sweeps",
+                  std::fabs(uMv - vMu) < 1.0e-12 * std::fabs(uMv));
+
+  // Rows of a color are independent, so threads do not change the sweeps
+  Vector x_serial(b.size());
+  for (const unsigned int n_threads: {1, 4})
+  {
+    MultiThreading::set_n_threads(n_threads);
+    Vector x_sweep(b.size(), 0.0);
+    for (unsigned int k = 0; k < 5; ++k)
+      relaxation.sweep(x_sweep, b, 1.2, k % 2 == 0);
+    if (n_threads == 1)
+      x_serial = x_sweep;
+    passed &= check(std::to_string(n_threads) + " threads",
+                    x_sweep == x_serial);
+  }
+  MultiThreading::set_n_threads(0);
+
+  // Multicolor SOR and SSOR solves, with new values through set_matrix
+  const Options opts(1.0e-10, 50000);
+  MulticolorSOR sor(1.0, opts), sor_N(1.5, opts);
+  MulticolorSSOR ssor(1.5, opts);
+  sor.set_matrix(S);
+  sor_N.set_matrix(N);
+  ssor.set_matrix(S);
+  passed &= check_solve("multicolor Gauss-Seidel", sor, S, b);
+  passed &= check_solve("multicolor SOR, non-symmetric", sor_N, N, b);
+  passed &= check_solve("multicolor SSOR", ssor, S, b);
+
+  const SparseMatrix S_scaled = assemble(*mesh, true, 2.0);
+  const SparseMatrix N_scaled = assemble(*mesh, false, 2.0);
+  sor.set_matrix(S_scaled);
+  sor_N.set_matrix(N_scaled);
+  ssor.set_matrix(S_scaled);
+  passed &= check_solve("multicolor Gauss-Seidel, new values",
+                        sor, S_scaled, b);
+  passed &= check_solve("multicolor SOR, non-symmetric, new values",
+                        sor_N, N_scaled, b);
+  passed &= check_solve("multicolor SSOR, new values", ssor, S_scaled, b);
+
+  // Zero diagonal entries are rejected
+  SparseMatrix S_zero(S);
+  S_zero.diag(3) = 0.0;
+  bool threw = false;
+  try { MulticolorRelaxation().reinit(S_zero); }
+  catch (const std::exception&) { threw = true; }
+  passed &= check("zero diagonals are rejected", threw);
+
+  return passed ? 0 : 1;
+}
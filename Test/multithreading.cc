@@ -0,0 +1,146 @@
+#include "test_utilities.h"
+
+#include "multithreading.h"
+#include "block_sparse_matrix.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+
+
+/**
+ * Build a square sparse matrix with a banded structure and a few dense
+ * rows, so that an equal number of rows per thread would be unbalanced.
+ */
+SparseMatrix
+create_matrix(const size_t n)
+{
+  SparseMatrix A(n, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    A.add(i, i, 4.0);
+    for (const size_t offset: {1, 7, 300})
+    {
+      if (i >= offset)
+        A.add(i, i - offset, -1.0 / offset);
+      if (i + offset < n)
+        A.add(i, i + offset, -0.5 / offset);
+    }
+    if (i % 5000 == 0)
+      for (size_t j = 0; j < n; j += 3)
+        A.add(i, j, 1.0e-3);
+  }
+  A.compress();
+  return A;
+}
+
+
+/** Return the maximum relative difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]) /
+                          std::max(1.0, std::fabs(x[i])));
+  return diff;
+}
+
+
+int main()
+{
+  using namespace MultiThreading;
+
+  bool passed = true;
+
+  // Partition rows with very different amounts of work
+  const size_t n_rows = 1000;
+  std::vector<size_t> offsets(n_rows + 1, 0);
+  for (size_t i = 0; i < n_rows; ++i)
+    offsets[i + 1] = offsets[i] + (i % 100 == 0 ? 500 : 5);
+
+  bool valid = true;
+  for (const unsigned int n_parts: {1, 2, 3, 8, 16})
+  {
+    const auto bounds = partition(offsets.data(), n_rows, n_parts);
+    valid &= bounds.size() == n_parts + 1;
+    valid &= bounds.front() == 0 && bounds.back() == n_rows;
+    for (unsigned int p = 0; p < n_parts; ++p)
+    {
+      valid &= bounds[p] <= bounds[p + 1];
+
+      // Each chunk holds at most its share plus one row of work
+      const size_t work = offsets[bounds[p + 1]] - offsets[bounds[p]];
+      valid &= work <= offsets.back() / n_parts + 500;
+    }
+  }
+  passed &= check("partition balances the work", valid);
+
+  passed &= check("small kernels run on one thread",
+                  n_threads(min_work_per_thread / 2) == 1 &&
+                  n_threads(0) == 1);
+  set_n_threads(2);
+  passed &= check("set_n_threads limits the thread count",
+                  n_threads() <= 2 &&
+                  n_threads(100 * min_work_per_thread) <= 2);
+
+  // Compare threaded products with single threaded ones
+  const size_t n = 40000;
+  const SparseMatrix A = create_matrix(n);
+  Vector x(n);
+  for (size_t i = 0; i < n; ++i)
+    x[i] = std::sin(0.01 * i);
+
+  set_n_threads(1);
+  Vector y_serial(n), yT_serial(n);
+  A.vmult(y_serial, x);
+  A.Tvmult(yT_serial, x);
+
+  BlockSparseMatrix B;
+  B.copy_from(A, 4);
+  Vector yB_serial(n);
+  B.vmult(yB_serial, x);
+
+  for (const unsigned int n_threads: {2, 3, 4, 8})
+  {
+    set_n_threads(n_threads);
+    const std::string label = std::to_string(n_threads) + " threads: ";
+
+    Vector y(n, 1.0), yT(n, 1.0), yB(n, 1.0);
+    A.vmult(y, x);
+    A.Tvmult(yT, x);
+    B.vmult(yB, x);
+    passed &= check(label + "vmult matches",
+                    max_difference(y_serial, y) < 1.0e-14);
+    passed &= check(label + "Tvmult matches",
+                    max_difference(yT_serial, yT) < 1.0e-12);
+    passed &= check(label + "block vmult matches",
+                    max_difference(yB_serial, yB) < 1.0e-14);
+
+    // Adding and aliased products
+    A.vmult(y, x, true);
+    A.Tvmult(yT, x, true);
+    Vector y_twice(y_serial), yT_twice(yT_serial);
+    y_twice.scale(2.0);
+    yT_twice.scale(2.0);
+    passed &= check(label + "adding products match",
+                    max_difference(y_twice, y) < 1.0e-12 &&
+                    max_difference(yT_twice, yT) < 1.0e-12);
+
+    Vector z(x), zT(x);
+    A.vmult(z, z);
+    A.Tvmult(zT, zT);
+    passed &= check(label + "aliased products match",
+                    max_difference(y_serial, z) < 1.0e-14 &&
+                    max_difference(yT_serial, zT) < 1.0e-12);
+  }
+  set_n_threads(0);
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#include "test_utilities.h"
+
+#include "ordering.h"
+#include "LinearSolvers/Direct/lu.h"
+#include "LinearSolvers/Direct/cholesky.h"
+#include "LinearSolvers/Direct/symbolic_factorization.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/** Return whether \p permutation is a permutation of <tt>0, ..., n-1</tt>. */
+bool
+is_permutation(const std::vector<size_t>& permutation, const size_t n)
+{
+  if (permutation.size() != n)
+    return false;
+  std::vector<bool> seen(n, false);
+  for (const size_t i: permutation)
+  {
+    if (i >= n || seen[i])
+      return false;
+    seen[i] = true;
+  }
+  return true;
+}
+
+
+/** Return the bandwidth of \p A. */
+size_t
+bandwidth(const SparseMatrix& A)
+{
+  size_t width = 0;
+  for (const auto entry: A)
+    width = std::max(width, entry.row > entry.column
+                            ? entry.row - entry.column
+                            : entry.column - entry.row);
+  return width;
+}
+
+
+/** Return the number of entries of the factors of \p A with \p ordering. */
+size_t
+factor_entries(const SparseMatrix& A, const std::vector<size_t>& ordering)
+{
+  SymbolicFactorization symbolic;
+  symbolic.analyze(A, ordering);
+  return symbolic.n_nonzero_entries();
+}
+
+
+int main()
+{
+  using Method = Ordering::Method;
+
+  bool passed = true;
+
+  const auto mesh = create_square_mesh(60);
+  const SparseMatrix S = assemble(*mesh, true);
+  SparseMatrix N = assemble(*mesh, false);
+  const size_t n = S.n_rows();
+
+  std::vector<Grid::Point> points;
+  for (const auto& cell: mesh->cells)
+    points.push_back(cell.centroid);
+
+  // Every method returns a permutation
+  bool valid = true;
+  for (const Method method: {Method::NATURAL, Method::RCM,
+                             Method::MINIMUM_DEGREE,
+                             Method::NESTED_DISSECTION})
+    valid &= is_permutation(Ordering::compute(method, N, points), n);
+  valid &= is_permutation(Ordering::nested_dissection(N, *mesh), n);
+  passed &= check("orderings are permutations", valid);
+
+  bool threw = false;
+  try { Ordering::compute(Method::NESTED_DISSECTION, N); }
+  catch (...) { threw = true; }
+  passed &= check("nested dissection requires coordinates", threw);
+
+  // Permuting and inverting
+  std::vector<size_t> shuffle(n);
+  for (size_t k = 0; k < n; ++k)
+    shuffle[k] = (k * 7919) % n;
+  const SparseMatrix P = Ordering::permute(N, shuffle);
+  const auto inverse = Ordering::invert(shuffle);
+
+  bool permuted = P.n_nonzero_entries() == N.n_nonzero_entries();
+  for (const auto entry: P)
+    permuted &= entry.value == N.el(shuffle[entry.row],
+                                    shuffle[entry.column]);
+  for (size_t k = 0; k < n; ++k)
+    permuted &= inverse[shuffle[k]] == k;
+  passed &= check("permute and invert", permuted);
+
+  // Reverse Cuthill-McKee recovers a narrow band from a shuffled matrix
+  const SparseMatrix R = Ordering::permute(P,
+                                           Ordering::reverse_cuthill_mckee(P));
+  std::cout << "Bandwidth: natural " << bandwidth(N) << ", shuffled "
+            << bandwidth(P) << ", RCM " << bandwidth(R) << std::endl;
+  passed &= check("RCM reduces the bandwidth",
+                  bandwidth(R) <= 2 * bandwidth(N) &&
+                  10 * bandwidth(R) < bandwidth(P));
+
+  // Minimum degree and nested dissection reduce the fill
+  const size_t natural_fill =
+      factor_entries(S, Ordering::compute(Method::NATURAL, S));
+  const size_t amd_fill =
+      factor_entries(S, Ordering::approximate_minimum_degree(S));
+  const size_t nd_fill =
+      factor_entries(S, Ordering::nested_dissection(S, points));
+  std::cout << "Factor entries: natural " << natural_fill << ", AMD "
+            << amd_fill << ", nested dissection " << nd_fill << std::endl;
+  passed &= check("AMD reduces the fill", 3 * amd_fill < natural_fill);
+  passed &= check("nested dissection reduces the fill",
+                  2 * nd_fill < natural_fill);
+
+  // Multicolor orderings group uncoupled rows
+  std::vector<size_t> color_offsets;
+  const auto colors = Ordering::multicolor(N, color_offsets);
+  std::vector<size_t> color(n);
+  for (size_t c = 0; c + 1 < color_offsets.size(); ++c)
+    for (size_t k = color_offsets[c]; k < color_offsets[c + 1]; ++k)
+      color[colors[k]] = c;
+
+  bool uncoupled = is_permutation(colors, n) && color_offsets.back() == n;
+  for (const auto entry: N)
+    if (entry.row != entry.column)
+      uncoupled &= color[entry.row] != color[entry.column];
+  passed &= check("multicolor ordering", uncoupled);
+
+  // Direct solves with each ordering
+  const Vector b = create_rhs(n);
+  for (const Method method: {Method::NATURAL, Method::RCM,
+                             Method::MINIMUM_DEGREE,
+                             Method::NESTED_DISSECTION})
+  {
+    const std::string label =
+        "ordering " + std::to_string(static_cast<int>(method));
+
+    SparseLU lu(true, method);
+    lu.set_coordinates(points);
+    lu.set_matrix(N);
+    Vector x(n);
+    lu.solve(x, b);
+    passed &= check_residual("SparseLU, " + label,
+                             relative_residual(N, x, b), 1.0e-12);
+
+    SparseCholesky cholesky(method);
+    cholesky.set_coordinates(points);
+    cholesky.set_matrix(S);
+    cholesky.solve(x, b);
+    passed &= check_residual("SparseCholesky, " + label,
+                             relative_residual(S, x, b), 1.0e-12);
+  }
+
+  // User provided permutations
+  SparseLU lu;
+  lu.set_permutation(shuffle);
+  lu.set_matrix(N);
+  Vector x(n);
+  lu.solve(x, b);
+  passed &= check_residual("SparseLU with a given permutation",
+                           relative_residual(N, x, b), 1.0e-12);
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+#include "test_utilities.h"
+
+#include "LinearSolvers/PETSc/petsc_solver.h"
+
+#include <petsc.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/** Solve with \p solver and check the residual with respect to \p A. */
+bool
+check_solve(const std::string& name,
+            LinearSolverBase<SparseMatrix>& solver,
+            const SparseMatrix& A,
+            const Vector& b)
+{
+  Vector x(b.size(), 0.0);
+  solver.solve(x, b);
+  return check_residual(name, relative_residual(A, x, b), 1.0e-8);
+}
+
+
+int main(int argc, char** argv)
+{
+  PetscInitialize(&argc, &argv, (char*) 0, NULL);
+
+  bool passed = true;
+
+  const auto mesh = create_square_mesh(30);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix N = assemble(*mesh, false);
+  const SparseMatrix N_scaled = assemble(*mesh, false, 2.0);
+  const Vector b = create_rhs(N.n_rows());
+
+  SparseMatrix N_extra(N);
+  N_extra.add(0, N.n_cols() - 1, -1.0e-3);
+  N_extra.compress();
+
+  // The matrix is refilled for the same pattern and reallocated for a new
+  // one, with the same solver context
+  const Options opts(1.0e-10, 1000);
+  auto lu = std::make_shared<PETScSolver>(KSPGMRES, PCLU, opts);
+  lu->set_matrix(N);
+  passed &= check_solve("GMRES + LU", *lu, N, b);
+  lu->set_matrix(N_scaled);
+  passed &= check_solve("GMRES + LU, new values", *lu, N_scaled, b);
+  lu->set_matrix(N_extra);
+  passed &= check_solve("GMRES + LU, new pattern", *lu, N_extra, b);
+  lu->set_matrix(N);
+  passed &= check_solve("GMRES + LU, original pattern", *lu, N, b);
+
+  const auto clone = lu->clone();
+  clone->set_matrix(N_scaled);
+  passed &= check_solve("GMRES + LU clone", *clone, N_scaled, b);
+
+  // A preconditioner kept for new values still converges
+  PETScSolver reuse(KSPGMRES, PCLU, opts);
+  reuse.set_reuse_preconditioner(true);
+  reuse.set_matrix(N);
+  passed &= check_solve("GMRES + LU, kept preconditioner", reuse, N, b);
+  reuse.set_matrix(N_scaled);
+  passed &= check_solve("GMRES + LU, kept preconditioner, new values",
+                        reuse, N_scaled, b);
+
+  PETScSolver cg(KSPCG, PCJACOBI, opts);
+  cg.set_matrix(S);
+  passed &= check_solve("CG + Jacobi", cg, S, b);
+  cg.set_matrix(assemble(*mesh, true, 2.0));
+  passed &= check_solve("CG + Jacobi, new values",
+                        cg, assemble(*mesh, true, 2.0), b);
+
+  // Solvers which outlive PETSc are destroyed without calling into it
+  PetscFinalize();
+  lu.reset();
+
+  return passed ? 0 : 1;
+}
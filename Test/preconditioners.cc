@@ -0,0 +1,175 @@
+#include "test_utilities.h"
+
+#include "LinearSolvers/Iterative/cg.h"
+#include "LinearSolvers/Iterative/gmres.h"
+#include "LinearSolvers/Preconditioners/jacobi_preconditioner.h"
+#include "LinearSolvers/Preconditioners/block_jacobi_preconditioner.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/** Wrap a preconditioner to count how often it is built. */
+template<typename PreconditionerType>
+class Counting : public PreconditionerType
+{
+public:
+  using PreconditionerType::PreconditionerType;
+
+  size_t n_builds = 0;
+
+  void
+  set_matrix(const SparseMatrix& matrix) override
+  {
+    ++n_builds;
+    PreconditionerType::set_matrix(matrix);
+  }
+};
+
+
+/** Return the maximum difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+  return diff;
+}
+
+
+/**
+ * Return the maximum relative residual of \f$ \operatorname{blockdiag}(A) z
+ * = r \f$ over the blocks of size \p block_size.
+ */
+double
+block_residual(const SparseMatrix& A,
+               const Vector& z,
+               const Vector& r,
+               const size_t block_size)
+{
+  double residual = 0.0;
+  for (size_t i = 0; i < A.n_rows(); ++i)
+  {
+    double res = r[i];
+    for (const auto entry: A.row_iterator(i))
+      if (entry.column / block_size == i / block_size)
+        res -= entry.value * z[entry.column];
+    residual = std::max(residual, std::fabs(res) / r.linfty_norm());
+  }
+  return residual;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  const auto mesh = create_square_mesh(60);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix N = assemble(*mesh, false);
+  const Vector r = create_rhs(S.n_rows());
+
+  // Point Jacobi scales by the inverse diagonal
+  JacobiPreconditioner jacobi;
+  jacobi.set_matrix(N);
+  Vector z(r.size());
+  jacobi.vmult(z, r);
+  double diff = 0.0;
+  for (size_t i = 0; i < r.size(); ++i)
+    diff = std::max(diff, std::fabs(z[i] * N.diag_el(i) - r[i]));
+  passed &= check("Jacobi scales by the inverse diagonal", diff < 1.0e-14);
+
+  // Block Jacobi solves with the within-cell group blocks, in place too
+  BlockJacobiPreconditioner block_jacobi(2);
+  block_jacobi.set_matrix(N);
+  block_jacobi.vmult(z, r);
+  passed &= check_residual("block Jacobi solves the group blocks",
+                           block_residual(N, z, r, 2), 1.0e-14);
+
+  Vector z_in_place(r);
+  block_jacobi.vmult(z_in_place, z_in_place);
+  passed &= check("block Jacobi in place", z_in_place == z);
+
+  // With a single group, block Jacobi is point Jacobi
+  BlockJacobiPreconditioner point_blocks(1);
+  point_blocks.set_matrix(N);
+  Vector z_jacobi(r.size()), z_point(r.size());
+  jacobi.vmult(z_jacobi, r);
+  point_blocks.vmult(z_point, r);
+  passed &= check("single group block Jacobi is Jacobi",
+                  max_difference(z_point, z_jacobi) <
+                  1.0e-14 * z_jacobi.linfty_norm());
+
+  // Preconditioned solves. The preconditioners are built when attached
+  // and rebuilt for each new matrix.
+  const Options opts(1.0e-10, 2000);
+  for (const double scale: {1.0, 2.0})
+  {
+    const std::string label = ", scale " +
+                              std::to_string(static_cast<int>(scale));
+    const SparseMatrix S_scale = assemble(*mesh, true, scale);
+    const SparseMatrix N_scale = assemble(*mesh, false, scale);
+
+    auto pc_jacobi = std::make_shared<Counting<JacobiPreconditioner>>();
+    auto pc_block = std::make_shared<Counting<BlockJacobiPreconditioner>>(2);
+    auto pc_gmres = std::make_shared<Counting<BlockJacobiPreconditioner>>(2);
+
+    CG cg_jacobi(opts), cg_block(opts);
+    GMRES gmres(30, opts);
+    cg_jacobi.set_matrix(S);
+    cg_jacobi.set_preconditioner(pc_jacobi);
+    cg_block.set_matrix(S);
+    cg_block.set_preconditioner(pc_block);
+    gmres.set_matrix(N);
+    gmres.set_preconditioner(pc_gmres);
+
+    cg_jacobi.set_matrix(S_scale);
+    cg_block.set_matrix(S_scale);
+    gmres.set_matrix(N_scale);
+    passed &= check("preconditioners are rebuilt" + label,
+                    pc_jacobi->n_builds == 2 && pc_block->n_builds == 2 &&
+                    pc_gmres->n_builds == 2);
+
+    Vector x(r.size());
+    cg_jacobi.solve(x, r);
+    passed &= check_residual("CG + Jacobi" + label,
+                             relative_residual(S_scale, x, r), 1.0e-8);
+    x = 0.0;
+    cg_block.solve(x, r);
+    passed &= check_residual("CG + block Jacobi" + label,
+                             relative_residual(S_scale, x, r), 1.0e-8);
+    x = 0.0;
+    gmres.solve(x, r);
+    passed &= check_residual("GMRES(30) + block Jacobi" + label,
+                             relative_residual(N_scale, x, r), 1.0e-8);
+  }
+
+  // Zero diagonal entries and singular blocks are rejected
+  SparseMatrix N_zero(N);
+  N_zero.diag(3) = 0.0;
+  bool threw_jacobi = false;
+  try { JacobiPreconditioner().set_matrix(N_zero); }
+  catch (const std::exception&) { threw_jacobi = true; }
+
+  SparseMatrix N_singular(N);
+  for (auto entry: N_singular.row_iterator(4))
+    if (entry.column / 2 == 2)
+      entry.value = 0.0;
+  bool threw_block = false;
+  try { BlockJacobiPreconditioner(2).set_matrix(N_singular); }
+  catch (const std::exception&) { threw_block = true; }
+  passed &= check("singular diagonals are rejected",
+                  threw_jacobi && threw_block);
+
+  return passed ? 0 : 1;
+}
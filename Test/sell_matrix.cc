@@ -0,0 +1,127 @@
+#include "test_utilities.h"
+
+#include "sell_matrix.h"
+#include "LinearSolvers/Iterative/cg.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Build a sparse matrix whose row lengths vary between 0 and 13 entries.
+ * The number of rows is not a multiple of the chunk size, so the last
+ * chunk is padded.
+ */
+SparseMatrix
+create_matrix(const size_t n)
+{
+  SparseMatrix A(n, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (i % 97 == 0)
+      continue;
+    A.add(i, i, 2.0 + i % 3);
+    const size_t length = (i * 7) % 13;
+    for (size_t k = 1; k <= length; ++k)
+      A.add(i, (i + 31 * k * k) % n, -0.01 * k);
+  }
+  A.compress();
+  return A;
+}
+
+
+/** Return the maximum difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+  return diff;
+}
+
+
+int main()
+{
+  using SIMD = SELLMatrix::SIMD;
+
+  bool passed = true;
+
+  const SIMD supported = SELLMatrix::simd_support();
+  std::cout << "Supported SIMD level: " << static_cast<int>(supported)
+            << std::endl;
+
+  const size_t n = 5003;
+  const SparseMatrix A = create_matrix(n);
+
+  Vector x(n);
+  for (size_t i = 0; i < n; ++i)
+    x[i] = std::sin(0.05 * i) + 0.5;
+
+  Vector y_csr(n);
+  A.vmult(y_csr, x);
+
+  // Sorting within larger windows reduces padding
+  const SELLMatrix unsorted(A, SELLMatrix::chunk_size);
+  const SELLMatrix sorted(A, 256);
+  passed &= check("format sizes",
+                  sorted.n_rows() == n && sorted.n_cols() == n &&
+                  sorted.n_chunks() ==
+                  (n + SELLMatrix::chunk_size - 1) / SELLMatrix::chunk_size);
+  passed &= check("stored entries include all non-zeros",
+                  unsorted.n_stored_entries() >= A.n_nonzero_entries() &&
+                  sorted.n_stored_entries() >= A.n_nonzero_entries());
+  passed &= check("sorting reduces padding",
+                  sorted.n_stored_entries() < unsorted.n_stored_entries());
+
+  // Every kernel the CPU supports, for several sorting windows
+  for (const SIMD level: {SIMD::SCALAR, SIMD::AVX2, SIMD::AVX512})
+  {
+    if (level > supported)
+      continue;
+    SELLMatrix::limit_simd_support(level);
+    const std::string label =
+        "SIMD level " + std::to_string(static_cast<int>(level));
+
+    for (const unsigned int sigma: {8u, 64u, 256u, 8192u})
+    {
+      const SELLMatrix S(A, sigma);
+      Vector y(n, 1.0e10);
+      S.vmult(y, x);
+
+      Vector y_add(y_csr);
+      S.vmult(y_add, x, true);
+      Vector y_twice(y_csr);
+      y_twice.scale(2.0);
+
+      passed &= check(label + ", sigma " + std::to_string(sigma) +
+                      ": vmult matches",
+                      max_difference(y_csr, y) < 1.0e-13 &&
+                      max_difference(y_twice, y_add) < 1.0e-13);
+    }
+  }
+  SELLMatrix::limit_simd_support(SIMD::AVX512);
+
+  // CG with SELL matrix-vector products on the diffusion problem
+  const auto mesh = create_square_mesh(50);
+  const SparseMatrix D = assemble(*mesh, true);
+  const Vector b = create_rhs(D.n_rows());
+
+  Options opts(1.0e-10, 2000);
+  opts.use_sell = true;
+  CG cg(opts);
+  cg.set_matrix(D);
+  Vector u(b.size(), 0.0);
+  cg.solve(u, b);
+  passed &= check_residual("CG with SELL products",
+                           relative_residual(D, u, b), 1.0e-9);
+
+  return passed ? 0 : 1;
+}
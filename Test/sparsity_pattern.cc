@@ -0,0 +1,85 @@
+#include "test_utilities.h"
+
+#include "sparsity_pattern.h"
+#include "Discretization/FiniteVolume/fv.h"
+
+#include <cstddef>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+
+
+int main()
+{
+  bool passed = true;
+
+  // Unsorted and duplicate entries are sorted and removed by compress
+  SparsityPattern pattern(4, 5);
+  pattern.add(0, 4);
+  pattern.add(0, 1);
+  pattern.add(0, 4);
+  pattern.add(2, 3);
+  pattern.add(2, 0);
+  pattern.add(3, 3);
+  pattern.add(2, 0);
+  pattern.compress();
+
+  passed &= check("compress removes duplicates",
+                  pattern.is_compressed() &&
+                  pattern.n_nonzero_entries() == 5 &&
+                  pattern.row_length(0) == 2 && pattern.row_length(1) == 0 &&
+                  pattern.row_length(2) == 2 && pattern.row_length(3) == 1);
+  passed &= check("compress sorts the columns",
+                  pattern.column(0, 0) == 1 && pattern.column(0, 1) == 4 &&
+                  pattern.column(2, 0) == 0 && pattern.column(2, 1) == 3);
+  passed &= check("exists finds only the entries",
+                  pattern.exists(0, 4) && pattern.exists(3, 3) &&
+                  !pattern.exists(1, 1) && !pattern.exists(0, 0));
+
+  // A matrix initialized from a pattern holds every entry as a zero
+  SparseMatrix B;
+  B.reinit(pattern);
+  bool zeros = B.is_compressed() &&
+               B.n_nonzero_entries() == pattern.n_nonzero_entries();
+  for (const auto entry: B)
+    zeros &= entry.value == 0.0 && pattern.exists(entry.row, entry.column);
+  passed &= check("reinit allocates the pattern with zeros", zeros);
+
+  // The coupled two-group FV pattern holds the diffusion operator
+  const auto mesh = create_square_mesh(20);
+  const FiniteVolume fv(mesh);
+
+  SparsityPattern fv_pattern;
+  fv.make_sparsity_pattern(fv_pattern, 2, true);
+
+  const SparseMatrix A = assemble(*mesh, true);
+  passed &= check("FV pattern matches the assembled operator",
+                  fv_pattern.n_rows() == A.n_rows() &&
+                  fv_pattern.n_nonzero_entries() == A.n_nonzero_entries());
+
+  // Assembly into the preallocated matrix never changes its structure
+  SparseMatrix M;
+  M.reinit(fv_pattern);
+  for (const auto entry: A)
+    M.add(entry.row, entry.column, entry.value);
+  passed &= check("assembly keeps the preallocated structure",
+                  M.is_compressed() &&
+                  M.n_nonzero_entries() == fv_pattern.n_nonzero_entries());
+  passed &= check("assembled values match", M == A);
+
+  // The uncoupled pattern only holds the diagonal group blocks
+  SparsityPattern uncoupled;
+  fv.make_sparsity_pattern(uncoupled, 2, false);
+  bool diagonal_blocks = true;
+  for (size_t i = 0; i < uncoupled.n_rows(); ++i)
+    for (unsigned int k = 0; k < uncoupled.row_length(i); ++k)
+      diagonal_blocks &= uncoupled.column(i, k) % 2 == i % 2;
+  passed &= check("uncoupled pattern has no group coupling",
+                  diagonal_blocks &&
+                  uncoupled.n_nonzero_entries() ==
+                  fv_pattern.n_nonzero_entries() - A.n_rows());
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include "test_utilities.h"
+
+#include "multithreading.h"
+#include "LinearSolvers/Direct/cholesky.h"
+#include "LinearSolvers/Direct/supernodal_cholesky.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Build a symmetric positive definite block tridiagonal matrix with dense
+ * blocks of size \p block_size. Without reordering, the columns of each
+ * block share their pattern, so the supernodes are large enough for the
+ * blocked dense kernels.
+ */
+SparseMatrix
+create_block_matrix(const size_t n_blocks, const size_t block_size)
+{
+  const size_t n = n_blocks * block_size;
+  SparseMatrix A(n, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t block = i / block_size;
+    const size_t end = std::min(n, (block + 2) * block_size);
+    A.add(i, i, 3.0 * block_size);
+    for (size_t j = i + 1; j < end; ++j)
+    {
+      const double value = -1.0 / (1.0 + (i + j) % 7);
+      A.add(i, j, value);
+      A.add(j, i, value);
+    }
+  }
+  A.compress();
+  return A;
+}
+
+
+/** Return the maximum difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+  return diff;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  const auto mesh = create_square_mesh(50);
+  const SparseMatrix S = assemble(*mesh, true);
+  const Vector b = create_rhs(S.n_rows());
+
+  // Agreement with the entry-wise sparse Cholesky solver
+  SparseCholesky reference;
+  reference.set_matrix(S);
+  Vector x_ref(b.size());
+  reference.solve(x_ref, b);
+
+  SupernodalCholesky cholesky;
+  cholesky.set_matrix(S);
+  Vector x(b.size());
+  cholesky.solve(x, b);
+  passed &= check_residual("supernodal Cholesky",
+                           relative_residual(S, x, b), 1.0e-12);
+  passed &= check("supernodes group columns",
+                  cholesky.n_supernodes() > 0 &&
+                  cholesky.n_supernodes() < S.n_rows() &&
+                  max_difference(x, x_ref) < 1.0e-10);
+
+  // Refactorizations with new values and a new pattern, and clones
+  const SparseMatrix S_scaled = assemble(*mesh, true, 3.0);
+  cholesky.set_matrix(S_scaled);
+  cholesky.solve(x, b);
+  passed &= check_residual("supernodal Cholesky, new values",
+                           relative_residual(S_scaled, x, b), 1.0e-12);
+
+  SparseMatrix S_extra(S);
+  S_extra.add(0, S.n_cols() - 1, 1.0e-3);
+  S_extra.add(S.n_rows() - 1, 0, 1.0e-3);
+  S_extra.compress();
+  cholesky.set_matrix(S_extra);
+  cholesky.solve(x, b);
+  passed &= check_residual("supernodal Cholesky, new pattern",
+                           relative_residual(S_extra, x, b), 1.0e-12);
+
+  const auto clone = cholesky.clone();
+  clone->set_matrix(S_extra);
+  clone->solve(x, b);
+  passed &= check_residual("supernodal Cholesky clone",
+                           relative_residual(S_extra, x, b), 1.0e-12);
+
+  // Large supernodes take the blocked path, serially and in parallel
+  const SparseMatrix D = create_block_matrix(30, 50);
+  const Vector b_block = create_rhs(D.n_rows());
+  Vector x_serial(b_block.size());
+  for (const unsigned int n_threads: {1, 4})
+  {
+    MultiThreading::set_n_threads(n_threads);
+    const std::string label = std::to_string(n_threads) + " threads";
+
+    SupernodalCholesky blocked(Ordering::Method::NATURAL);
+    blocked.set_matrix(D);
+    Vector x_block(b_block.size());
+    blocked.solve(x_block, b_block);
+    passed &= check_residual("block matrix, " + label,
+                             relative_residual(D, x_block, b_block), 1.0e-12);
+
+    SupernodalCholesky threaded;
+    threaded.set_matrix(S);
+    threaded.solve(x, b);
+    if (n_threads == 1)
+      x_serial = x;
+    passed &= check("diffusion matrix, " + label,
+                    max_difference(x, x_ref) < 1.0e-10 &&
+                    max_difference(x, x_serial) < 1.0e-14);
+    if (n_threads == 1)
+      passed &= check("block supernodes are large",
+                      blocked.n_supernodes() <= 30);
+  }
+  MultiThreading::set_n_threads(0);
+
+  SparseMatrix S_indefinite(S);
+  S_indefinite.diag(5) = -1.0;
+  bool threw = false;
+  try { cholesky.set_matrix(S_indefinite); }
+  catch (const std::exception&) { threw = true; }
+  passed &= check("indefinite matrices are rejected", threw);
+
+  return passed ? 0 : 1;
+}
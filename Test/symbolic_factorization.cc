@@ -0,0 +1,156 @@
+#include "test_utilities.h"
+
+#include "ordering.h"
+#include "LinearSolvers/Direct/lu.h"
+#include "LinearSolvers/Direct/cholesky.h"
+#include "LinearSolvers/Direct/symbolic_factorization.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <exception>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/**
+ * Return \p A with the rows of the two groups of each cell swapped. The
+ * diagonal then holds the small cross-group coefficients, or zeros, so the
+ * matrix cannot be factored without pivoting.
+ */
+SparseMatrix
+swap_group_rows(const SparseMatrix& A)
+{
+  SparseMatrix B(A.n_rows(), A.n_cols());
+  for (const auto entry: A)
+    B.add(entry.row ^ 1, entry.column, entry.value);
+  B.compress();
+  return B;
+}
+
+
+/** Solve with \p solver and check the residual with respect to \p A. */
+bool
+check_solve(const std::string& name,
+            LinearSolverBase<SparseMatrix>& solver,
+            const SparseMatrix& A,
+            const Vector& b)
+{
+  Vector x(b.size());
+  solver.solve(x, b);
+  return check_residual(name, relative_residual(A, x, b), 1.0e-12);
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  const auto mesh = create_square_mesh(40);
+  const SparseMatrix S = assemble(*mesh, true);
+  const SparseMatrix N = assemble(*mesh, false);
+  const SparseMatrix N_scaled = assemble(*mesh, false, 3.0);
+  const Vector b = create_rhs(N.n_rows());
+
+  // The analysis matches matrices with the same pattern only
+  const auto ordering = Ordering::approximate_minimum_degree(N);
+  SymbolicFactorization symbolic;
+  passed &= check("empty analysis", symbolic.empty());
+  symbolic.analyze(N, ordering);
+
+  SparseMatrix N_extra(N);
+  N_extra.add(0, N.n_cols() - 1, 1.0e-3);
+  N_extra.compress();
+  passed &= check("analysis matches the same pattern",
+                  !symbolic.empty() && symbolic.n_rows() == N.n_rows() &&
+                  symbolic.matches(N) && symbolic.matches(N_scaled) &&
+                  !symbolic.matches(N_extra));
+
+  // The elimination tree points forward and the factor pattern holds the
+  // matrix pattern and the diagonal
+  const auto& parent = symbolic.elimination_tree();
+  bool tree = parent.size() == N.n_rows();
+  for (size_t i = 0; i < parent.size(); ++i)
+    tree &= parent[i] > i;
+  passed &= check("elimination tree", tree);
+
+  std::vector<double> values;
+  symbolic.scatter(N, values);
+  const size_t* offsets = symbolic.row_offsets_data();
+  const unsigned int* colnums = symbolic.colnums_data();
+  const size_t* diag = symbolic.diagonal_offsets_data();
+
+  double sum = 0.0, matrix_sum = 0.0;
+  bool pattern = values.size() == symbolic.n_nonzero_entries() &&
+                 symbolic.n_nonzero_entries() >= N.n_nonzero_entries();
+  for (size_t k = 0; k < symbolic.n_rows(); ++k)
+  {
+    pattern &= colnums[diag[k]] == k;
+    for (size_t p = offsets[k] + 1; p < offsets[k + 1]; ++p)
+      pattern &= colnums[p - 1] < colnums[p];
+    for (size_t p = offsets[k]; p < offsets[k + 1]; ++p)
+      sum += values[p];
+  }
+  for (const auto entry: N)
+    matrix_sum += entry.value;
+  passed &= check("scattered values",
+                  pattern && std::fabs(sum - matrix_sum) <
+                             1.0e-12 * std::fabs(matrix_sum));
+
+  // Numeric refactorizations with new values and a new pattern
+  SparseLU lu;
+  lu.set_matrix(N);
+  passed &= check_solve("SparseLU", lu, N, b);
+  passed &= check("diagonally dominant matrices do not pivot",
+                  !lu.used_pivoting());
+
+  lu.set_matrix(N_scaled);
+  passed &= check_solve("SparseLU, new values", lu, N_scaled, b);
+  lu.set_matrix(N_extra);
+  passed &= check_solve("SparseLU, new pattern", lu, N_extra, b);
+
+  const auto clone = lu.clone();
+  clone->set_matrix(N_scaled);
+  passed &= check_solve("SparseLU clone, new values", *clone, N_scaled, b);
+
+  // Small pivots fall back to partial pivoting, and the next matrix with
+  // the same pattern is factored without pivoting if possible. Pivoting
+  // inserts fill dynamically, so a small problem is used.
+  const auto small_mesh = create_square_mesh(10);
+  const SparseMatrix N_small = assemble(*small_mesh, false);
+  const SparseMatrix B = swap_group_rows(N_small);
+  const Vector b_small = create_rhs(B.n_rows());
+
+  SparseLU pivoting;
+  pivoting.set_matrix(B);
+  passed &= check_solve("SparseLU with small pivots", pivoting, B, b_small);
+  passed &= check("small pivots use partial pivoting",
+                  pivoting.used_pivoting());
+  pivoting.set_matrix(N_small);
+  passed &= check_solve("SparseLU after pivoting",
+                        pivoting, N_small, b_small);
+  passed &= check("pivoting is only used when needed",
+                  !pivoting.used_pivoting());
+
+  // Cholesky refactorizations
+  SparseCholesky cholesky;
+  cholesky.set_matrix(S);
+  passed &= check_solve("SparseCholesky", cholesky, S, b);
+  const SparseMatrix S_scaled = assemble(*mesh, true, 3.0);
+  cholesky.set_matrix(S_scaled);
+  passed &= check_solve("SparseCholesky, new values", cholesky, S_scaled, b);
+
+  SparseMatrix S_indefinite(S);
+  S_indefinite.diag(5) = -1.0;
+  bool threw = false;
+  try { cholesky.set_matrix(S_indefinite); }
+  catch (const std::exception&) { threw = true; }
+  passed &= check("SparseCholesky rejects indefinite matrices", threw);
+
+  return passed ? 0 : 1;
+}
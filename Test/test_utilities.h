@@ -0,0 +1,181 @@
+#ifndef TEST_UTILITIES_H
+#define TEST_UTILITIES_H
+
+#include "mesh.h"
+#include "ortho_grids.h"
+
+#include "Math/sparse_matrix.h"
+#include "vector.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+
+
+/**
+ * Shared problems and checks for the test programs. Each test program is a
+ * plain executable that prints one line per check and returns a non-zero
+ * exit code when any check fails.
+ */
+
+
+/**
+ * Two-group diffusion cross sections. The removal cross section of the fast
+ * group includes the downscattering cross section.
+ */
+struct TwoGroupXS
+{
+  double D[2];
+  double sigma_r[2];
+  double sigma_s12;
+};
+
+
+/**
+ * Create a 2D orthogonal mesh with \p n_cells per dimension on a square
+ * domain with side \p length.
+ */
+inline std::shared_ptr<PDEs::Grid::Mesh>
+create_square_mesh(const size_t n_cells, const double length = 100.0)
+{
+  std::vector<double> verts(n_cells + 1);
+  for (size_t i = 0; i <= n_cells; ++i)
+    verts[i] = length * i / n_cells;
+  return PDEs::Grid::create_2d_orthomesh(verts, verts);
+}
+
+
+/**
+ * Assemble the two-group finite volume diffusion operator on a 2D
+ * orthogonal mesh with the groups of each cell contiguous, as expected by
+ * GMGPreconditioner. The lower left quadrant of a 100 cm x 100 cm domain is
+ * fuel, the rest reflector, with zero flux boundaries.
+ *
+ * With \p symmetric set, the groups are coupled symmetrically and the
+ * operator is symmetric positive definite. Otherwise, the fast group
+ * downscatters into the thermal group and there is a weaker upscattering
+ * term, which makes the operator non-symmetric. The \p scale factor
+ * multiplies the removal cross sections, which gives operators with the
+ * same sparsity pattern and different values.
+ */
+inline PDEs::Math::SparseMatrix
+assemble(const PDEs::Grid::Mesh& mesh,
+         const bool symmetric,
+         const double scale = 1.0)
+{
+  using namespace PDEs;
+
+  const TwoGroupXS fuel{{1.5, 0.4}, {0.03 * scale, 0.1 * scale}, 0.02};
+  const TwoGroupXS reflector{{1.2, 0.2}, {0.025 * scale, 0.02 * scale}, 0.025};
+  const auto material = [&](const Grid::Cell& cell) -> const TwoGroupXS&
+  {
+    const auto& c = cell.centroid;
+    return (c.x() < 50.0 && c.y() < 50.0) ? fuel : reflector;
+  };
+
+  const size_t n_cells = mesh.cells.size();
+  Math::SparseMatrix A(2 * n_cells, 2 * n_cells);
+  for (const auto& cell: mesh.cells)
+  {
+    const TwoGroupXS& xs = material(cell);
+    const size_t i = cell.id;
+    const double volume = cell.volume;
+
+    A.add(2 * i, 2 * i, xs.sigma_r[0] * volume);
+    A.add(2 * i + 1, 2 * i + 1, xs.sigma_r[1] * volume);
+    A.add(2 * i + 1, 2 * i, -xs.sigma_s12 * volume);
+    if (symmetric)
+    {
+      A.add(2 * i, 2 * i + 1, -xs.sigma_s12 * volume);
+      A.add(2 * i + 1, 2 * i + 1, xs.sigma_s12 * volume);
+    }
+    else
+      A.add(2 * i, 2 * i + 1, -0.1 * xs.sigma_s12 * volume);
+
+    for (const auto& face: cell.faces)
+      for (unsigned int g = 0; g < 2; ++g)
+      {
+        if (!face.has_neighbor)
+        {
+          const double d = cell.centroid.distance(face.centroid);
+          A.add(2 * i + g, 2 * i + g, xs.D[g] / d * face.area);
+          continue;
+        }
+
+        // Harmonic mean of the diffusion coefficients
+        const auto& nbr_cell = mesh.cells[face.neighbor_id];
+        const TwoGroupXS& nbr_xs = material(nbr_cell);
+        const double d_i = cell.centroid.distance(face.centroid);
+        const double d_j = nbr_cell.centroid.distance(face.centroid);
+        const double D_f = (d_i + d_j) /
+                           (d_i / xs.D[g] + d_j / nbr_xs.D[g]);
+        const double coef = D_f / (d_i + d_j) * face.area;
+
+        const size_t j = face.neighbor_id;
+        A.add(2 * i + g, 2 * i + g, coef);
+        A.add(2 * i + g, 2 * j + g, -coef);
+      }
+  }
+  A.compress();
+  return A;
+}
+
+
+/** Return a right-hand side with the repeating pattern 1, 2, 3. */
+inline PDEs::Math::Vector
+create_rhs(const size_t n)
+{
+  PDEs::Math::Vector b(n);
+  for (size_t i = 0; i < n; ++i)
+    b[i] = 1.0 + i % 3;
+  return b;
+}
+
+
+/**
+ * Return the relative residual \f$ \| b - A x \| / \| b \| \f$ for any
+ * matrix type that provides <tt>vmult(y, x)</tt>.
+ */
+template<typename MatrixType>
+double
+relative_residual(const MatrixType& A,
+                  const PDEs::Math::Vector& x,
+                  const PDEs::Math::Vector& b)
+{
+  PDEs::Math::Vector r(b.size());
+  A.vmult(r, x);
+  r.sadd(-1.0, b);
+  return r.l2_norm() / b.l2_norm();
+}
+
+
+/** Print the result of the check \p name and return \p passed. */
+inline bool
+check(const std::string& name, const bool passed)
+{
+  std::cout << std::left << std::setw(64) << name
+            << (passed ? "PASSED" : "FAILED") << std::endl;
+  return passed;
+}
+
+
+/**
+ * Print \p name with the relative residual \p residual and return whether
+ * it is at most \p tolerance.
+ */
+inline bool
+check_residual(const std::string& name,
+               const double residual,
+               const double tolerance)
+{
+  std::ostringstream label;
+  label << name << ", residual "
+        << std::scientific << std::setprecision(2) << residual;
+  return check(label.str(), residual <= tolerance);
+}
+
+#endif //TEST_UTILITIES_H
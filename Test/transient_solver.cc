@@ -0,0 +1,298 @@
+#include "test_utilities.h"
+
+#include "NeutronDiffusion/TransientSolver/transient_solver.h"
+#include "LinearSolvers/Direct/lu.h"
+#include "LinearSolvers/Iterative/gmres.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+using namespace NeutronDiffusion;
+
+
+/** Expose the transient solution and operator cache for testing. */
+class TestSolver : public TransientSolver
+{
+public:
+  using TransientSolver::phi;
+  using TransientSolver::power;
+  using TransientSolver::operator_cache;
+
+  /**
+   * Form the multi-group matrix for the time step \p time_step from its
+   * split parts and return its maximum difference from a full assembly,
+   * relative to the largest entry.
+   */
+  double
+  split_operator_error(const double time_step)
+  {
+    dt = time_step;
+    form_transient_matrix();
+
+    SparseMatrix A_full(A);
+    A_full = 0.0;
+    assemble_transient_matrix(A_full, ASSEMBLE_SCATTER | ASSEMBLE_FISSION);
+    if (A_full.n_nonzero_entries() != A.n_nonzero_entries())
+      return 1.0;
+
+    double diff = 0.0, scale = 0.0;
+    for (const auto entry: A)
+    {
+      diff = std::max(diff, std::fabs(entry.value -
+                                      A_full.el(entry.row, entry.column)));
+      scale = std::max(scale, std::fabs(entry.value));
+    }
+    return diff / scale;
+  }
+};
+
+
+/** A sparse LU solver which counts the factorizations of all instances. */
+class CountingLU : public SparseLU
+{
+public:
+  static unsigned int n_factorizations;
+
+  void
+  factorize() override
+  {
+    ++n_factorizations;
+    SparseLU::factorize();
+  }
+
+  std::shared_ptr<LinearSolverBase<SparseMatrix>>
+  clone() const override
+  { return std::make_shared<CountingLU>(); }
+};
+
+unsigned int CountingLU::n_factorizations = 0;
+
+
+/** The transient results compared between runs. */
+struct Results
+{
+  double power;
+  Vector phi;
+  size_t n_cached;
+  unsigned int n_factorizations;
+};
+
+
+/**
+ * Write a two-group TWIGL cross-section file with one precursor group to
+ * \p path.
+ */
+void
+write_xs_file(const std::string& path,
+              const double D[2],
+              const double sigma_a[2],
+              const double nu_sigma_f[2])
+{
+  std::ofstream file(path);
+  file << "NUM_GROUPS 2\nNUM_MOMENTS 1\nNUM_PRECURSORS 1\nDENSITY 1.0\n\n"
+       << "DIFFUSION_COEFF_BEGIN\n0 " << D[0] << "\n1 " << D[1]
+       << "\nDIFFUSION_COEFF_END\n\n"
+       << "SIGMA_A_BEGIN\n0 " << sigma_a[0] << "\n1 " << sigma_a[1]
+       << "\nSIGMA_A_END\n\n"
+       << "TRANSFER_MOMENTS_BEGIN\n"
+       << "M_GPRIME_G_VAL 0 0 0 0.0\nM_GPRIME_G_VAL 0 0 1 0.01\n"
+       << "M_GPRIME_G_VAL 0 1 0 0.0\nM_GPRIME_G_VAL 0 1 1 0.0\n"
+       << "TRANSFER_MOMENTS_END\n\n"
+       << "NU_SIGMA_F_BEGIN\n0 " << nu_sigma_f[0] << "\n1 " << nu_sigma_f[1]
+       << "\nNU_SIGMA_F_END\n\n"
+       << "NU_BEGIN\n0 2.43\n1 2.43\nNU_END\n\n"
+       << "BETA_BEGIN\n0 0.0075\n1 0.0075\nBETA_END\n\n"
+       << "CHI_PROMPT_BEGIN\n0 1.0\n1 0.0\nCHI_PROMPT_END\n\n"
+       << "CHI_DELAYED_BEGIN\nG_PRECURSORJ_VAL 0 0 1.0\nCHI_DELAYED_END\n\n"
+       << "PRECURSOR_LAMBDA_BEGIN\n0 0.08\nPRECURSOR_LAMBDA_END\n\n"
+       << "PRECURSOR_YIELD_BEGIN\n0 1.0\nPRECURSOR_YIELD_END\n\n"
+       << "VELOCITY_BEGIN\n0 1.0e7\n1 2.0e5\nVELOCITY_END\n";
+}
+
+
+/**
+ * Set up a coarse TWIGL ramp transient in \p solver, with the cross-section
+ * files in \p xs_dir. Adaptive time stepping refines and coarsens the time
+ * step during and after the ramp, so that time step sizes are revisited.
+ */
+void
+setup_twigl(TransientSolver& solver, const std::string& xs_dir)
+{
+  std::vector<double> verts(21);
+  for (size_t i = 0; i < verts.size(); ++i)
+    verts[i] = 4.0 * i;
+  auto mesh = Grid::create_2d_orthomesh(verts, verts);
+  for (auto& cell: mesh->cells)
+  {
+    const auto& c = cell.centroid;
+    const bool inner_x = c.x() > 24.0 && c.x() < 56.0;
+    const bool inner_y = c.y() > 24.0 && c.y() < 56.0;
+    if (inner_x && inner_y)
+      cell.material_id = 0;
+    else if ((c.x() < 24.0 && inner_y) || (inner_x && c.y() < 24.0))
+      cell.material_id = 1;
+    else
+      cell.material_id = 2;
+  }
+
+  const auto ramp = [](const unsigned int group_num,
+                       const std::vector<double>& args,
+                       const double reference)
+  {
+    const double t = args[0], magnitude = 0.97667 - 1.0, duration = 0.2;
+    if (group_num != 1)
+      return reference;
+    return (1.0 + std::min(t, duration) / duration * magnitude) * reference;
+  };
+
+  const std::vector<std::string> xs_files = {"fuel0.xs", "fuel0.xs",
+                                             "fuel1.xs"};
+  solver.materials.clear();
+  for (unsigned int i = 0; i < xs_files.size(); ++i)
+  {
+    auto xs = std::make_shared<CrossSections>();
+    xs->read_xs_file(xs_dir + "/" + xs_files[i]);
+    if (i == 0)
+      xs->sigma_a_function = ramp;
+    auto material = std::make_shared<Physics::Material>("Fuel " +
+                                                        std::to_string(i));
+    material->properties.emplace_back(xs);
+    solver.materials.emplace_back(material);
+  }
+
+  solver.mesh = mesh;
+  solver.use_precursors = true;
+  solver.outer_tolerance = 1.0e-10;
+  solver.max_outer_iterations = 1000;
+  solver.algorithm = Algorithm::DIRECT;
+
+  solver.boundary_info.clear();
+  solver.boundary_info.emplace_back(BoundaryType::REFLECTIVE, -1);
+  solver.boundary_info.emplace_back(BoundaryType::VACUUM, -1);
+  solver.boundary_info.emplace_back(BoundaryType::VACUUM, -1);
+  solver.boundary_info.emplace_back(BoundaryType::REFLECTIVE, -1);
+
+  solver.t_end = 0.4;
+  solver.dt = 0.01;
+  solver.time_stepping_method = TimeSteppingMethod::CRANK_NICHOLSON;
+  solver.normalization_method = NormalizationMethod::TOTAL_POWER;
+  solver.normalize_fission_xs = true;
+
+  solver.adaptive_time_stepping = true;
+  solver.refine_threshold = 0.05;
+  solver.coarsen_threshold = 0.01;
+}
+
+
+/**
+ * Run the TWIGL transient with the specified \p linear_solver,
+ * \p operator_type, and \p cache_size. Only the factorizations during the
+ * transient are counted.
+ */
+Results
+run(const std::string& xs_dir,
+    const std::shared_ptr<LinearSolverBase<SparseMatrix>>& linear_solver,
+    const OperatorType operator_type = OperatorType::SPARSE,
+    const unsigned int cache_size = 4)
+{
+  TestSolver solver;
+  setup_twigl(solver, xs_dir);
+  solver.linear_solver = linear_solver;
+  solver.operator_type = operator_type;
+  solver.operator_cache_size = cache_size;
+
+  solver.initialize();
+  CountingLU::n_factorizations = 0;
+  solver.execute();
+  return {solver.power, solver.phi, solver.operator_cache.size(),
+          CountingLU::n_factorizations};
+}
+
+
+/** Return the maximum relative difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  if (x.size() != y.size())
+    return 1.0;
+
+  double diff = 0.0, scale = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+    scale = std::max(scale, std::fabs(x[i]));
+  }
+  return diff / scale;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  const auto xs_dir = std::filesystem::temp_directory_path() /
+                      "pdes_transient_solver_xs";
+  std::filesystem::create_directories(xs_dir);
+
+  const double D0[2] = {1.4, 0.4}, D1[2] = {1.3, 0.5};
+  const double sigma_a0[2] = {0.01, 0.15}, sigma_a1[2] = {0.008, 0.05};
+  const double nu_sigma_f0[2] = {0.007, 0.2}, nu_sigma_f1[2] = {0.003, 0.06};
+  write_xs_file((xs_dir / "fuel0.xs").string(), D0, sigma_a0, nu_sigma_f0);
+  write_xs_file((xs_dir / "fuel1.xs").string(), D1, sigma_a1, nu_sigma_f1);
+
+  // Reusing cached operators does not change the transient
+  const auto uncached = run(xs_dir.string(), std::make_shared<CountingLU>(),
+                            OperatorType::SPARSE, 0);
+  const auto cached = run(xs_dir.string(), std::make_shared<CountingLU>());
+  passed &= check("operators are cached when enabled",
+                  uncached.n_cached == 0 && cached.n_cached > 0 &&
+                  cached.n_cached <= 4);
+  passed &= check("cached operators avoid refactorizations",
+                  cached.n_factorizations < uncached.n_factorizations);
+  passed &= check("cached operators give the same power",
+                  std::fabs(cached.power - uncached.power) <=
+                  1.0e-10 * uncached.power);
+  passed &= check("cached operators give the same flux",
+                  max_difference(uncached.phi, cached.phi) < 1.0e-10);
+
+  // The split operator matches a full assembly for other time steps,
+  // including the implicit delayed fission terms
+  {
+    TestSolver solver;
+    setup_twigl(solver, xs_dir.string());
+    solver.linear_solver = std::make_shared<SparseLU>();
+    solver.initialize();
+    solver.execute();
+
+    double error = 0.0;
+    for (const double time_step: {1.0e-4, 0.003, 0.01, 0.25})
+      error = std::max(error, solver.split_operator_error(time_step));
+    passed &= check("split operator matches a full assembly", error < 1.0e-13);
+  }
+
+  // Block sparse and matrix-free operators are fully reassembled
+  for (const auto operator_type: {OperatorType::BLOCK_SPARSE,
+                                  OperatorType::MATRIX_FREE})
+  {
+    const auto gmres = std::make_shared<GMRES>(30, Options(1.0e-12, 1000));
+    const auto result = run(xs_dir.string(), gmres, operator_type);
+    const std::string label = operator_type == OperatorType::BLOCK_SPARSE
+                              ? "block sparse" : "matrix-free";
+    passed &= check(label + " reassembly matches the split operator",
+                    std::fabs(result.power - uncached.power) <=
+                    1.0e-8 * uncached.power &&
+                    max_difference(uncached.phi, result.phi) < 1.0e-8);
+  }
+
+  std::filesystem::remove_all(xs_dir);
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#include "test_utilities.h"
+
+#include "multithreading.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+
+
+/** Return the maximum relative difference between two vectors. */
+double
+max_difference(const Vector& x, const Vector& y)
+{
+  if (x.size() != y.size())
+    return 1.0;
+  double diff = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    diff = std::max(diff, std::fabs(x[i] - y[i]) /
+                          std::max(1.0, std::fabs(x[i])));
+  return diff;
+}
+
+
+/** Return whether \p a and \p b agree to a relative tolerance. */
+bool
+close(const double a, const double b, const double tolerance = 1.0e-12)
+{
+  return std::fabs(a - b) <= tolerance * std::max(1.0, std::fabs(a));
+}
+
+
+/** Check the fused kernels against the unfused operations. */
+bool
+check_kernels(const size_t n, const std::string& label)
+{
+  Vector x(n), y(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    x[i] = std::sin(0.1 * i);
+    y[i] = std::cos(0.07 * i) - 0.3;
+  }
+
+  bool passed = true;
+  passed &= check(label + "l1_norm_diff",
+                  close(l1_norm_diff(x, y), (x - y).l1_norm()));
+
+  const auto [x_dot_y, x_norm] = dot_and_norm(x, y);
+  passed &= check(label + "dot_and_norm",
+                  close(x_dot_y, x.dot(y)) && close(x_norm, x.l2_norm()));
+
+  // y = 2 x - 0.5 y
+  Vector z(y);
+  axpby(2.0, x, -0.5, z);
+  passed &= check(label + "axpby",
+                  max_difference(z, 2.0 * x - 0.5 * y) < 1.0e-14);
+
+  // w = 3 x + 4 y, with w resized and with w aliasing x or y
+  const Vector expected = 3.0 * x + 4.0 * y;
+  Vector w;
+  waxpby(w, 3.0, x, 4.0, y);
+  Vector wx(x), wy(y);
+  waxpby(wx, 3.0, wx, 4.0, y);
+  waxpby(wy, 3.0, x, 4.0, wy);
+  passed &= check(label + "waxpby",
+                  max_difference(w, expected) < 1.0e-14 &&
+                  max_difference(wx, expected) < 1.0e-14 &&
+                  max_difference(wy, expected) < 1.0e-14);
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // Small vectors stay serial, large vectors are split among threads
+  passed &= check_kernels(10, "10 entries: ");
+  for (const unsigned int n_threads: {1, 4})
+  {
+    MultiThreading::set_n_threads(n_threads);
+    passed &= check_kernels(200000, "200000 entries, " +
+                                    std::to_string(n_threads) +
+                                    " threads: ");
+  }
+  MultiThreading::set_n_threads(0);
+
+  return passed ? 0 : 1;
+}
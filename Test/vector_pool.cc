@@ -0,0 +1,135 @@
+#include "test_utilities.h"
+
+#include "aligned_allocator.h"
+#include "vector_pool.h"
+#include "matrix.h"
+#include "LinearSolvers/Iterative/cg.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <iostream>
+
+
+using namespace PDEs;
+using namespace Math;
+using namespace LinearSolvers;
+
+
+/** Return whether \p ptr is aligned to \p alignment bytes. */
+bool
+is_aligned(const void* ptr, const size_t alignment)
+{
+  return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+
+int main()
+{
+  bool passed = true;
+
+  // Raw aligned allocations, with and without huge pages
+  bool aligned = aligned_malloc(0, 64) == nullptr;
+  for (const size_t alignment: {16, 64, 4096})
+    for (const size_t n_bytes: {1, 24, 1000, 100000})
+    {
+      void* ptr = aligned_malloc(n_bytes, alignment);
+      aligned &= is_aligned(ptr, alignment);
+      aligned_free(ptr);
+    }
+  passed &= check("aligned_malloc alignment", aligned);
+
+  use_huge_pages(true);
+  void* huge = aligned_malloc(huge_page_size + 8, default_alignment);
+  void* small = aligned_malloc(huge_page_size / 2, default_alignment);
+  passed &= check("large allocations use huge page boundaries",
+                  use_huge_pages() && is_aligned(huge, huge_page_size) &&
+                  is_aligned(small, default_alignment));
+  aligned_free(huge);
+  aligned_free(small);
+  use_huge_pages(false);
+
+  // Vector and dense matrix storage
+  aligned = true;
+  for (size_t n = 1; n < 100; n += 7)
+  {
+    Vector x(n, 1.0);
+    const Vector y(x);
+    x.resize(3 * n + 1);
+    aligned &= is_aligned(x.data(), default_alignment) &&
+               is_aligned(y.data(), default_alignment);
+  }
+  passed &= check("vector storage alignment", aligned);
+
+  Matrix M(5, Matrix::padding_threshold + 3, 1.0);
+  aligned = M.leading_dimension() % Matrix::row_alignment == 0;
+  for (size_t i = 0; i < M.n_rows(); ++i)
+    aligned &= is_aligned(M[i], default_alignment);
+  passed &= check("padded matrix row alignment", aligned);
+
+  // Scratch vectors are returned to the pool and reused
+  auto& pool = VectorPool::thread_pool();
+  pool.clear();
+  const double* first;
+  {
+    ScratchVector a(100, 2.0), b(100);
+    first = a->data();
+    passed &= check("scratch vectors are distinct and initialized",
+                    a->data() != b->data() && a->size() == 100 &&
+                    (*a)[99] == 2.0 && pool.n_available() == 0);
+  }
+  passed &= check("scratch vectors are released", pool.n_available() == 2);
+  {
+    ScratchVector a(50);
+    passed &= check("released storage is reused",
+                    pool.n_available() == 1 && a->size() == 50 &&
+                    a->capacity() >= 100);
+  }
+
+  // The vector with the smallest sufficient capacity is checked out
+  pool.clear();
+  {
+    ScratchVector large(1000), medium(200), small(20);
+  }
+  {
+    ScratchVector a(150);
+    passed &= check("best fitting vector is checked out",
+                    a->capacity() >= 200 && a->capacity() < 1000);
+  }
+  {
+    ScratchVector a(5000);
+    passed &= check("largest vector is grown",
+                    a->size() == 5000 && pool.n_available() == 2);
+  }
+
+  // Each thread has its own pool
+  const VectorPool* other = nullptr;
+  std::thread thread([&other]() { other = &VectorPool::thread_pool(); });
+  thread.join();
+  passed &= check("pools are per thread", other != &pool);
+
+  // Repeated solves do not allocate work vectors once the pool is warm
+  pool.clear();
+  const auto mesh = create_square_mesh(30);
+  const SparseMatrix A = assemble(*mesh, true);
+  const Vector b = create_rhs(A.n_rows());
+
+  CG cg(Options(1.0e-10, 1000));
+  cg.set_matrix(A);
+  Vector x(b.size(), 0.0);
+  cg.solve(x, b);
+  const size_t n_warm = pool.n_available();
+  for (unsigned int k = 0; k < 3; ++k)
+  {
+    x = 0.0;
+    cg.solve(x, b);
+  }
+  passed &= check("repeated solves reuse the pool",
+                  n_warm > 0 && pool.n_available() == n_warm);
+  passed &= check_residual("CG with pooled work vectors",
+                           relative_residual(A, x, b), 1.0e-9);
+  pool.clear();
+
+  return passed ? 0 : 1;
+}